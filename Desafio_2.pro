@@ -5,17 +5,73 @@ CONFIG += qt
 
 SOURCES += \
     GestorUdeaStay.cpp \
+    agendaalojamientos.cpp \
     alojamiento.cpp \
+    bufercsv.cpp \
+    cachebusquedas.cpp \
+    almacenhistorico.cpp \
+    calendarioocupacion.cpp \
     fecha.cpp \
+    generadorcodigos.cpp \
+    analiticaocupacion.cpp \
     anfitrion.cpp \
+    canalcambios.cpp \
+    clienteudeastay.cpp \
+    colavencimientos.cpp \
+    drenadorcambios.cpp \
+    escritorgrupal.cpp \
     huesped.cpp \
+    indiceclaves.cpp \
+    indicehistorico.cpp \
+    indicelineascsv.cpp \
+    integridadreservaciones.cpp \
+    lecturacampos.cpp \
+    listaestadias.cpp \
     main.cpp \
-    reservacion.cpp
+    poolhilos.cpp \
+    reservacion.cpp \
+    servidorudeastay.cpp \
+    sesion.cpp \
+    tarifastemporada.cpp \
+    vigilantearchivos.cpp
 
 HEADERS += \
     GestorUdeaStay.h \
+    agendaalojamientos.h \
     alojamiento.h \
+    bufercsv.h \
+    cachebusquedas.h \
+    almacenhistorico.h \
+    calendarioocupacion.h \
+    cargadorcsv.h \
     fecha.h \
+    generadorcodigos.h \
+    analiticaocupacion.h \
     anfitrion.h \
+    canalcambios.h \
+    clienteudeastay.h \
+    colacircular.h \
+    colavencimientos.h \
+    drenadorcambios.h \
+    escritorgrupal.h \
     huesped.h \
-    reservacion.h 
+    indiceclaves.h \
+    indicehistorico.h \
+    indicelineascsv.h \
+    integridadreservaciones.h \
+    lecturacampos.h \
+    listaestadias.h \
+    poolhilos.h \
+    registrobajodemanda.h \
+    reservacion.h \
+    servidorudeastay.h \
+    sesion.h \
+    tablahash.h \
+    tarifastemporada.h \
+    vigilantearchivos.h
+
+# Compresión opcional del histórico particionado: qmake CONFIG+=zlib
+CONFIG(zlib) {
+    DEFINES += UDEASTAY_CON_ZLIB
+    LIBS += -lz
+}
@@ -9,6 +9,16 @@
 #include <algorithm>    // Para std::remove si se usa para limpiar strings (opcional)
 #include <cctype>
 #include <iomanip>  // para std::setfill y setw se usa para formatear un identificador de reservacion unico
+#include <cerrno>
+#include <chrono>       // Para el intervalo del archivado automático
+#include <random>       // Para la prueba de estrés
+#include <fcntl.h>      // Para ::open (anexar al histórico con una sola escritura)
+#include <unistd.h>     // Para ::write, ::fsync, ::close
+#include <sys/stat.h>   // Para saber si el archivo de rechazadas ya tiene cabecera
+#include <cstring>      // Para memmove (unir los bloques de una búsqueda paralela)
+#include <cmath>        // Para llround (precio base en pesos enteros)
+#include "cargadorcsv.h"
+#include "integridadreservaciones.h"
 // Usamos el namespace std para este archivo .cpp
 using namespace std;
 
@@ -20,14 +30,25 @@ using namespace std;
  * las cantidades a 0 y los cupos a un valor inicial.
  * Llama a inicializarSistema() para cargar los datos.
  */
-GestorUdeaStay::GestorUdeaStay() :
+GestorUdeaStay::GestorUdeaStay(bool usuariosBajoDemanda) :
     todosAlojamientos(nullptr), cantidadAlojamientos(0), cupoAlojamientos(0),
     todasReservaciones(nullptr), cantidadReservaciones(0), cupoReservaciones(0),
-    todosAnfitriones(nullptr), cantidadAnfitriones(0), cupoAnfitriones(0),
-    todosHuespedes(nullptr), cantidadHuespedes(0), cupoHuespedes(0),
-    anfitrionLogueado(nullptr),
-    huespedLogueado(nullptr),
-    contadorIteracionesGlobal(0)
+    usuariosBajoDemanda(usuariosBajoDemanda),
+    inicioAlojamientosDeAnfitrion(nullptr), alojamientosDeAnfitrion(nullptr),
+    contadorIteracionesGlobal(0),
+    indiceHistorico(archivoHistorico, archivoIndiceHistorico),
+    almacenHistorico(directorioHistoricoParticionado),
+    historicoParticionado(false),
+    cantidadDrenadoresCambios(0),
+    recargasAlojamientos(0),
+    cantidadAlojamientosRetirados(0),
+    generadorCodigos("RES"),
+    sincronizarHistoricoEnDisco(false),
+    versionReservaciones(0),
+    versionGuardada(0),
+    persistirCambios(true),
+    detenerHiloArchivado(false),
+    intervaloArchivadoSegundos(0)
 // Los const std::string para nombres de archivo ya se inicializan en el .h
 {
     cout << "Inicializando GestorUdeaStay..." << endl; // Mensaje de prueba
@@ -36,6 +57,10 @@ GestorUdeaStay::GestorUdeaStay() :
     // O dejar que los métodos de carga manejen la primera asignación.
     // Por ahora, los métodos de carga se encargarán de la primera asignación si son nullptr.
 
+    // Antes de cargar: la revisión de integridad ya reparte su trabajo en estos hilos
+    const int nucleos = static_cast<int>(thread::hardware_concurrency());
+    poolRecorridos.iniciar(nucleos > 1 ? nucleos - 1 : 0);
+
     inicializarSistema(); // Carga todos los datos al crear el objeto
 }
 
@@ -46,16 +71,19 @@ GestorUdeaStay::GestorUdeaStay() :
  */
 GestorUdeaStay::~GestorUdeaStay() {
     cout << "Finalizando GestorUdeaStay y guardando datos..." << endl; // Mensaje de prueba
+    vigilanteAlojamientos.detener(); // Ninguna recarga a medias mientras se guarda y libera
+    detenerArchivadoAutomatico(); // El hilo de archivado no debe correr mientras se guarda y libera
     finalizarSistema(); // Guarda los datos necesarios (ej. reservaciones)
+    detenerDrenadoresCambios();
 
     // Liberar memoria de los arreglos dinámicos
     delete[] todosAlojamientos;
     delete[] todasReservaciones;
-    delete[] todosAnfitriones;
-    delete[] todosHuespedes;
+    delete[] inicioAlojamientosDeAnfitrion;
+    delete[] alojamientosDeAnfitrion;
 
-    // Los punteros anfitrionLogueado y huespedLogueado no son dueños de la memoria,
-    // solo apuntan a objetos dentro de todosAnfitriones o todosHuespedes,
+    // Los punteros de sesionConsola no son dueños de la memoria,
+    // solo apuntan a objetos de 'anfitriones' o 'huespedes' (que los liberan),
     // así que no se hace delete sobre ellos aquí.
     cout << "Memoria liberada." << endl;
 }
@@ -95,18 +123,23 @@ void GestorUdeaStay::inspeccionarDatosCargadosParaDebug()  {
         // Para depuración, puedes quitar const de este método o hacer mutable el contador.
         // O no contar iteraciones aquí.
 
-    cout << "\n--- Anfitriones en Memoria (" << cantidadAnfitriones << ") ---" << endl;
-    for (int i = 0; i < cantidadAnfitriones; ++i) {
-        // Asumiendo que Anfitrion tiene getId() y getContrasena()
-        cout << "Índice " << i << ": ID=[" << todosAnfitriones[i].getId() << "], Pass=[" << todosAnfitriones[i].getContrasena()
-             << "], Nombre=[" << todosAnfitriones[i].getNombre() << "]" << endl;
+    // Bajo demanda solo se muestran los usuarios que ya se leyeron del archivo
+    cout << "\n--- Anfitriones en Memoria (" << anfitriones.getEnMemoria() << " de " << anfitriones.getCantidad()
+         << ") ---" << endl;
+    for (int i = 0; i < anfitriones.getCantidad(); ++i) {
+        const Anfitrion* anfitrion = anfitriones.obtenerSiEnMemoria(i);
+        if (anfitrion == nullptr) continue;
+        cout << "Índice " << i << ": ID=[" << anfitrion->getId() << "], Pass=[" << anfitrion->getContrasena()
+             << "], Nombre=[" << anfitrion->getNombre() << "]" << endl;
     }
 
-    cout << "\n--- Huéspedes en Memoria (" << cantidadHuespedes << ") ---" << endl;
-    for (int i = 0; i < cantidadHuespedes; ++i) {
-        // Asumiendo que Huesped tiene getId() y getContrasena()
-        cout << "Índice " << i << ": ID=[" << todosHuespedes[i].getId() << "], Pass=[" << todosHuespedes[i].getContrasena()
-             << "], Nombre=[" << todosHuespedes[i].getNombre() << "]" << endl;
+    cout << "\n--- Huéspedes en Memoria (" << huespedes.getEnMemoria() << " de " << huespedes.getCantidad()
+         << ") ---" << endl;
+    for (int i = 0; i < huespedes.getCantidad(); ++i) {
+        const Huesped* huesped = huespedes.obtenerSiEnMemoria(i);
+        if (huesped == nullptr) continue;
+        cout << "Índice " << i << ": ID=[" << huesped->getId() << "], Pass=[" << huesped->getContrasena()
+             << "], Nombre=[" << huesped->getNombre() << "]" << endl;
     }
     cout << "--- Fin Inspección ---" << endl;
 }
@@ -117,11 +150,12 @@ void limpiarBufferEntrada() {
 void GestorUdeaStay::manejarMenuAnfitrion() {
     int opcion = -1;
     do {
-        cout << "\n--- Menú Anfitrión: " << anfitrionLogueado->getNombre() << " ---" << endl;
+        cout << "\n--- Menú Anfitrión: " << sesionConsola.getAnfitrion()->getNombre() << " ---" << endl;
         cout << "1. Actualizar archivo histórico" << endl;
         cout << "2. Consultar mis reservaciones" << endl; // Por implementar
         cout << "3. Anular una reservación" << endl;       // Por implementar
         cout << "4. Ver estado de recursos" << endl;
+        cout << "5. Consultar histórico de mis alojamientos" << endl;
         cout << "0. Cerrar Sesión" << endl;
         cout << "Seleccione una opción: ";
         cin >> opcion;
@@ -158,7 +192,7 @@ void GestorUdeaStay::manejarMenuAnfitrion() {
             f1.setFecha(d1, m1, a1);
             f2.setFecha(d2, m2, a2);
 
-            mostrarReservacionesDelAnfitrion(f1, f2);
+            mostrarReservacionesDelAnfitrion(sesionConsola, f1, f2);
             break;
         }
 
@@ -166,14 +200,25 @@ void GestorUdeaStay::manejarMenuAnfitrion() {
             std::string codigo;
             std::cout << "Ingrese el código de la reservación que desea anular: ";
             std::getline(std::cin >> std::ws, codigo);
-            cancelarUnaReservacion(codigo);
+            cancelarUnaReservacion(sesionConsola, codigo);
             break;
         }
         case 4:
             mostrarEstadoRecursosActual();
             break;
+        case 5: {
+            int d1, m1, a1, d2, m2, a2;
+            cout << "Ingrese fecha inicial (dd mm aaaa): ";
+            cin >> d1 >> m1 >> a1;
+            cout << "Ingrese fecha final (dd mm aaaa): ";
+            cin >> d2 >> m2 >> a2;
+            limpiarBufferEntrada();
+
+            consultarHistoricoDelAnfitrion(sesionConsola, Fecha(d1, m1, a1), Fecha(d2, m2, a2));
+            break;
+        }
         case 0:
-            cerrarSesion();
+            sesionConsola.cerrar();
             cout << "Sesión de Anfitrión cerrada." << endl;
             break;
         default:
@@ -185,11 +230,13 @@ void GestorUdeaStay::manejarMenuAnfitrion() {
 void GestorUdeaStay::manejarMenuHuesped() {
     int opcion = -1;
     do {
-        cout << "\n--- Menú Huésped: " << huespedLogueado->getNombre() << " ---" << endl;
+        cout << "\n--- Menú Huésped: " << sesionConsola.getHuesped()->getNombre() << " ---" << endl;
         cout << "1. Buscar alojamiento disponible" << endl; // Por implementar
         cout << "2. Crear nueva reservación por código" << endl; // Por implementar
         cout << "3. Anular una de mis reservaciones" << endl;  // Por implementar
         cout << "4. Ver estado de recursos" << endl;
+        cout << "5. Consultar mis estadías pasadas" << endl;
+        cout << "6. Buscar con fechas flexibles" << endl;
         cout << "0. Cerrar Sesión" << endl;
         cout << "Seleccione una opción: ";
         cin >> opcion;
@@ -214,11 +261,23 @@ void GestorUdeaStay::manejarMenuHuesped() {
             cout << "Ingrese cantidad de noches: ";
             cin >> noches;
 
+            double precioNocheMaximo, costoTotalMaximo;
+            cout << "Precio promedio máximo por noche (0 = sin límite): ";
+            cin >> precioNocheMaximo;
+            cout << "Costo total máximo de la estadía (0 = sin límite): ";
+            cin >> costoTotalMaximo;
+            if (cin.fail()) {
+                cin.clear();
+                precioNocheMaximo = costoTotalMaximo = 0;
+            }
+            limpiarBufferEntrada();
+
             string municipioIgnorado = "";
-            double precioIgnorado = -1;
             double puntuacionIgnorada = -1;
 
-            mostrarAlojamientosDisponibles(fechaEntrada, municipioIgnorado, noches, precioIgnorado, puntuacionIgnorada);
+            mostrarAlojamientosDisponibles(fechaEntrada, municipioIgnorado, noches,
+                                           precioNocheMaximo > 0 ? precioNocheMaximo : -1, puntuacionIgnorada,
+                                           costoTotalMaximo > 0 ? costoTotalMaximo : -1);
             break;
         }
         case 2: {    
@@ -248,11 +307,10 @@ void GestorUdeaStay::manejarMenuHuesped() {
             Fecha fechaEntrada(dia, mes, anio);
 
             // --- Lógica principal ---
-            bool exito = crearNuevaReservacion(codigoAloj, fechaEntrada, noches, metodoPago, anotaciones);
+            bool exito = crearNuevaReservacion(sesionConsola, codigoAloj, fechaEntrada, noches, metodoPago, anotaciones);
 
-            if (exito) {
-                guardarReservacionesActivasEnArchivo(); // Sincronizar con el dataset
-            } else {
+            // crearNuevaReservacion ya sincroniza el dataset si tuvo éxito.
+            if (!exito) {
                 cout << "No se pudo crear la reservación. Inténtelo nuevamente.\n";
             }
 
@@ -262,17 +320,7 @@ void GestorUdeaStay::manejarMenuHuesped() {
             cout << " Anular una de mis reservaciones ";
 
             // Mostrar reservaciones activas del huésped
-            const Huesped* h = getHuespedActual();
-            bool tieneActivas = false;
-            for (int i = 0; i < h->getCantidadReservaciones(); ++i) {
-                std::string codigo = h->getCodigoReservacion(i);
-                Reservacion* r = encontrarReservacionActivaPorCodigo(codigo);
-                if (r != nullptr && r->EstaActiva()) {
-                    r->mostrarComprobante();
-                    cout << "              " << endl;
-                    tieneActivas = true;
-                }
-            }
+            bool tieneActivas = mostrarReservacionesDelHuesped(sesionConsola);
 
             if (!tieneActivas) {
                 cout << "No tiene reservaciones activas para anular.\n";
@@ -283,7 +331,7 @@ void GestorUdeaStay::manejarMenuHuesped() {
             cout << "Ingrese el código de la reservación que desea anular: ";
             cin >> codigoElegido;
 
-            bool resultado = cancelarUnaReservacion(codigoElegido);
+            bool resultado = cancelarUnaReservacion(sesionConsola, codigoElegido);
             if (!resultado) {
                 cout << "No se pudo anular la reservación.\n";
             }
@@ -293,8 +341,35 @@ void GestorUdeaStay::manejarMenuHuesped() {
         case 4:
             mostrarEstadoRecursosActual();
             break;
+        case 5: {
+            int d1, m1, a1, d2, m2, a2;
+            cout << "Ingrese fecha inicial (dd mm aaaa): ";
+            cin >> d1 >> m1 >> a1;
+            cout << "Ingrese fecha final (dd mm aaaa): ";
+            cin >> d2 >> m2 >> a2;
+            limpiarBufferEntrada();
+
+            consultarHistoricoDelHuesped(sesionConsola, Fecha(d1, m1, a1), Fecha(d2, m2, a2));
+            break;
+        }
+        case 6: {
+            int d1, m1, a1, d2, m2, a2, noches;
+            cout << "Primera noche posible (dd mm aaaa): ";
+            cin >> d1 >> m1 >> a1;
+            cout << "Última noche posible (dd mm aaaa): ";
+            cin >> d2 >> m2 >> a2;
+            cout << "Ingrese cantidad de noches: ";
+            cin >> noches;
+            limpiarBufferEntrada();
+            string municipio;
+            cout << "Municipio (vacío = cualquiera): ";
+            getline(cin, municipio);
+
+            mostrarVentanasDisponibles(Fecha(d1, m1, a1), Fecha(d2, m2, a2), noches, municipio);
+            break;
+        }
         case 0:
-            cerrarSesion();
+            sesionConsola.cerrar();
             cout << "Sesión de Huésped cerrada." << endl;
             break;
         default:
@@ -332,7 +407,7 @@ void GestorUdeaStay::ejecutar() {
             getline(cin, id);
             cout << "Ingrese Contraseña: ";
             getline(cin, contrasena);
-            if (intentarLoginAnfitrion(id, contrasena)) {
+            if (intentarLoginAnfitrion(sesionConsola, id, contrasena)) {
                 cout << "Login de Anfitrión exitoso." << endl;
                 manejarMenuAnfitrion(); // Llama al menú específico
             } else {
@@ -344,7 +419,7 @@ void GestorUdeaStay::ejecutar() {
             getline(cin, id);
             cout << "Ingrese Contraseña: ";
             getline(cin, contrasena);
-            if (intentarLoginHuesped(id, contrasena)) {
+            if (intentarLoginHuesped(sesionConsola, id, contrasena)) {
                 cout << "Login de Huésped exitoso." << endl;
                 manejarMenuHuesped(); // Llama al menú específico
             } else {
@@ -376,10 +451,17 @@ void GestorUdeaStay::inicializarSistema() {
     cout << "Cargando datos del sistema..." << endl;
     // En orden, por si hay dependencias (aunque aquí no debería haber muchas directas)
     cargarAlojamientosDesdeArchivo();
+    cargarTarifasDesdeArchivo();
     cargarAnfitrionesDesdeArchivo();
+    construirAdyacenciaAnfitriones();
     cargarHuespedesDesdeArchivo();
     cargarReservacionesActivasDesdeArchivo();
+    aplicarDiarioDeReservaciones();
     // No cargamos el histórico a memoria por defecto, solo se usa para añadir o consultar específicamente.
+    // Pero sí se recorren sus códigos para que el generador nunca reemita uno ya archivado.
+    sembrarGeneradorDesdeHistorico();
+    generadorCodigos.cargarSecuencia(archivoSecuenciaReservaciones);
+    indiceHistorico.abrir(); // Solo indexa lo añadido al histórico desde la última ejecución
     cout << "Datos cargados." << endl;
 }
 
@@ -391,7 +473,22 @@ void GestorUdeaStay::inicializarSistema() {
  */
 void GestorUdeaStay::finalizarSistema()  {
     cout << "Guardando datos modificados del sistema..." << endl;
-    guardarReservacionesActivasEnArchivo();
+    lock_guard<shared_mutex> bloqueo(mutexDatos);
+    if (!persistirCambios) {
+        cout << "Modo sin persistencia: no se escriben archivos." << endl;
+        return;
+    }
+    // Punto de control: con el CSV ya en disco, el diario se puede vaciar.
+    if (guardarReservacionesActivasEnArchivo(diarioReservaciones.estaAbierto()) && diarioReservaciones.estaAbierto()) {
+        diarioReservaciones.truncar();
+    }
+    guardarReservacionesRechazadas();
+    if (!generadorCodigos.guardarSecuencia(archivoSecuenciaReservaciones)) {
+        cerr << "Error [GestorUdeaStay]: No se pudo guardar la secuencia de códigos en '"
+             << archivoSecuenciaReservaciones << "'." << endl;
+    }
+    lock_guard<mutex> bloqueoHistorico(mutexHistorico);
+    indiceHistorico.guardar();
     // No se guardan alojamientos, anfitriones, huéspedes porque se asumen estáticos post-carga.
     // Si esta lógica cambia (ej. puntuaciones actualizadas deben persistir), se añadirían aquí.
     cout << "Datos guardados." << endl;
@@ -399,23 +496,11 @@ void GestorUdeaStay::finalizarSistema()  {
 Fecha GestorUdeaStay::parsearStringAFechaInterno(const string& strFecha) {
     incrementarContadorIteraciones();
 
-    if (strFecha.length() != 10 || strFecha[2] != '/' || strFecha[5] != '/') {
-        cerr << "Error [GestorUdeaStay]: Formato de fecha inválido '" << strFecha << "'. Se esperaba dd/mm/aaaa." << endl;
-        return Fecha();
-    }
-    try {
-        int dia = stoi(strFecha.substr(0, 2));
-        int mes = stoi(strFecha.substr(3, 2));
-        int anio = stoi(strFecha.substr(6, 4));
-        incrementarContadorIteraciones(3);
-
-        Fecha fechaObtenida(dia, mes, anio);
-        return fechaObtenida;
-    } catch (const std::exception& e) {
-        cerr << "Error [GestorUdeaStay]: Excepción al convertir string a fecha '" << strFecha << "'. Error: " << e.what() << endl;
-        incrementarContadorIteraciones();
-        return Fecha();
+    Fecha fechaObtenida;
+    if (leerFecha(strFecha, fechaObtenida) != LECTURA_CORRECTA) {
+        cerr << "Error [GestorUdeaStay]: Fecha inválida '" << strFecha << "'. Se esperaba dd/mm/aaaa." << endl;
     }
+    return fechaObtenida;
 }
 
 /**
@@ -425,560 +510,1777 @@ Fecha GestorUdeaStay::parsearStringAFechaInterno(const string& strFecha) {
  * y eliminando espacios en blanco al inicio/final de cada campo.
  */
 int GestorUdeaStay::parsearLineaCSVInterno(const string& linea, string campos[], int numCamposEsperados) {
+    incrementarContadorIteraciones(1 + static_cast<long long>(linea.length()));
+    return dividirLineaCSV(linea, campos, numCamposEsperados);
+}
+Huesped* GestorUdeaStay::encontrarHuespedPorID(const std::string& idLogin) {
     incrementarContadorIteraciones();
+    return obtenerHuesped(indiceHuespedesPorId.buscar(idLogin));
+}
+Anfitrion* GestorUdeaStay::encontrarAnfitrionPorID(const std::string& idLogin)  {
+    incrementarContadorIteraciones();
+    return obtenerAnfitrion(indiceAnfitrionesPorId.buscar(idLogin));
+}
 
-    if (linea.empty()) {
-        return 0;
-    }
-
-    int indiceCampo = 0;
-    string campoActual = "";
-    bool dentroDeComillas = false;
+Alojamiento* GestorUdeaStay::encontrarAlojamientoPorCodigo(const std::string& codigo) const {
+    int indice = obtenerIndiceAlojamiento(codigo);
+    return indice >= 0 ? &todosAlojamientos[indice] : nullptr; // nullptr si no se encuentra
+}
 
-    for (size_t i = 0; i < linea.length(); ++i) { // Usar size_t para 'i'
-        incrementarContadorIteraciones();
-        char caracter = linea[i];
+int GestorUdeaStay::obtenerIndiceAlojamiento(const std::string& codigo) const {
+    const int* indice = indiceAlojamientosPorCodigo.buscar(codigo);
+    // Uno retirado en una recarga conserva su entrada (por si vuelve) pero ya no se encuentra
+    return indice != nullptr && !todosAlojamientos[*indice].estaRetirado() ? *indice : -1;
+}
 
-        if (caracter == '"') {
-            if (dentroDeComillas && i + 1 < linea.length() && linea[i+1] == '"') {
-                campoActual += '"';
-                i++;
-            } else {
-                dentroDeComillas = !dentroDeComillas;
-            }
-        } else if (caracter == ',' && !dentroDeComillas) {
-            if (indiceCampo < numCamposEsperados) {
-                string campoProcesado = campoActual; // Copia para hacer trim
-                campos[indiceCampo++] = trim(campoProcesado);
-            } else {
-                // Se encontraron más comas de las esperadas para los campos, podría ser un error
-                // o simplemente ignorar el resto de la línea.
-                // Por ahora, si ya llenamos numCamposEsperados, paramos.
-                break;
-            }
-            campoActual = "";
-        } else {
-            campoActual += caracter;
-        }
+// Ajuste como "+25%", "-10%" o "12.5%" (hasta dos decimales) en puntos básicos.
+static bool leerAjustePorcentual(const string& texto, long& puntosBasicos) {
+    size_t i = 0;
+    bool negativo = false;
+    if (i < texto.size() && (texto[i] == '+' || texto[i] == '-')) {
+        negativo = texto[i] == '-';
+        i++;
     }
-
-    // Añadir el último campo
-    if (indiceCampo < numCamposEsperados) {
-        string campoProcesado = campoActual; // Copia para hacer trim
-        campos[indiceCampo++] = trim(campoProcesado);
+    long entero = 0, decimales = 0;
+    int cifras = 0, cifrasDecimales = 0;
+    for (; i < texto.size() && texto[i] >= '0' && texto[i] <= '9' && cifras < 6; ++i, ++cifras) {
+        entero = entero * 10 + (texto[i] - '0');
     }
-
-    return indiceCampo;
-}
-Huesped* GestorUdeaStay::encontrarHuespedPorID(const std::string& idLogin) {
-    cout << "DEBUG_BUSQUEDA_HUE: Iniciando encontrarHuespedPorID..." << endl;
-    cout << "  ID Buscado: [" << idLogin << "] (Longitud: " << idLogin.length() << ")" << endl;
-    for (int i = 0; i < cantidadHuespedes; ++i) {
-        // incrementarContadorIteraciones(); // Comentado porque es método const
-        std::string idEnMemoria = todosHuespedes[i].getId(); // Usa el getter
-        cout << "    Comparando con Huésped en memoria (Índice " << i << ") ID: [" << idEnMemoria << "] (Longitud: " << idEnMemoria.length() << ")" << endl;
-        if (idEnMemoria == idLogin) {
-            cout << "    ¡ID de Huésped Coincide en Índice " << i << "!" << endl;
-            return &todosHuespedes[i];
+    if (i < texto.size() && texto[i] == '.') {
+        for (++i; i < texto.size() && texto[i] >= '0' && texto[i] <= '9' && cifrasDecimales < 2; ++i, ++cifrasDecimales) {
+            decimales = decimales * 10 + (texto[i] - '0');
         }
+        if (cifrasDecimales == 1) decimales *= 10;
     }
-    cout << "  ID de Huésped [" << idLogin << "] NO encontrado en la colección." << endl;
-    return nullptr;
-}
-Anfitrion* GestorUdeaStay::encontrarAnfitrionPorID(const std::string& idLogin)  {
-    cout << "DEBUG_BUSQUEDA_ANF: Iniciando encontrarAnfitrionPorID..." << endl;
-    cout << "  ID Buscado: [" << idLogin << "] (Longitud: " << idLogin.length() << ")" << endl;
-    for (int i = 0; i < cantidadAnfitriones; ++i) {
-        incrementarContadorIteraciones(); // Si necesitas contar iteraciones
-        std::string idEnMemoria = todosAnfitriones[i].getId();
-        cout << "    Comparando con Anfitrion en memoria (Índice " << i << ") ID: [" << idEnMemoria << "] (Longitud: " << idEnMemoria.length() << ")" << endl;
-        if (idEnMemoria == idLogin) {
-            cout << "    ¡ID de Anfitrion Coincide en Índice " << i << "!" << endl;
-            return &todosAnfitriones[i];
-        }
+    if (cifras == 0 || i + 1 != texto.size() || texto[i] != '%') {
+        return false;
     }
-    cout << "  ID de Anfitrion [" << idLogin << "] NO encontrado en la colección." << endl;
-    return nullptr;
+    puntosBasicos = (entero * 100 + decimales) * (negativo ? -1 : 1);
+    return true;
 }
 
-Alojamiento* GestorUdeaStay::encontrarAlojamientoPorCodigo(const std::string& codigo) const {
-    for (int i = 0; i < cantidadAlojamientos; ++i) {
-        if (todosAlojamientos[i].getCodigoID() == codigo) {
-            return &todosAlojamientos[i];
-        }
+// --- Esquemas de los archivos CSV (ver cargadorcsv.h) ---
+
+// Porcentaje de Tarifas.csv en puntos básicos.
+struct CampoAjustePorcentual {
+    using Tipo = long;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) {
+        return leerAjustePorcentual(texto, valor) ? LECTURA_CORRECTA : LECTURA_VALOR_INVALIDO;
     }
-    return nullptr; // Si no se encuentra
+};
+
+struct EsquemaAlojamiento : EsquemaCSV<CampoTexto, CampoTexto, CampoTexto, CampoTexto, CampoTexto, CampoTexto,
+                                       CampoTexto, CampoDecimal, CampoTexto> {
+    enum { CODIGO, NOMBRE, DIRECCION, DEPARTAMENTO, MUNICIPIO, TIPO, AMENIDADES, PRECIO, ANFITRION };
+    static constexpr const char* NOMBRES_CAMPOS[NUM_CAMPOS] = {
+        "CodigoID", "Nombre", "Direccion", "Departamento", "Municipio", "Tipo", "Amenidades", "Precio", "AnfitrionID"};
+};
+
+struct EsquemaTarifa : EsquemaCSV<CampoTexto, CampoFecha, CampoFecha, CampoTexto, CampoAjustePorcentual> {
+    enum { ALOJAMIENTO, DESDE, HASTA, DIAS, AJUSTE };
+    static constexpr const char* NOMBRES_CAMPOS[NUM_CAMPOS] = {"Alojamiento", "Desde", "Hasta", "Dias", "Ajuste"};
+};
+
+// Anfitriones y huéspedes tienen las mismas columnas
+using EsquemaPersona = EsquemaCSV<CampoTexto, CampoTexto, CampoTexto, CampoTexto, CampoEntero, CampoFlotante>;
+enum { PERSONA_ID, PERSONA_NOMBRE, PERSONA_DOCUMENTO, PERSONA_CLAVE, PERSONA_ANTIGUEDAD, PERSONA_PUNTUACION };
+
+struct EsquemaAnfitrion : EsquemaPersona {
+    static constexpr const char* NOMBRES_CAMPOS[NUM_CAMPOS] = {
+        "AnfitrionID", "NombreCompleto", "Documento", "ContrasenaLogin", "AntiguedadMeses", "Puntuacion"};
+};
+
+struct EsquemaHuesped : EsquemaPersona {
+    static constexpr const char* NOMBRES_CAMPOS[NUM_CAMPOS] = {
+        "HuespedID", "NombreCompleto", "Documento", "CredencialLogin", "AntiguedadMeses", "Puntuacion"};
+};
+
+struct EsquemaReservacion : EsquemaCSV<CampoTexto, CampoTexto, CampoTexto, CampoFecha, CampoEnteroPositivo,
+                                       CampoTexto, CampoFecha, CampoEntero, CampoTexto, CampoBandera> {
+    enum { CODIGO, ALOJAMIENTO, HUESPED, FECHA_ENTRADA, NOCHES, METODO_PAGO, FECHA_PAGO, MONTO, ANOTACIONES, ACTIVA };
+    static constexpr const char* NOMBRES_CAMPOS[NUM_CAMPOS] = {
+        "CodigoReservacion", "CodigoAlojamiento", "DocumentoHuesped", "FechaEntrada", "DuracionNoches",
+        "MetodoPago", "FechaPago", "MontoPagado", "Anotaciones", "Activa"};
+};
+
+// El constructor siempre la crea activa: se conserva el estado del archivo.
+static Reservacion aReservacion(const EsquemaReservacion::Valores& v) {
+    using E = EsquemaReservacion;
+    Reservacion reservacion(get<E::CODIGO>(v), get<E::ALOJAMIENTO>(v), get<E::HUESPED>(v), get<E::METODO_PAGO>(v),
+                            get<E::FECHA_ENTRADA>(v), get<E::NOCHES>(v), get<E::FECHA_PAGO>(v), get<E::MONTO>(v),
+                            get<E::ANOTACIONES>(v));
+    reservacion.setActiva(get<E::ACTIVA>(v));
+    return reservacion;
 }
 
 // --- Métodos de Carga de Datos ---
 void GestorUdeaStay::cargarAlojamientosDesdeArchivo() {
     incrementarContadorIteraciones();
-    ifstream archivo(archivoAlojamientos);
-    string linea;
-
-    if (!archivo.is_open()) {
-        cerr << "Error: No se pudo abrir el archivo de alojamientos: " << archivoAlojamientos << endl;
+    using E = EsquemaAlojamiento;
+    InformeCarga informe(archivoAlojamientos);
+    bool leido = cargarArchivoCSV<E>(archivoAlojamientos, informe, [this](const E::Valores& v, long) {
+        asegurarCapacidadAlojamientos();
+        todosAlojamientos[cantidadAlojamientos++] = Alojamiento(
+            get<E::CODIGO>(v), get<E::NOMBRE>(v), get<E::DIRECCION>(v), get<E::DEPARTAMENTO>(v),
+            get<E::MUNICIPIO>(v), get<E::TIPO>(v), get<E::AMENIDADES>(v), get<E::PRECIO>(v), get<E::ANFITRION>(v));
+        if (!indiceAlojamientosPorCodigo.contiene(get<E::CODIGO>(v))) { // Ante códigos repetidos vale el primero
+            indiceAlojamientosPorCodigo.insertar(get<E::CODIGO>(v), cantidadAlojamientos - 1);
+        }
+        return true;
+    });
+    incrementarContadorIteraciones(informe.getLineasLeidas());
+    if (!leido) {
+        cerr << "Error: No se pudo abrir el archivo de alojamientos (o está vacío): " << archivoAlojamientos << endl;
         return;
     }
+    informe.mostrar(E::NOMBRES_CAMPOS);
+    agendaAlojamientos.inicializar(cantidadAlojamientos);
+    calendarioOcupacion.inicializar(cantidadAlojamientos);
+    cout << "Alojamientos cargados: " << cantidadAlojamientos << endl;
+}
 
-    if (getline(archivo, linea)) { // Omitir cabecera
-        incrementarContadorIteraciones();
-    } else {
-        cerr << "Error: Archivo de alojamientos vacío o cabecera ilegible." << endl;
-        archivo.close();
-        return;
+
+/**
+ * @brief Vuelve a leer Alojamientos.csv y aplica solo las diferencias, sin reiniciar.
+ * El archivo se lee sin candado y las diferencias se aplican con mutexDatos exclusivo:
+ * una búsqueda en curso termina con el conjunto anterior y la siguiente ve el nuevo.
+ * Se compara por código (ante códigos repetidos vale el primero): los nuevos se agregan
+ * al final, los que cambiaron se reemplazan en su posición y los que ya no están se
+ * retiran, salvo si tienen reservaciones activas (se conservan con una advertencia).
+ * Un retirado guarda su posición, porque agenda, calendario y tarifas se indexan por
+ * posición, y vuelve a ella si su código reaparece.
+ * @return false si el archivo no se pudo leer o no tiene registros (no se cambia nada).
+ */
+bool GestorUdeaStay::recargarAlojamientos() {
+    incrementarContadorIteraciones();
+    using E = EsquemaAlojamiento;
+    InformeCarga informe(archivoAlojamientos);
+    Alojamiento* leidos = nullptr;
+    int cantidadLeidos = 0, cupoLeidos = 0;
+    bool leido = cargarArchivoCSV<E>(archivoAlojamientos, informe, [&](const E::Valores& v, long) {
+        if (cantidadLeidos == cupoLeidos) {
+            cupoLeidos = cupoLeidos == 0 ? 64 : cupoLeidos * 2;
+            Alojamiento* nuevoArreglo = new Alojamiento[cupoLeidos];
+            for (int i = 0; i < cantidadLeidos; ++i) {
+                nuevoArreglo[i] = leidos[i];
+            }
+            delete[] leidos;
+            leidos = nuevoArreglo;
+        }
+        leidos[cantidadLeidos++] = Alojamiento(
+            get<E::CODIGO>(v), get<E::NOMBRE>(v), get<E::DIRECCION>(v), get<E::DEPARTAMENTO>(v),
+            get<E::MUNICIPIO>(v), get<E::TIPO>(v), get<E::AMENIDADES>(v), get<E::PRECIO>(v), get<E::ANFITRION>(v));
+        return true;
+    });
+    incrementarContadorIteraciones(informe.getLineasLeidas());
+    if (!leido || cantidadLeidos == 0) {
+        // Un archivo a medio escribir o vaciado por error no debe retirar todo
+        cerr << "Error: No se pudo recargar " << archivoAlojamientos << " (o está vacío); se conservan los actuales." << endl;
+        delete[] leidos;
+        return false;
+    }
+    informe.mostrar(E::NOMBRES_CAMPOS);
+
+    unique_lock<shared_mutex> bloqueo(mutexDatos);
+    const int cantidadAnterior = cantidadAlojamientos;
+    // Anfitrión de cada posición antes del cambio ("" si estaba retirado), para ajustar
+    // después las listas de códigos de los anfitriones en memoria
+    string* anfitrionAnterior = new string[cantidadAnterior > 0 ? cantidadAnterior : 1];
+    bool* enArchivo = new bool[cantidadAnterior > 0 ? cantidadAnterior : 1]();
+    for (int i = 0; i < cantidadAnterior; ++i) {
+        if (!todosAlojamientos[i].estaRetirado()) {
+            anfitrionAnterior[i] = trim(todosAlojamientos[i].getAnfitrionResponsableID());
+        }
     }
 
-    const int NUM_CAMPOS = 9; // CodigoID,Nombre,Direccion,Depto,Mun,Tipo,Amen,Precio,AnfID
-    string campos[NUM_CAMPOS];
+    int agregados = 0, modificados = 0, retirados = 0, conservados = 0;
+    for (int j = 0; j < cantidadLeidos; ++j) {
+        incrementarContadorIteraciones();
+        const string codigo = leidos[j].getCodigoID();
+        const int* posicion = indiceAlojamientosPorCodigo.buscar(codigo);
+        if (posicion == nullptr) {
+            asegurarCapacidadAlojamientos();
+            todosAlojamientos[cantidadAlojamientos] = leidos[j];
+            indiceAlojamientosPorCodigo.insertar(codigo, cantidadAlojamientos);
+            cantidadAlojamientos++;
+            agregados++;
+            continue;
+        }
+        const int i = *posicion;
+        if (i >= cantidadAnterior || enArchivo[i]) {
+            continue; // Código repetido en el archivo: vale el primero
+        }
+        enArchivo[i] = true;
+        if (todosAlojamientos[i].estaRetirado()) {
+            todosAlojamientos[i] = leidos[j]; // Vuelve (el constructor lo deja sin retirar)
+            agregados++;
+        } else if (todosAlojamientos[i].toFileString() != leidos[j].toFileString()) {
+            todosAlojamientos[i] = leidos[j];
+            modificados++;
+        }
+    }
+    delete[] leidos;
 
-    while (getline(archivo, linea)) {
+    for (int i = 0; i < cantidadAnterior; ++i) {
+        if (enArchivo[i] || todosAlojamientos[i].estaRetirado()) {
+            continue;
+        }
         incrementarContadorIteraciones();
-        if (linea.empty()) continue;
+        // Las copias con código repetido de la carga inicial no tienen entrada propia
+        // en el índice ni reservaciones: se retiran sin más
+        const int* posicion = indiceAlojamientosPorCodigo.buscar(todosAlojamientos[i].getCodigoID());
+        if (posicion != nullptr && *posicion == i &&
+            agendaAlojamientos.hayCruce(i, 0, numeric_limits<long>::max())) {
+            cerr << "Advertencia [GestorUdeaStay]: El alojamiento " << todosAlojamientos[i].getCodigoID()
+                 << " ya no está en " << archivoAlojamientos << " pero tiene reservaciones activas; se conserva." << endl;
+            conservados++;
+            continue;
+        }
+        todosAlojamientos[i].setRetirado(true);
+        retirados++;
+    }
+    delete[] enArchivo;
+
+    // Estructuras por posición: las posiciones nuevas empiezan vacías
+    agendaAlojamientos.ampliar(cantidadAlojamientos);
+    calendarioOcupacion.ampliar(cantidadAlojamientos);
+    cargarTarifasDesdeArchivo(); // Sus reglas nombran alojamientos por código
+    construirAdyacenciaAnfitriones(false);
+    // Anfitriones ya en memoria: pierden los códigos que dejaron de ser suyos y ganan los
+    // nuevos (los que se lean después bajo demanda los toman del CSR nuevo)
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        const string actual = todosAlojamientos[i].estaRetirado() ? string()
+                                                                   : trim(todosAlojamientos[i].getAnfitrionResponsableID());
+        const string anterior = i < cantidadAnterior ? anfitrionAnterior[i] : string();
+        if (actual == anterior) {
+            continue;
+        }
+        const string codigo = todosAlojamientos[i].getCodigoID();
+        Anfitrion* antes = anterior.empty() ? nullptr : anfitriones.obtenerSiEnMemoria(indiceAnfitrionesPorId.buscar(anterior));
+        Anfitrion* ahora = actual.empty() ? nullptr : anfitriones.obtenerSiEnMemoria(indiceAnfitrionesPorId.buscar(actual));
+        if (antes != nullptr) antes->eliminarCodigoAlojamiento(codigo);
+        if (ahora != nullptr) ahora->agregarCodigoAlojamiento(codigo);
+    }
+    delete[] anfitrionAnterior;
 
-        int camposLeidos = parsearLineaCSVInterno(linea, campos, NUM_CAMPOS);
+    cantidadAlojamientosRetirados = 0;
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        if (todosAlojamientos[i].estaRetirado()) cantidadAlojamientosRetirados++;
+    }
+    cacheBusquedas.vaciar(); // Los resultados guardados pueden nombrar retirados o precios viejos
+    recargasAlojamientos++;
+    cout << "Alojamientos recargados: +" << agregados << " -" << retirados << " ~" << modificados
+         << (conservados > 0 ? " (" + to_string(conservados) + " conservados por reservaciones activas)" : string())
+         << "; vigentes: " << cantidadAlojamientos - cantidadAlojamientosRetirados << endl;
+    return true;
+}
 
-        if (camposLeidos == NUM_CAMPOS) {
-            asegurarCapacidadAlojamientos();
-            double precio;
-            try {
-                precio = stod(campos[7]);
-                incrementarContadorIteraciones();
-            } catch (const exception& e) {
-                cerr << "Error al convertir precio en línea (Alojamiento): " << linea << ". Error: " << e.what() << endl;
-                incrementarContadorIteraciones();
-                continue;
-            }
-            todosAlojamientos[cantidadAlojamientos++] = Alojamiento(campos[0], campos[1], campos[2], campos[3], campos[4], campos[5], campos[6], precio, campos[8]);
-            incrementarContadorIteraciones();
-        } else {
-            cerr << "Advertencia: Línea con formato incorrecto en alojamientos: " << linea << endl;
-            incrementarContadorIteraciones();
-        }
+bool GestorUdeaStay::activarRecargaAlojamientos() {
+    const string rutas[] = {archivoAlojamientos};
+    if (!vigilanteAlojamientos.iniciar(rutas, 1, [this](const string&) { recargarAlojamientos(); })) {
+        return false;
     }
-    archivo.close();
-    cout << "Alojamientos cargados: " << cantidadAlojamientos << endl;
+    cout << "Recarga automática de " << archivoAlojamientos << " activada." << endl;
+    return true;
 }
 
-void GestorUdeaStay::cargarAnfitrionesDesdeArchivo() {
+/**
+ * @brief Carga Tarifas.csv: Alojamiento,Desde,Hasta,Dias,Ajuste
+ * "Alojamiento" es un código o "*" (todos); Desde y Hasta son la primera y la última
+ * noche (dd/mm/aaaa); Dias es "todos" o "finde" (noches de viernes y sábado) y Ajuste
+ * un porcentaje sobre el precio base ("+20%", "-10%"). Las reglas se componen en el
+ * orden del archivo. Si el archivo no existe, todas las noches valen el precio base.
+ */
+void GestorUdeaStay::cargarTarifasDesdeArchivo() {
     incrementarContadorIteraciones();
-    ifstream archivo(archivoAnfitriones);
-    string linea;
-
-    if (!archivo.is_open()) {
-        cerr << "Error: No se pudo abrir el archivo de anfitriones: " << archivoAnfitriones << endl;
+    using E = EsquemaTarifa;
+    tarifasTemporada.inicializar(cantidadAlojamientos);
+    InformeCarga informe(archivoTarifas);
+    bool leido = cargarArchivoCSV<E>(archivoTarifas, informe, [this, &informe](const E::Valores& v, long linea) {
+        int alojamiento = -1;
+        if (get<E::ALOJAMIENTO>(v) != "*" && (alojamiento = obtenerIndiceAlojamiento(get<E::ALOJAMIENTO>(v))) < 0) {
+            informe.registrar(linea, E::ALOJAMIENTO, LECTURA_VALOR_INVALIDO);
+            return false;
+        }
+        const string& dias = get<E::DIAS>(v);
+        if (dias != "todos" && dias != "finde") {
+            informe.registrar(linea, E::DIAS, LECTURA_VALOR_INVALIDO);
+            return false;
+        }
+        if (!tarifasTemporada.agregarRegla(alojamiento, get<E::DESDE>(v).aNumeroDia(), get<E::HASTA>(v).aNumeroDia(),
+                                           dias == "finde" ? TarifasTemporada::FIN_DE_SEMANA
+                                                           : TarifasTemporada::TODOS_LOS_DIAS,
+                                           get<E::AJUSTE>(v))) {
+            informe.registrar(linea, E::AJUSTE, LECTURA_VALOR_INVALIDO);
+            return false;
+        }
+        return true;
+    });
+    incrementarContadorIteraciones(informe.getLineasLeidas());
+    if (!leido) {
+        cout << "Sin tarifas de temporada: se usa el precio base por noche." << endl;
         return;
     }
+    informe.mostrar(E::NOMBRES_CAMPOS);
+    tarifasTemporada.construir();
+    cout << "Tarifas de temporada cargadas: " << tarifasTemporada.getCantidadReglas() << " reglas en "
+         << tarifasTemporada.getCantidadPerfiles() << " perfiles de precio." << endl;
+}
 
-    if (getline(archivo, linea)) { // Omitir cabecera
-        incrementarContadorIteraciones();
+long long GestorUdeaStay::calcularCostoEstadia(int alojamiento, long diaEntrada, long diaSalida) const {
+    return tarifasTemporada.costoEstadia(alojamiento, llround(todosAlojamientos[alojamiento].getPrecioPorNoche()),
+                                         diaEntrada, diaSalida);
+}
+
+void GestorUdeaStay::cargarAnfitrionesDesdeArchivo() {
+    incrementarContadorIteraciones();
+    using E = EsquemaAnfitrion;
+    InformeCarga informe(archivoAnfitriones);
+    bool leido;
+    if (usuariosBajoDemanda) {
+        // Solo ID (la clave del login y de los alojamientos); el resto se lee al usarlo
+        static const int COLUMNAS_CLAVE[] = {PERSONA_ID};
+        leido = anfitriones.abrirBajoDemanda(archivoAnfitriones, archivoIndiceAnfitriones, COLUMNAS_CLAVE, 1, informe,
+                                             [this](int posicion, const string claves[]) {
+                                                 indiceAnfitrionesPorId.insertar(claves[0], posicion);
+                                             });
     } else {
-        cerr << "Error: Archivo de anfitriones vacío o cabecera ilegible." << endl;
-        archivo.close();
+        leido = cargarArchivoCSV<E>(archivoAnfitriones, informe, [this](const E::Valores& v, long) {
+            int posicion = anfitriones.agregar(new Anfitrion(get<PERSONA_ID>(v), get<PERSONA_NOMBRE>(v),
+                                                             get<PERSONA_DOCUMENTO>(v), get<PERSONA_CLAVE>(v),
+                                                             get<PERSONA_ANTIGUEDAD>(v), get<PERSONA_PUNTUACION>(v)));
+            indiceAnfitrionesPorId.insertar(get<PERSONA_ID>(v), posicion); // Ante IDs repetidos vale el primero
+            return true;
+        });
+    }
+    incrementarContadorIteraciones(informe.getLineasLeidas());
+    if (!leido) {
+        cerr << "Error: No se pudo abrir el archivo de anfitriones (o está vacío): " << archivoAnfitriones << endl;
         return;
     }
+    if (anfitriones.esBajoDemanda()) {
+        if (!anfitriones.indiceDesdeLateral()) informe.mostrar(E::NOMBRES_CAMPOS);
+        cout << "Anfitriones indexados: " << anfitriones.getCantidad() << " (se leen al usarlos"
+             << (anfitriones.indiceDesdeLateral() ? ", índice desde " + archivoIndiceAnfitriones : string()) << ")" << endl;
+        return;
+    }
+    informe.mostrar(E::NOMBRES_CAMPOS);
+    cout << "Anfitriones cargados: " << anfitriones.getCantidad() << endl;
+}
 
-    const int NUM_CAMPOS = 6; // AnfitrionID,NombreCompleto,Documento,ContrasenaLogin,AntiguedadMeses,Puntuacion
-    string campos[NUM_CAMPOS];
-
-    while (getline(archivo, linea)) {
+/**
+ * @brief Construye la adyacencia anfitrión -> alojamientos en formato CSR.
+ * Cuenta los alojamientos de cada anfitrión, acumula los conteos en el arreglo de
+ * inicios y coloca cada alojamiento en su tramo (ordenamiento por conteo, O(A + H)).
+ * En la carga inicial también registra los códigos en cada Anfitrion en memoria con
+ * agregarCodigoAlojamiento (los que se leen después bajo demanda los toman del CSR, ver
+ * obtenerAnfitrion); en una recarga esas listas las ajusta recargarAlojamientos.
+ * Los alojamientos retirados no entran en ningún tramo.
+ */
+void GestorUdeaStay::construirAdyacenciaAnfitriones(bool cargaInicial) {
+    incrementarContadorIteraciones();
+    delete[] inicioAlojamientosDeAnfitrion;
+    delete[] alojamientosDeAnfitrion;
+    const int cantidadAnfitriones = anfitriones.getCantidad();
+    inicioAlojamientosDeAnfitrion = new int[cantidadAnfitriones + 1]();
+    alojamientosDeAnfitrion = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+
+    // Anfitrión de cada alojamiento (-1 si su anfitrión no está cargado).
+    int* anfitrionDe = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
         incrementarContadorIteraciones();
-        if (linea.empty()) continue;
-
-        int camposLeidos = parsearLineaCSVInterno(linea, campos, NUM_CAMPOS);
-
-        if (camposLeidos == NUM_CAMPOS) {
-            asegurarCapacidadAnfitriones();
-            int antiguedad;
-            float puntuacion;
-            try {
-                antiguedad = stoi(campos[4]);
-                puntuacion = stof(campos[5]);
-                incrementarContadorIteraciones(2);
-            } catch (const exception& e) {
-                cerr << "Error al convertir datos numéricos en línea (Anfitrión): " << linea << ". Error: " << e.what() << endl;
-                incrementarContadorIteraciones();
-                continue;
-            }
-
-            // --- AGREGAR BLOQUE DE DEPURACIÓN ANTES DE INCREMENTAR cantidadAnfitriones ---
-            cout << "DEBUG_CARGA_ANF: Procesando línea CSV para Anfitrión." << endl;
-            cout << "  CSV Raw -> ID: [" << campos[0] << "], PassLeidaCSV: [" << campos[3] << "]" << endl;
-
-            // Crear el objeto primero
-            todosAnfitriones[cantidadAnfitriones] = Anfitrion(campos[0], campos[1], campos[2], campos[3], antiguedad, puntuacion);
-
-            // Luego depurar el objeto creado
-            Anfitrion& anfitrionActual = todosAnfitriones[cantidadAnfitriones];
-            cout << "  OBJETO Anfitrion Creado -> ID via Getter: [" << anfitrionActual.getId()
-                 << "], Pass via Getter: [" << anfitrionActual.getContrasena()
-                 << "], Nombre via Getter: [" << anfitrionActual.getNombre() << "]" << endl;
-            // --- FIN BLOQUE DEPURACIÓN ---
+        const int anfitrion = todosAlojamientos[i].estaRetirado()
+                                  ? -1
+                                  : indiceAnfitrionesPorId.buscar(trim(todosAlojamientos[i].getAnfitrionResponsableID()));
+        anfitrionDe[i] = anfitrion;
+        if (anfitrion >= 0) {
+            inicioAlojamientosDeAnfitrion[anfitrion + 1]++;
+        } else if (cargaInicial) {
+            cerr << "Advertencia [GestorUdeaStay]: El alojamiento " << todosAlojamientos[i].getCodigoID()
+                 << " tiene un anfitrión desconocido (" << todosAlojamientos[i].getAnfitrionResponsableID() << ")." << endl;
+        }
+    }
+    for (int h = 0; h < cantidadAnfitriones; ++h) {
+        inicioAlojamientosDeAnfitrion[h + 1] += inicioAlojamientosDeAnfitrion[h];
+    }
 
-            cantidadAnfitriones++; // Incrementar después de la depuración
-            incrementarContadorIteraciones();
-        } else {
-            cerr << "Advertencia: Línea con formato incorrecto en anfitriones: " << linea << endl;
-            incrementarContadorIteraciones();
+    // Se recorre en orden, así cada tramo conserva el orden del archivo.
+    int* siguiente = new int[cantidadAnfitriones > 0 ? cantidadAnfitriones : 1];
+    for (int h = 0; h < cantidadAnfitriones; ++h) {
+        siguiente[h] = inicioAlojamientosDeAnfitrion[h];
+    }
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        if (anfitrionDe[i] < 0) continue;
+        alojamientosDeAnfitrion[siguiente[anfitrionDe[i]]++] = i;
+        Anfitrion* anfitrion = cargaInicial ? anfitriones.obtenerSiEnMemoria(anfitrionDe[i]) : nullptr;
+        if (anfitrion != nullptr) {
+            anfitrion->agregarCodigoAlojamiento(todosAlojamientos[i].getCodigoID());
         }
+        incrementarContadorIteraciones();
     }
-    archivo.close();
-    cout << "Anfitriones cargados: " << cantidadAnfitriones << endl;
+    delete[] siguiente;
+    delete[] anfitrionDe;
 }
 
 void GestorUdeaStay::cargarHuespedesDesdeArchivo() {
     incrementarContadorIteraciones();
-    ifstream archivo(archivoHuespedes);
-    string linea;
-
-    if (!archivo.is_open()) {
-        cerr << "Error: No se pudo abrir el archivo de huéspedes: " << archivoHuespedes << endl;
+    using E = EsquemaHuesped;
+    InformeCarga informe(archivoHuespedes);
+    auto indexar = [this](int posicion, const string& id, const string& documento) {
+        // Ante claves repetidas vale la primera
+        indiceHuespedesPorId.insertar(id, posicion);
+        indiceHuespedesPorDocumento.insertar(documento, posicion);
+    };
+    bool leido;
+    if (usuariosBajoDemanda) {
+        // ID (login) y documento (reservaciones); el resto se lee al usarlo
+        static const int COLUMNAS_CLAVE[] = {PERSONA_ID, PERSONA_DOCUMENTO};
+        leido = huespedes.abrirBajoDemanda(archivoHuespedes, archivoIndiceHuespedes, COLUMNAS_CLAVE, 2, informe,
+                                           [&indexar](int posicion, const string claves[]) {
+                                               indexar(posicion, claves[0], claves[1]);
+                                           });
+    } else {
+        leido = cargarArchivoCSV<E>(archivoHuespedes, informe, [this, &indexar](const E::Valores& v, long) {
+            int posicion = huespedes.agregar(new Huesped(get<PERSONA_ID>(v), get<PERSONA_NOMBRE>(v),
+                                                         get<PERSONA_DOCUMENTO>(v), get<PERSONA_CLAVE>(v),
+                                                         get<PERSONA_ANTIGUEDAD>(v), get<PERSONA_PUNTUACION>(v)));
+            indexar(posicion, get<PERSONA_ID>(v), get<PERSONA_DOCUMENTO>(v));
+            return true;
+        });
+    }
+    incrementarContadorIteraciones(informe.getLineasLeidas());
+    if (!leido) {
+        cerr << "Error: No se pudo abrir el archivo de huéspedes (o está vacío): " << archivoHuespedes << endl;
         return;
     }
-
-    if (getline(archivo, linea)) { // Omitir cabecera
-        incrementarContadorIteraciones();
-    } else {
-        cerr << "Error: Archivo de huéspedes vacío o cabecera ilegible." << endl;
-        archivo.close();
+    if (huespedes.esBajoDemanda()) {
+        if (!huespedes.indiceDesdeLateral()) informe.mostrar(E::NOMBRES_CAMPOS);
+        cout << "Huéspedes indexados: " << huespedes.getCantidad() << " (se leen al usarlos"
+             << (huespedes.indiceDesdeLateral() ? ", índice desde " + archivoIndiceHuespedes : string()) << ")" << endl;
         return;
     }
+    informe.mostrar(E::NOMBRES_CAMPOS);
+    cout << "Huéspedes cargados: " << huespedes.getCantidad() << endl;
+}
 
-    const int NUM_CAMPOS = 6; // HuespedID,NombreCompleto,Documento,CredencialLogin,AntiguedadMeses,Puntuacion
-    string campos[NUM_CAMPOS];
-
-    while (getline(archivo, linea)) {
-        incrementarContadorIteraciones();
-        if (linea.empty()) continue;
-
-        int camposLeidos = parsearLineaCSVInterno(linea, campos, NUM_CAMPOS);
-
-        if (camposLeidos == NUM_CAMPOS) {
-            asegurarCapacidadHuespedes();
-            int antiguedad;
-            float puntuacion;
-            try {
-                antiguedad = stoi(campos[4]);
-                puntuacion = stof(campos[5]);
-                incrementarContadorIteraciones(2);
-            } catch (const exception& e) {
-                cerr << "Error al convertir datos numéricos en línea (Huésped): " << linea << ". Error: " << e.what() << endl;
-                incrementarContadorIteraciones();
-                continue;
-            }
-
-            // --- INICIO BLOQUE DEPURACIÓN CARGA HUÉSPED ---
-            cout << "DEBUG_CARGA_HUE: Procesando línea CSV para Huésped." << endl;
-            cout << "  CSV Raw -> ID: [" << campos[0] << "], PassLeidaCSV: [" << campos[3] << "]" << endl;
-            // --- FIN BLOQUE DEPURACIÓN CARGA HUÉSPED ---
+/**
+ * @brief Construye un usuario desde su línea del archivo (carga bajo demanda).
+ * @return El objeto nuevo, o nullptr si la línea no es válida (se avisa por cerr).
+ */
+template <typename T, typename Esquema>
+static T* construirUsuarioDesdeLinea(const string& linea, const string& archivo) {
+    string campos[Esquema::NUM_CAMPOS];
+    typename Esquema::Valores v;
+    int campoConError = -1;
+    EstadoLectura estado = dividirLineaCSV(linea, campos, Esquema::NUM_CAMPOS) != Esquema::NUM_CAMPOS
+                               ? LECTURA_CAMPOS_INCOMPLETOS
+                               : Esquema::convertir(campos, v, campoConError);
+    if (estado != LECTURA_CORRECTA) {
+        cerr << "Advertencia [GestorUdeaStay]: Registro inválido en " << archivo << " ("
+             << (campoConError >= 0 ? Esquema::NOMBRES_CAMPOS[campoConError] : "línea") << ": "
+             << describirEstadoLectura(estado) << ")." << endl;
+        return nullptr;
+    }
+    return new T(get<PERSONA_ID>(v), get<PERSONA_NOMBRE>(v), get<PERSONA_DOCUMENTO>(v), get<PERSONA_CLAVE>(v),
+                 get<PERSONA_ANTIGUEDAD>(v), get<PERSONA_PUNTUACION>(v));
+}
 
-            // Asumiendo que Huesped tiene un constructor que toma: id, nombre, doc, clave, antig, punt
-            todosHuespedes[cantidadHuespedes++] = Huesped(campos[0], campos[1], campos[2], campos[3], antiguedad, puntuacion);
+Anfitrion* GestorUdeaStay::obtenerAnfitrion(int posicion) const {
+    return anfitriones.obtener(posicion, [this, posicion](const string& linea) {
+        Anfitrion* anfitrion = construirUsuarioDesdeLinea<Anfitrion, EsquemaAnfitrion>(linea, archivoAnfitriones);
+        // Sus alojamientos salen del tramo CSR (construirAdyacenciaAnfitriones solo
+        // registra los códigos en los anfitriones que ya estaban en memoria)
+        for (int k = inicioAlojamientosDeAnfitrion[posicion];
+             anfitrion != nullptr && k < inicioAlojamientosDeAnfitrion[posicion + 1]; ++k) {
+            anfitrion->agregarCodigoAlojamiento(todosAlojamientos[alojamientosDeAnfitrion[k]].getCodigoID());
+        }
+        return anfitrion;
+    });
+}
 
-            // --- INICIO BLOQUE DEPURACIÓN VERIFICACIÓN OBJETO ---
-            // Verifica el objeto recién añadido (accediendo a cantidadHuespedes-1)
-            cout << "  OBJETO Huésped Creado -> ID via Getter: [" << todosHuespedes[cantidadHuespedes-1].getId()
-                 << "], Pass via Getter: [" << todosHuespedes[cantidadHuespedes-1].getContrasena() << "]" << endl;
-            // --- FIN BLOQUE DEPURACIÓN VERIFICACIÓN OBJETO ---
+Huesped* GestorUdeaStay::obtenerHuesped(int posicion) const {
+    return huespedes.obtener(posicion, [this](const string& linea) {
+        return construirUsuarioDesdeLinea<Huesped, EsquemaHuesped>(linea, archivoHuespedes);
+    });
+}
 
-            incrementarContadorIteraciones();
-        } else {
-            cerr << "Advertencia: Línea con formato incorrecto en huéspedes: " << linea << endl;
-            incrementarContadorIteraciones();
-        }
-    }
-    archivo.close();
-    cout << "Huéspedes cargados: " << cantidadHuespedes << endl;
+int GestorUdeaStay::obtenerPosicionAnfitrion(const Anfitrion* anfitrion) const {
+    return indiceAnfitrionesPorId.buscar(anfitrion->getId());
 }
 void GestorUdeaStay::cargarReservacionesActivasDesdeArchivo() {
     incrementarContadorIteraciones();
-    ifstream archivo(archivoReservaciones);
-    string linea;
-
-    if (!archivo.is_open()) {
-        cerr << "Error: No se pudo abrir el archivo de reservaciones: " << archivoReservaciones << endl;
+    using E = EsquemaReservacion;
+    InformeCarga informe(archivoReservaciones);
+    bool leido = cargarArchivoCSV<E>(archivoReservaciones, informe, [this](const E::Valores& v, long) {
+        // Todo código presente en el archivo (activo o no) queda reservado para el generador.
+        generadorCodigos.observarCodigo(get<E::CODIGO>(v));
+        if (!get<E::ACTIVA>(v)) {
+            return false; // Solo se cargan las activas
+        }
+        asegurarCapacidadReservaciones();
+        todasReservaciones[cantidadReservaciones++] = aReservacion(v);
+        return true;
+    });
+    incrementarContadorIteraciones(informe.getLineasLeidas());
+    if (!leido) {
+        cerr << "Error: No se pudo abrir el archivo de reservaciones (o está vacío): " << archivoReservaciones << endl;
         return;
     }
+    informe.mostrar(E::NOMBRES_CAMPOS);
+    // Se registran en los índices solo las que pasan la revisión de integridad
+    revisarIntegridadReservaciones();
+    cout << "Reservaciones activas cargadas: " << cantidadReservaciones << endl;
+}
 
-    if (!getline(archivo, linea) || linea.empty()) { // Omitir cabecera y verificar si el archivo está vacío después
-        cerr << "Error: Archivo de reservaciones vacío o cabecera ilegible." << endl;
-        archivo.close();
+/**
+ * @brief Revisa las reservaciones activas recién leídas antes de registrarlas.
+ * Rechaza las que apuntan a un alojamiento inexistente, las de código repetido
+ * (búsquedas en los índices por código) y las que se cruzan con otra del mismo
+ * alojamiento (detectarCrucesPorAlojamiento: orden por alojamiento y
+ * entrada y un solo recorrido, en paralelo por alojamientos). Un documento que no está
+ * en el índice de huéspedes solo se informa como advertencia. Las demás se compactan
+ * al inicio del arreglo y se registran en los índices. Las rechazadas se muestran en
+ * el informe y se guardan en archivoReservacionesRechazadas al finalizar, para que no
+ * se pierdan al reescribir el archivo de reservaciones.
+ */
+void GestorUdeaStay::revisarIntegridadReservaciones() {
+    const int cantidad = cantidadReservaciones;
+    InformeIntegridad informe(archivoReservaciones);
+    informe.setRevisadas(cantidad);
+    if (cantidad == 0) {
+        informe.mostrar();
         return;
     }
-    incrementarContadorIteraciones(); // Por leer la cabecera
-
-    // Formato CSV esperado:
-    // CodigoReservacion,CodigoAlojamiento,DocumentoHuesped,FechaEntrada,DuracionNoches,MetodoPago,FechaPago,MontoPagado,Anotaciones,Activa
-    const int NUM_CAMPOS = 10;
-    string campos[NUM_CAMPOS];
-
-    while (getline(archivo, linea)) {
-        incrementarContadorIteraciones(); // Por leer una línea de datos
-        if (linea.empty()) continue; // Saltar líneas vacías
-
-        int camposLeidos = parsearLineaCSVInterno(linea, campos, NUM_CAMPOS);
-
-        if (camposLeidos == NUM_CAMPOS) {
-            // Campos de string directos
-            string codigoRes = campos[0];
-            string codigoAloja = campos[1];
-            string docHuesped = campos[2];
-            string metodoPago = campos[5];
-            string anotaciones = campos[8]; // El constructor de Reservacion maneja el truncamiento
-
-            // Campos que necesitan conversión
-            Fecha fechaEntrada;
-            int duracionNoches;
-            Fecha fechaPago;
-            int montoPagado; // Basado en el constructor de Reservacion que usa 'int valortotal'
-            bool activa;
-
-            try {
-                fechaEntrada = parsearStringAFechaInterno(campos[3]); // Usa el helper
-                duracionNoches = stoi(campos[4]);
-                fechaPago = parsearStringAFechaInterno(campos[6]);   // Usa el helper
-                montoPagado = stoi(campos[7]); // Si es int, o stod si es double
-                activa = (campos[9] == "1" || campos[9] == "true"); // Asumiendo 1/true para activa
-                incrementarContadorIteraciones(3); // Por stoi, stoi/stod, y la comparación bool
-            } catch (const std::exception& e) {
-                cerr << "Error [GestorUdeaStay]: Error al convertir datos para reservación en línea: " << linea << ". Error: " << e.what() << endl;
-                incrementarContadorIteraciones(); // Por manejo de excepción
-                continue; // Saltar esta línea
-            }
-
-            // Solo cargar si la reservación está marcada como activa en el archivo
-            if (activa) {
-                asegurarCapacidadReservaciones(); // Llama al método de redimensionamiento
-                std::cout << "DEBUG_CARGA_RES: Cargando -> " << codigoRes << ", Alojamiento: " << codigoAloja << ", Huesped: " << docHuesped << "\n";
-
-                // Crear el objeto Reservacion usando el constructor parametrizado
-                // El constructor de Reservacion que me mostraste es:
-                // Reservacion(cod, codigoAloja, docHues, metPago, entrada, duracionNoche, pago, valortotal, anot)
-                // y 'activa' se establece a true internamente en ese constructor.
-                todasReservaciones[cantidadReservaciones++] = Reservacion(
-                    codigoRes, codigoAloja, docHuesped, metodoPago,
-                    fechaEntrada, duracionNoches, fechaPago, montoPagado,
-                    anotaciones
-                    );
-                incrementarContadorIteraciones(); // Por la creación y asignación del objeto
-            } else {
-                // Si la reservación en el archivo NO está activa, no la cargamos en la lista de activas.
-                // Podría considerarse para cargarla directamente en una lista de históricas si fuera necesario aquí.
-                incrementarContadorIteraciones(); // Por la decisión de no cargarla
-            }
-        } else {
-            cerr << "Advertencia [GestorUdeaStay]: Línea con formato incorrecto en " << archivoReservaciones << ": " << linea
-                 << " (Esperados " << NUM_CAMPOS << " campos, encontrados " << camposLeidos << ")" << endl;
-            incrementarContadorIteraciones(); // Por el manejo de la línea incorrecta
+    int* alojamiento = new int[cantidad];
+    long* diaEntrada = new long[cantidad];
+    long* diaSalida = new long[cantidad];
+    int* cruceCon = new int[cantidad];
+    ProblemaIntegridad* problema = new ProblemaIntegridad[cantidad];
+    indiceReservacionesPorCodigo.reservar(cantidad);
+    for (int i = 0; i < cantidad; ++i) {
+        const Reservacion& r = todasReservaciones[i];
+        problema[i] = INTEGRIDAD_CORRECTA;
+        alojamiento[i] = obtenerIndiceAlojamiento(r.getCodigoAlojamiento());
+        diaEntrada[i] = r.getDiaEntrada();
+        diaSalida[i] = r.getDiaSalida();
+        if (alojamiento[i] < 0) {
+            problema[i] = INTEGRIDAD_ALOJAMIENTO_DESCONOCIDO;
+        } else if (!indiceReservacionesPorCodigo.insertar(r.getCodigo(), i)) {
+            // La posición se corrige al registrarla; aquí el índice solo detecta repetidos
+            problema[i] = INTEGRIDAD_CODIGO_REPETIDO;
+        } else if (indiceHuespedesPorDocumento.buscar(r.getDocumentoHuesped()) < 0) {
+            // Solo advertencia: se conserva y sigue ocupando su alojamiento
+            informe.registrar(r.getCodigo(), INTEGRIDAD_HUESPED_DESCONOCIDO, r.getDocumentoHuesped(), false);
+        }
+        if (problema[i] != INTEGRIDAD_CORRECTA) {
+            alojamiento[i] = -1; // No participa en la detección de cruces
         }
     }
+    incrementarContadorIteraciones(cantidad);
+    informe.setHilos(detectarCrucesPorAlojamiento(alojamiento, diaEntrada, diaSalida, cantidad, cantidadAlojamientos,
+                                                  poolRecorridos, cruceCon));
 
-    archivo.close();
-    cout << "Reservaciones activas cargadas: " << cantidadReservaciones << endl;
+    // Informar y apartar las rechazadas (antes de mover nada: cruceCon apunta a posiciones)
+    for (int i = 0; i < cantidad; ++i) {
+        const Reservacion& r = todasReservaciones[i];
+        if (problema[i] == INTEGRIDAD_CORRECTA && cruceCon[i] >= 0) {
+            problema[i] = INTEGRIDAD_CRUCE_DE_FECHAS;
+        }
+        if (problema[i] == INTEGRIDAD_CORRECTA) continue;
+        string relacionado;
+        switch (problema[i]) {
+        case INTEGRIDAD_ALOJAMIENTO_DESCONOCIDO: relacionado = r.getCodigoAlojamiento(); break;
+        case INTEGRIDAD_CRUCE_DE_FECHAS: relacionado = todasReservaciones[cruceCon[i]].getCodigo(); break;
+        default: relacionado = r.getCodigo(); break;
+        }
+        informe.registrar(r.getCodigo(), problema[i], relacionado);
+        r.escribirCSV(reservacionesRechazadas);
+        reservacionesRechazadas.agregar(',');
+        reservacionesRechazadas.agregar(describirProblemaIntegridad(problema[i]));
+        reservacionesRechazadas.agregar(',');
+        reservacionesRechazadas.agregarEntreComillas(relacionado);
+        reservacionesRechazadas.agregar('\n');
+    }
+    // Compactar las correctas conservando su orden
+    int conservadas = 0;
+    for (int i = 0; i < cantidad; ++i) {
+        if (problema[i] != INTEGRIDAD_CORRECTA) continue;
+        if (conservadas != i) todasReservaciones[conservadas] = todasReservaciones[i];
+        conservadas++;
+    }
+    cantidadReservaciones = conservadas;
+    for (int i = 0; i < cantidadReservaciones; ++i) {
+        registrarReservacionEnIndices(i);
+    }
+    delete[] alojamiento;
+    delete[] diaEntrada;
+    delete[] diaSalida;
+    delete[] cruceCon;
+    delete[] problema;
+    informe.mostrar();
 }
-void GestorUdeaStay::guardarReservacionesActivasEnArchivo()  {
-    incrementarContadorIteraciones();
-    ofstream archivo(archivoReservaciones);
-
-    if (!archivo.is_open()) {
-        cerr << "Error [GestorUdeaStay]: No se pudo abrir el archivo '" << archivoReservaciones
-             << "' para guardar las reservaciones activas." << endl;
-        incrementarContadorIteraciones();
+/**
+ * @brief Añade al final de archivoReservacionesRechazadas las reservaciones que la
+ * revisión de integridad dejó fuera, con el problema y el dato con que chocan.
+ * El archivo se crea con cabecera la primera vez; solo se escribe si hubo rechazadas.
+ */
+void GestorUdeaStay::guardarReservacionesRechazadas() {
+    if (reservacionesRechazadas.getTamano() == 0) {
         return;
     }
-    archivo << "CodigoReservacion,CodigoAlojamiento,DocumentoHuesped,FechaEntrada,DuracionNoches,MetodoPago,FechaPago,MontoPagado,Anotaciones,Activa\n";
-    incrementarContadorIteraciones();
-
-    for (int i = 0; i < cantidadReservaciones; ++i) {
-        incrementarContadorIteraciones();
-        archivo << todasReservaciones[i].toFileString() << "\n";
-        incrementarContadorIteraciones();
+    struct stat estado;
+    const bool nuevo = ::stat(archivoReservacionesRechazadas.c_str(), &estado) != 0 || estado.st_size == 0;
+    ofstream archivo(archivoReservacionesRechazadas, ios::app);
+    if (nuevo) {
+        archivo << "CodigoReservacion,CodigoAlojamiento,DocumentoHuesped,FechaEntrada,DuracionNoches,"
+                   "MetodoPago,FechaPago,MontoPagado,Anotaciones,Activa,Problema,Relacionado\n";
     }
-
+    archivo.write(reservacionesRechazadas.getDatos(), static_cast<streamsize>(reservacionesRechazadas.getTamano()));
     archivo.close();
+    if (archivo.fail()) {
+        cerr << "Error [GestorUdeaStay]: No se pudieron guardar las reservaciones rechazadas en '"
+             << archivoReservacionesRechazadas << "'." << endl;
+        return;
+    }
+    reservacionesRechazadas.limpiar();
 }
 
-void GestorUdeaStay::agregarReservacionAHistoricoEnArchivo(const Reservacion& reservacion) {
-    incrementarContadorIteraciones();
-    ofstream archivo(archivoHistorico, ios::app);
+static const char* const ENCABEZADO_RESERVACIONES =
+    "CodigoReservacion,CodigoAlojamiento,DocumentoHuesped,FechaEntrada,DuracionNoches,"
+    "MetodoPago,FechaPago,MontoPagado,Anotaciones,Activa\n";
 
+// Reemplaza 'destino' con lo que 'escribir' deja en un temporal: un corte a mitad
+// nunca deja el archivo a medias. Con 'sincronizar' lo fuerza a disco antes del cambio.
+template <typename Escritura>
+static bool reemplazarArchivo(const string& destino, bool sincronizar, Escritura escribir) {
+    const string temporal = destino + ".tmp";
+    ofstream archivo(temporal);
     if (!archivo.is_open()) {
-        cerr << "Error [GestorUdeaStay]: No se pudo abrir o crear el archivo histórico '"
-             << archivoHistorico << "' para añadir la reservación." << endl;
-        incrementarContadorIteraciones();
-        return;
+        cerr << "Error [GestorUdeaStay]: No se pudo abrir el archivo '" << temporal
+             << "' para guardar las reservaciones activas." << endl;
+        return false;
     }
-    // Asumiendo que Reservacion tiene el método toFileString() implementado por tu compañero
-    archivo << reservacion.toFileString() << "\n";
-    incrementarContadorIteraciones();
-
+    escribir(archivo);
     archivo.close();
+    bool exito = !archivo.fail();
+    if (exito && sincronizar) {
+        int descriptor = ::open(temporal.c_str(), O_WRONLY);
+        exito = descriptor >= 0 && ::fsync(descriptor) == 0;
+        if (descriptor >= 0) ::close(descriptor);
+    }
+    if (!exito || ::rename(temporal.c_str(), destino.c_str()) != 0) {
+        cerr << "Error [GestorUdeaStay]: No se pudo reemplazar '" << destino << "'." << endl;
+        return false;
+    }
+    return true;
 }
-bool GestorUdeaStay::actualizarArchivoHistorico(Fecha fechaCorte) {
-    incrementarContadorIteraciones();
 
-    if (cantidadReservaciones == 0) {
-        cout << "No hay reservaciones activas para procesar." << endl;
+bool GestorUdeaStay::guardarReservacionesActivasEnArchivo(bool sincronizar) {
+    incrementarContadorIteraciones();
+    if (!persistirCambios) {
         return true;
     }
+    lock_guard<mutex> bloqueoArchivo(mutexArchivoReservaciones);
+    bool exito = reemplazarArchivo(archivoReservaciones, sincronizar, [this](ofstream& archivo) {
+        // Todas las líneas se escriben en un mismo búfer que se vacía al archivo cada ~1 MB
+        const size_t TAMANO_BLOQUE = 1 << 20;
+        BuferCSV bloque(TAMANO_BLOQUE + 4096);
+        bloque.agregar(string(ENCABEZADO_RESERVACIONES));
+        incrementarContadorIteraciones();
 
-    Reservacion* nuevasReservacionesActivas = nullptr;
-    int nuevaCantidadActivas = 0;
-    int nuevoCupoActivas = cupoReservaciones;
+        for (int i = 0; i < cantidadReservaciones; ++i) {
+            incrementarContadorIteraciones();
+            todasReservaciones[i].escribirCSV(bloque);
+            bloque.agregar('\n');
+            if (bloque.getTamano() >= TAMANO_BLOQUE) {
+                archivo.write(bloque.getDatos(), static_cast<streamsize>(bloque.getTamano()));
+                bloque.limpiar();
+            }
+            incrementarContadorIteraciones();
+        }
+        archivo.write(bloque.getDatos(), static_cast<streamsize>(bloque.getTamano()));
+    });
+    if (exito) {
+        versionGuardada = versionReservaciones;
+    }
+    return exito;
+}
+
+/**
+ * @brief Reescribe Reservaciones.csv después de una reserva o anulación sin diario.
+ * Las líneas se arman en memoria con mutexDatos compartido y mutexRegistro: mientras
+ * tanto no se registra ninguna reserva, pero nadie espera al disco. La escritura va
+ * después, sin esos candados y con mutexArchivoReservaciones; si otra ya dejó en el
+ * archivo un conjunto más nuevo, esta no escribe.
+ */
+bool GestorUdeaStay::reescribirReservacionesActivas() {
+    incrementarContadorIteraciones();
+    if (!persistirCambios) {
+        return true;
+    }
+    BuferCSV contenido;
+    unsigned long long version;
+    {
+        shared_lock<shared_mutex> lectura(mutexDatos);
+        lock_guard<mutex> registro(mutexRegistro);
+        contenido.agregar(string(ENCABEZADO_RESERVACIONES));
+        for (int i = 0; i < cantidadReservaciones; ++i) {
+            incrementarContadorIteraciones();
+            todasReservaciones[i].escribirCSV(contenido);
+            contenido.agregar('\n');
+        }
+        version = versionReservaciones;
+    }
+    lock_guard<mutex> bloqueoArchivo(mutexArchivoReservaciones);
+    if (version <= versionGuardada) {
+        return true; // Ya se escribió un conjunto que incluye este
+    }
+    bool exito = reemplazarArchivo(archivoReservaciones, false, [&contenido](ofstream& archivo) {
+        archivo.write(contenido.getDatos(), static_cast<streamsize>(contenido.getTamano()));
+    });
+    if (exito) {
+        versionGuardada = version;
+    }
+    return exito;
+}
 
-    if (nuevoCupoActivas > 0) {
-        nuevasReservacionesActivas = new Reservacion[nuevoCupoActivas];
+/**
+ * @brief Rehace las operaciones que quedaron en el diario de reservaciones.
+ * "+<línea CSV>" agrega la reservación si no está cargada y "-<código>" la anula.
+ * Un registro cortado por una caída no se puede parsear y se omite (nunca fue
+ * confirmado). Después guarda un punto de control y borra el diario.
+ */
+void GestorUdeaStay::aplicarDiarioDeReservaciones() {
+    ifstream archivo(archivoDiarioReservaciones);
+    if (!archivo.is_open()) {
+        return;
+    }
+    int aplicadas = 0;
+    string linea;
+    while (getline(archivo, linea)) {
         incrementarContadorIteraciones();
-    } else {
-        cout << "No hay reservaciones activas (cupo 0)." << endl;
+        if (linea.size() < 2) continue;
+        if (linea[0] == '+') {
+            Reservacion reservacion;
+            if (!parsearReservacionDesdeLinea(linea.substr(1), reservacion)) continue;
+            generadorCodigos.observarCodigo(reservacion.getCodigo());
+            if (indiceReservacionesPorCodigo.buscar(reservacion.getCodigo()) != nullptr) continue;
+            asegurarCapacidadReservaciones();
+            todasReservaciones[cantidadReservaciones++] = reservacion;
+            registrarReservacionEnIndices(cantidadReservaciones - 1);
+            aplicadas++;
+        } else if (linea[0] == '-') {
+            int indice = obtenerIndiceReservacionActiva(linea.substr(1));
+            if (indice < 0) continue;
+            todasReservaciones[indice].anular();
+            retirarReservacionDeIndices(todasReservaciones[indice]);
+            aplicadas++;
+        }
+    }
+    archivo.close();
+
+    if (aplicadas > 0) {
+        cout << "Diario de reservaciones: " << aplicadas << " operaciones recuperadas." << endl;
+        if (!guardarReservacionesActivasEnArchivo(true)) {
+            return; // Se conserva el diario para reintentar en la próxima carga
+        }
+    }
+    ::unlink(archivoDiarioReservaciones.c_str());
+}
+
+bool GestorUdeaStay::activarDiarioDeReservaciones(int ventanaMicrosegundos, int maximoLote) {
+    lock_guard<shared_mutex> bloqueo(mutexDatos);
+    if (!diarioReservaciones.abrir(archivoDiarioReservaciones, ventanaMicrosegundos, maximoLote)) {
+        return false;
+    }
+    cout << "Diario de reservaciones activo (ventana de " << ventanaMicrosegundos
+         << " us, lotes de hasta " << maximoLote << " registros)." << endl;
+    return true;
+}
+
+/**
+ * @brief Añade un bloque ya serializado al final del histórico con una sola escritura.
+ * Abre el archivo una vez, escribe todo el bloque (repitiendo write() solo si el
+ * sistema acepta menos bytes) y, si está habilitado, fuerza el bloque a disco con fsync.
+ * @param bloque Líneas CSV terminadas en '\n'.
+ * @return true si el bloque quedó escrito completo.
+ */
+bool GestorUdeaStay::anexarBloqueAHistorico(const BuferCSV& bloque) {
+    incrementarContadorIteraciones();
+    if (bloque.getTamano() == 0) {
         return true;
     }
 
-    int movidasAlHistorico = 0;
+    int descriptor = ::open(archivoHistorico.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (descriptor < 0) {
+        cerr << "Error [GestorUdeaStay]: No se pudo abrir o crear el archivo histórico '"
+             << archivoHistorico << "' para añadir reservaciones." << endl;
+        incrementarContadorIteraciones();
+        return false;
+    }
 
-    for (int i = 0; i < cantidadReservaciones; ++i) {
+    const char* datos = bloque.getDatos();
+    size_t pendientes = bloque.getTamano();
+    bool exito = true;
+    while (pendientes > 0) {
+        ssize_t escritos = ::write(descriptor, datos, pendientes);
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            exito = false;
+            break;
+        }
+        datos += escritos;
+        pendientes -= static_cast<size_t>(escritos);
         incrementarContadorIteraciones();
+    }
+
+    if (exito && sincronizarHistoricoEnDisco && ::fsync(descriptor) != 0) {
+        exito = false;
+    }
+    ::close(descriptor);
+
+    if (!exito) {
+        cerr << "Error [GestorUdeaStay]: Falló la escritura en el archivo histórico '"
+             << archivoHistorico << "'." << endl;
+    }
+    indiceHistorico.sincronizar(); // Indexa las líneas recién anexadas
+    return exito;
+}
 
-        Fecha fechaSalida = todasReservaciones[i].getFechaSalida();
+void GestorUdeaStay::agregarReservacionAHistoricoEnArchivo(const Reservacion& reservacion) {
+    incrementarContadorIteraciones();
+    const Reservacion* registro = &reservacion;
+    anexarAlHistorico(&registro, 1);
+}
+
+/**
+ * @brief Anexa reservaciones al histórico que esté en uso.
+ * Con el histórico particionado se escribe un segmento por cada mes tocado;
+ * si no, se serializan todas en un solo búfer CSV y se anexan con una escritura.
+ */
+bool GestorUdeaStay::anexarAlHistorico(const Reservacion* const* registros, int cantidad) {
+    incrementarContadorIteraciones();
+    if (!persistirCambios) {
+        return true;
+    }
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    return anexarAlHistoricoConCandado(registros, cantidad);
+}
+
+bool GestorUdeaStay::anexarAlHistoricoConCandado(const Reservacion* const* registros, int cantidad) {
+    if (historicoParticionado) {
+        incrementarContadorIteraciones(cantidad);
+        return almacenHistorico.anexar(registros, cantidad, sincronizarHistoricoEnDisco);
+    }
+    BuferCSV bloque(static_cast<size_t>(cantidad) * 96 + 64);
+    for (int i = 0; i < cantidad; ++i) {
         incrementarContadorIteraciones();
+        registros[i]->escribirCSV(bloque);
+        bloque.agregar('\n');
+    }
+    return anexarBloqueAHistorico(bloque);
+}
+
+/**
+ * @brief Anexa al histórico una anulación ya confirmada por el diario. El anexo y la
+ * salida de anulacionesSinHistorico van bajo el mismo candado: la analítica, que toma
+ * su marca del histórico con él, la cuenta en uno de los dos lados y solo en uno.
+ */
+void GestorUdeaStay::anexarAnulacionConfirmada(const Reservacion& anulada) {
+    incrementarContadorIteraciones();
+    const Reservacion* registro = &anulada;
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    anexarAlHistoricoConCandado(&registro, 1);
+    anulacionesSinHistorico.eliminar(anulada.getCodigo());
+}
+
+void GestorUdeaStay::setSincronizarHistoricoEnDisco(bool sincronizar) {
+    sincronizarHistoricoEnDisco = sincronizar;
+}
+
+/**
+ * @brief Registra una reservación recién añadida al arreglo en el índice por código
+ * y en la cola de vencimientos.
+ * @param indice Posición de la reservación en todasReservaciones.
+ */
+void GestorUdeaStay::registrarReservacionEnIndices(int indice, bool nochesReclamadas) {
+    const Reservacion& r = todasReservaciones[indice];
+    const int alojamiento = obtenerIndiceAlojamiento(r.getCodigoAlojamiento());
+    versionReservaciones++;
+    indiceReservacionesPorCodigo.insertar(r.getCodigo(), indice);
+    colaVencimientos.insertar(r.getDiaSalida(), r.getCodigo());
+    agendaAlojamientos.insertar(alojamiento, r.getDiaEntrada(), r.getDiaSalida(), r.getCodigo());
+    if (!nochesReclamadas && alojamiento >= 0 &&
+        !calendarioOcupacion.reclamar(alojamiento, r.getDiaEntrada(), r.getDiaSalida())) {
+        cerr << "Advertencia [GestorUdeaStay]: La reservación " << r.getCodigo()
+             << " se cruza con otra del mismo alojamiento o está fuera del calendario." << endl;
+    }
+    invalidarBusquedas(alojamiento, r.getDiaEntrada(), r.getDiaSalida());
+    Huesped* huesped = encontrarHuespedPorDocumento(r.getDocumentoHuesped());
+    if (huesped != nullptr) {
+        huesped->agregarReservacion(r.getCodigo(), r.getDiaEntrada(), r.getDiaSalida());
+    }
+    incrementarContadorIteraciones();
+}
+
+void GestorUdeaStay::retirarReservacionDeIndices(const Reservacion& reservacion) {
+    const int alojamiento = obtenerIndiceAlojamiento(reservacion.getCodigoAlojamiento());
+    const long entrada = reservacion.getDiaEntrada();
+    const long salida = reservacion.getDiaSalida();
+    versionReservaciones++;
+    if (agendaAlojamientos.eliminar(alojamiento, entrada, reservacion.getCodigo())) {
+        calendarioOcupacion.liberar(alojamiento, entrada, salida);
+        // Una estadía que se cruza (cargada con advertencia, o una anulación que se deshizo
+        // antes que esta reserva) sigue ocupando las noches en común
+        agendaAlojamientos.recorrerCruces(alojamiento, entrada, salida - 1, [&](const AgendaAlojamientos::Estadia& otra) {
+            asegurarNochesOcupadas(alojamiento, otra.diaEntrada > entrada ? otra.diaEntrada : entrada,
+                                   otra.diaSalida < salida ? otra.diaSalida : salida);
+        });
+        invalidarBusquedas(alojamiento, entrada, salida);
+    }
+    Huesped* huesped = encontrarHuespedPorDocumento(reservacion.getDocumentoHuesped());
+    if (huesped != nullptr) {
+        huesped->eliminarReservacion(reservacion.getCodigo(), reservacion.getDiaEntrada());
+    }
+    incrementarContadorIteraciones();
+}
+
+/**
+ * @brief Marca en el calendario todas las noches del rango, aunque ya estén tomadas.
+ * Solo se usa al deshacer y al retirar una estadía que comparte noches con otra. No le
+ * quita noches a una reserva confirmada. Una reserva que tomó las noches liberadas por
+ * una anulación se encoló en el diario después de esa anulación, porque las tomó cuando
+ * la anulación ya había soltado los candados. Si el diario no confirma la anulación, la
+ * falla queda fija y los lotes siguientes se descartan, así que esa reserva tampoco se
+ * confirma y se deshace después. Mientras tanto las dos comparten las noches, y al
+ * deshacerla retirarReservacionDeIndices deja marcadas las de la reactivada.
+ */
+void GestorUdeaStay::asegurarNochesOcupadas(int alojamiento, long diaEntrada, long diaSalida) {
+    if (alojamiento < 0) return;
+    if (calendarioOcupacion.reclamar(alojamiento, diaEntrada, diaSalida)) return;
+    // reclamar devuelve lo que tomó si choca: noche por noche se quedan todas marcadas
+    for (long dia = diaEntrada; dia < diaSalida; ++dia) {
+        calendarioOcupacion.reclamar(alojamiento, dia, dia + 1);
+    }
+}
+
+bool GestorUdeaStay::diarioEnFalla() const {
+    return persistirCambios && diarioReservaciones.estaAbierto() && diarioReservaciones.estaEnError();
+}
+
+/**
+ * @brief Revierte una reserva que no llegó al diario: si sigue activa se anula y se
+ * retira de los índices (liberando sus noches). Si ya la anuló otra operación que
+ * tampoco se confirmó, se recuerda para que deshacer esa anulación no la reactive.
+ */
+void GestorUdeaStay::deshacerCreacion(const string& codigo) {
+    lock_guard<mutex> escritura(mutexEscritores);
+    lock_guard<shared_mutex> bloqueo(mutexDatos);
+    creacionesDeshechas.insertar(codigo, true);
+    const int indice = obtenerIndiceReservacionActiva(codigo);
+    if (indice < 0) {
+        return;
+    }
+    Reservacion& reservacion = todasReservaciones[indice];
+    reservacion.anular();
+    retirarReservacionDeIndices(reservacion);
+    publicarCambio(EVENTO_ANULADA, reservacion);
+}
+
+/**
+ * @brief Revierte una anulación que no llegó al diario: la reservación vuelve a estar
+ * activa con sus noches. Si el archivado ya la sacó del arreglo (las anuladas salen sin
+ * escribirse), se vuelve a agregar y el próximo archivado la lleva al histórico.
+ */
+void GestorUdeaStay::deshacerAnulacion(const Reservacion& anulada) {
+    lock_guard<mutex> escritura(mutexEscritores);
+    lock_guard<shared_mutex> bloqueo(mutexDatos);
+    {
+        lock_guard<mutex> bloqueoHistorico(mutexHistorico);
+        anulacionesSinHistorico.eliminar(anulada.getCodigo());
+    }
+    if (creacionesDeshechas.contiene(anulada.getCodigo())) {
+        return; // Su creación tampoco se confirmó
+    }
+    const int* posicion = indiceReservacionesPorCodigo.buscar(anulada.getCodigo());
+    int indice;
+    if (posicion != nullptr) {
+        indice = *posicion;
+        if (todasReservaciones[indice].EstaActiva()) return;
+    } else {
+        asegurarCapacidadReservaciones();
+        indice = cantidadReservaciones++;
+        todasReservaciones[indice] = anulada;
+    }
+    Reservacion& reservacion = todasReservaciones[indice];
+    reservacion.setActiva(true);
+    // Otra reserva sin confirmar pudo tomar sus noches; al deshacerse esa, retirarla
+    // respeta las noches que esta comparte
+    asegurarNochesOcupadas(obtenerIndiceAlojamiento(reservacion.getCodigoAlojamiento()), reservacion.getDiaEntrada(),
+                           reservacion.getDiaSalida());
+    registrarReservacionEnIndices(indice, true);
+    publicarCambio(EVENTO_CREADA, reservacion);
+}
+
+/**
+ * @brief Publica el cambio de una reservación en el canal de cambios.
+ * Se llama con mutexDatos exclusivo, o compartido y mutexRegistro (el canal admite un
+ * solo productor a la vez); no espera a ningún consumidor.
+ */
+void GestorUdeaStay::publicarCambio(TipoEventoReservacion tipo, const Reservacion& reservacion) {
+    EventoReservacion evento{};
+    evento.tipo = tipo;
+    evento.diaEntrada = static_cast<int32_t>(reservacion.getDiaEntrada());
+    evento.noches = reservacion.getDuracionNoches();
+    evento.monto = reservacion.getValorTotal();
+    reservacion.getCodigo().copy(evento.codigo, EventoReservacion::LARGO_CODIGO - 1);
+    reservacion.getCodigoAlojamiento().copy(evento.alojamiento, EventoReservacion::LARGO_CODIGO - 1);
+    reservacion.getDocumentoHuesped().copy(evento.documento, EventoReservacion::LARGO_DOCUMENTO - 1);
+    canalCambios.publicar(evento);
+}
+
+bool GestorUdeaStay::agregarSumideroCambios(SumideroEventos* sumidero, int intervaloMilisegundos) {
+    lock_guard<shared_mutex> bloqueo(mutexDatos); // Se suscribe entre dos publicaciones
+    if (cantidadDrenadoresCambios == MAX_DRENADORES_CAMBIOS) {
+        cerr << "Error [GestorUdeaStay]: No se admiten más de " << MAX_DRENADORES_CAMBIOS
+             << " consumidores del canal de cambios." << endl;
+        delete sumidero;
+        return false;
+    }
+    drenadoresCambios[cantidadDrenadoresCambios++] = new DrenadorCambios(canalCambios, sumidero, intervaloMilisegundos);
+    cout << "Canal de cambios: eventos hacia " << drenadoresCambios[cantidadDrenadoresCambios - 1]->describir()
+         << " cada " << intervaloMilisegundos << " ms." << endl;
+    return true;
+}
+
+void GestorUdeaStay::detenerDrenadoresCambios() {
+    for (int i = 0; i < cantidadDrenadoresCambios; ++i) {
+        delete drenadoresCambios[i]; // Entrega lo pendiente antes de terminar
+        drenadoresCambios[i] = nullptr;
+    }
+    cantidadDrenadoresCambios = 0;
+}
+
+Huesped* GestorUdeaStay::encontrarHuespedPorDocumento(const std::string& documento) const {
+    return obtenerHuesped(indiceHuespedesPorDocumento.buscar(documento));
+}
+
+/**
+ * @brief Mueve al histórico las reservaciones cuya fecha de salida es anterior a la fecha de corte.
+ */
+bool GestorUdeaStay::actualizarArchivoHistorico(Fecha fechaCorte) {
+    incrementarContadorIteraciones();
+    lock_guard<mutex> escritura(mutexEscritores);
+    return archivarVencidasHasta(fechaCorte.aNumeroDia(), true);
+}
+
+/**
+ * @brief Archiva las reservaciones con día de salida anterior a diaCorte.
+ * Extrae de la cola de vencimientos solo las k reservaciones vencidas (O(k log n)),
+ * y anexa las activas al histórico en uso con una sola escritura por archivo.
+ * Las anuladas van al histórico al anularse (con diario, cuando este lo confirma; ver
+ * anexarAnulacionConfirmada), así que solo se retiran.
+ *
+ * Se llama con mutexEscritores tomado y sin mutexDatos: nadie más anula ni retira
+ * reservaciones, y las búsquedas, consultas y reservas nuevas siguen con el candado
+ * compartido mientras se escribe el histórico (de copias de las k, no del arreglo).
+ * La extracción de la cola y las copias van con mutexRegistro, porque las reservas
+ * nuevas anexan a esas mismas estructuras.
+ * Después se retiran del arreglo en su lugar (la última ocupa el hueco; ver
+ * quitarReservacionDelArreglo) por tandas de RESERVACIONES_POR_TANDA, cada una con
+ * mutexDatos exclusivo: una búsqueda espera a lo sumo una tanda, y la corrida entera
+ * cuesta O(k log n) sin copiar las que siguen.
+ * @param diaCorte Número de día de la fecha de corte.
+ * @param informar Si es true, muestra el resumen en consola.
+ */
+bool GestorUdeaStay::archivarVencidasHasta(long diaCorte, bool informar) {
+    incrementarContadorIteraciones();
+
+    // Sin diario las archivadas volverían como activas tras una caída (y podría llevarse
+    // una reserva que todavía se va a deshacer)
+    if (diarioEnFalla()) {
+        if (informar) cerr << "Error: El diario de reservaciones no está disponible; no se archiva." << endl;
+        return false;
+    }
 
-        if (fechaSalida.esMenor(fechaCorte)) {
-            agregarReservacionAHistoricoEnArchivo(todasReservaciones[i]);
-            movidasAlHistorico++;
+    // Se extraen las entradas vencidas en orden de salida; también se guardan
+    // para reinsertarlas si la escritura al histórico falla.
+    ColaVencimientos::Entrada* extraidas = nullptr;
+    int cantidadExtraidas = 0;
+    int cupoExtraidas = 0;
+    // Copias de las activas extraídas: el histórico se escribe sin tocar el arreglo
+    Reservacion* copias = nullptr;
+    int movidasAlHistorico = 0;
+    // Una anulación deshecha vuelve a la cola sin sacar su entrada anterior: cada
+    // código se archiva una sola vez
+    TablaHash<bool> yaExtraidas;
+
+    int restantes;
+    {
+        // Las reservas siguen entrando (mutexDatos compartido): la cola, el índice y el
+        // arreglo se leen con mutexRegistro, que ellas toman para anexar.
+        lock_guard<mutex> registro(mutexRegistro);
+        if (cantidadReservaciones == 0) {
+            if (informar) cout << "No hay reservaciones activas para procesar." << endl;
+            return true;
+        }
+
+        while (!colaVencimientos.estaVacia() && colaVencimientos.verDiaMinimo() < diaCorte) {
             incrementarContadorIteraciones();
-        } else {
-            if (nuevasReservacionesActivas != nullptr) {
-                nuevasReservacionesActivas[nuevaCantidadActivas++] = todasReservaciones[i];
+            ColaVencimientos::Entrada entrada = colaVencimientos.extraerMinimo();
+            const int* indice = indiceReservacionesPorCodigo.buscar(entrada.codigo);
+            if (indice == nullptr || !yaExtraidas.insertar(entrada.codigo, true)) {
+                continue; // Entrada obsoleta: la reservación ya no está en memoria.
             }
+
+            if (cantidadExtraidas == cupoExtraidas) {
+                int nuevoCupo = cupoExtraidas == 0 ? 16 : cupoExtraidas * 2;
+                ColaVencimientos::Entrada* nuevo = new ColaVencimientos::Entrada[nuevoCupo];
+                Reservacion* nuevasCopias = new Reservacion[nuevoCupo];
+                for (int i = 0; i < cantidadExtraidas; ++i) nuevo[i] = std::move(extraidas[i]);
+                for (int i = 0; i < movidasAlHistorico; ++i) nuevasCopias[i] = copias[i];
+                delete[] extraidas;
+                delete[] copias;
+                extraidas = nuevo;
+                copias = nuevasCopias;
+                cupoExtraidas = nuevoCupo;
+            }
+            const Reservacion& r = todasReservaciones[*indice];
+            if (r.EstaActiva()) {
+                copias[movidasAlHistorico++] = r;
+            }
+            extraidas[cantidadExtraidas++] = std::move(entrada);
+        }
+        restantes = cantidadReservaciones;
+    }
+
+    if (cantidadExtraidas == 0) {
+        if (informar) {
+            cout << "0 reservaciones han sido movidas al archivo histórico." << endl;
+            cout << restantes << " reservaciones permanecen activas." << endl;
+        }
+        return true;
+    }
+
+    const Reservacion** paraHistorico = new const Reservacion*[movidasAlHistorico > 0 ? movidasAlHistorico : 1];
+    for (int i = 0; i < movidasAlHistorico; ++i) {
+        paraHistorico[i] = &copias[i];
+    }
+    bool anexado = anexarAlHistorico(paraHistorico, movidasAlHistorico);
+    delete[] paraHistorico;
+    delete[] copias;
+    if (!anexado) {
+        // No se toca el arreglo: las reservaciones siguen activas y vuelven a la cola.
+        lock_guard<mutex> registro(mutexRegistro);
+        for (int i = 0; i < cantidadExtraidas; ++i) {
+            colaVencimientos.insertar(extraidas[i].diaSalida, extraidas[i].codigo);
+        }
+        delete[] extraidas;
+        return false;
+    }
+
+    unsigned long long ultimoTurnoDiario = 0;
+    for (int desde = 0; desde < cantidadExtraidas; desde += RESERVACIONES_POR_TANDA) {
+        const int hasta = desde + RESERVACIONES_POR_TANDA < cantidadExtraidas ? desde + RESERVACIONES_POR_TANDA
+                                                                                : cantidadExtraidas;
+        lock_guard<shared_mutex> bloqueo(mutexDatos);
+        for (int i = desde; i < hasta; ++i) {
             incrementarContadorIteraciones();
+            const int posicion = *indiceReservacionesPorCodigo.buscar(extraidas[i].codigo);
+            const Reservacion& r = todasReservaciones[posicion];
+            if (r.EstaActiva()) { // Las anuladas ya salieron de los índices
+                retirarReservacionDeIndices(r);
+                publicarCambio(EVENTO_ARCHIVADA, r);
+                // Ya está en el histórico: si hay una caída antes del punto de control no debe volver como activa.
+                if (persistirCambios && diarioReservaciones.estaAbierto()) {
+                    ultimoTurnoDiario = diarioReservaciones.encolar("-" + extraidas[i].codigo);
+                }
+            }
+            quitarReservacionDelArreglo(posicion);
         }
     }
+    delete[] extraidas;
 
-    delete[] todasReservaciones;
+    // El archivado termina cuando los "-" están en disco. Si hay una caída antes, la
+    // carga encuentra sus códigos en el histórico y no las reactiva (ver
+    // retirarSiYaEstaEnHistorico), así que tampoco se archivan dos veces.
+    if (ultimoTurnoDiario != 0 && !diarioReservaciones.esperar(ultimoTurnoDiario)) {
+        if (informar) cerr << "Error: El archivado no se pudo confirmar en el diario de reservaciones." << endl;
+        return false;
+    }
+
+    if (informar) {
+        cout << movidasAlHistorico << " reservaciones han sido movidas al archivo histórico." << endl;
+        cout << cantidadReservaciones << " reservaciones permanecen activas." << endl;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Saca del arreglo la reservación en 'posicion' (ya retirada de los demás
+ * índices) en O(1): la última del arreglo pasa a ocupar su lugar. El orden del arreglo
+ * no importa (las consultas ordenadas usan las agendas y las listas de los huéspedes).
+ * Requiere mutexDatos exclusivo.
+ */
+void GestorUdeaStay::quitarReservacionDelArreglo(int posicion) {
+    versionReservaciones++;
+    indiceReservacionesPorCodigo.eliminar(todasReservaciones[posicion].getCodigo());
+    const int ultima = --cantidadReservaciones;
+    if (posicion != ultima) {
+        todasReservaciones[posicion] = todasReservaciones[ultima];
+        indiceReservacionesPorCodigo.insertar(todasReservaciones[posicion].getCodigo(), posicion);
+    }
+    todasReservaciones[ultima] = Reservacion(); // Libera sus textos
+}
+
+/**
+ * @brief Inicia un hilo que cada 'intervaloSegundos' archiva lo vencido hasta hoy.
+ * Si ya había un hilo corriendo, se detiene y se reemplaza con el nuevo intervalo.
+ */
+void GestorUdeaStay::iniciarArchivadoAutomatico(int intervaloSegundos) {
+    detenerArchivadoAutomatico();
+    if (intervaloSegundos <= 0) {
+        return;
+    }
+    {
+        lock_guard<mutex> bloqueo(mutexArchivado);
+        detenerHiloArchivado = false;
+        intervaloArchivadoSegundos = intervaloSegundos;
+    }
+    hiloArchivado = thread(&GestorUdeaStay::cicloArchivadoAutomatico, this);
+    cout << "Archivado automático activado cada " << intervaloSegundos << " segundos." << endl;
+}
+
+void GestorUdeaStay::detenerArchivadoAutomatico() {
+    {
+        lock_guard<mutex> bloqueo(mutexArchivado);
+        detenerHiloArchivado = true;
+    }
+    condicionArchivado.notify_all();
+    if (hiloArchivado.joinable()) {
+        hiloArchivado.join();
+    }
+}
+
+/**
+ * @brief Cuerpo del hilo de archivado automático.
+ * Espera el intervalo (o la señal de detención) y archiva en silencio hasta la fecha actual.
+ */
+void GestorUdeaStay::cicloArchivadoAutomatico() {
+    unique_lock<mutex> espera(mutexArchivado);
+    while (!detenerHiloArchivado) {
+        bool detenido = condicionArchivado.wait_for(espera, chrono::seconds(intervaloArchivadoSegundos),
+                                                    [this] { return detenerHiloArchivado; });
+        if (detenido) break;
+        espera.unlock();
+        {
+            lock_guard<mutex> escritura(mutexEscritores); // Las búsquedas siguen mientras se archiva
+            archivarVencidasHasta(Fecha::hoy().aNumeroDia(), false);
+        }
+        espera.lock();
+    }
+}
+
+/**
+ * @brief Recorre el histórico y siembra el generador con el mayor código archivado.
+ * Solo se lee el primer campo de cada línea; el resto del registro no se parsea.
+ * En el mismo recorrido se retiran las activas que ya están en el histórico (ver
+ * retirarSiYaEstaEnHistorico).
+ */
+void GestorUdeaStay::sembrarGeneradorDesdeHistorico() {
     incrementarContadorIteraciones();
+    ifstream archivo(archivoHistorico);
+    if (!archivo.is_open()) {
+        return; // Sin histórico todavía: no hay códigos archivados que respetar.
+    }
+    int retiradas = 0;
+    string linea;
+    while (getline(archivo, linea)) {
+        incrementarContadorIteraciones();
+        size_t coma = linea.find(',');
+        const string codigo = trim(linea.substr(0, coma));
+        generadorCodigos.observarCodigo(codigo);
+        // Solo se parsea la línea si su código está entre las activas (casi nunca)
+        Reservacion registro;
+        if (obtenerIndiceReservacionActiva(codigo) >= 0 && parsearReservacionDesdeLinea(linea, registro) &&
+            retirarSiYaEstaEnHistorico(registro)) {
+            retiradas++;
+        }
+    }
+    informarRetiradasYaEnHistorico(retiradas);
+}
+
+/**
+ * @brief Una activa que ya tiene su fila en el histórico es una reservación terminada
+ * (archivada o anulada), aunque Reservaciones.csv o el diario la traigan activa: eso
+ * pasa si hubo una caída entre el anexo al histórico y el registro "-" en el diario (o,
+ * sin diario, antes de reescribir Reservaciones.csv). Se retira de las activas sin
+ * volver a escribirla, así el próximo archivado no duplica su fila. Se compara la
+ * estadía completa y no solo el código: los datos de ejemplo repiten códigos entre el
+ * histórico y las activas. Solo al cargar.
+ * @return true si estaba activa y se retiró.
+ */
+bool GestorUdeaStay::retirarSiYaEstaEnHistorico(const Reservacion& registro) {
+    const int indice = obtenerIndiceReservacionActiva(registro.getCodigo());
+    if (indice < 0) {
+        return false;
+    }
+    Reservacion& reservacion = todasReservaciones[indice];
+    if (reservacion.getCodigoAlojamiento() != registro.getCodigoAlojamiento() ||
+        reservacion.getDocumentoHuesped() != registro.getDocumentoHuesped() ||
+        reservacion.getDiaEntrada() != registro.getDiaEntrada() ||
+        reservacion.getDuracionNoches() != registro.getDuracionNoches()) {
+        return false;
+    }
+    reservacion.anular(); // Inactiva: el archivado la saca sin escribirla
+    retirarReservacionDeIndices(reservacion);
+    return true;
+}
+
+void GestorUdeaStay::informarRetiradasYaEnHistorico(int retiradas) {
+    if (retiradas == 0) return;
+    cout << "Advertencia: " << retiradas << " reservaciones activas ya estaban en el histórico "
+         << "(archivado interrumpido); se retiran de las activas." << endl;
+    guardarReservacionesActivasEnArchivo(true);
+}
 
-    todasReservaciones = nuevasReservacionesActivas;
-    cantidadReservaciones = nuevaCantidadActivas;
-    cupoReservaciones = nuevoCupoActivas;
+/**
+ * @brief Convierte una línea CSV de reservación en un objeto Reservacion.
+ * Conserva el estado 'Activa' del archivo (el constructor siempre la crea activa).
+ */
+bool GestorUdeaStay::parsearReservacionDesdeLinea(const string& linea, Reservacion& reservacion) {
+    string campos[EsquemaReservacion::NUM_CAMPOS];
+    EsquemaReservacion::Valores valores;
+    int campoConError;
+    if (parsearLineaCSVInterno(linea, campos, EsquemaReservacion::NUM_CAMPOS) != EsquemaReservacion::NUM_CAMPOS ||
+        EsquemaReservacion::convertir(campos, valores, campoConError) != LECTURA_CORRECTA) {
+        return false;
+    }
+    reservacion = aReservacion(valores);
+    return true;
+}
+
+/**
+ * @brief Cambia el histórico en uso al almacenamiento particionado por mes.
+ * Desde aquí los archivos nuevos y las consultas van al directorio "historico/";
+ * Historico.csv queda intacto (se puede copiar con importarHistoricoDesdeCSV).
+ * @param comprimir Si es true, los segmentos nuevos se comprimen con zlib.
+ */
+bool GestorUdeaStay::usarHistoricoParticionado(bool comprimir) {
+    lock_guard<mutex> escritura(mutexEscritores); // El archivado lee historicoParticionado sin mutexDatos
+    lock_guard<shared_mutex> bloqueo(mutexDatos);
+    lock_guard<mutex> bloqueoHistorico(mutexHistorico);
+    if (!almacenHistorico.abrir()) {
+        return false;
+    }
+    if (!almacenHistorico.setComprimir(comprimir)) {
+        cerr << "Advertencia [GestorUdeaStay]: Compilado sin zlib; el histórico particionado no se comprimirá." << endl;
+    }
+    historicoParticionado = true;
+    // Los códigos archivados en las particiones tampoco se pueden reemitir.
+    generadorCodigos.observarNumero(almacenHistorico.getMayorNumeroCodigo());
+    // Las activas que un archivado interrumpido ya dejó en las particiones: basta con
+    // recorrer el tramo de fechas de las activas (las particiones se saltan por rango)
+    long entradaMinima = numeric_limits<long>::max(), entradaMaxima = numeric_limits<long>::min();
+    for (int i = 0; i < cantidadReservaciones; ++i) {
+        const Reservacion& r = todasReservaciones[i];
+        if (!r.EstaActiva()) continue;
+        if (r.getDiaEntrada() < entradaMinima) entradaMinima = r.getDiaEntrada();
+        if (r.getDiaEntrada() > entradaMaxima) entradaMaxima = r.getDiaEntrada();
+    }
+    if (entradaMinima <= entradaMaxima) {
+        int retiradas = 0;
+        almacenHistorico.consultarPorRango(entradaMinima, entradaMaxima, [&](const Reservacion& registro) {
+            if (retirarSiYaEstaEnHistorico(registro)) retiradas++;
+        });
+        informarRetiradasYaEnHistorico(retiradas);
+    }
+    cout << "Histórico particionado en '" << directorioHistoricoParticionado << "/': "
+         << almacenHistorico.getCantidadRegistros() << " registros." << endl;
+    return true;
+}
 
-    cout << movidasAlHistorico << " reservaciones han sido movidas al archivo histórico." << endl;
-    cout << cantidadReservaciones << " reservaciones permanecen activas." << endl;
+/**
+ * @brief Copia Historico.csv al histórico particionado, en lotes para acotar la memoria.
+ * @return Cantidad de registros importados o -1 si hubo error.
+ */
+long long GestorUdeaStay::importarHistoricoDesdeCSV() {
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    if (!historicoParticionado) {
+        cerr << "Error [GestorUdeaStay]: El histórico particionado no está activo." << endl;
+        return -1;
+    }
+    ifstream archivo(archivoHistorico);
+    if (!archivo.is_open()) {
+        cerr << "Error [GestorUdeaStay]: No se pudo abrir '" << archivoHistorico << "'." << endl;
+        return -1;
+    }
 
+    const int TAMANO_LOTE = 4096;
+    Reservacion* lote = new Reservacion[TAMANO_LOTE];
+    const Reservacion** punteros = new const Reservacion*[TAMANO_LOTE];
+    int enLote = 0;
+    long long importados = 0;
+    bool exito = true;
+    string linea;
+    while (exito && getline(archivo, linea)) {
+        incrementarContadorIteraciones();
+        if (trim(linea).empty()) continue;
+        if (!parsearReservacionDesdeLinea(linea, lote[enLote])) {
+            cerr << "Advertencia [GestorUdeaStay]: Línea del histórico omitida: " << linea << endl;
+            continue;
+        }
+        punteros[enLote] = &lote[enLote];
+        if (++enLote == TAMANO_LOTE) {
+            exito = almacenHistorico.anexar(punteros, enLote, sincronizarHistoricoEnDisco);
+            importados += enLote;
+            enLote = 0;
+        }
+    }
+    if (exito && enLote > 0) {
+        exito = almacenHistorico.anexar(punteros, enLote, sincronizarHistoricoEnDisco);
+        importados += enLote;
+    }
+    delete[] punteros;
+    delete[] lote;
+    return exito ? importados : -1;
+}
+
+/**
+ * @brief Reordena Historico.csv por fecha de entrada y reconstruye su índice.
+ * Con las líneas ordenadas cada bloque cubre un tramo de fechas propio, así que una
+ * consulta por rango lee solo los bloques de esas fechas. Mientras corre no se archiva
+ * ni se anula nada (mutexEscritores), porque eso anexaría al archivo que se reescribe.
+ */
+bool GestorUdeaStay::reordenarHistorico() {
+    lock_guard<mutex> escritura(mutexEscritores);
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    if (historicoParticionado) {
+        cerr << "Error [GestorUdeaStay]: El histórico particionado ya está ordenado por mes." << endl;
+        return false;
+    }
+    if (!indiceHistorico.reordenarPorFecha()) {
+        cerr << "Error [GestorUdeaStay]: No se pudo reordenar '" << archivoHistorico << "'." << endl;
+        return false;
+    }
+    cout << "Histórico reordenado por fecha de entrada: " << indiceHistorico.getCantidadBloques() << " bloques."
+         << endl;
     return true;
 }
 
-std::string GestorUdeaStay::generarNuevoCodigoReservacion() const {
-    int numero = cantidadReservaciones + 1;
-    std::ostringstream oss;
-    oss << "RES" << std::setfill('0') << std::setw(3) << numero;
-    return oss.str();  // Ej: RES001, RES002
+long long GestorUdeaStay::exportarHistoricoCSV(const string& archivoDestino) {
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    if (!historicoParticionado) {
+        cerr << "Error [GestorUdeaStay]: El histórico particionado no está activo." << endl;
+        return -1;
+    }
+    return almacenHistorico.exportarCSV(archivoDestino);
+}
+
+/**
+ * @brief Calcula la analítica de ocupación con las reservaciones activas y el histórico.
+ * Con mutexEscritores, mutexRegistro y mutexHistorico se toma una foto: las activas, las anulaciones
+ * que esperan al diario para ir al histórico y una marca de hasta dónde llega el
+ * histórico (bytes del CSV o registros por partición). Luego se sueltan los candados y
+ * el histórico se lee solo hasta la marca: lo que el archivado o una anulación anexen
+ * después ya estaba en la foto, así que nada se cuenta dos veces ni se pierde, y
+ * reservar, anular y archivar siguen mientras se recorre. Cada bloque de poolRecorridos
+ * suma en su parcial.
+ */
+bool GestorUdeaStay::generarAnalitica(Fecha desde, Fecha hasta, const string& prefijo, int parciales) {
+    if (hasta.esMenor(desde)) {
+        cerr << "Error [GestorUdeaStay]: La fecha final de la analítica es anterior a la inicial." << endl;
+        return false;
+    }
+    AnaliticaOcupacion analitica(desde.aNumeroDia(), hasta.aNumeroDia(), poolRecorridos);
+    bool particionado;
+    AlmacenHistorico::Marca marcaParticiones;
+    long long marcaBytes = -1;
+    {
+        lock_guard<mutex> escritura(mutexEscritores);
+        shared_lock<shared_mutex> lectura(mutexDatos);
+        for (int i = 0; i < cantidadAlojamientos; ++i) {
+            analitica.agregarAlojamiento(todosAlojamientos[i].getCodigoID(),
+                                         trim(todosAlojamientos[i].getAnfitrionResponsableID()),
+                                         todosAlojamientos[i].getMunicipio());
+        }
+        parciales = analitica.preparar(parciales, MEMORIA_ANALITICA);
+        // Las anuladas ya están en el histórico (o en anulacionesSinHistorico); aquí solo las activas.
+        // Las reservas nuevas siguen entrando: mutexRegistro fija el arreglo mientras se recorre.
+        {
+            lock_guard<mutex> registro(mutexRegistro);
+            for (int i = 0; i < cantidadReservaciones; ++i) {
+                const Reservacion& r = todasReservaciones[i];
+                if (r.EstaActiva()) {
+                    analitica.sumarFoto(r.getCodigoAlojamiento(), r.getDiaEntrada(), r.getDuracionNoches(),
+                                        r.getValorTotal(), true);
+                }
+            }
+        }
+        lock_guard<mutex> bloqueoHistorico(mutexHistorico);
+        anulacionesSinHistorico.paraCada([&analitica](const string&, const Reservacion& r) {
+            analitica.sumarFoto(r.getCodigoAlojamiento(), r.getDiaEntrada(), r.getDuracionNoches(),
+                                r.getValorTotal(), false);
+        });
+        particionado = historicoParticionado;
+        if (particionado) {
+            almacenHistorico.tomarMarca(marcaParticiones);
+        } else {
+            struct stat datos;
+            if (::stat(archivoHistorico.c_str(), &datos) == 0) marcaBytes = static_cast<long long>(datos.st_size);
+        }
+    }
+
+    // Sin candados: los anexos al histórico son todo o nada bajo mutexHistorico, así que
+    // la marca cae siempre en un borde entre anexos. Si los parciales no caben con todos
+    // los meses, cada ventana de meses relee el histórico hasta la misma marca.
+    long long historicas = 0;
+    bool exito = true;
+    for (int pasada = 0; pasada < analitica.getPasadas() && exito; ++pasada) {
+        analitica.iniciarPasada(pasada);
+        long long leidas = 0;
+        if (particionado) {
+            AlmacenHistorico::EstadisticaConsulta estadistica;
+            almacenHistorico.recorrerEnParalelo(marcaParticiones, poolRecorridos, parciales,
+                                                [&](int parcial, const Reservacion& r) {
+                analitica.sumar(parcial, r.getCodigoAlojamiento(), r.getDiaEntrada(), r.getDuracionNoches(),
+                                r.getValorTotal(), r.EstaActiva());
+            }, estadistica);
+            leidas = estadistica.registrosEncontrados;
+        } else if (marcaBytes >= 0) {
+            leidas = analitica.leerCSVEnParalelo(archivoHistorico, marcaBytes);
+        }
+        if (pasada == 0) historicas = leidas > 0 ? leidas : 0;
+        analitica.combinar();
+        exito = analitica.escribir(prefijo);
+    }
+
+    const AnaliticaOcupacion::Metricas m = analitica.getMetricas();
+    cout << "Analítica de " << desde.toString() << " a " << hasta.toString() << ": "
+         << m.estadias << " estadías (" << historicas << " registros del histórico), "
+         << m.anuladas << " anuladas, " << m.sinAlojamiento << " de alojamientos desconocidos, "
+         << m.conError << " líneas con error." << endl;
+    cout << "  " << m.hilos << (m.hilos == 1 ? " hilo, " : " hilos, ") << m.parciales << " parciales, "
+         << (m.bytesParciales + 1023) / 1024 << " KB en agregados parciales";
+    if (m.pasadas > 1) {
+        cout << ", " << m.pasadas << " pasadas por ventanas de meses (" << (m.bytesFoto + 1023) / 1024
+             << " KB de la foto)";
+    }
+    cout << "." << endl;
+    if (exito) {
+        cout << "  Escrito en " << prefijo << "_alojamientos.csv, " << prefijo << "_anfitriones.csv y "
+             << prefijo << "_municipios.csv" << endl;
+    }
+    return exito;
+}
+
+/**
+ * @brief Genera un código de reservación nuevo.
+ * El número sale de un contador atómico sembrado con el máximo código existente,
+ * así que no depende de cantidadReservaciones ni se repite tras archivar o anular.
+ */
+std::string GestorUdeaStay::generarNuevoCodigoReservacion() {
+    return generadorCodigos.siguiente(); // Ej: RES012, RES1000, ...
+}
+
+// Deja el motivo de un fallo en 'error' (el servidor lo envía al cliente) o, si no hay
+// destino, lo muestra en la consola como siempre.
+static void informarFallo(string* error, const string& mensaje) {
+    if (error != nullptr) {
+        *error = mensaje;
+    } else {
+        cerr << "Error: " << mensaje << endl;
+    }
 }
 
 //Implementacion de creacion de reservaciones
 
-bool GestorUdeaStay::crearNuevaReservacion(const std::string& codigoAlojamiento, Fecha fechaInicio, int noches,
-                                           const std::string& metodoPago, const std::string& anotacionesHuesped) {
+bool GestorUdeaStay::crearNuevaReservacion(const Sesion& sesion, const std::string& codigoAlojamiento, Fecha fechaInicio, int noches,
+                                           const std::string& metodoPago, const std::string& anotacionesHuesped,
+                                           std::string* codigoCreado, std::string* error) {
     incrementarContadorIteraciones();
 
-    if (!haySesionHuespedActiva()) {
-        std::cerr << "Error: No hay un huésped logueado para crear una reservación." << std::endl;
+    Huesped* huesped = sesion.getHuesped();
+    if (huesped == nullptr) {
+        informarFallo(error, "No hay un huésped logueado para crear una reservación.");
         incrementarContadorIteraciones();
         return false;
     }
 
-    Alojamiento* alojamiento = encontrarAlojamientoPorCodigo(codigoAlojamiento);
-    if (alojamiento == nullptr) {
-        std::cerr << "Error: No se encontró un alojamiento con código " << codigoAlojamiento << "." << std::endl;
-        incrementarContadorIteraciones();
+    if (diarioEnFalla()) {
+        informarFallo(error, "El diario de reservaciones no está disponible; no se aceptan reservas.");
         return false;
     }
 
-    Fecha fechaSalida = fechaInicio.calcularFechaMasDuracion(noches);
-
-    // Verificamos que no exista una reservación activa que cruce estas fechas para este alojamiento
-    for (int i = 0; i < cantidadReservaciones; ++i) {
-        const Reservacion& r = todasReservaciones[i];
-        if (r.EstaActiva() && r.getCodigoAlojamiento() == codigoAlojamiento) {
-            Fecha entradaExistente = r.getFechaEntrada();
-            Fecha salidaExistente = r.getFechaSalida();
-            if (!(fechaSalida.esMenor(entradaExistente) || fechaInicio.esMayorOIgual(salidaExistente))) {
-                std::cerr << "Error: El alojamiento ya tiene una reservación activa que se cruza con las fechas solicitadas." << std::endl;
-                incrementarContadorIteraciones(3); // por comparaciones
-                return false;
+    const long diaEntrada = fechaInicio.aNumeroDia();
+    const long diaSalida = diaEntrada + noches;
+    const bool usarDiario = persistirCambios && diarioReservaciones.estaAbierto();
+    std::string nuevoCodigo;
+    unsigned long long turnoDiario = 0;
+    {
+        // Todo va con el candado compartido: reservas de alojamientos o noches distintas
+        // avanzan a la vez, y una recarga no puede retirar el alojamiento mientras tanto.
+        shared_lock<shared_mutex> lectura(mutexDatos);
+        const int indiceAlojamiento = obtenerIndiceAlojamiento(codigoAlojamiento);
+        if (indiceAlojamiento < 0) {
+            informarFallo(error, "No se encontró un alojamiento con código " + codigoAlojamiento + ".");
+            incrementarContadorIteraciones();
+            return false;
+        }
+        if (!CalendarioOcupacion::enRango(diaEntrada, diaSalida)) {
+            informarFallo(error, "Las fechas solicitadas no son válidas (se reciben estadías de al menos una noche "
+                                 "entre el 01/01/2000 y el " + Fecha::desdeNumeroDia(CalendarioOcupacion::DIA_BASE +
+                                 CalendarioOcupacion::DIAS_CUBIERTOS).toString() + ").");
+            return false;
+        }
+        // Las noches se toman con CAS: una reserva que choca falla aquí sin esperar a nadie.
+        bool revertido;
+        if (!calendarioOcupacion.reclamar(indiceAlojamiento, diaEntrada, diaSalida, &revertido)) {
+            if (revertido) {
+                // Devolvió noches que tomó a medias: una búsqueda pudo verlas ocupadas
+                invalidarBusquedas(indiceAlojamiento, diaEntrada, diaSalida);
             }
+            informarFallo(error, "El alojamiento ya tiene una reservación activa que se cruza con las fechas solicitadas.");
+            incrementarContadorIteraciones(3); // por comparaciones
+            return false;
         }
-    }
-
-    int montoTotal = static_cast<int>(alojamiento->getPrecioPorNoche() * noches);
-    Fecha fechaPago = Fecha(); // fecha actual no disponible, se pone default
 
-    std::string nuevoCodigo = generarNuevoCodigoReservacion(); // Método que tú ya declaraste
-
-    // Asegurar espacio en arreglo
-    asegurarCapacidadReservaciones();
+        // Suma exacta de las tarifas de cada noche (temporada, fin de semana), en pesos enteros
+        long long costo = calcularCostoEstadia(indiceAlojamiento, diaEntrada, diaSalida);
+        if (costo > numeric_limits<int>::max()) {
+            calendarioOcupacion.liberar(indiceAlojamiento, diaEntrada, diaSalida);
+            invalidarBusquedas(indiceAlojamiento, diaEntrada, diaSalida);
+            informarFallo(error, "El costo de la estadía excede el monto máximo de una reservación.");
+            return false;
+        }
+        int montoTotal = static_cast<int>(costo);
+        Fecha fechaPago = Fecha(); // fecha actual no disponible, se pone default
+
+        // Lo único serializado entre reservas: anexar a las colecciones compartidas (O(log n))
+        lock_guard<mutex> registro(mutexRegistro);
+        // El huésped tampoco puede tener otra estadía (en cualquier alojamiento) en esas noches.
+        if (huesped->tieneEstadiaQueSeCruza(diaEntrada, diaSalida)) {
+            calendarioOcupacion.liberar(indiceAlojamiento, diaEntrada, diaSalida);
+            invalidarBusquedas(indiceAlojamiento, diaEntrada, diaSalida); // Alguna búsqueda pudo ver las noches tomadas
+            informarFallo(error, "Ya tiene una reservación activa que se cruza con las fechas solicitadas.");
+            incrementarContadorIteraciones(2);
+            return false;
+        }
 
-    todasReservaciones[cantidadReservaciones++] = Reservacion(
-        nuevoCodigo,
-        codigoAlojamiento,
-        huespedLogueado->getDocumento(),
-        metodoPago,
-        fechaInicio,
-        noches,
-        fechaPago,
-        montoTotal,
-        anotacionesHuesped
-        );
+        nuevoCodigo = generarNuevoCodigoReservacion();
+
+        // Asegurar espacio en arreglo
+        asegurarCapacidadReservaciones();
+
+        todasReservaciones[cantidadReservaciones++] = Reservacion(
+            nuevoCodigo,
+            codigoAlojamiento,
+            huesped->getDocumento(),
+            metodoPago,
+            fechaInicio,
+            noches,
+            fechaPago,
+            montoTotal,
+            anotacionesHuesped
+            );
+        registrarReservacionEnIndices(cantidadReservaciones - 1, true); // También la agrega a la lista del huésped
+        publicarCambio(EVENTO_CREADA, todasReservaciones[cantidadReservaciones - 1]);
+        // En el diario queda antes que cualquier anulación suya (que la busca en el índice)
+        if (usarDiario) {
+            turnoDiario = diarioReservaciones.encolar("+" + todasReservaciones[cantidadReservaciones - 1].toFileString());
+        }
+        incrementarContadorIteraciones(5);
+    }
 
-    huespedLogueado->agregarCodigoReservacion(nuevoCodigo);
+    // El disco va sin candados: otras reservas entran mientras tanto y comparten el mismo
+    // fdatasync (con diario) o la misma reescritura del CSV (sin diario).
+    if (!usarDiario) {
+        reescribirReservacionesActivas();
+    }
+    if (turnoDiario != 0 && !diarioReservaciones.esperar(turnoDiario)) {
+        deshacerCreacion(nuevoCodigo);
+        informarFallo(error, "La reservación " + nuevoCodigo + " no se pudo confirmar en disco y se descartó.");
+        return false;
+    }
 
     std::cout << "Reservación creada exitosamente con código: " << nuevoCodigo << std::endl;
-    guardarReservacionesActivasEnArchivo();
-    incrementarContadorIteraciones(5);
-
+    if (codigoCreado != nullptr) {
+        *codigoCreado = nuevoCodigo;
+    }
     return true;
 }
 // Implementacion de cancelar una Reservacion
-bool GestorUdeaStay::cancelarUnaReservacion(const std::string& codigoReservacion) {
+bool GestorUdeaStay::cancelarUnaReservacion(const Sesion& sesion, const std::string& codigoReservacion,
+                                            std::string* error) {
     incrementarContadorIteraciones();
+    unique_lock<mutex> escritura(mutexEscritores);
+    unique_lock<shared_mutex> bloqueo(mutexDatos);
 
+    if (diarioEnFalla()) {
+        informarFallo(error, "El diario de reservaciones no está disponible; no se aceptan anulaciones.");
+        return false;
+    }
     int indice = obtenerIndiceReservacionActiva(codigoReservacion);
     if (indice == -1) {
-        cerr << "Reservación no encontrada o ya está anulada.\n";
+        informarFallo(error, "Reservación no encontrada o ya está anulada.");
         return false;
     }
 
     Reservacion& reservacion = todasReservaciones[indice];
 
-    if (haySesionHuespedActiva()) {
-        if (reservacion.getDocumentoHuesped() != huespedLogueado->getDocumento()) {
-            cerr << "Error: No tiene permiso para anular esta reservación.\n";
+    if (sesion.esHuesped()) {
+        if (reservacion.getDocumentoHuesped() != sesion.getHuesped()->getDocumento()) {
+            informarFallo(error, "No tiene permiso para anular esta reservación.");
             return false;
         }
-        huespedLogueado->eliminarCodigoReservacion(codigoReservacion);
 
-    } else if (haySesionAnfitrionActiva()) {
+    } else if (sesion.esAnfitrion()) {
         Alojamiento* aloja = encontrarAlojamientoPorCodigo(reservacion.getCodigoAlojamiento());
 
-        std::string idAnfitrionAlojamiento = trim(aloja->getAnfitrionResponsableID());
-        std::string idAnfitrionLogueado   = trim(anfitrionLogueado->getId());
-
-        std::cout << "DEBUG_IDS: Alojamiento tiene ID [" << idAnfitrionAlojamiento
-                  << "], anfitrión logueado es [" << idAnfitrionLogueado << "]\n";
+        std::string idAnfitrionAlojamiento = aloja != nullptr ? trim(aloja->getAnfitrionResponsableID()) : "";
+        std::string idAnfitrionLogueado   = trim(sesion.getAnfitrion()->getId());
 
         if (aloja == nullptr || idAnfitrionAlojamiento != idAnfitrionLogueado) {
-            std::cerr << "Error: Esta reservación no le pertenece a este anfitrión.\n";
+            informarFallo(error, "Esta reservación no le pertenece a este anfitrión.");
             return false;
         }
     } else {
-        cerr << "Error: No hay ninguna sesión activa.\n";
+        informarFallo(error, "No hay ninguna sesión activa.");
         return false;
     }
 
     reservacion.anular();
-    agregarReservacionAHistoricoEnArchivo(reservacion);
-    guardarReservacionesActivasEnArchivo();
-    cout << "Reservación anulada con éxito.\n";
+    retirarReservacionDeIndices(reservacion);
+    publicarCambio(EVENTO_ANULADA, reservacion);
+    const Reservacion anulada = reservacion; // El arreglo puede cambiar al soltar los candados
+    const bool usarDiario = persistirCambios && diarioReservaciones.estaAbierto();
+    unsigned long long turnoDiario = 0;
+    if (usarDiario) {
+        // Al histórico va cuando el diario la confirme: si no se confirma, se deshace
+        // sin dejar en el histórico una anulación que no ocurrió
+        turnoDiario = diarioReservaciones.encolar("-" + reservacion.getCodigo());
+        lock_guard<mutex> bloqueoHistorico(mutexHistorico);
+        anulacionesSinHistorico.insertar(anulada.getCodigo(), anulada);
+    } else {
+        agregarReservacionAHistoricoEnArchivo(reservacion);
+    }
     incrementarContadorIteraciones(3);
+
+    bloqueo.unlock();
+    escritura.unlock();
+    if (!usarDiario) {
+        reescribirReservacionesActivas(); // Fuera del candado exclusivo, como en la creación
+    }
+    if (turnoDiario != 0) {
+        if (!diarioReservaciones.esperar(turnoDiario)) {
+            deshacerAnulacion(anulada);
+            informarFallo(error, "La anulación no se pudo confirmar en disco; la reservación sigue activa.");
+            return false;
+        }
+        anexarAnulacionConfirmada(anulada);
+    }
+    cout << "Reservación anulada con éxito.\n";
     return true;
 }
 
@@ -1014,51 +2316,6 @@ void GestorUdeaStay::asegurarCapacidadAlojamientos() {
         // No se incrementan iteraciones por delete o asignación de puntero, ya contamos la creación y copia.
     }
 }
-void GestorUdeaStay::asegurarCapacidadAnfitriones() {
-    incrementarContadorIteraciones();
-
-    if (cupoAnfitriones == 0) {
-        cupoAnfitriones = 10; // Cupo inicial
-        todosAnfitriones = new Anfitrion[cupoAnfitriones];
-        incrementarContadorIteraciones();
-    } else if (cantidadAnfitriones == cupoAnfitriones) {
-        int nuevoCupo = cupoAnfitriones * 2;
-        Anfitrion* nuevoArreglo = new Anfitrion[nuevoCupo];
-        incrementarContadorIteraciones();
-
-        for (int i = 0; i < cantidadAnfitriones; ++i) {
-            nuevoArreglo[i] = todosAnfitriones[i]; // Copia usando el operador= de Anfitrion
-            incrementarContadorIteraciones();
-        }
-
-        delete[] todosAnfitriones;
-        todosAnfitriones = nuevoArreglo;
-        cupoAnfitriones = nuevoCupo;
-    }
-}
-
-void GestorUdeaStay::asegurarCapacidadHuespedes() {
-    incrementarContadorIteraciones();
-
-    if (cupoHuespedes == 0) {
-        cupoHuespedes = 10; // Cupo inicial
-        todosHuespedes = new Huesped[cupoHuespedes];
-        incrementarContadorIteraciones();
-    } else if (cantidadHuespedes == cupoHuespedes) {
-        int nuevoCupo = cupoHuespedes * 2;
-        Huesped* nuevoArreglo = new Huesped[nuevoCupo];
-        incrementarContadorIteraciones();
-
-        for (int i = 0; i < cantidadHuespedes; ++i) {
-            nuevoArreglo[i] = todosHuespedes[i]; // Copia usando el operador= de Huesped
-            incrementarContadorIteraciones();
-        }
-
-        delete[] todosHuespedes;
-        todosHuespedes = nuevoArreglo;
-        cupoHuespedes = nuevoCupo;
-    }
-}
 void GestorUdeaStay::asegurarCapacidadReservaciones() {
     incrementarContadorIteraciones();
 
@@ -1083,30 +2340,56 @@ void GestorUdeaStay::asegurarCapacidadReservaciones() {
 }
 void GestorUdeaStay::mostrarEstadoRecursosActual() const {
     cout << "\n--- Estado Actual de Recursos ---" << endl;
-    cout << "Iteraciones acumuladas: " << contadorIteracionesGlobal << endl;
+    shared_lock<shared_mutex> bloqueo(mutexDatos);
+    lock_guard<mutex> registro(mutexRegistro);
+    cout << "Iteraciones acumuladas: " << contadorIteracionesGlobal.load() << endl;
 
     size_t memoriaTotalObjetos = 0;
     // Cálculo de memoria (aproximación basada en cantidad de objetos)
     if (todosAlojamientos != nullptr) {
         memoriaTotalObjetos += (size_t)cantidadAlojamientos * sizeof(Alojamiento);
     }
-    if (todosAnfitriones != nullptr) {
-        memoriaTotalObjetos += (size_t)cantidadAnfitriones * sizeof(Anfitrion);
-        // Si Anfitrion tiene arreglos dinámicos internos (ej. codigosAlojamiento),
-        // se debería sumar también esa memoria aquí iterando por cada anfitrión.
-        // for (int i = 0; i < cantidadAnfitriones; ++i) {
-        //    memoriaTotalObjetos += todosAnfitriones[i].getMemoriaInternaDinamica(); // Método hipotético
-        // }
-    }
-    if (todosHuespedes != nullptr) {
-        memoriaTotalObjetos += (size_t)cantidadHuespedes * sizeof(Huesped);
-        // Similar para Huesped si tiene arreglos dinámicos internos (codigosDeSusReservaciones)
-    }
+    // Bajo demanda solo cuentan los usuarios ya leídos, más el índice de posiciones
+    memoriaTotalObjetos += anfitriones.memoriaAproximada() + huespedes.memoriaAproximada();
     if (todasReservaciones != nullptr) {
         memoriaTotalObjetos += (size_t)cantidadReservaciones * sizeof(Reservacion);
     }
 
     cout << "Memoria aproximada por objetos principales en colecciones: " << memoriaTotalObjetos << " bytes" << endl;
+    CalendarioOcupacion::Metricas calendario = calendarioOcupacion.getMetricas();
+    cout << "Calendario de ocupación: " << calendario.reclamos << " reclamos, " << calendario.conflictos
+         << " conflictos (" << calendario.reversiones << " con reversión), " << calendario.reintentos
+         << " reintentos de CAS, " << calendarioOcupacion.memoriaAproximada() << " bytes" << endl;
+    PoolHilos::Metricas pool = poolBusqueda.getMetricas();
+    cout << "Búsqueda paralela: " << pool.hilos + 1 << " hilos, " << pool.peticiones << " búsquedas repartidas en "
+         << pool.bloques << " bloques (" << pool.robados << " robados)" << endl;
+    cout << "Tarifas de temporada: " << tarifasTemporada.getCantidadReglas() << " reglas, "
+         << tarifasTemporada.getCantidadPerfiles() << " perfiles, " << tarifasTemporada.memoriaAproximada()
+         << " bytes" << endl;
+    CacheBusquedas::Metricas cache = cacheBusquedas.getMetricas();
+    cout << "Cache de búsquedas: " << cache.aciertos << " aciertos, " << cache.fallos << " fallos, "
+         << cache.invalidadas << " invalidadas, " << cache.desalojadas << " desalojadas; " << cache.entradas
+         << " entradas en " << cache.bytes << " de " << cache.presupuesto << " bytes" << endl;
+    if (diarioReservaciones.estaAbierto()) {
+        EscritorGrupal::Metricas m = diarioReservaciones.getMetricas();
+        cout << "Diario de reservaciones: " << m.registros << " registros en " << m.lotes << " lotes (promedio "
+             << (m.lotes > 0 ? static_cast<double>(m.registros) / m.lotes : 0) << ", máximo " << m.loteMaximo
+             << "), latencia de confirmación promedio " << static_cast<long>(m.latenciaPromedioMicros)
+             << " us (máxima " << static_cast<long>(m.latenciaMaximaMicros) << " us), write+fdatasync promedio "
+             << static_cast<long>(m.sincronizacionPromedioMicros) << " us, errores " << m.errores << endl;
+    }
+    cout << "Canal de cambios: " << canalCambios.getPublicados() << " eventos publicados (anillo de "
+         << canalCambios.getCupo() << ")" << endl;
+    for (int i = 0; i < cantidadDrenadoresCambios; ++i) {
+        DrenadorCambios::Metricas m = drenadoresCambios[i]->getMetricas();
+        cout << "  hacia " << drenadoresCambios[i]->describir() << ": " << m.escritos << " escritos en " << m.lotes
+             << " lotes, " << m.perdidos << " perdidos por atraso, " << m.descartados << " descartados por el destino"
+             << endl;
+    }
+    if (recargasAlojamientos > 0 || vigilanteAlojamientos.estaActivo()) {
+        cout << "Recargas de " << archivoAlojamientos << ": " << recargasAlojamientos << " ("
+             << cantidadAlojamientosRetirados << " alojamientos retirados)" << endl;
+    }
     cout << "Nota: Esta es una estimación y no incluye toda la memoria dinámica (ej. std::string, arreglos internos de objetos)." << endl;
     cout << "---------------------------------\n" << endl;
 }
@@ -1115,165 +2398,276 @@ void GestorUdeaStay::mostrarEstadoRecursosActual() const {
  * Es llamado por otros métodos del gestor cuando realizan operaciones significativas.
  * @param cantidad Número de iteraciones a sumar (por defecto 1).
  */
-void GestorUdeaStay::incrementarContadorIteraciones(unsigned long long cantidad) {
-    contadorIteracionesGlobal += cantidad;
+void GestorUdeaStay::incrementarContadorIteraciones(unsigned long long cantidad) const {
+    contadorIteracionesGlobal.fetch_add(cantidad, memory_order_relaxed);
 }
 
 
 //LOGIN
 
-bool GestorUdeaStay::intentarLoginAnfitrion(const string &idLogin, const string &contrasenaIngresada) {
+bool GestorUdeaStay::intentarLoginAnfitrion(Sesion& sesion, const string &idLogin, const string &contrasenaIngresada) {
     incrementarContadorIteraciones();
-    cout << "DEBUG_LOGIN_ANF: Iniciando intentarLoginAnfitrion..." << endl;
-    cout << "  ID Ingresado: [" << idLogin << "], Pass Ingresada: [" << contrasenaIngresada << "]" << endl;
-
-    Anfitrion* anfitrionEncontrado = encontrarAnfitrionPorID(idLogin);
-
-    if (anfitrionEncontrado != nullptr) {
-        cout << "  Anfitrion con ID [" << idLogin << "] encontrado. Verificando contraseña..." << endl;
-        std::string passAlmacenada = anfitrionEncontrado->getContrasena();
-        cout << "    Pass Ingresada por Usuario: [" << contrasenaIngresada << "] (Longitud: " << contrasenaIngresada.length() << ")" << endl;
-        cout << "    Pass Almacenada en Objeto: [" << passAlmacenada << "] (Longitud: " << passAlmacenada.length() << ")" << endl;
-
-        if (passAlmacenada == contrasenaIngresada) {
-            anfitrionLogueado = anfitrionEncontrado;
-            cout << "    ¡Contraseña CORRECTA! Login exitoso." << endl;
-            return true;
-        } else {
-            cout << "    Contraseña INCORRECTA." << endl;
-            return false;
-        }
+    Anfitrion* anfitrionEncontrado;
+    {
+        // Si se lee bajo demanda toma sus alojamientos del CSR, que una recarga puede rehacer
+        shared_lock<shared_mutex> lectura(mutexDatos);
+        anfitrionEncontrado = encontrarAnfitrionPorID(idLogin);
+    }
+    // Sin mensajes propios: quien llama informa el fallo sin decir si el ID existe
+    if (anfitrionEncontrado == nullptr || anfitrionEncontrado->getContrasena() != contrasenaIngresada) {
+        return false;
     }
-    // El mensaje de "NO encontrado" ya salió de encontrarAnfitrionPorID si es nullptr
-    cout << "  Login FALLIDO: Anfitrión con ID [" << idLogin << "] no encontrado (reportado por intentarLoginAnfitrion)." << endl;
-    return false;
+    sesion.iniciarComoAnfitrion(anfitrionEncontrado);
+    return true;
 }
 
 
-bool GestorUdeaStay::intentarLoginHuesped(const string &idLogin, const string &contrasenaIngresada) {
+bool GestorUdeaStay::intentarLoginHuesped(Sesion& sesion, const string &idLogin, const string &contrasenaIngresada) {
     incrementarContadorIteraciones();
-    cout << "DEBUG_LOGIN_HUE: Iniciando intentarLoginHuesped..." << endl;
-    cout << "  ID Ingresado: [" << idLogin << "], Pass Ingresada: [" << contrasenaIngresada << "]" << endl;
-
     Huesped* huespedEncontrado = encontrarHuespedPorID(idLogin);
+    if (huespedEncontrado == nullptr || huespedEncontrado->getContrasena() != contrasenaIngresada) {
+        return false;
+    }
+    sesion.iniciarComoHuesped(huespedEncontrado);
+    return true;
+}
 
-    if (huespedEncontrado != nullptr) {
-        cout << "  Huésped con ID [" << idLogin << "] encontrado. Verificando contraseña..." << endl;
-        std::string passAlmacenada = huespedEncontrado->getContrasena(); // Usa el getter
-        cout << "    Pass Ingresada por Usuario: [" << contrasenaIngresada << "] (Longitud: " << contrasenaIngresada.length() << ")" << endl;
-        cout << "    Pass Almacenada en Objeto: [" << passAlmacenada << "] (Longitud: " << passAlmacenada.length() << ")" << endl;
 
-        if (passAlmacenada == contrasenaIngresada) {
-            huespedLogueado = huespedEncontrado;
-            cout << "    ¡Contraseña CORRECTA! Login exitoso." << endl;
-            return true;
-        } else {
-            cout << "    Contraseña INCORRECTA." << endl;
-            return false;
-        }
+int GestorUdeaStay::obtenerIndiceReservacionActiva(const std::string& codigoBuscado) const {
+    const int* indice = indiceReservacionesPorCodigo.buscar(codigoBuscado);
+    if (indice == nullptr || !todasReservaciones[*indice].EstaActiva()) {
+        return -1;
     }
-    cout << "  Login FALLIDO: Huésped con ID [" << idLogin << "] no encontrado (reportado por intentarLoginHuesped)." << endl;
-    return false;
-}
-void GestorUdeaStay::cerrarSesion() {
-    anfitrionLogueado = nullptr;
-    huespedLogueado = nullptr;
+    return *indice;
 }
 
-bool GestorUdeaStay::haySesionHuespedActiva() const {
-    return huespedLogueado != nullptr;
+Reservacion* GestorUdeaStay::encontrarReservacionActivaPorCodigo(const std::string& codigo) const {
+    int indice = obtenerIndiceReservacionActiva(codigo);
+    return indice >= 0 ? &todasReservaciones[indice] : nullptr;
 }
 
-const Anfitrion* GestorUdeaStay::getAnfitrionActual() const {
-    return anfitrionLogueado;
+std::string aMinusculas(const std::string& texto) {
+    std::string resultado = texto;
+    for (char& c : resultado) {
+        c = std::tolower(static_cast<unsigned char>(c));
+    }
+    return resultado;
 }
 
-const Huesped* GestorUdeaStay::getHuespedActual() const {
-    return huespedLogueado;
+void GestorUdeaStay::invalidarBusquedas(int alojamiento, long diaEntrada, long diaSalida) {
+    if (alojamiento < 0 || !cacheBusquedas.estaActiva()) return;
+    cacheBusquedas.invalidar(aMinusculas(todosAlojamientos[alojamiento].getMunicipio()), diaEntrada, diaSalida);
 }
 
-bool GestorUdeaStay::haySesionAnfitrionActiva() const {
-    return anfitrionLogueado != nullptr;
-}
+void GestorUdeaStay::mostrarAlojamientosDisponibles(Fecha fecha, const string& municipio, int noches,
+                                                    double costoMax, double puntMinAnf, double costoTotalMax) {
+    incrementarContadorIteraciones();
+    shared_lock<shared_mutex> bloqueo(mutexDatos); // Varias búsquedas pueden correr a la vez
+
+    const long diaEntrada = fecha.aNumeroDia();
+    int* disponibles = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+    int encontrados = buscarAlojamientosDisponibles(diaEntrada, noches, municipio, disponibles,
+                                                    costoMax >= 0 ? llround(costoMax) : -1,
+                                                    costoTotalMax >= 0 ? llround(costoTotalMax) : -1);
+
+    lock_guard<mutex> salida(mutexConsola);
+    for (int k = 0; k < encontrados; ++k) {
+        todosAlojamientos[disponibles[k]].mostrarDetalles();
+        cout << "Costo de la estadía (" << noches << " noches): $"
+             << calcularCostoEstadia(disponibles[k], diaEntrada, diaEntrada + noches) << endl;
+        cout << endl;
+    }
+    delete[] disponibles;
 
+    if (encontrados == 0) {
+        cout << "No se encontraron alojamientos disponibles en ese rango de fechas.\n";
+    }
+}
 
-int GestorUdeaStay::obtenerIndiceReservacionActiva(const std::string& codigoBuscado) const {
-    for (int i = 0; i < cantidadReservaciones; ++i) {
-        const std::string& cod = todasReservaciones[i].getCodigo();
+/**
+ * @brief Responde desde la cache si la consulta (ya normalizada) está guardada; si no,
+ * la calcula y la guarda.
+ */
+int GestorUdeaStay::buscarAlojamientosDisponibles(long diaEntrada, int noches, const string& municipio,
+                                                  int* resultado, long long precioNocheMaximo,
+                                                  long long costoMaximo) const {
+    const long diaSalida = diaEntrada + noches;
+    string municipioNormalizado = municipio;
+    const string municipioBuscado = aMinusculas(trim(municipioNormalizado));
+    unsigned long long marca;
+    int guardados = cacheBusquedas.buscar(municipioBuscado, diaEntrada, diaSalida, precioNocheMaximo, costoMaximo,
+                                          resultado, marca);
+    if (guardados >= 0) {
+        incrementarContadorIteraciones();
+        return guardados;
+    }
+    int encontrados = calcularAlojamientosDisponibles(diaEntrada, diaSalida, municipioBuscado, precioNocheMaximo,
+                                                      costoMaximo, resultado);
+    // Un cambio que se invalidó mientras se calculaba (una reserva que devolvió noches
+    // con el candado compartido) hace que no se guarde
+    cacheBusquedas.guardar(municipioBuscado, diaEntrada, diaSalida, precioNocheMaximo, costoMaximo, resultado,
+                           encontrados, marca);
+    return encontrados;
+}
 
-        std::cout << "DEBUG_COMPARACION: [" << codigoBuscado << "] vs [" << cod << "]\n";
+/**
+ * @brief Busca en paralelo por bloques fijos de ALOJAMIENTOS_POR_BLOQUE posiciones.
+ * Cada bloque deja sus resultados al inicio de su propio tramo de 'resultado' (nadie
+ * más escribe ahí) y al final los tramos se juntan en orden de bloque, así que la
+ * respuesta sale en el orden del arreglo sin importar qué hilo evaluó cada bloque.
+ */
+int GestorUdeaStay::calcularAlojamientosDisponibles(long diaEntrada, long diaSalida, const string& municipioBuscado,
+                                                    long long precioNocheMaximo, long long costoMaximo,
+                                                    int* resultado) const {
+    const int bloques = (cantidadAlojamientos + ALOJAMIENTOS_POR_BLOQUE - 1) / ALOJAMIENTOS_POR_BLOQUE;
+    if (bloques <= 1 || poolBusqueda.getCantidadHilos() == 0) {
+        return filtrarAlojamientosDisponibles(0, cantidadAlojamientos, diaEntrada, diaSalida, municipioBuscado,
+                                              precioNocheMaximo, costoMaximo, resultado);
+    }
 
-        if (cod == codigoBuscado) {
-            return i;
-        }
+    int* encontradosPorBloque = new int[bloques];
+    poolBusqueda.ejecutarBloques(bloques, [&](int bloque) {
+        int desde = bloque * ALOJAMIENTOS_POR_BLOQUE;
+        int hasta = desde + ALOJAMIENTOS_POR_BLOQUE < cantidadAlojamientos ? desde + ALOJAMIENTOS_POR_BLOQUE
+                                                                           : cantidadAlojamientos;
+        encontradosPorBloque[bloque] = filtrarAlojamientosDisponibles(desde, hasta, diaEntrada, diaSalida,
+                                                                      municipioBuscado, precioNocheMaximo,
+                                                                      costoMaximo, resultado + desde);
+    });
+    int encontrados = 0;
+    for (int bloque = 0; bloque < bloques; ++bloque) {
+        // El destino nunca está después del origen: se puede mover hacia la izquierda en orden
+        memmove(resultado + encontrados, resultado + bloque * ALOJAMIENTOS_POR_BLOQUE,
+                static_cast<size_t>(encontradosPorBloque[bloque]) * sizeof(int));
+        encontrados += encontradosPorBloque[bloque];
     }
-    return -1;
+    delete[] encontradosPorBloque;
+    return encontrados;
 }
 
-Reservacion* GestorUdeaStay::encontrarReservacionActivaPorCodigo(const std::string& codigo) const {
-    for (int i = 0; i < cantidadReservaciones; ++i) {
-        if (todasReservaciones[i].getCodigo() == codigo && todasReservaciones[i].EstaActiva()) {
-            return &todasReservaciones[i];
+int GestorUdeaStay::filtrarAlojamientosDisponibles(int desde, int hasta, long diaEntrada, long diaSalida,
+                                                   const string& municipioBuscado, long long precioNocheMaximo,
+                                                   long long costoMaximo, int* resultado) const {
+    const bool filtraPrecio = precioNocheMaximo >= 0 || costoMaximo >= 0;
+    int encontrados = 0;
+    for (int i = desde; i < hasta; ++i) {
+        if (todosAlojamientos[i].estaRetirado()) {
+            continue;
+        }
+        if (!municipioBuscado.empty() && aMinusculas(todosAlojamientos[i].getMunicipio()) != municipioBuscado) {
+            continue;
+        }
+        if (filtraPrecio) {
+            // Costo exacto en O(1) con las sumas prefijas; promedio por noche sin dividir
+            long long costo = calcularCostoEstadia(i, diaEntrada, diaSalida);
+            if ((costoMaximo >= 0 && costo > costoMaximo) ||
+                (precioNocheMaximo >= 0 && costo > precioNocheMaximo * (diaSalida - diaEntrada))) {
+                continue;
+            }
+        }
+        if (calendarioOcupacion.estaLibre(i, diaEntrada, diaSalida)) {
+            resultado[encontrados++] = i;
         }
     }
-    return nullptr;
+    incrementarContadorIteraciones(hasta - desde); // por iteración individual
+    return encontrados;
 }
 
-Anfitrion* GestorUdeaStay::encontrarAnfitrionPorDocumento(const std::string& documento) const {
-    for (int i = 0; i < cantidadAnfitriones; ++i) {
-        if (todosAnfitriones[i].getDocumento() == documento) {
-            return &todosAnfitriones[i];
-        }
+/**
+ * @brief Por cada alojamiento recorre su calendario una vez, tramo libre por tramo libre
+ * (el calendario resuelve 64 noches por palabra). Un tramo libre [inicio, fin) con al
+ * menos 'noches' noches admite cualquier entrada entre inicio y fin - noches: se guarda
+ * como un solo resultado en lugar de una búsqueda por cada fecha candidata.
+ */
+int GestorUdeaStay::buscarVentanasDisponibles(long diaDesde, long diaHasta, int noches, const string& municipio,
+                                              VentanaLibre*& ventanas) const {
+    string municipioNormalizado = municipio;
+    const string municipioBuscado = aMinusculas(trim(municipioNormalizado));
+    int cantidad = 0;
+    int cupo = 16;
+    ventanas = new VentanaLibre[cupo];
+    if (noches <= 0) {
+        return 0;
     }
-    return nullptr;
-}
 
-std::string aMinusculas(const std::string& texto) {
-    std::string resultado = texto;
-    for (char& c : resultado) {
-        c = std::tolower(static_cast<unsigned char>(c));
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        if (todosAlojamientos[i].estaRetirado() ||
+            (!municipioBuscado.empty() && aMinusculas(todosAlojamientos[i].getMunicipio()) != municipioBuscado)) {
+            continue;
+        }
+        calendarioOcupacion.recorrerTramosLibres(i, diaDesde, diaHasta + 1, [&](long inicio, long fin) {
+            if (fin - inicio < noches) return;
+            if (cantidad == cupo) {
+                VentanaLibre* mas = new VentanaLibre[cupo * 2];
+                for (int k = 0; k < cantidad; ++k) mas[k] = ventanas[k];
+                delete[] ventanas;
+                ventanas = mas;
+                cupo *= 2;
+            }
+            ventanas[cantidad++] = VentanaLibre{i, inicio, fin - noches};
+        });
     }
-    return resultado;
+    incrementarContadorIteraciones(cantidadAlojamientos);
+    return cantidad;
 }
 
-void GestorUdeaStay::mostrarAlojamientosDisponibles(Fecha fecha, const string& municipio, int noches,
-                                                    double costoMax, double puntMinAnf) {
+void GestorUdeaStay::mostrarVentanasDisponibles(Fecha desde, Fecha hasta, int noches, const string& municipio) {
     incrementarContadorIteraciones();
-
-    Fecha fechaSalida = fecha.calcularFechaMasDuracion(noches);
-    bool seEncontroAlguno = false;
-
-    for (int i = 0; i < cantidadAlojamientos; ++i) {
-        const Alojamiento& aloja = todosAlojamientos[i];
-        bool estaOcupado = false;
-        for (int j = 0; j < cantidadReservaciones && !estaOcupado; ++j) {
-            const Reservacion& r = todasReservaciones[j];
-            if (r.EstaActiva() && r.getCodigoAlojamiento() == aloja.getCodigoID()) {
-                Fecha entradaExistente = r.getFechaEntrada();
-                Fecha salidaExistente = r.getFechaSalida();
-                if (!(fechaSalida.esMenor(entradaExistente) || fecha.esMayorOIgual(salidaExistente))) {
-                    estaOcupado = true;
-                }
-            }
+    shared_lock<shared_mutex> bloqueo(mutexDatos);
+    VentanaLibre* ventanas = nullptr;
+    int cantidad = buscarVentanasDisponibles(desde.aNumeroDia(), hasta.aNumeroDia(), noches, municipio, ventanas);
+
+    lock_guard<mutex> salida(mutexConsola);
+    for (int k = 0; k < cantidad; ++k) {
+        if (k == 0 || ventanas[k].alojamiento != ventanas[k - 1].alojamiento) {
+            todosAlojamientos[ventanas[k].alojamiento].mostrarDetalles();
         }
-
-        if (!estaOcupado) {
-            aloja.mostrarDetalles();
-            cout << endl;
-            seEncontroAlguno = true;
+        Fecha primera = Fecha::desdeNumeroDia(ventanas[k].primeraEntrada);
+        if (ventanas[k].primeraEntrada == ventanas[k].ultimaEntrada) {
+            cout << "  Entrada el " << primera.toString() << endl;
+        } else {
+            cout << "  Entrada entre el " << primera.toString() << " y el "
+                 << Fecha::desdeNumeroDia(ventanas[k].ultimaEntrada).toString() << endl;
         }
+    }
+    delete[] ventanas;
 
-        incrementarContadorIteraciones(); // por iteración individual
+    if (cantidad == 0) {
+        cout << "No hay alojamientos con " << noches << " noches libres seguidas en ese rango de fechas.\n";
     }
+}
 
-    if (!seEncontroAlguno) {
-        cout << "No se encontraron alojamientos disponibles en ese rango de fechas.\n";
+/**
+ * @brief Muestra las reservaciones activas del huésped de la sesión, en orden de entrada.
+ * Recorre solo la lista del huésped y ubica cada reservación con el índice por código.
+ * @return true si el huésped tiene al menos una reservación activa.
+ */
+bool GestorUdeaStay::mostrarReservacionesDelHuesped(const Sesion& sesion) const {
+    shared_lock<shared_mutex> bloqueo(mutexDatos);
+    lock_guard<mutex> registro(mutexRegistro); // Una reserva nueva puede estar anexando
+    const Huesped* h = sesion.getHuesped();
+    if (h == nullptr) {
+        cout << "ERROR: No hay ningún huésped con sesión iniciada.\n";
+        return false;
+    }
+    bool tieneActivas = false;
+    for (int i = 0; i < h->getCantidadReservaciones(); ++i) {
+        const Reservacion* r = encontrarReservacionActivaPorCodigo(h->getCodigoReservacion(i));
+        if (r != nullptr) {
+            r->mostrarComprobante();
+            cout << "              " << endl;
+            tieneActivas = true;
+        }
     }
+    return tieneActivas;
 }
 
 //Mostrar reservaciones del anfitrion
 
-void GestorUdeaStay::mostrarReservacionesDelAnfitrion(Fecha fechaDesde, Fecha fechaHasta) const {
+void GestorUdeaStay::mostrarReservacionesDelAnfitrion(const Sesion& sesion, Fecha fechaDesde, Fecha fechaHasta) const {
+    shared_lock<shared_mutex> bloqueo(mutexDatos);
+    lock_guard<mutex> registro(mutexRegistro); // Una reserva nueva puede estar anexando
+    const Anfitrion* anfitrionLogueado = sesion.getAnfitrion();
     if (anfitrionLogueado == nullptr) {
         cout << "ERROR: No hay ningún anfitrión con sesión iniciada.\n";
         return;
@@ -1283,30 +2677,555 @@ void GestorUdeaStay::mostrarReservacionesDelAnfitrion(Fecha fechaDesde, Fecha fe
          << " entre " << fechaDesde.toString() << " y " << fechaHasta.toString() << ":\n";
 
     bool seMostroAlguna = false;
+    const long diaDesde = fechaDesde.aNumeroDia();
+    const long diaHasta = fechaHasta.aNumeroDia();
+
+    // Solo se visitan los alojamientos del anfitrión (tramo CSR) y, en cada uno,
+    // las estadías que se cruzan con el rango (búsqueda binaria + recorrido contiguo).
+    const int anfitrion = obtenerPosicionAnfitrion(anfitrionLogueado);
+    for (int k = inicioAlojamientosDeAnfitrion[anfitrion]; k < inicioAlojamientosDeAnfitrion[anfitrion + 1]; ++k) {
+        agendaAlojamientos.recorrerCruces(alojamientosDeAnfitrion[k], diaDesde, diaHasta,
+                                          [&](const AgendaAlojamientos::Estadia& estadia) {
+                                              const int* indice = indiceReservacionesPorCodigo.buscar(estadia.codigoReservacion);
+                                              if (indice == nullptr) return;
+                                              todasReservaciones[*indice].mostrarComprobante();
+                                              cout << "--------------------------------------\n";
+                                              seMostroAlguna = true;
+                                          });
+    }
 
-    for (int i = 0; i < cantidadReservaciones; ++i) {
-        const Reservacion& r = todasReservaciones[i];
-        if (!r.EstaActiva()) continue;
+    if (!seMostroAlguna) {
+        cout << "No se encontraron reservaciones activas en ese intervalo para este anfitrión.\n";
+    }
+}
+
+// --- Consultas al histórico ---
+
+// Adapta una reservación decodificada del histórico particionado al formato de consulta.
+static RegistroHistorico aRegistroHistorico(const Reservacion& r) {
+    return RegistroHistorico{r.toFileString(), r.getCodigo(), r.getCodigoAlojamiento(),
+                             r.getDocumentoHuesped(), r.getDiaEntrada(), r.getDiaSalida()};
+}
+
+/**
+ * @brief Muestra un registro del histórico en una sola línea.
+ * Formato: código | alojamiento | huésped | entrada -> salida | monto | anotaciones
+ */
+void GestorUdeaStay::mostrarRegistroHistorico(const RegistroHistorico& registro) {
+    const int NUM_CAMPOS = 10;
+    string campos[NUM_CAMPOS];
+    int camposLeidos = parsearLineaCSVInterno(registro.linea, campos, NUM_CAMPOS);
+
+    cout << registro.codigoReservacion << " | " << registro.codigoAlojamiento
+         << " | Huésped " << registro.documentoHuesped
+         << " | " << Fecha::desdeNumeroDia(registro.diaEntrada).toString()
+         << " -> " << Fecha::desdeNumeroDia(registro.diaSalida).toString();
+    if (camposLeidos == NUM_CAMPOS) {
+        cout << " | $" << campos[7];
+        if (!campos[8].empty()) cout << " | " << campos[8];
+    }
+    cout << "\n";
+}
+
+/**
+ * @brief Muestra las estadías archivadas de un alojamiento que se cruzan con el rango dado.
+ */
+void GestorUdeaStay::consultarHistoricoDeAlojamiento(const string& codigoAlojamiento, Fecha fechaDesde, Fecha fechaHasta) {
+    incrementarContadorIteraciones();
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    int encontradas = 0;
+    if (historicoParticionado) {
+        almacenHistorico.consultarPorAlojamiento(codigoAlojamiento, fechaDesde.aNumeroDia(), fechaHasta.aNumeroDia(),
+                                                 [&](const Reservacion& r) {
+                                                     mostrarRegistroHistorico(aRegistroHistorico(r));
+                                                     encontradas++;
+                                                 });
+        AlmacenHistorico::EstadisticaConsulta est = almacenHistorico.getUltimaConsulta();
+        incrementarContadorIteraciones(est.registrosEncontrados);
+        cout << encontradas << " estadías en el histórico para " << codigoAlojamiento
+             << " (segmentos leídos: " << est.segmentosLeidos << ", omitidos: " << est.segmentosOmitidos;
+        if (est.segmentosConError > 0) cout << ", dañados: " << est.segmentosConError;
+        cout << ")." << endl;
+        return;
+    }
+    indiceHistorico.consultarPorAlojamiento(codigoAlojamiento, fechaDesde.aNumeroDia(), fechaHasta.aNumeroDia(),
+                                            [&](const RegistroHistorico& registro) {
+                                                mostrarRegistroHistorico(registro);
+                                                encontradas++;
+                                            });
+    IndiceHistorico::EstadisticaConsulta est = indiceHistorico.getUltimaConsulta();
+    incrementarContadorIteraciones(est.registrosExaminados);
+    cout << encontradas << " estadías en el histórico para " << codigoAlojamiento
+         << " (bloques leídos: " << est.bloquesLeidos << " de " << est.bloquesTotales << ")." << endl;
+}
+
+/**
+ * @brief Muestra las estadías archivadas de todos los alojamientos del anfitrión logueado.
+ */
+void GestorUdeaStay::consultarHistoricoDelAnfitrion(const Sesion& sesion, Fecha fechaDesde, Fecha fechaHasta) {
+    const Anfitrion* anfitrionLogueado = sesion.getAnfitrion();
+    if (anfitrionLogueado == nullptr) {
+        cout << "ERROR: No hay ningún anfitrión con sesión iniciada.\n";
+        return;
+    }
+    shared_lock<shared_mutex> lectura(mutexDatos); // Antes que mutexHistorico (ver su declaración)
+    const int anfitrion = obtenerPosicionAnfitrion(anfitrionLogueado);
+    for (int k = inicioAlojamientosDeAnfitrion[anfitrion]; k < inicioAlojamientosDeAnfitrion[anfitrion + 1]; ++k) {
+        incrementarContadorIteraciones();
+        consultarHistoricoDeAlojamiento(todosAlojamientos[alojamientosDeAnfitrion[k]].getCodigoID(), fechaDesde, fechaHasta);
+    }
+}
+
+/**
+ * @brief Muestra las estadías archivadas del huésped logueado dentro del rango dado.
+ * Usa los rangos de fechas de los bloques para leer solo los que pueden contenerlas.
+ */
+void GestorUdeaStay::consultarHistoricoDelHuesped(const Sesion& sesion, Fecha fechaDesde, Fecha fechaHasta) {
+    const Huesped* huespedLogueado = sesion.getHuesped();
+    if (huespedLogueado == nullptr) {
+        cout << "ERROR: No hay ningún huésped con sesión iniciada.\n";
+        return;
+    }
+    incrementarContadorIteraciones();
+    lock_guard<mutex> bloqueo(mutexHistorico);
+    const string documento = huespedLogueado->getDocumento();
+    int encontradas = 0;
+    if (historicoParticionado) {
+        almacenHistorico.consultarPorRango(fechaDesde.aNumeroDia(), fechaHasta.aNumeroDia(),
+                                           [&](const Reservacion& r) {
+                                               if (r.getDocumentoHuesped() == documento) {
+                                                   mostrarRegistroHistorico(aRegistroHistorico(r));
+                                                   encontradas++;
+                                               }
+                                           });
+        AlmacenHistorico::EstadisticaConsulta est = almacenHistorico.getUltimaConsulta();
+        incrementarContadorIteraciones(est.registrosEncontrados);
+        cout << encontradas << " estadías pasadas encontradas (particiones leídas: " << est.particionesLeidas
+             << " de " << est.particionesTotales << ")." << endl;
+        return;
+    }
+    indiceHistorico.consultarPorRango(fechaDesde.aNumeroDia(), fechaHasta.aNumeroDia(),
+                                      [&](const RegistroHistorico& registro) {
+                                          if (registro.documentoHuesped == documento) {
+                                              mostrarRegistroHistorico(registro);
+                                              encontradas++;
+                                          }
+                                      });
+    IndiceHistorico::EstadisticaConsulta est = indiceHistorico.getUltimaConsulta();
+    incrementarContadorIteraciones(est.registrosExaminados);
+    cout << encontradas << " estadías pasadas encontradas (bloques leídos: " << est.bloquesLeidos
+         << " de " << est.bloquesTotales << ")." << endl;
+}
+
+// --- Modo servidor ---
+
+// Divide una solicitud en campos separados por '|'. El último campo conserva
+// cualquier '|' restante. Devuelve la cantidad de campos.
+static int dividirSolicitud(const string& solicitud, string campos[], int maximo) {
+    int cantidad = 0;
+    size_t inicio = 0;
+    while (cantidad < maximo - 1) {
+        size_t separador = solicitud.find('|', inicio);
+        if (separador == string::npos) break;
+        campos[cantidad++] = solicitud.substr(inicio, separador - inicio);
+        inicio = separador + 1;
+    }
+    campos[cantidad++] = solicitud.substr(inicio);
+    return cantidad;
+}
+
+// Entero positivo escrito solo con dígitos (sin signo ni espacios).
+static bool leerEnteroPositivo(const string& texto, int& valor) {
+    if (texto.empty() || texto.size() > 6) return false;
+    valor = 0;
+    for (char c : texto) {
+        if (c < '0' || c > '9') return false;
+        valor = valor * 10 + (c - '0');
+    }
+    return valor > 0;
+}
+
+// Tope de precio opcional en pesos: vacío = sin tope (-1); si no, solo dígitos.
+static bool leerTopePrecio(const string& texto, long long& tope) {
+    tope = -1;
+    if (texto.empty()) return true;
+    if (texto.size() > 15) return false;
+    tope = 0;
+    for (char c : texto) {
+        if (c < '0' || c > '9') return false;
+        tope = tope * 10 + (c - '0');
+    }
+    return true;
+}
+
+// Fecha en formato dd/mm/aaaa; false si el formato o la fecha no son válidos.
+static bool leerFechaSolicitud(const string& texto, Fecha& fecha) {
+    return leerFecha(texto, fecha) == LECTURA_CORRECTA;
+}
+
+/**
+ * @brief Atiende una solicitud del protocolo del servidor.
+ * Órdenes (campos separados por '|'):
+ *   LOGIN|HUESPED|<id>|<clave>     LOGIN|ANFITRION|<id>|<clave>     LOGOUT
+ *   BUSCAR|<dd/mm/aaaa>|<noches>[|<municipio>[|<precioNocheMax>[|<costoTotalMax>]]]
+ *       -> "* codigo|nombre|municipio|departamento|tipo|precioPorNoche|costoEstadia" por alojamiento
+ *          libre; los topes son opcionales (vacío = sin tope) y el de la noche es sobre el promedio
+ *   BUSCARFLEX|<desde dd/mm/aaaa>|<hasta dd/mm/aaaa>|<noches>[|<municipio>]
+ *       -> "* codigo|nombre|municipio|precioPorNoche|primeraEntrada|ultimaEntrada" por tramo libre
+ *   RESERVAR|<alojamiento>|<dd/mm/aaaa>|<noches>|<metodoPago>[|<anotaciones>]  -> "OK <código>"
+ *   ANULAR|<código>
+ *   RESERVAS   -> "* <línea CSV>" por reservación activa del usuario (huésped o anfitrión)
+ *   ESTADO
+ * Toda respuesta termina con una línea "OK ..." o "ERR ..."; en RESERVAR y ANULAR el
+ * "ERR" lleva el motivo que dio la operación. Un LOGIN fallido no dice si el ID existe.
+ */
+string GestorUdeaStay::atenderSolicitud(Sesion& sesion, const string& solicitud) {
+    incrementarContadorIteraciones();
+    const int MAX_CAMPOS = 6;
+    string campos[MAX_CAMPOS];
+    const int n = dividirSolicitud(solicitud, campos, MAX_CAMPOS);
+    const string& orden = campos[0];
+
+    if (orden == "LOGIN") {
+        if (n != 4 || (campos[1] != "HUESPED" && campos[1] != "ANFITRION")) {
+            return "ERR Uso: LOGIN|HUESPED|<id>|<clave> o LOGIN|ANFITRION|<id>|<clave>\n";
+        }
+        sesion.cerrar();
+        bool valido = campos[1] == "HUESPED" ? intentarLoginHuesped(sesion, campos[2], campos[3])
+                                             : intentarLoginAnfitrion(sesion, campos[2], campos[3]);
+        if (!valido) {
+            return "ERR Credenciales inválidas\n";
+        }
+        return "OK " + (sesion.esHuesped() ? sesion.getHuesped()->getNombre() : sesion.getAnfitrion()->getNombre()) + "\n";
+    }
+    if (orden == "LOGOUT") {
+        sesion.cerrar();
+        return "OK Sesión cerrada\n";
+    }
+    if (orden == "ESTADO") {
+        shared_lock<shared_mutex> bloqueo(mutexDatos);
+        lock_guard<mutex> registro(mutexRegistro);
+        string estado = "OK alojamientos=" + to_string(cantidadAlojamientos - cantidadAlojamientosRetirados) +
+                        " alojamientosRetirados=" + to_string(cantidadAlojamientosRetirados) +
+                        " recargasAlojamientos=" + to_string(recargasAlojamientos) + " reservaciones=" +
+                        to_string(agendaAlojamientos.getCantidadEstadias()) + " iteraciones=" +
+                        to_string(contadorIteracionesGlobal.load());
+        CalendarioOcupacion::Metricas calendario = calendarioOcupacion.getMetricas();
+        estado += " reclamos=" + to_string(calendario.reclamos) + " conflictos=" + to_string(calendario.conflictos) +
+                  " reversiones=" + to_string(calendario.reversiones) + " reintentosCAS=" + to_string(calendario.reintentos);
+        PoolHilos::Metricas pool = poolBusqueda.getMetricas();
+        estado += " hilosBusqueda=" + to_string(pool.hilos + 1) + " bloquesBusqueda=" + to_string(pool.bloques) +
+                  " bloquesRobados=" + to_string(pool.robados);
+        CacheBusquedas::Metricas cache = cacheBusquedas.getMetricas();
+        estado += " cacheAciertos=" + to_string(cache.aciertos) + " cacheFallos=" + to_string(cache.fallos) +
+                  " cacheInvalidadas=" + to_string(cache.invalidadas) + " cacheDesalojadas=" +
+                  to_string(cache.desalojadas) + " cacheBytes=" + to_string(cache.bytes);
+        if (diarioReservaciones.estaAbierto()) {
+            EscritorGrupal::Metricas m = diarioReservaciones.getMetricas();
+            estado += " diarioRegistros=" + to_string(m.registros) + " diarioLotes=" + to_string(m.lotes) +
+                      " diarioLoteMaximo=" + to_string(m.loteMaximo) +
+                      " diarioLatenciaPromedioUs=" + to_string(static_cast<long>(m.latenciaPromedioMicros)) +
+                      " diarioLatenciaMaximaUs=" + to_string(static_cast<long>(m.latenciaMaximaMicros));
+        }
+        estado += " cambiosPublicados=" + to_string(canalCambios.getPublicados());
+        for (int i = 0; i < cantidadDrenadoresCambios; ++i) {
+            DrenadorCambios::Metricas m = drenadoresCambios[i]->getMetricas();
+            const string sufijo = to_string(i + 1) + "=";
+            estado += " cambiosEscritos" + sufijo + to_string(m.escritos) + " cambiosPerdidos" + sufijo +
+                      to_string(m.perdidos) + " cambiosDescartados" + sufijo + to_string(m.descartados);
+        }
+        return estado + "\n";
+    }
+    if (orden == "BUSCAR") {
+        Fecha fecha;
+        int noches;
+        long long precioNocheMaximo, costoMaximo;
+        if (n < 3 || !leerFechaSolicitud(campos[1], fecha) || !leerEnteroPositivo(campos[2], noches) ||
+            !leerTopePrecio(campos[4], precioNocheMaximo) || !leerTopePrecio(campos[5], costoMaximo)) {
+            return "ERR Uso: BUSCAR|<dd/mm/aaaa>|<noches>[|<municipio>[|<precioNocheMax>[|<costoTotalMax>]]]\n";
+        }
+        const long diaEntrada = fecha.aNumeroDia();
+        string respuesta;
+        shared_lock<shared_mutex> bloqueo(mutexDatos);
+        int* disponibles = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+        int encontrados = buscarAlojamientosDisponibles(diaEntrada, noches, campos[3], disponibles,
+                                                        precioNocheMaximo, costoMaximo);
+        for (int k = 0; k < encontrados; ++k) {
+            const Alojamiento& a = todosAlojamientos[disponibles[k]];
+            respuesta += "* " + a.getCodigoID() + "|" + a.getNombre() + "|" + a.getMunicipio() + "|" +
+                         a.getDepartamento() + "|" + a.getTipoAlojamiento() + "|" +
+                         to_string(static_cast<long long>(a.getPrecioPorNoche())) + "|" +
+                         to_string(calcularCostoEstadia(disponibles[k], diaEntrada, diaEntrada + noches)) + "\n";
+        }
+        delete[] disponibles;
+        return respuesta + "OK " + to_string(encontrados) + " disponibles\n";
+    }
+    if (orden == "BUSCARFLEX") {
+        Fecha desde, hasta;
+        int noches;
+        if ((n != 4 && n != 5) || !leerFechaSolicitud(campos[1], desde) || !leerFechaSolicitud(campos[2], hasta) ||
+            !leerEnteroPositivo(campos[3], noches)) {
+            return "ERR Uso: BUSCARFLEX|<desde dd/mm/aaaa>|<hasta dd/mm/aaaa>|<noches>[|<municipio>]\n";
+        }
+        string respuesta;
+        shared_lock<shared_mutex> bloqueo(mutexDatos);
+        VentanaLibre* ventanas = nullptr;
+        int cantidad = buscarVentanasDisponibles(desde.aNumeroDia(), hasta.aNumeroDia(), noches,
+                                                 n == 5 ? campos[4] : "", ventanas);
+        for (int k = 0; k < cantidad; ++k) {
+            const Alojamiento& a = todosAlojamientos[ventanas[k].alojamiento];
+            respuesta += "* " + a.getCodigoID() + "|" + a.getNombre() + "|" + a.getMunicipio() + "|" +
+                         to_string(static_cast<long long>(a.getPrecioPorNoche())) + "|" +
+                         Fecha::desdeNumeroDia(ventanas[k].primeraEntrada).toString() + "|" +
+                         Fecha::desdeNumeroDia(ventanas[k].ultimaEntrada).toString() + "\n";
+        }
+        delete[] ventanas;
+        return respuesta + "OK " + to_string(cantidad) + " tramos libres\n";
+    }
+    if (orden == "RESERVAR") {
+        Fecha fecha;
+        int noches;
+        if ((n != 5 && n != 6) || !leerFechaSolicitud(campos[2], fecha) || !leerEnteroPositivo(campos[3], noches)) {
+            return "ERR Uso: RESERVAR|<alojamiento>|<dd/mm/aaaa>|<noches>|<metodoPago>[|<anotaciones>]\n";
+        }
+        if (!sesion.esHuesped()) {
+            return "ERR Solo un huésped con sesión iniciada puede reservar\n";
+        }
+        string codigo, error;
+        if (!crearNuevaReservacion(sesion, campos[1], fecha, noches, campos[4], n == 6 ? campos[5] : "", &codigo,
+                                   &error)) {
+            return "ERR " + error + "\n";
+        }
+        return "OK " + codigo + "\n";
+    }
+    if (orden == "ANULAR") {
+        if (n != 2) {
+            return "ERR Uso: ANULAR|<código>\n";
+        }
+        string error;
+        if (!cancelarUnaReservacion(sesion, campos[1], &error)) {
+            return "ERR " + error + "\n";
+        }
+        return "OK Reservación anulada\n";
+    }
+    if (orden == "RESERVAS") {
+        string respuesta;
+        int cantidad = 0;
+        shared_lock<shared_mutex> bloqueo(mutexDatos);
+        lock_guard<mutex> registro(mutexRegistro);
+        if (sesion.esHuesped()) {
+            const Huesped* h = sesion.getHuesped();
+            for (int i = 0; i < h->getCantidadReservaciones(); ++i) {
+                const Reservacion* r = encontrarReservacionActivaPorCodigo(h->getCodigoReservacion(i));
+                if (r != nullptr) {
+                    respuesta += "* " + r->toFileString() + "\n";
+                    cantidad++;
+                }
+            }
+        } else if (sesion.esAnfitrion()) {
+            const int anfitrion = obtenerPosicionAnfitrion(sesion.getAnfitrion());
+            for (int k = inicioAlojamientosDeAnfitrion[anfitrion]; k < inicioAlojamientosDeAnfitrion[anfitrion + 1]; ++k) {
+                const int alojamiento = alojamientosDeAnfitrion[k];
+                agendaAlojamientos.recorrerCruces(alojamiento, 0, numeric_limits<long>::max(),
+                                                  [&](const AgendaAlojamientos::Estadia& estadia) {
+                                                      const int* indice = indiceReservacionesPorCodigo.buscar(estadia.codigoReservacion);
+                                                      if (indice == nullptr) return;
+                                                      respuesta += "* " + todasReservaciones[*indice].toFileString() + "\n";
+                                                      cantidad++;
+                                                  });
+            }
+        } else {
+            return "ERR No hay ninguna sesión iniciada\n";
+        }
+        return respuesta + "OK " + to_string(cantidad) + " reservaciones activas\n";
+    }
+    return "ERR Orden desconocida: " + orden + "\n";
+}
+
+// --- Concurrencia y prueba de estrés ---
+
+void GestorUdeaStay::setPersistirCambios(bool persistir) {
+    lock_guard<mutex> escritura(mutexEscritores);
+    lock_guard<shared_mutex> bloqueo(mutexDatos);
+    persistirCambios = persistir;
+}
 
-        const Alojamiento* aloj = encontrarAlojamientoPorCodigo(r.getCodigoAlojamiento());
-        if (aloj == nullptr) continue;
+void GestorUdeaStay::setPresupuestoCacheBusquedas(size_t bytes) {
+    cacheBusquedas.setPresupuesto(bytes);
+}
 
-        if (aloj->getAnfitrionResponsableID() != anfitrionLogueado->getId()) continue;
+void GestorUdeaStay::setHilosDeBusqueda(int hilos) {
+    lock_guard<shared_mutex> bloqueo(mutexDatos); // Ninguna búsqueda en curso mientras se cambian los hilos
+    poolBusqueda.iniciar(hilos > 1 ? hilos - 1 : 0);
+}
 
-        Fecha entrada = r.getFechaEntrada();
-        Fecha salida = r.getFechaSalida();
+// Estadía de una reservación activa agrupada por alojamiento o por huésped.
+struct EstadiaAgrupada {
+    int grupo;
+    long diaEntrada;
+    long diaSalida;
+};
 
-        // Mostrar si hay solapamiento de fechas
-        if (!(fechaHasta.esMenor(entrada) || fechaDesde.esMayorOIgual(salida))) {
-            r.mostrarComprobante();
-            cout << "--------------------------------------\n";
-            seMostroAlguna = true;
+/**
+ * @brief Cuenta las estadías que comparten al menos una noche con otra del mismo grupo.
+ * Ordena por (grupo, entrada) y recorre una vez guardando la salida más lejana del grupo.
+ */
+static long contarNochesDobles(EstadiaAgrupada* estadias, int cantidad) {
+    sort(estadias, estadias + cantidad, [](const EstadiaAgrupada& a, const EstadiaAgrupada& b) {
+        return a.grupo != b.grupo ? a.grupo < b.grupo : a.diaEntrada < b.diaEntrada;
+    });
+    long dobles = 0;
+    long salidaMaxima = 0;
+    for (int i = 0; i < cantidad; ++i) {
+        if (i > 0 && estadias[i].grupo == estadias[i - 1].grupo && estadias[i].diaEntrada < salidaMaxima) {
+            dobles++;
+        }
+        if (i == 0 || estadias[i].grupo != estadias[i - 1].grupo || estadias[i].diaSalida > salidaMaxima) {
+            salidaMaxima = estadias[i].diaSalida;
         }
     }
+    return dobles;
+}
 
-    if (!seMostroAlguna) {
-        cout << "No se encontraron reservaciones activas en ese intervalo para este anfitrión.\n";
+// Descarta todo lo que se escribe (silencia los mensajes de los hilos de la prueba).
+class BufferNulo : public streambuf {
+protected:
+    int overflow(int c) override { return c == EOF ? 0 : c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+/**
+ * @brief Prueba de estrés de la concurrencia del gestor.
+ * Cada hilo actúa como un huésped con su propia Sesion y hace una mezcla de reservas
+ * (60%), búsquedas (30%) y anulaciones (10%) sobre pocos alojamientos y una ventana
+ * corta de fechas, para forzar la contención. Al final verifica, con un barrido
+ * ordenado independiente de las agendas, que ninguna noche quedó reservada dos veces
+ * en un alojamiento ni para un huésped, y que la agenda coincide con las activas.
+ * Desactiva la persistencia: los datos de prueba nunca llegan a los archivos.
+ * @return true si no aparecieron noches dobles nuevas y los índices son consistentes.
+ */
+bool GestorUdeaStay::ejecutarPruebaDeEstres(int hilos, int operacionesPorHilo) {
+    if (hilos <= 0 || operacionesPorHilo <= 0 || cantidadAlojamientos == 0 || huespedes.getCantidad() == 0) {
+        cerr << "Error [GestorUdeaStay]: La prueba de estrés necesita hilos, operaciones, alojamientos y huéspedes." << endl;
+        return false;
     }
+    setPersistirCambios(false);
+
+    // Cuenta noches dobles por alojamiento y por huésped (requiere mutexDatos tomado).
+    auto contarDobles = [this](long& porAlojamiento, long& porHuesped) {
+        EstadiaAgrupada* estadias = new EstadiaAgrupada[cantidadReservaciones > 0 ? cantidadReservaciones : 1];
+        int n = 0;
+        for (int i = 0; i < cantidadReservaciones; ++i) {
+            const Reservacion& r = todasReservaciones[i];
+            if (!r.EstaActiva()) continue;
+            estadias[n++] = EstadiaAgrupada{obtenerIndiceAlojamiento(r.getCodigoAlojamiento()), r.getDiaEntrada(), r.getDiaSalida()};
+        }
+        porAlojamiento = contarNochesDobles(estadias, n);
+        n = 0;
+        for (int i = 0; i < cantidadReservaciones; ++i) {
+            const Reservacion& r = todasReservaciones[i];
+            const int huesped = indiceHuespedesPorDocumento.buscar(r.getDocumentoHuesped());
+            if (!r.EstaActiva() || huesped < 0) continue;
+            estadias[n++] = EstadiaAgrupada{huesped, r.getDiaEntrada(), r.getDiaSalida()};
+        }
+        porHuesped = contarNochesDobles(estadias, n);
+        delete[] estadias;
+        return n;
+    };
+
+    long doblesAlojamientoAntes, doblesHuespedAntes;
+    {
+        shared_lock<shared_mutex> bloqueo(mutexDatos);
+        lock_guard<mutex> registro(mutexRegistro);
+        contarDobles(doblesAlojamientoAntes, doblesHuespedAntes);
+    }
+
+    const int alojamientosEnJuego = cantidadAlojamientos < 4 ? cantidadAlojamientos : 4;
+    const long diaBase = Fecha::hoy().aNumeroDia() + 400; // Lejos de los datos reales
+    const int ventanaDias = 60;
+    atomic<long> creadas(0), rechazadas(0), anuladas(0), busquedas(0);
+
+    cout << "Prueba de estrés: " << hilos << " hilos x " << operacionesPorHilo << " operaciones sobre "
+         << alojamientosEnJuego << " alojamientos y " << ventanaDias << " días..." << endl;
+    BufferNulo bufferNulo;
+    streambuf* salidaOriginal = cout.rdbuf(&bufferNulo);
+    streambuf* erroresOriginal = cerr.rdbuf(&bufferNulo);
+    auto inicio = chrono::steady_clock::now();
+
+    thread* trabajadores = new thread[hilos];
+    for (int t = 0; t < hilos; ++t) {
+        trabajadores[t] = thread([&, t]() {
+            Sesion sesion;
+            Huesped* huesped = obtenerHuesped(t % huespedes.getCantidad());
+            sesion.iniciarComoHuesped(huesped);
+            mt19937 azar(20250u + static_cast<unsigned>(t));
+            for (int op = 0; op < operacionesPorHilo; ++op) {
+                int tipo = static_cast<int>(azar() % 10);
+                Fecha entrada = Fecha::desdeNumeroDia(diaBase + static_cast<long>(azar() % ventanaDias));
+                int noches = 1 + static_cast<int>(azar() % 5);
+                if (tipo < 6) {
+                    const string& codigo = todosAlojamientos[azar() % alojamientosEnJuego].getCodigoID();
+                    if (crearNuevaReservacion(sesion, codigo, entrada, noches, "PSE", "prueba de estres")) {
+                        creadas++;
+                    } else {
+                        rechazadas++;
+                    }
+                } else if (tipo < 9) {
+                    mostrarAlojamientosDisponibles(entrada, "", noches);
+                    busquedas++;
+                } else {
+                    string codigo;
+                    {
+                        shared_lock<shared_mutex> bloqueo(mutexDatos);
+                        lock_guard<mutex> registro(mutexRegistro);
+                        if (huesped->getCantidadReservaciones() > 0) {
+                            codigo = huesped->getCodigoReservacion(static_cast<int>(azar() % huesped->getCantidadReservaciones()));
+                        }
+                    }
+                    if (!codigo.empty() && cancelarUnaReservacion(sesion, codigo)) {
+                        anuladas++;
+                    }
+                }
+            }
+        });
+    }
+    for (int t = 0; t < hilos; ++t) {
+        trabajadores[t].join();
+    }
+    delete[] trabajadores;
+
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    cout.rdbuf(salidaOriginal);
+    cerr.rdbuf(erroresOriginal);
+
+    long doblesAlojamiento, doblesHuesped, activas;
+    long long enAgendas;
+    {
+        shared_lock<shared_mutex> bloqueo(mutexDatos);
+        lock_guard<mutex> registro(mutexRegistro);
+        contarDobles(doblesAlojamiento, doblesHuesped);
+        activas = 0;
+        for (int i = 0; i < cantidadReservaciones; ++i) {
+            if (todasReservaciones[i].EstaActiva() && obtenerIndiceAlojamiento(todasReservaciones[i].getCodigoAlojamiento()) >= 0) {
+                activas++;
+            }
+        }
+        enAgendas = agendaAlojamientos.getCantidadEstadias();
+    }
+
+    long operaciones = static_cast<long>(hilos) * operacionesPorHilo;
+    cout << "Reservas creadas: " << creadas << ", rechazadas por cruce: " << rechazadas
+         << ", anuladas: " << anuladas << ", búsquedas: " << busquedas << endl;
+    cout << "Tiempo: " << segundos << " s (" << static_cast<long>(operaciones / (segundos > 0 ? segundos : 1))
+         << " operaciones/s)" << endl;
+    cout << "Noches dobles por alojamiento: " << doblesAlojamiento << " (antes: " << doblesAlojamientoAntes << ")" << endl;
+    cout << "Noches dobles por huésped: " << doblesHuesped << " (antes: " << doblesHuespedAntes << ")" << endl;
+    cout << "Estadías en agendas: " << enAgendas << ", reservaciones activas: " << activas << endl;
+
+    bool correcto = doblesAlojamiento == doblesAlojamientoAntes && doblesHuesped == doblesHuespedAntes &&
+                    enAgendas == activas;
+    cout << (correcto ? "Resultado: CORRECTO" : "Resultado: FALLÓ") << endl;
+    return correcto;
 }
 
 // TODO: Implementar el resto de los métodos declarados en GestorUdeaStay.h
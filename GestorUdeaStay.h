@@ -1,11 +1,36 @@
 #ifndef GESTOR_UDEASTAY_H
 #define GESTOR_UDEASTAY_H
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <condition_variable>
 #include "Fecha.h"
 #include "Alojamiento.h"
 #include "Reservacion.h"
 #include "Anfitrion.h"
 #include "Huesped.h"
+#include "generadorcodigos.h"
+#include "tablahash.h"
+#include "colavencimientos.h"
+#include "indicehistorico.h"
+#include "almacenhistorico.h"
+#include "agendaalojamientos.h"
+#include "calendarioocupacion.h"
+#include "sesion.h"
+#include "escritorgrupal.h"
+#include "poolhilos.h"
+#include "cachebusquedas.h"
+#include "tarifastemporada.h"
+#include "bufercsv.h"
+#include "lecturacampos.h"
+#include "registrobajodemanda.h"
+#include "indiceclaves.h"
+#include "canalcambios.h"
+#include "drenadorcambios.h"
+#include "vigilantearchivos.h"
+#include "analiticaocupacion.h"
 
 class GestorUdeaStay {
 private:
@@ -15,25 +40,51 @@ private:
     Alojamiento* todosAlojamientos;
     int cantidadAlojamientos;
     int cupoAlojamientos;
+    // Índice código -> posición en todosAlojamientos
+    TablaHash<int> indiceAlojamientosPorCodigo;
+    // Reservaciones activas de cada alojamiento, ordenadas por día de entrada
+    AgendaAlojamientos agendaAlojamientos;
+    // Noches ocupadas de cada alojamiento (bits atómicos): es lo que decide si una
+    // reserva entra, sin candado exclusivo (ver crearNuevaReservacion)
+    CalendarioOcupacion calendarioOcupacion;
+    // Precio de cada noche por temporada (Tarifas.csv); sin reglas, el precio base
+    TarifasTemporada tarifasTemporada;
     Reservacion* todasReservaciones; // Solo reservaciones activas
     int cantidadReservaciones;
     int cupoReservaciones;
+    // Índice código -> posición en todasReservaciones (evita recorridos lineales)
+    TablaHash<int> indiceReservacionesPorCodigo;
+    // Reservaciones en memoria ordenadas por día de salida (para archivar)
+    ColaVencimientos colaVencimientos;
+    // Reservaciones rechazadas por la revisión de integridad de la carga (líneas CSV
+    // con el problema), pendientes de guardar en archivoReservacionesRechazadas
+    BuferCSV reservacionesRechazadas;
 
-    Anfitrion* todosAnfitriones;
-    int cantidadAnfitriones;
-    int cupoAnfitriones;
+    // Anfitriones y huéspedes por posición en su archivo. Con usuariosBajoDemanda al
+    // iniciar solo se indexan sus archivos y cada uno se lee la primera vez que se usa
+    // (login o una reservación suya); ver obtenerAnfitrion / obtenerHuesped.
+    bool usuariosBajoDemanda;
+    RegistroBajoDemanda<Anfitrion> anfitriones;
+    // Índice ID -> posición en anfitriones
+    IndiceClaves indiceAnfitrionesPorId;
+    // Adyacencia anfitrión -> alojamientos en formato CSR: los alojamientos del
+    // anfitrión i son alojamientosDeAnfitrion[inicioAlojamientosDeAnfitrion[i] .. inicio[i + 1])
+    int* inicioAlojamientosDeAnfitrion;
+    int* alojamientosDeAnfitrion;
 
-    Huesped* todosHuespedes;
-    int cantidadHuespedes;
-    int cupoHuespedes;
+    RegistroBajoDemanda<Huesped> huespedes;
+    // Índices ID (login) y documento (reservaciones) -> posición en huespedes
+    // (IndiceClaves: compactos, para bases de usuarios grandes)
+    IndiceClaves indiceHuespedesPorId;
+    IndiceClaves indiceHuespedesPorDocumento;
 
-    // Información de la sesión actual
-    Anfitrion* anfitrionLogueado;
-    Huesped* huespedLogueado;
+    // Sesión del menú interactivo de consola. Las operaciones reciben la sesión como
+    // parámetro, así que otros usuarios (hilos, conexiones) usan la suya propia.
+    Sesion sesionConsola;
     void manejarMenuAnfitrion();
     void manejarMenuHuesped();
     // Para medir el rendimiento
-    unsigned long long contadorIteracionesGlobal; // Un contador general de operaciones
+    mutable std::atomic<unsigned long long> contadorIteracionesGlobal; // Un contador general de operaciones (atómico: lo suman varios hilos)
     // La memoria se calculará bajo demanda o se actualizará en puntos clave
 
     // Nombres de los archivos de datos
@@ -42,12 +93,107 @@ private:
     const std::string archivoHuespedes = "Huespedes.csv";
     const std::string archivoReservaciones = "Reservaciones.csv";
     const std::string archivoHistorico = "Historico.csv";
+    const std::string archivoSecuenciaReservaciones = "SecuenciaReservaciones.txt";
+    const std::string archivoIndiceHistorico = "Historico.idx";
+    const std::string directorioHistoricoParticionado = "historico";
+    const std::string archivoDiarioReservaciones = "Reservaciones.diario";
+    const std::string archivoTarifas = "Tarifas.csv";
+    const std::string archivoReservacionesRechazadas = "Reservaciones.rechazadas.csv";
+    // Índices laterales de la carga bajo demanda (posición de cada línea y sus claves)
+    const std::string archivoIndiceAnfitriones = "Anfitriones.idx";
+    const std::string archivoIndiceHuespedes = "Huespedes.idx";
+
+    // Índice por bloques del histórico (zone maps por fecha + listas por alojamiento)
+    IndiceHistorico indiceHistorico;
+    // Muestra un registro del histórico en una línea legible
+    void mostrarRegistroHistorico(const RegistroHistorico& registro);
+    // Histórico particionado por mes y codificado (alternativa opcional a Historico.csv)
+    AlmacenHistorico almacenHistorico;
+    bool historicoParticionado;
+
+    // Canal de cambios: cada reserva, anulación y archivado se publica como un evento;
+    // los drenadores lo leen con su propio hilo y lo entregan a su sumidero por lotes.
+    CanalCambios canalCambios;
+    static const int MAX_DRENADORES_CAMBIOS = 4;
+    DrenadorCambios* drenadoresCambios[MAX_DRENADORES_CAMBIOS];
+    int cantidadDrenadoresCambios;
+    void publicarCambio(TipoEventoReservacion tipo, const Reservacion& reservacion);
+    void detenerDrenadoresCambios();
+
+    // Recarga de Alojamientos.csv al cambiar (ver recargarAlojamientos). Los contadores
+    // se leen y cambian con mutexDatos.
+    VigilanteArchivos vigilanteAlojamientos;
+    int recargasAlojamientos;
+    int cantidadAlojamientosRetirados;
+
+    // Asignador de códigos de reservación (monotónico y atómico)
+    GeneradorCodigos generadorCodigos;
+    // Si es true, cada anexo al histórico termina con fsync (más lento, más durable)
+    bool sincronizarHistoricoEnDisco;
+    // Diario de reservaciones con commit en grupo (opcional). Cuando está abierto,
+    // cada reserva o anulación queda en disco antes de confirmarse y Reservaciones.csv
+    // solo se reescribe en los puntos de control (al cargar y al salir).
+    EscritorGrupal diarioReservaciones;
+    // Reservas cuyo registro en el diario falló y se deshicieron (con mutexEscritores):
+    // deshacer después una anulación suya no debe reactivarlas
+    TablaHash<bool> creacionesDeshechas;
+    // Anulaciones que esperan al diario para ir al histórico (con mutexHistorico): la
+    // analítica las cuenta de aquí porque ya no están activas ni todavía en el histórico
+    TablaHash<Reservacion> anulacionesSinHistorico;
+
+    // Protege las colecciones: las búsquedas, las consultas y las reservas toman el
+    // candado compartido (varias a la vez); las anulaciones, las recargas y el archivado
+    // lo toman exclusivo (el archivado, por tandas al retirar lo archivado; ver
+    // archivarVencidasHasta).
+    mutable std::shared_mutex mutexDatos;
+    // Serializa a quienes sacan reservaciones del conjunto (anular, archivar, deshacer)
+    // y la foto de la analítica. Se toma antes que mutexDatos; mientras se tiene, nada
+    // sale del arreglo de reservaciones. Las reservas no lo toman: solo agregan.
+    std::mutex mutexEscritores;
+    // Serializa el acceso al histórico (CSV + índice o particionado), que guarda estado
+    // de la última consulta. Si se necesitan ambos, se toma primero mutexDatos.
+    mutable std::mutex mutexHistorico;
+    // Registro de las reservas nuevas. Una reserva lo toma con mutexDatos compartido
+    // para anexarse al arreglo, al índice por código, a la cola de vencimientos, a la
+    // agenda de su alojamiento y a la lista de su huésped (O(log n), sin disco). Quien
+    // lee esas colecciones con el candado compartido también lo toma, y el archivado lo
+    // toma solo (sin mutexDatos) para extraer de la cola. Va después de mutexDatos y
+    // antes de mutexHistorico; con mutexDatos exclusivo no hace falta.
+    mutable std::mutex mutexRegistro;
+    // Cambios del conjunto de reservaciones (con mutexDatos exclusivo, o compartido y
+    // mutexRegistro) y el último que quedó en Reservaciones.csv
+    unsigned long long versionReservaciones;
+    unsigned long long versionGuardada;           // Con mutexArchivoReservaciones
+    // Serializa las reescrituras de Reservaciones.csv. Se toma después de mutexDatos.
+    std::mutex mutexArchivoReservaciones;
+    // Hilos que evalúan en paralelo los bloques de alojamientos de una búsqueda
+    mutable PoolHilos poolBusqueda;   // mutable: las búsquedas son const
+    static const int ALOJAMIENTOS_POR_BLOQUE = 1024;
+    // Hilos de los recorridos largos (revisión de integridad al cargar, analítica). Van
+    // aparte de poolBusqueda: una búsqueda roba bloques mientras espera y no debe tomar
+    // uno de estos.
+    PoolHilos poolRecorridos;
+    // Reservaciones que el archivado retira por cada toma del candado exclusivo
+    static const int RESERVACIONES_POR_TANDA = 256;
+    // Memoria máxima de los agregados parciales de la analítica (todos los hilos)
+    static const size_t MEMORIA_ANALITICA = 256u * 1024 * 1024;
+    // Resultados de búsquedas recientes (LRU con presupuesto de memoria)
+    mutable CacheBusquedas cacheBusquedas;
+    // Serializa la impresión de las búsquedas concurrentes (cout y su formato son compartidos).
+    mutable std::mutex mutexConsola;
+    // Si es false no se escribe ningún archivo (modo de prueba de estrés)
+    bool persistirCambios;
+    // Archivado automático en segundo plano
+    std::thread hiloArchivado;
+    std::mutex mutexArchivado;
+    std::condition_variable condicionArchivado;
+    bool detenerHiloArchivado;
+    int intervaloArchivadoSegundos;
+    void cicloArchivadoAutomatico();
 
     // --- Métodos de ayuda internos ---
     // Para manejar el tamaño de los arreglos dinámicos
     void asegurarCapacidadAlojamientos();
-    void asegurarCapacidadAnfitriones();
-    void asegurarCapacidadHuespedes();
     void asegurarCapacidadReservaciones();
 
     // Para cargar datos desde los archivos CSV
@@ -55,23 +201,115 @@ private:
     void cargarAnfitrionesDesdeArchivo();
     void cargarHuespedesDesdeArchivo();
     void cargarReservacionesActivasDesdeArchivo();
+    // Rechaza las reservaciones cargadas inconsistentes y registra las demás en los índices
+    void revisarIntegridadReservaciones();
+    // Reglas de precio por temporada (opcional; después de cargar los alojamientos)
+    void cargarTarifasDesdeArchivo();
+    // Construye la adyacencia anfitrión -> alojamientos (después de cargar ambos; otra
+    // vez tras cada recarga de alojamientos, con cargaInicial = false)
+    void construirAdyacenciaAnfitriones(bool cargaInicial = true);
 
-    // Para guardar las reservaciones (activas y al histórico)
-    void guardarReservacionesActivasEnArchivo();
+    // Para guardar las reservaciones (activas y al histórico). Reemplaza el archivo
+    // completo de forma atómica; con 'sincronizar' lo fuerza a disco antes del cambio.
+    // Requiere mutexDatos exclusivo (o la carga, de un solo hilo).
+    bool guardarReservacionesActivasEnArchivo(bool sincronizar = false);
+    // Lo mismo sin diario tras una reserva o anulación: toma los candados que necesita
+    // y escribe sin ellos (ver su implementación)
+    bool reescribirReservacionesActivas();
+    void guardarReservacionesRechazadas();
+    // Rehace lo que quedó en el diario de una ejecución que no llegó al punto de control
+    void aplicarDiarioDeReservaciones();
     void agregarReservacionAHistoricoEnArchivo(const Reservacion& reservacion);
+    // Anexa reservaciones al histórico en uso (CSV o particionado) con una escritura por archivo
+    bool anexarAlHistorico(const Reservacion* const* registros, int cantidad);
+    bool anexarAlHistoricoConCandado(const Reservacion* const* registros, int cantidad); // mutexHistorico tomado
+    // Anexa al histórico una anulación que el diario confirmó y la saca de anulacionesSinHistorico
+    void anexarAnulacionConfirmada(const Reservacion& anulada);
+    // Anexa un bloque de líneas CSV al histórico con una sola apertura y escritura
+    bool anexarBloqueAHistorico(const BuferCSV& bloque);
+    // Archiva las reservaciones con salida anterior a diaCorte (requiere mutexEscritores
+    // tomado y mutexDatos libre: lo toma exclusivo por tandas para retirarlas)
+    bool archivarVencidasHasta(long diaCorte, bool informar);
+    // Saca una reservación del arreglo moviendo la última a su lugar (mutexDatos exclusivo)
+    void quitarReservacionDelArreglo(int posicion);
+    // Registra la reservación en la posición 'indice' en el índice por código, la cola de
+    // vencimientos, la agenda de su alojamiento y la lista de su huésped. Si las noches no
+    // se reclamaron antes en el calendario (carga de archivos), las marca ahí también.
+    // Requiere mutexDatos exclusivo, o compartido y mutexRegistro.
+    void registrarReservacionEnIndices(int indice, bool nochesReclamadas = false);
+    // Retira la reservación de la agenda y el calendario de su alojamiento y de la lista
+    // de su huésped (al anularla o archivarla)
+    void retirarReservacionDeIndices(const Reservacion& reservacion);
+    // Toma en el calendario todas las noches del rango, aunque alguna ya esté marcada
+    // por otra estadía que se cruza
+    void asegurarNochesOcupadas(int alojamiento, long diaEntrada, long diaSalida);
+    // true si el diario está en uso y una escritura suya falló: no se aceptan cambios
+    bool diarioEnFalla() const;
+    // Revierten en memoria una reserva o anulación que el diario no confirmó (toman
+    // mutexEscritores y mutexDatos) y publican el evento contrario
+    void deshacerCreacion(const std::string& codigo);
+    void deshacerAnulacion(const Reservacion& anulada);
+    // Siembra el generador de códigos con los códigos ya usados en el histórico
+    void sembrarGeneradorDesdeHistorico();
+    // Al cargar: retira de las activas la que ya está en el histórico (archivado
+    // interrumpido por una caída); el informe guarda Reservaciones.csv si retiró alguna
+    bool retirarSiYaEstaEnHistorico(const Reservacion& registro);
+    void informarRetiradasYaEnHistorico(int retiradas);
+    // Convierte una línea CSV de reservación (10 campos) en objeto; false si no es válida
+    bool parsearReservacionDesdeLinea(const std::string& linea, Reservacion& reservacion);
 
     // Para buscar entidades internamente
     Huesped* encontrarHuespedPorID(const std::string& idLogin);
     Anfitrion* encontrarAnfitrionPorID(const std::string& idLogin);
-    Anfitrion* encontrarAnfitrionPorDocumento(const std::string& documento) const;
     Huesped* encontrarHuespedPorDocumento(const std::string& documento) const;
+    // Usuario en esa posición de su archivo (lo lee si está bajo demanda y no se ha usado)
+    Anfitrion* obtenerAnfitrion(int posicion) const;
+    Huesped* obtenerHuesped(int posicion) const;
+    // Posición (y tramo CSR) de un anfitrión entregado por encontrarAnfitrionPorID
+    int obtenerPosicionAnfitrion(const Anfitrion* anfitrion) const;
     Alojamiento* encontrarAlojamientoPorCodigo(const std::string& codigo) const; // Cambiado para uso público potencial
+    int obtenerIndiceAlojamiento(const std::string& codigo) const; // -1 si no existe
+    // Costo de las noches [diaEntrada, diaSalida) del alojamiento en la posición dada,
+    // en pesos enteros, con las tarifas de temporada
+    long long calcularCostoEstadia(int alojamiento, long diaEntrada, long diaSalida) const;
+    // Guarda en 'resultado' (cupo cantidadAlojamientos) los alojamientos libres en
+    // [diaEntrada, diaEntrada + noches) y del municipio dado ("" = cualquiera), en el
+    // orden del arreglo. Con 'precioNocheMaximo' o 'costoMaximo' (>= 0) descarta los que
+    // superan ese precio promedio por noche o ese costo total de la estadía.
+    // Devuelve cuántos encontró. Requiere mutexDatos tomado.
+    int buscarAlojamientosDisponibles(long diaEntrada, int noches, const std::string& municipio, int* resultado,
+                                      long long precioNocheMaximo = -1, long long costoMaximo = -1) const;
+    // Descarta de la cache las búsquedas que un cambio en esas noches del alojamiento
+    // puede alterar. Se llama después del cambio y con mutexDatos tomado (basta el
+    // compartido: la cache no guarda lo que se calculó durante el cambio).
+    void invalidarBusquedas(int alojamiento, long diaEntrada, long diaSalida);
+    // Calcula la búsqueda sin la cache, repartiendo los bloques de alojamientos entre los hilos
+    int calcularAlojamientosDisponibles(long diaEntrada, long diaSalida, const std::string& municipioBuscado,
+                                        long long precioNocheMaximo, long long costoMaximo, int* resultado) const;
+    // Lo mismo sobre las posiciones [desde, hasta) del arreglo (un bloque de la búsqueda)
+    int filtrarAlojamientosDisponibles(int desde, int hasta, long diaEntrada, long diaSalida,
+                                       const std::string& municipioBuscado, long long precioNocheMaximo,
+                                       long long costoMaximo, int* resultado) const;
+    // Tramo de noches libres de un alojamiento: se puede entrar cualquier día entre
+    // primeraEntrada y ultimaEntrada (ambos incluidos) y quedarse las noches pedidas
+    struct VentanaLibre {
+        int alojamiento;
+        long primeraEntrada;
+        long ultimaEntrada;
+    };
+    // Recorre una sola vez el calendario de cada alojamiento (del municipio dado, "" =
+    // cualquiera) entre diaDesde y diaHasta (última noche, incluida) y guarda en 'ventanas'
+    // (arreglo nuevo que libera quien llama) los tramos donde caben 'noches' noches, en
+    // orden de alojamiento y de fecha. Devuelve cuántos hay. Requiere mutexDatos tomado.
+    int buscarVentanasDisponibles(long diaDesde, long diaHasta, int noches, const std::string& municipio,
+                                  VentanaLibre*& ventanas) const;
     Reservacion* encontrarReservacionActivaPorCodigo(const std::string& codigo) const;     // Para modificarla
     int obtenerIndiceReservacionActiva(const std::string& codigoReservacion) const;
-    std::string generarNuevoCodigoReservacion() const; // Crea un ID único
+    std::string generarNuevoCodigoReservacion(); // Crea un ID único (nunca reutilizado)
 
 public:
-    GestorUdeaStay();
+    // Con usuariosBajoDemanda, anfitriones y huéspedes se leen de sus archivos al usarlos
+    explicit GestorUdeaStay(bool usuariosBajoDemanda = false);
     ~GestorUdeaStay();
 
     // --- Gestión principal y Menús (a ser llamados desde main.cpp) ---
@@ -81,28 +319,84 @@ public:
     void inicializarSistema(); // Carga todos los datos al inicio
     void finalizarSistema();   // Guarda los datos necesarios al salir
     // --- Login y Sesión ---
-    bool intentarLoginAnfitrion(const std::string& idLogin, const std::string& contrasena);
-    bool intentarLoginHuesped(const std::string& documento, const std::string& contrasena);
-    void cerrarSesion();
-    bool haySesionAnfitrionActiva() const;
-    bool haySesionHuespedActiva() const;
-    const Anfitrion* getAnfitrionActual() const; // Devuelve el anfitrión logueado
-    const Huesped* getHuespedActual() const;     // Devuelve el huésped logueado
+    // Si las credenciales son válidas, inicia la sesión dada con ese usuario
+    bool intentarLoginAnfitrion(Sesion& sesion, const std::string& idLogin, const std::string& contrasena);
+    bool intentarLoginHuesped(Sesion& sesion, const std::string& documento, const std::string& contrasena);
     // --- Funcionalidades para Huéspedes ---
+    // costoMax: precio promedio por noche máximo de la estadía; costoTotalMax: costo total
+    // máximo. Negativo = sin límite.
     void mostrarAlojamientosDisponibles(Fecha fecha, const std::string& municipio, int noches,
-                                        double costoMax = -1.0, double puntMinAnf = -1.0);
+                                        double costoMax = -1.0, double puntMinAnf = -1.0,
+                                        double costoTotalMax = -1.0);
+    // Fechas flexibles: todas las entradas posibles de 'noches' noches entre 'desde' y
+    // 'hasta' (última noche de la estadía, incluida) en cada alojamiento del municipio
+    void mostrarVentanasDisponibles(Fecha desde, Fecha hasta, int noches, const std::string& municipio);
     // getAlojamientoPorCodigo se puede usar antes de reservar si el huésped busca por código
-    bool crearNuevaReservacion(const std::string& codigoAlojamiento, Fecha fechaInicio, int noches,
-                               const std::string& metodoPago, const std::string& anotacionesHuesped);
+    // Si se da 'codigoCreado', recibe el código de la reservación nueva; si se da 'error',
+    // recibe el motivo del fallo en lugar de mostrarlo en consola
+    bool crearNuevaReservacion(const Sesion& sesion, const std::string& codigoAlojamiento, Fecha fechaInicio, int noches,
+                               const std::string& metodoPago, const std::string& anotacionesHuesped,
+                               std::string* codigoCreado = nullptr, std::string* error = nullptr);
+    // Muestra las reservaciones activas del huésped de la sesión; false si no tiene
+    bool mostrarReservacionesDelHuesped(const Sesion& sesion) const;
     // --- Funcionalidades para Anfitriones ---
-    void mostrarReservacionesDelAnfitrion(Fecha fechaDesde, Fecha fechaHasta) const; // Muestra las del anfitrión logueado
+    void mostrarReservacionesDelAnfitrion(const Sesion& sesion, Fecha fechaDesde, Fecha fechaHasta) const;
     bool actualizarArchivoHistorico(Fecha fechaCorte);
+    void setSincronizarHistoricoEnDisco(bool sincronizar); // fsync tras cada anexo al histórico
+    // Activa el diario durable de reservaciones: el hilo escritor junta lo que llega durante
+    // 'ventanaMicrosegundos' (o hasta 'maximoLote' registros) en un solo write + fdatasync.
+    bool activarDiarioDeReservaciones(int ventanaMicrosegundos, int maximoLote);
+    // Usa el histórico particionado por mes (directorio "historico/") en lugar de Historico.csv
+    bool usarHistoricoParticionado(bool comprimir);
+    // Reescribe Historico.csv ordenado por fecha de entrada (bloques del índice con
+    // rangos de fechas disjuntos); false si el histórico particionado está activo.
+    // Solo al arrancar: la analítica lee el CSV sin candado hasta su marca de bytes
+    bool reordenarHistorico();
+    // Copia Historico.csv al histórico particionado / exporta el particionado a un CSV
+    long long importarHistoricoDesdeCSV();
+    long long exportarHistoricoCSV(const std::string& archivoDestino);
+    // Ocupación, ingresos y estadía promedio por mes (de 'desde' a 'hasta') con las
+    // reservaciones activas y el histórico; escribe <prefijo>_alojamientos.csv,
+    // <prefijo>_anfitriones.csv y <prefijo>_municipios.csv. Suma en 'parciales' agregados
+    // repartidos en poolRecorridos.
+    bool generarAnalitica(Fecha desde, Fecha hasta, const std::string& prefijo, int parciales);
+    // Consultas al histórico (solo leen del disco los bloques necesarios)
+    void consultarHistoricoDelAnfitrion(const Sesion& sesion, Fecha fechaDesde, Fecha fechaHasta);   // Alojamientos del anfitrión
+    void consultarHistoricoDeAlojamiento(const std::string& codigoAlojamiento, Fecha fechaDesde, Fecha fechaHasta);
+    void consultarHistoricoDelHuesped(const Sesion& sesion, Fecha fechaDesde, Fecha fechaHasta);     // Estadías pasadas del huésped
+    // Archiva periódicamente (cada 'intervaloSegundos') lo vencido hasta la fecha actual
+    void iniciarArchivadoAutomatico(int intervaloSegundos);
+    void detenerArchivadoAutomatico();
     // --- Funcionalidades Comunes ---
-    bool cancelarUnaReservacion(const std::string& codigoReservacion); // Verifica permisos antes de anular
+    // Verifica permisos antes de anular; 'error' como en crearNuevaReservacion
+    bool cancelarUnaReservacion(const Sesion& sesion, const std::string& codigoReservacion,
+                                std::string* error = nullptr);
+
+    // --- Concurrencia ---
+    void setPersistirCambios(bool persistir); // false: no escribe archivos (solo memoria)
+    // Hilos por búsqueda (contando al que la pide); 1 o menos: búsqueda secuencial
+    void setHilosDeBusqueda(int hilos);
+    // Memoria máxima de la cache de búsquedas; 0 la desactiva
+    void setPresupuestoCacheBusquedas(size_t bytes);
+    // Agrega un consumidor del canal de cambios que entrega los eventos nuevos al sumidero
+    // (creado con new; lo toma) cada 'intervaloMilisegundos'. Nunca frena las reservas.
+    bool agregarSumideroCambios(SumideroEventos* sumidero, int intervaloMilisegundos = 50);
+    // Vuelve a leer Alojamientos.csv y aplica lo agregado, modificado y quitado; false si
+    // no se pudo leer (se conservan los actuales)
+    bool recargarAlojamientos();
+    // Vigila Alojamientos.csv (inotify) y lo recarga cada vez que se termina de escribir
+    bool activarRecargaAlojamientos();
+    // --- Modo servidor ---
+    // Atiende una línea del protocolo del servidor (ver servidorudeastay.h) en nombre de
+    // la sesión de la conexión y devuelve la respuesta completa, terminada en '\n'.
+    std::string atenderSolicitud(Sesion& sesion, const std::string& solicitud);
+    // Lanza 'hilos' usuarios concurrentes que reservan, buscan y anulan al azar y luego
+    // verifica que ningún alojamiento ni huésped quedó con noches dobles. No escribe archivos.
+    bool ejecutarPruebaDeEstres(int hilos, int operacionesPorHilo);
 
     // --- Medición de Recursos (ahora son métodos públicos para ser llamados desde el menú) ---
     void mostrarEstadoRecursosActual() const; // Muestra iteraciones y memoria
-    void incrementarContadorIteraciones(unsigned long long cantidad = 1); // Para ser llamado por otros métodos
+    void incrementarContadorIteraciones(unsigned long long cantidad = 1) const; // Para ser llamado por otros métodos
     // La memoria se calcula dentro de mostrarEstadoRecursosActual
 
     // --- Métodos de Ayuda Públicos (si fueran necesarios por main.cpp) ---
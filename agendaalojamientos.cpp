@@ -0,0 +1,63 @@
+// --- agendaalojamientos.cpp ---
+// Implementación de las agendas de reservaciones por alojamiento.
+#include "agendaalojamientos.h"
+using namespace std;
+
+AgendaAlojamientos::AgendaAlojamientos() : agendas(nullptr), cantidadAlojamientos(0) {
+}
+
+AgendaAlojamientos::~AgendaAlojamientos() {
+    delete[] agendas;
+}
+
+void AgendaAlojamientos::inicializar(int cantidad) {
+    delete[] agendas;
+    agendas = cantidad > 0 ? new ListaEstadias[cantidad] : nullptr;
+    cantidadAlojamientos = cantidad;
+}
+
+void AgendaAlojamientos::ampliar(int cantidad) {
+    if (cantidad <= cantidadAlojamientos) return;
+    ListaEstadias* nuevas = new ListaEstadias[cantidad];
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        nuevas[i] = agendas[i];
+    }
+    delete[] agendas;
+    agendas = nuevas;
+    cantidadAlojamientos = cantidad;
+}
+
+int AgendaAlojamientos::getCantidadAlojamientos() const {
+    return cantidadAlojamientos;
+}
+
+void AgendaAlojamientos::insertar(int alojamiento, long diaEntrada, long diaSalida, const string& codigoReservacion) {
+    if (alojamiento < 0 || alojamiento >= cantidadAlojamientos) return;
+    agendas[alojamiento].insertar(diaEntrada, diaSalida, codigoReservacion);
+}
+
+bool AgendaAlojamientos::eliminar(int alojamiento, long diaEntrada, const string& codigoReservacion) {
+    if (alojamiento < 0 || alojamiento >= cantidadAlojamientos) return false;
+    return agendas[alojamiento].eliminar(diaEntrada, codigoReservacion);
+}
+
+bool AgendaAlojamientos::hayCruce(int alojamiento, long diaDesde, long diaHasta) const {
+    if (alojamiento < 0 || alojamiento >= cantidadAlojamientos) return false;
+    return agendas[alojamiento].hayCruce(diaDesde, diaHasta);
+}
+
+long long AgendaAlojamientos::getCantidadEstadias() const {
+    long long total = 0;
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        total += agendas[i].getCantidad();
+    }
+    return total;
+}
+
+size_t AgendaAlojamientos::memoriaAproximada() const {
+    size_t total = sizeof(*this);
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        total += agendas[i].memoriaAproximada();
+    }
+    return total;
+}
@@ -0,0 +1,51 @@
+#ifndef AGENDAALOJAMIENTOS_H
+#define AGENDAALOJAMIENTOS_H
+
+#include <string>
+#include "listaestadias.h"
+
+// Reservaciones activas de cada alojamiento, ordenadas por día de entrada
+// (una ListaEstadias por alojamiento). Los alojamientos se identifican por su
+// posición en el arreglo del gestor; un índice fuera de rango no tiene estadías.
+class AgendaAlojamientos {
+public:
+    typedef ListaEstadias::Estadia Estadia;
+
+private:
+    ListaEstadias* agendas;
+    int cantidadAlojamientos;
+
+public:
+    AgendaAlojamientos();
+    ~AgendaAlojamientos();
+
+    AgendaAlojamientos(const AgendaAlojamientos&) = delete;
+    AgendaAlojamientos& operator=(const AgendaAlojamientos&) = delete;
+
+    // Descarta todo y prepara agendas vacías para 'cantidad' alojamientos.
+    void inicializar(int cantidad);
+    // Agrega agendas vacías hasta tener 'cantidad' alojamientos; conserva las actuales.
+    void ampliar(int cantidad);
+    int getCantidadAlojamientos() const;
+
+    void insertar(int alojamiento, long diaEntrada, long diaSalida, const std::string& codigoReservacion);
+    // Devuelve false si la estadía no estaba registrada.
+    bool eliminar(int alojamiento, long diaEntrada, const std::string& codigoReservacion);
+
+    // true si alguna estadía cumple entrada <= diaHasta y salida > diaDesde
+    // (mismo criterio de cruce que usa el gestor al reservar).
+    bool hayCruce(int alojamiento, long diaDesde, long diaHasta) const;
+
+    // Llama visitante(const Estadia&) para cada estadía que se cruza con [diaDesde, diaHasta],
+    // en orden de entrada. Devuelve la cantidad de estadías examinadas.
+    template <typename Visitante>
+    int recorrerCruces(int alojamiento, long diaDesde, long diaHasta, Visitante visitante) const {
+        if (alojamiento < 0 || alojamiento >= cantidadAlojamientos) return 0;
+        return agendas[alojamiento].recorrerCruces(diaDesde, diaHasta, visitante);
+    }
+
+    long long getCantidadEstadias() const;
+    size_t memoriaAproximada() const;
+};
+
+#endif // AGENDAALOJAMIENTOS_H
@@ -0,0 +1,745 @@
+// --- almacenhistorico.cpp ---
+// Implementación del histórico particionado por mes con codificación compacta.
+#include "almacenhistorico.h"
+#include "bufercsv.h"
+#include "generadorcodigos.h"
+#include "poolhilos.h"
+#include "tablahash.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <dirent.h>     // Para listar las particiones existentes
+#include <fcntl.h>
+#include <sys/stat.h>   // Para mkdir
+#include <unistd.h>
+#ifdef UDEASTAY_CON_ZLIB
+#include <zlib.h>
+#endif
+using namespace std;
+
+// --- Codificación de bajo nivel ---
+
+static const unsigned char VERSION_SEGMENTO = 1;
+static const unsigned char BANDERA_COMPRIMIDO = 1;
+static const char* const PREFIJO_CODIGO = "RES";
+// Tope de textos de un diccionario leído del disco (antes de reservar memoria)
+static const unsigned long long MAX_TEXTOS_DICCIONARIO = 1ULL << 24;
+
+static void escribirVarint(string& salida, unsigned long long valor) {
+    while (valor >= 0x80) {
+        salida += static_cast<char>((valor & 0x7F) | 0x80);
+        valor >>= 7;
+    }
+    salida += static_cast<char>(valor);
+}
+
+// Zigzag: lleva enteros con signo pequeños a varints cortos (0,-1,1,-2 -> 0,1,2,3).
+static unsigned long long aZigzag(long long valor) {
+    return (static_cast<unsigned long long>(valor) << 1) ^ static_cast<unsigned long long>(valor >> 63);
+}
+
+static long long desdeZigzag(unsigned long long valor) {
+    return static_cast<long long>(valor >> 1) ^ -static_cast<long long>(valor & 1);
+}
+
+static void escribirTexto(string& salida, const string& texto) {
+    escribirVarint(salida, texto.size());
+    salida += texto;
+}
+
+static bool leerVarint(const char*& p, const char* fin, unsigned long long& valor) {
+    valor = 0;
+    for (int desplazamiento = 0; p < fin && desplazamiento < 64; desplazamiento += 7) {
+        unsigned char byte = static_cast<unsigned char>(*p++);
+        valor |= static_cast<unsigned long long>(byte & 0x7F) << desplazamiento;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static bool leerTexto(const char*& p, const char* fin, string& texto) {
+    unsigned long long largo;
+    if (!leerVarint(p, fin, largo) || static_cast<unsigned long long>(fin - p) < largo) return false;
+    texto.assign(p, static_cast<size_t>(largo));
+    p += largo;
+    return true;
+}
+
+// Versiones sobre un flujo, para leer cabeceras sin cargar el segmento completo.
+static bool leerVarint(istream& entrada, unsigned long long& valor) {
+    valor = 0;
+    for (int desplazamiento = 0; desplazamiento < 64; desplazamiento += 7) {
+        int byte = entrada.get();
+        if (byte == EOF) return false;
+        valor |= static_cast<unsigned long long>(byte & 0x7F) << desplazamiento;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static bool leerTexto(istream& entrada, string& texto) {
+    unsigned long long largo;
+    if (!leerVarint(entrada, largo) || largo > (1ULL << 30)) return false;
+    texto.resize(static_cast<size_t>(largo));
+    if (largo > 0) entrada.read(&texto[0], static_cast<streamsize>(largo));
+    return static_cast<bool>(entrada);
+}
+
+static int claveMesDeDia(long numeroDia) {
+    Fecha fecha = Fecha::desdeNumeroDia(numeroDia);
+    return fecha.getAnio() * 12 + (fecha.getMes() - 1);
+}
+
+// Diccionario de un segmento: asigna índices a los textos en orden de aparición.
+class Diccionario {
+private:
+    TablaHash<int> indices;
+    string* valores;
+    int cantidad;
+    int cupo;
+
+public:
+    Diccionario() : valores(nullptr), cantidad(0), cupo(0) {}
+    ~Diccionario() { delete[] valores; }
+    Diccionario(const Diccionario&) = delete;
+    Diccionario& operator=(const Diccionario&) = delete;
+
+    int obtenerIndice(const string& texto) {
+        const int* existente = indices.buscar(texto);
+        if (existente != nullptr) return *existente;
+        if (cantidad == cupo) {
+            int nuevoCupo = cupo == 0 ? 8 : cupo * 2;
+            string* nuevo = new string[nuevoCupo];
+            for (int i = 0; i < cantidad; ++i) nuevo[i] = std::move(valores[i]);
+            delete[] valores;
+            valores = nuevo;
+            cupo = nuevoCupo;
+        }
+        valores[cantidad] = texto;
+        indices.insertar(texto, cantidad);
+        return cantidad++;
+    }
+
+    void escribir(string& salida) const {
+        escribirVarint(salida, static_cast<unsigned long long>(cantidad));
+        for (int i = 0; i < cantidad; ++i) escribirTexto(salida, valores[i]);
+    }
+};
+
+// Lista de textos leída de un diccionario ya escrito.
+struct ListaTextos {
+    string* valores;
+    int cantidad;
+
+    ListaTextos() : valores(nullptr), cantidad(0) {}
+    ~ListaTextos() { delete[] valores; }
+    ListaTextos(const ListaTextos&) = delete;
+    ListaTextos& operator=(const ListaTextos&) = delete;
+
+    void redimensionar(int nuevaCantidad) {
+        delete[] valores;
+        valores = nuevaCantidad > 0 ? new string[nuevaCantidad] : nullptr;
+        cantidad = nuevaCantidad;
+    }
+
+    bool leer(const char*& p, const char* fin) {
+        unsigned long long n;
+        if (!leerVarint(p, fin, n) || n > static_cast<unsigned long long>(fin - p) || n > MAX_TEXTOS_DICCIONARIO) {
+            return false;
+        }
+        redimensionar(static_cast<int>(n));
+        for (int i = 0; i < cantidad; ++i) {
+            if (!leerTexto(p, fin, valores[i])) return false;
+        }
+        return true;
+    }
+
+    bool contiene(const string& texto) const {
+        for (int i = 0; i < cantidad; ++i) {
+            if (valores[i] == texto) return true;
+        }
+        return false;
+    }
+};
+
+// Cabecera de un segmento tal como se lee del disco.
+struct CabeceraSegmento {
+    unsigned char banderas;
+    unsigned long long registros;
+    long diaMinEntrada;
+    long diaMaxSalida;
+    unsigned long long mayorNumeroCodigo;
+    ListaTextos alojamientos;
+    unsigned long long longitudOriginal;
+    unsigned long long longitudAlmacenada;
+};
+
+/**
+ * @brief Lee la cabecera de un segmento. Si 'leerAlojamientos' es false, el
+ * diccionario de alojamientos se salta sin guardarlo.
+ * @return false al llegar al final de la partición o ante datos corruptos.
+ */
+static bool leerCabecera(istream& entrada, CabeceraSegmento& cabecera, bool leerAlojamientos) {
+    char firma[4];
+    if (!entrada.read(firma, 4)) return false;
+    if (firma[0] != 'U' || firma[1] != 'S' || static_cast<unsigned char>(firma[2]) != VERSION_SEGMENTO) {
+        cerr << "Error [AlmacenHistorico]: Segmento con firma o versión desconocida." << endl;
+        return false;
+    }
+    cabecera.banderas = static_cast<unsigned char>(firma[3]);
+
+    unsigned long long minimo, maximo, alojamientos;
+    if (!leerVarint(entrada, cabecera.registros) || !leerVarint(entrada, minimo) ||
+        !leerVarint(entrada, maximo) || !leerVarint(entrada, cabecera.mayorNumeroCodigo) ||
+        !leerVarint(entrada, alojamientos)) {
+        return false;
+    }
+    cabecera.diaMinEntrada = static_cast<long>(desdeZigzag(minimo));
+    cabecera.diaMaxSalida = static_cast<long>(desdeZigzag(maximo));
+    // Cada alojamiento del diccionario aparece en al menos un registro
+    if (alojamientos > cabecera.registros || alojamientos > MAX_TEXTOS_DICCIONARIO) {
+        cerr << "Error [AlmacenHistorico]: Diccionario de alojamientos con tamaño inválido." << endl;
+        return false;
+    }
+
+    cabecera.alojamientos.redimensionar(leerAlojamientos ? static_cast<int>(alojamientos) : 0);
+    string descartado;
+    for (unsigned long long i = 0; i < alojamientos; ++i) {
+        if (!leerTexto(entrada, leerAlojamientos ? cabecera.alojamientos.valores[i] : descartado)) return false;
+    }
+    return leerVarint(entrada, cabecera.longitudOriginal) && leerVarint(entrada, cabecera.longitudAlmacenada) &&
+           cabecera.longitudAlmacenada <= (1ULL << 31);
+}
+
+// --- AlmacenHistorico ---
+
+AlmacenHistorico::AlmacenHistorico(const string& directorioParticiones) :
+    directorio(directorioParticiones), comprimir(false),
+    particiones(nullptr), cantidadParticiones(0), cupoParticiones(0),
+    mayorNumeroCodigo(0), ultimaConsulta{0, 0, 0, 0, 0, 0} {
+}
+
+AlmacenHistorico::~AlmacenHistorico() {
+    delete[] particiones;
+}
+
+bool AlmacenHistorico::setComprimir(bool activar) {
+#ifdef UDEASTAY_CON_ZLIB
+    comprimir = activar;
+    return true;
+#else
+    comprimir = false;
+    return !activar;
+#endif
+}
+
+string AlmacenHistorico::rutaParticion(int claveMes) const {
+    char nombre[32];
+    snprintf(nombre, sizeof(nombre), "/%04d-%02d.part", claveMes / 12, claveMes % 12 + 1);
+    return directorio + nombre;
+}
+
+/**
+ * @brief Devuelve el resumen de la partición del mes, creándolo si no existe.
+ * El arreglo se mantiene ordenado por mes para recorrer en orden cronológico.
+ */
+AlmacenHistorico::Particion& AlmacenHistorico::obtenerParticion(int claveMes) {
+    int posicion = 0;
+    while (posicion < cantidadParticiones && particiones[posicion].claveMes < claveMes) posicion++;
+    if (posicion < cantidadParticiones && particiones[posicion].claveMes == claveMes) {
+        return particiones[posicion];
+    }
+
+    if (cantidadParticiones == cupoParticiones) {
+        int nuevoCupo = cupoParticiones == 0 ? 16 : cupoParticiones * 2;
+        Particion* nuevo = new Particion[nuevoCupo];
+        for (int i = 0; i < cantidadParticiones; ++i) nuevo[i] = particiones[i];
+        delete[] particiones;
+        particiones = nuevo;
+        cupoParticiones = nuevoCupo;
+    }
+    for (int i = cantidadParticiones; i > posicion; --i) particiones[i] = particiones[i - 1];
+    cantidadParticiones++;
+
+    Particion& nueva = particiones[posicion];
+    nueva.claveMes = claveMes;
+    nueva.diaMinEntrada = LONG_MAX;
+    nueva.diaMaxSalida = LONG_MIN;
+    nueva.registros = 0;
+    return nueva;
+}
+
+/**
+ * @brief Recorre solo las cabeceras de los segmentos de una partición
+ * (saltando los cuerpos) para calcular su rango de fechas y su mayor código.
+ * Lo que sigue al último segmento completo es una escritura que no terminó (anexar
+ * recorta las que fallan, pero no las de un proceso que murió a mitad): se recorta,
+ * porque los segmentos que se anexaran detrás quedarían ilegibles.
+ */
+bool AlmacenHistorico::resumirParticion(Particion& particion) {
+    const string ruta = rutaParticion(particion.claveMes);
+    ifstream entrada(ruta, ios::binary | ios::ate);
+    if (!entrada.is_open()) return false;
+    const long long tamano = static_cast<long long>(entrada.tellg());
+    entrada.seekg(0);
+
+    CabeceraSegmento cabecera;
+    long long finValido = 0;
+    while (entrada.peek() != EOF && leerCabecera(entrada, cabecera, false)) {
+        const long long finSegmento = static_cast<long long>(entrada.tellg()) +
+                                      static_cast<long long>(cabecera.longitudAlmacenada);
+        if (finSegmento > tamano) break; // Cuerpo incompleto
+        particion.registros += static_cast<long long>(cabecera.registros);
+        if (cabecera.diaMinEntrada < particion.diaMinEntrada) particion.diaMinEntrada = cabecera.diaMinEntrada;
+        if (cabecera.diaMaxSalida > particion.diaMaxSalida) particion.diaMaxSalida = cabecera.diaMaxSalida;
+        if (cabecera.mayorNumeroCodigo > mayorNumeroCodigo) mayorNumeroCodigo = cabecera.mayorNumeroCodigo;
+        entrada.seekg(static_cast<streamoff>(finSegmento));
+        finValido = finSegmento;
+    }
+    entrada.close();
+    if (finValido < tamano) {
+        cerr << "Advertencia [AlmacenHistorico]: Se descartan " << (tamano - finValido)
+             << " bytes de un segmento incompleto al final de '" << ruta << "'." << endl;
+        if (::truncate(ruta.c_str(), static_cast<off_t>(finValido)) != 0) {
+            cerr << "Error [AlmacenHistorico]: No se pudo recortar '" << ruta << "'." << endl;
+        }
+    }
+    return true;
+}
+
+bool AlmacenHistorico::abrir() {
+    if (mkdir(directorio.c_str(), 0755) != 0 && errno != EEXIST) {
+        cerr << "Error [AlmacenHistorico]: No se pudo crear el directorio '" << directorio << "'." << endl;
+        return false;
+    }
+    DIR* dir = opendir(directorio.c_str());
+    if (dir == nullptr) {
+        return false;
+    }
+    cantidadParticiones = 0;
+    mayorNumeroCodigo = 0;
+    while (dirent* entrada = readdir(dir)) {
+        int anio, mes;
+        char sufijo[8] = {0};
+        if (sscanf(entrada->d_name, "%4d-%2d.%5s", &anio, &mes, sufijo) == 3 &&
+            string(sufijo) == "part" && mes >= 1 && mes <= 12) {
+            resumirParticion(obtenerParticion(anio * 12 + mes - 1));
+        }
+    }
+    closedir(dir);
+    return true;
+}
+
+/**
+ * @brief Codifica un grupo de reservaciones como un segmento (ver formato en el .h).
+ */
+string AlmacenHistorico::codificarSegmento(const Reservacion* const* registros, int cantidad) const {
+    Diccionario alojamientos, huespedes, metodos;
+    string cuerpoRegistros;
+    cuerpoRegistros.reserve(static_cast<size_t>(cantidad) * 24);
+
+    long diaMin = LONG_MAX, diaMax = LONG_MIN;
+    unsigned long long mayorCodigo = 0;
+    for (int i = 0; i < cantidad; ++i) {
+        long entrada = registros[i]->getDiaEntrada();
+        long salida = registros[i]->getDiaSalida();
+        if (entrada < diaMin) diaMin = entrada;
+        if (salida > diaMax) diaMax = salida;
+    }
+
+    long entradaAnterior = diaMin;
+    for (int i = 0; i < cantidad; ++i) {
+        const Reservacion& r = *registros[i];
+
+        // Código: los canónicos ("RES" + número) se guardan como número; el resto como texto.
+        const string codigo = r.getCodigo();
+        unsigned long long numero;
+        if (GeneradorCodigos::extraerNumero(codigo, PREFIJO_CODIGO, numero) &&
+            GeneradorCodigos::formatear(PREFIJO_CODIGO, numero) == codigo && numero < (1ULL << 62)) {
+            escribirVarint(cuerpoRegistros, numero << 1);
+            if (numero > mayorCodigo) mayorCodigo = numero;
+        } else {
+            escribirVarint(cuerpoRegistros, (static_cast<unsigned long long>(codigo.size()) << 1) | 1);
+            cuerpoRegistros += codigo;
+        }
+
+        escribirVarint(cuerpoRegistros, static_cast<unsigned long long>(alojamientos.obtenerIndice(r.getCodigoAlojamiento())));
+        escribirVarint(cuerpoRegistros, static_cast<unsigned long long>(huespedes.obtenerIndice(r.getDocumentoHuesped())));
+
+        long entrada = r.getDiaEntrada();
+        escribirVarint(cuerpoRegistros, aZigzag(entrada - entradaAnterior));
+        entradaAnterior = entrada;
+
+        unsigned long long noches = static_cast<unsigned long long>(r.getDuracionNoches() < 0 ? 0 : r.getDuracionNoches());
+        escribirVarint(cuerpoRegistros, (noches << 1) | (r.EstaActiva() ? 1 : 0));
+        escribirVarint(cuerpoRegistros, static_cast<unsigned long long>(metodos.obtenerIndice(r.getMetodoPago())));
+        escribirVarint(cuerpoRegistros, aZigzag(r.getFechaPago().aNumeroDia() - entrada));
+        escribirVarint(cuerpoRegistros, aZigzag(r.getValorTotal()));
+        escribirTexto(cuerpoRegistros, r.getAnotaciones());
+    }
+
+    string cuerpo;
+    huespedes.escribir(cuerpo);
+    metodos.escribir(cuerpo);
+    cuerpo += cuerpoRegistros;
+
+    unsigned char banderas = 0;
+    unsigned long long longitudOriginal = cuerpo.size();
+#ifdef UDEASTAY_CON_ZLIB
+    if (comprimir) {
+        uLongf largoComprimido = compressBound(static_cast<uLong>(cuerpo.size()));
+        string comprimido(largoComprimido, '\0');
+        if (compress2(reinterpret_cast<Bytef*>(&comprimido[0]), &largoComprimido,
+                      reinterpret_cast<const Bytef*>(cuerpo.data()), static_cast<uLong>(cuerpo.size()),
+                      Z_BEST_SPEED) == Z_OK && largoComprimido < cuerpo.size()) {
+            comprimido.resize(largoComprimido);
+            cuerpo.swap(comprimido);
+            banderas |= BANDERA_COMPRIMIDO;
+        }
+    }
+#endif
+
+    string segmento;
+    segmento.reserve(cuerpo.size() + 64);
+    segmento += 'U';
+    segmento += 'S';
+    segmento += static_cast<char>(VERSION_SEGMENTO);
+    segmento += static_cast<char>(banderas);
+    escribirVarint(segmento, static_cast<unsigned long long>(cantidad));
+    escribirVarint(segmento, aZigzag(diaMin));
+    escribirVarint(segmento, aZigzag(diaMax));
+    escribirVarint(segmento, mayorCodigo);
+    alojamientos.escribir(segmento);
+    escribirVarint(segmento, longitudOriginal);
+    escribirVarint(segmento, cuerpo.size());
+    segmento += cuerpo;
+    return segmento;
+}
+
+/**
+ * @brief Anexa reservaciones al histórico. Se agrupan por mes de salida y cada
+ * partición tocada recibe un solo segmento con una sola apertura y escritura.
+ * Antes de escribir se anota el tamaño de cada partición; si una escritura (o su
+ * fsync) falla, todas las ya escritas en esta llamada se recortan a ese tamaño, así
+ * quien reintente no archiva dos veces lo que sí había quedado.
+ * @param sincronizar Si es true, cada partición escrita se fuerza a disco con fsync.
+ */
+bool AlmacenHistorico::anexar(const Reservacion* const* registros, int cantidad, bool sincronizar) {
+    if (cantidad <= 0) return true;
+
+    const Reservacion** ordenados = new const Reservacion*[cantidad];
+    for (int i = 0; i < cantidad; ++i) ordenados[i] = registros[i];
+    stable_sort(ordenados, ordenados + cantidad, [](const Reservacion* a, const Reservacion* b) {
+        return claveMesDeDia(a->getDiaSalida()) < claveMesDeDia(b->getDiaSalida());
+    });
+
+    struct Escrito {               // Un mes ya escrito en esta llamada
+        int claveMes;
+        int inicio, fin;           // Tramo de 'ordenados'
+        off_t tamanoAnterior;
+    };
+    Escrito* escritos = new Escrito[cantidad];
+    int cantidadEscritos = 0;
+    bool exito = true;
+    int inicio = 0;
+    while (exito && inicio < cantidad) {
+        int claveMes = claveMesDeDia(ordenados[inicio]->getDiaSalida());
+        int fin = inicio;
+        while (fin < cantidad && claveMesDeDia(ordenados[fin]->getDiaSalida()) == claveMes) fin++;
+
+        string segmento = codificarSegmento(ordenados + inicio, fin - inicio);
+        string ruta = rutaParticion(claveMes);
+        int descriptor = ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        struct stat estado;
+        bool escrito = descriptor >= 0 && ::fstat(descriptor, &estado) == 0;
+        if (escrito) {
+            // Se anota antes de escribir: si la escritura queda a medias también se recorta
+            escritos[cantidadEscritos++] = Escrito{claveMes, inicio, fin, estado.st_size};
+        }
+        const char* datos = segmento.data();
+        size_t pendientes = segmento.size();
+        while (escrito && pendientes > 0) {
+            ssize_t n = ::write(descriptor, datos, pendientes);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                escrito = false;
+                break;
+            }
+            datos += n;
+            pendientes -= static_cast<size_t>(n);
+        }
+        if (escrito && sincronizar && ::fsync(descriptor) != 0) escrito = false;
+        if (descriptor >= 0) ::close(descriptor);
+
+        if (!escrito) {
+            cerr << "Error [AlmacenHistorico]: No se pudo escribir la partición '" << ruta << "'." << endl;
+            exito = false;
+        }
+        inicio = fin;
+    }
+
+    for (int e = 0; e < cantidadEscritos; ++e) {
+        const Escrito& escrito = escritos[e];
+        if (!exito) {
+            const string ruta = rutaParticion(escrito.claveMes);
+            if (::truncate(ruta.c_str(), escrito.tamanoAnterior) != 0) {
+                cerr << "Error [AlmacenHistorico]: No se pudo deshacer el anexo en '" << ruta << "'." << endl;
+            }
+            continue;
+        }
+        Particion& particion = obtenerParticion(escrito.claveMes);
+        for (int i = escrito.inicio; i < escrito.fin; ++i) {
+            long entrada = ordenados[i]->getDiaEntrada();
+            long salida = ordenados[i]->getDiaSalida();
+            if (entrada < particion.diaMinEntrada) particion.diaMinEntrada = entrada;
+            if (salida > particion.diaMaxSalida) particion.diaMaxSalida = salida;
+            unsigned long long numero;
+            if (GeneradorCodigos::extraerNumero(ordenados[i]->getCodigo(), PREFIJO_CODIGO, numero) &&
+                numero > mayorNumeroCodigo) {
+                mayorNumeroCodigo = numero;
+            }
+        }
+        particion.registros += escrito.fin - escrito.inicio;
+    }
+    delete[] escritos;
+    delete[] ordenados;
+    return exito;
+}
+
+/**
+ * @brief Decodifica el cuerpo de un segmento y visita los registros que cumplen el
+ * filtro. 'huespedes' y 'metodos' solo se reutilizan entre segmentos.
+ * @return false si el cuerpo está dañado (los registros ya visitados quedan visitados).
+ */
+static bool decodificarCuerpo(const CabeceraSegmento& cabecera, string& cuerpo, const string* codigoAlojamiento,
+                              long diaDesde, long diaHasta, const AlmacenHistorico::Visitante& visitante,
+                              ListaTextos& huespedes, ListaTextos& metodos, long long& encontrados) {
+    if (cabecera.banderas & BANDERA_COMPRIMIDO) {
+#ifdef UDEASTAY_CON_ZLIB
+        if (cabecera.longitudOriginal > (1ULL << 31)) return false;
+        string original(static_cast<size_t>(cabecera.longitudOriginal), '\0');
+        uLongf largo = static_cast<uLongf>(original.size());
+        if (uncompress(reinterpret_cast<Bytef*>(&original[0]), &largo,
+                       reinterpret_cast<const Bytef*>(cuerpo.data()), static_cast<uLong>(cuerpo.size())) != Z_OK) {
+            return false;
+        }
+        cuerpo.swap(original);
+#else
+        cerr << "Error [AlmacenHistorico]: El segmento está comprimido y el programa no tiene soporte zlib." << endl;
+        return false;
+#endif
+    }
+
+    // Los alojamientos del diccionario de la cabecera se usan tal cual para decodificar
+    const ListaTextos& alojamientos = cabecera.alojamientos;
+    const char* p = cuerpo.data();
+    const char* fin = p + cuerpo.size();
+    if (!huespedes.leer(p, fin) || !metodos.leer(p, fin)) return false;
+
+    long entradaAnterior = cabecera.diaMinEntrada;
+    string codigo, anotaciones;
+    for (unsigned long long i = 0; i < cabecera.registros; ++i) {
+        unsigned long long valorCodigo, aloja, huesped, deltaEntrada, nochesEstado, metodo, deltaPago, monto;
+        if (!leerVarint(p, fin, valorCodigo)) return false;
+        if (valorCodigo & 1) {
+            size_t largo = static_cast<size_t>(valorCodigo >> 1);
+            if (static_cast<size_t>(fin - p) < largo) return false;
+            codigo.assign(p, largo);
+            p += largo;
+        } else {
+            codigo = GeneradorCodigos::formatear(PREFIJO_CODIGO, valorCodigo >> 1);
+        }
+        if (!leerVarint(p, fin, aloja) || !leerVarint(p, fin, huesped) || !leerVarint(p, fin, deltaEntrada) ||
+            !leerVarint(p, fin, nochesEstado) || !leerVarint(p, fin, metodo) || !leerVarint(p, fin, deltaPago) ||
+            !leerVarint(p, fin, monto) || !leerTexto(p, fin, anotaciones)) {
+            return false;
+        }
+        if (aloja >= static_cast<unsigned long long>(alojamientos.cantidad) ||
+            huesped >= static_cast<unsigned long long>(huespedes.cantidad) ||
+            metodo >= static_cast<unsigned long long>(metodos.cantidad)) {
+            return false;
+        }
+
+        long diaEntrada = entradaAnterior + static_cast<long>(desdeZigzag(deltaEntrada));
+        entradaAnterior = diaEntrada;
+        int noches = static_cast<int>(nochesEstado >> 1);
+        long diaSalida = diaEntrada + noches;
+
+        const string& codigoAloja = alojamientos.valores[aloja];
+        if ((codigoAlojamiento != nullptr && codigoAloja != *codigoAlojamiento) ||
+            diaEntrada > diaHasta || diaSalida <= diaDesde) {
+            continue;
+        }
+
+        Reservacion registro(codigo, codigoAloja, huespedes.valores[huesped], metodos.valores[metodo],
+                             Fecha::desdeNumeroDia(diaEntrada), noches,
+                             Fecha::desdeNumeroDia(diaEntrada + static_cast<long>(desdeZigzag(deltaPago))),
+                             static_cast<int>(desdeZigzag(monto)), anotaciones);
+        registro.setActiva((nochesEstado & 1) != 0);
+        encontrados++;
+        visitante(registro);
+    }
+    return true;
+}
+
+/**
+ * @brief Recorre los segmentos de una partición. Los segmentos cuyo rango de fechas
+ * no se cruza con [diaDesde, diaHasta] o cuyo diccionario no tiene el alojamiento
+ * pedido se saltan sin leer su cuerpo. Un cuerpo dañado se cuenta en
+ * segmentosConError y se sigue con el siguiente segmento; una cabecera dañada o un
+ * cuerpo incompleto terminan la partición (no se sabe dónde empieza el siguiente).
+ * Se detiene tras los particion.registros registros del resumen: lo que haya después
+ * es un anexo en curso o posterior a la marca con que se recorre.
+ */
+void AlmacenHistorico::recorrerParticion(const Particion& particion, const string* codigoAlojamiento,
+                                         long diaDesde, long diaHasta, const Visitante& visitante,
+                                         EstadisticaConsulta& estadistica) const {
+    const string ruta = rutaParticion(particion.claveMes);
+    ifstream entrada(ruta, ios::binary);
+    if (!entrada.is_open()) {
+        cerr << "Error [AlmacenHistorico]: No se pudo abrir la partición '" << ruta << "'." << endl;
+        estadistica.segmentosConError++;
+        return;
+    }
+    estadistica.particionesLeidas++;
+
+    CabeceraSegmento cabecera;
+    string cuerpo;
+    ListaTextos huespedes, metodos;
+    long long vistos = 0;
+    while (vistos < particion.registros && entrada.peek() != EOF) {
+        if (!leerCabecera(entrada, cabecera, true)) {
+            cerr << "Error [AlmacenHistorico]: Cabecera de segmento dañada en '" << ruta
+                 << "'; se omite el resto de la partición." << endl;
+            estadistica.segmentosConError++;
+            return;
+        }
+        vistos += static_cast<long long>(cabecera.registros);
+        bool cruzaFechas = cabecera.diaMinEntrada <= diaHasta && cabecera.diaMaxSalida > diaDesde;
+        bool tieneAlojamiento = codigoAlojamiento == nullptr || cabecera.alojamientos.contiene(*codigoAlojamiento);
+        if (!cruzaFechas || !tieneAlojamiento) {
+            estadistica.segmentosOmitidos++;
+            entrada.seekg(static_cast<streamoff>(cabecera.longitudAlmacenada), ios::cur);
+            continue;
+        }
+        estadistica.segmentosLeidos++;
+
+        cuerpo.resize(static_cast<size_t>(cabecera.longitudAlmacenada));
+        if (!cuerpo.empty() && !entrada.read(&cuerpo[0], static_cast<streamsize>(cuerpo.size()))) {
+            cerr << "Error [AlmacenHistorico]: Segmento incompleto en '" << ruta << "'." << endl;
+            estadistica.segmentosConError++;
+            return;
+        }
+        if (!decodificarCuerpo(cabecera, cuerpo, codigoAlojamiento, diaDesde, diaHasta, visitante, huespedes, metodos,
+                               estadistica.registrosEncontrados)) {
+            cerr << "Error [AlmacenHistorico]: Segmento dañado en '" << ruta << "'; se omite." << endl;
+            estadistica.segmentosConError++;
+        }
+    }
+}
+
+void AlmacenHistorico::consultarPorRango(long diaDesde, long diaHasta, const Visitante& visitante) {
+    ultimaConsulta = EstadisticaConsulta{cantidadParticiones, 0, 0, 0, 0, 0};
+    for (int i = 0; i < cantidadParticiones; ++i) {
+        const Particion& particion = particiones[i];
+        if (particion.registros > 0 && particion.diaMinEntrada <= diaHasta && particion.diaMaxSalida > diaDesde) {
+            recorrerParticion(particion, nullptr, diaDesde, diaHasta, visitante, ultimaConsulta);
+        }
+    }
+}
+
+void AlmacenHistorico::consultarPorAlojamiento(const string& codigoAlojamiento, long diaDesde, long diaHasta,
+                                               const Visitante& visitante) {
+    ultimaConsulta = EstadisticaConsulta{cantidadParticiones, 0, 0, 0, 0, 0};
+    for (int i = 0; i < cantidadParticiones; ++i) {
+        const Particion& particion = particiones[i];
+        if (particion.registros > 0 && particion.diaMinEntrada <= diaHasta && particion.diaMaxSalida > diaDesde) {
+            recorrerParticion(particion, &codigoAlojamiento, diaDesde, diaHasta, visitante, ultimaConsulta);
+        }
+    }
+}
+
+void AlmacenHistorico::recorrerTodo(const Visitante& visitante) {
+    consultarPorRango(LONG_MIN, LONG_MAX, visitante);
+}
+
+void AlmacenHistorico::tomarMarca(Marca& marca) const {
+    delete[] marca.particiones;
+    marca.particiones = new Particion[cantidadParticiones > 0 ? cantidadParticiones : 1];
+    marca.cantidad = cantidadParticiones;
+    for (int i = 0; i < cantidadParticiones; ++i) marca.particiones[i] = particiones[i];
+}
+
+int AlmacenHistorico::recorrerEnParalelo(const Marca& marca, PoolHilos& pool, int bloques,
+                                         const function<void(int bloque, const Reservacion&)>& visitante,
+                                         EstadisticaConsulta& estadistica) const {
+    const int cantidad = marca.cantidad;
+    if (bloques > cantidad) bloques = cantidad;
+    if (bloques < 1) bloques = 1;
+    estadistica = EstadisticaConsulta{cantidad, 0, 0, 0, 0, 0};
+    EstadisticaConsulta* estadisticas = new EstadisticaConsulta[bloques]();
+    atomic<int> siguiente(0);
+    // Las particiones son de tamaños muy distintos (meses flojos y de temporada): cada
+    // bloque toma la siguiente libre en vez de un tramo fijo
+    pool.ejecutarBloques(bloques, [&](int bloque) {
+        for (int i = siguiente.fetch_add(1); i < cantidad; i = siguiente.fetch_add(1)) {
+            if (marca.particiones[i].registros == 0) continue;
+            recorrerParticion(marca.particiones[i], nullptr, LONG_MIN, LONG_MAX,
+                              [&visitante, bloque](const Reservacion& registro) { visitante(bloque, registro); },
+                              estadisticas[bloque]);
+        }
+    });
+    for (int b = 0; b < bloques; ++b) {
+        estadistica.particionesLeidas += estadisticas[b].particionesLeidas;
+        estadistica.segmentosLeidos += estadisticas[b].segmentosLeidos;
+        estadistica.segmentosOmitidos += estadisticas[b].segmentosOmitidos;
+        estadistica.segmentosConError += estadisticas[b].segmentosConError;
+        estadistica.registrosEncontrados += estadisticas[b].registrosEncontrados;
+    }
+    delete[] estadisticas;
+    return bloques;
+}
+
+/**
+ * @brief Exporta todas las particiones, en orden cronológico, a un CSV con el
+ * mismo formato de Historico.csv. Escribe en bloques de ~1 MB.
+ */
+long long AlmacenHistorico::exportarCSV(const string& archivoDestino) {
+    ofstream salida(archivoDestino, ios::binary | ios::trunc);
+    if (!salida.is_open()) {
+        cerr << "Error [AlmacenHistorico]: No se pudo crear '" << archivoDestino << "'." << endl;
+        return -1;
+    }
+    const size_t TAMANO_BLOQUE = 1 << 20;
+    BuferCSV bloque(TAMANO_BLOQUE + 4096);
+    long long escritos = 0;
+    recorrerTodo([&](const Reservacion& registro) {
+        registro.escribirCSV(bloque);
+        bloque.agregar('\n');
+        escritos++;
+        if (bloque.getTamano() >= TAMANO_BLOQUE) {
+            salida.write(bloque.getDatos(), static_cast<streamsize>(bloque.getTamano()));
+            bloque.limpiar();
+        }
+    });
+    salida.write(bloque.getDatos(), static_cast<streamsize>(bloque.getTamano()));
+    return salida ? escritos : -1;
+}
+
+unsigned long long AlmacenHistorico::getMayorNumeroCodigo() const {
+    return mayorNumeroCodigo;
+}
+
+long long AlmacenHistorico::getCantidadRegistros() const {
+    long long total = 0;
+    for (int i = 0; i < cantidadParticiones; ++i) total += particiones[i].registros;
+    return total;
+}
+
+AlmacenHistorico::EstadisticaConsulta AlmacenHistorico::getUltimaConsulta() const {
+    return ultimaConsulta;
+}
@@ -0,0 +1,125 @@
+#ifndef ALMACENHISTORICO_H
+#define ALMACENHISTORICO_H
+
+#include <functional>
+#include <string>
+#include "reservacion.h"
+
+class PoolHilos;
+
+// Almacenamiento compacto del histórico, particionado por año-mes de salida.
+// Cada partición es un archivo "<directorio>/AAAA-MM.part" formado por segmentos;
+// cada anexo escribe un segmento nuevo al final de la partición de su mes.
+//
+// Formato de un segmento (enteros en varint; los con signo en zigzag):
+//   'U' 'S' version banderas
+//   nRegistros diaMinEntrada diaMaxSalida mayorNumeroCodigo
+//   diccionario de alojamientos (n, luego cada código como longitud + bytes)
+//   longitudOriginal longitudAlmacenada cuerpo
+// El cuerpo (opcionalmente comprimido con zlib) tiene los diccionarios de huéspedes
+// y de métodos de pago y luego cada registro: código (número "RES" o literal),
+// índices de diccionario, fecha de entrada en delta respecto al registro anterior,
+// noches y estado, fecha de pago en delta respecto a la entrada, monto y anotaciones.
+// La cabecera sin comprimir permite descartar segmentos por fecha o alojamiento
+// sin leer ni descomprimir el cuerpo.
+class AlmacenHistorico {
+public:
+    typedef std::function<void(const Reservacion&)> Visitante;
+
+    struct EstadisticaConsulta {
+        int particionesTotales;
+        int particionesLeidas;
+        int segmentosLeidos;
+        int segmentosOmitidos;
+        int segmentosConError;     // Dañados o ilegibles (se saltan; si es la cabecera, el resto de la partición)
+        long long registrosEncontrados;
+    };
+
+private:
+    struct Particion {
+        int claveMes;              // anio * 12 + (mes - 1)
+        long diaMinEntrada;
+        long diaMaxSalida;
+        long long registros;
+    };
+
+    std::string directorio;
+    bool comprimir;
+    Particion* particiones;        // Ordenadas por claveMes
+    int cantidadParticiones;
+    int cupoParticiones;
+    unsigned long long mayorNumeroCodigo;
+    EstadisticaConsulta ultimaConsulta;
+
+    std::string rutaParticion(int claveMes) const;
+    Particion& obtenerParticion(int claveMes);
+    // Lee las cabeceras de los segmentos de una partición para reconstruir su resumen.
+    // Un segmento incompleto al final (escritura interrumpida) se recorta del archivo.
+    bool resumirParticion(Particion& particion);
+    // Codifica 'cantidad' reservaciones (todas del mismo mes) como un segmento.
+    std::string codificarSegmento(const Reservacion* const* registros, int cantidad) const;
+    // Recorre los segmentos de una partición aplicando los filtros; cuenta en 'estadistica'.
+    // Lee solo los primeros particion.registros registros, aunque el archivo tenga más.
+    void recorrerParticion(const Particion& particion, const std::string* codigoAlojamiento,
+                           long diaDesde, long diaHasta, const Visitante& visitante,
+                           EstadisticaConsulta& estadistica) const;
+
+public:
+    // Copia del resumen de las particiones en un momento dado (ver tomarMarca).
+    class Marca {
+        friend class AlmacenHistorico;
+        Particion* particiones;
+        int cantidad;
+
+    public:
+        Marca() : particiones(nullptr), cantidad(0) {}
+        ~Marca() { delete[] particiones; }
+        Marca(const Marca&) = delete;
+        Marca& operator=(const Marca&) = delete;
+    };
+
+    explicit AlmacenHistorico(const std::string& directorioParticiones);
+    ~AlmacenHistorico();
+
+    AlmacenHistorico(const AlmacenHistorico&) = delete;
+    AlmacenHistorico& operator=(const AlmacenHistorico&) = delete;
+
+    // Crea el directorio si falta y resume las particiones existentes.
+    bool abrir();
+    // Activa la compresión general (zlib) del cuerpo de los segmentos nuevos.
+    // Devuelve false si el programa se compiló sin soporte de zlib.
+    bool setComprimir(bool activar);
+
+    // Anexa las reservaciones: un segmento y una escritura por cada mes tocado. Si alguna
+    // escritura falla, todas las particiones vuelven a su tamaño anterior y no queda
+    // ninguna de las reservaciones (todo o nada).
+    bool anexar(const Reservacion* const* registros, int cantidad, bool sincronizar);
+
+    // --- Consultas ---
+    void consultarPorRango(long diaDesde, long diaHasta, const Visitante& visitante);
+    void consultarPorAlojamiento(const std::string& codigoAlojamiento, long diaDesde, long diaHasta,
+                                 const Visitante& visitante);
+    void recorrerTodo(const Visitante& visitante);
+    // Anota cuántos registros tiene cada partición. Se toma con el candado de quien anexa;
+    // recorrer con la marca no necesita ese candado.
+    void tomarMarca(Marca& marca) const;
+    // Recorre lo que había al tomar la marca repartiendo las particiones entre 'bloques'
+    // bloques de 'pool' (cada uno toma la siguiente libre); lo anexado después no se lee.
+    // El visitante recibe el número de bloque (0 .. bloques - 1) y se llama a la vez desde
+    // varios hilos, pero nunca con el mismo número a la vez. No toca el estado del
+    // almacén, así que puede correr mientras otro hilo anexa; las estadísticas quedan en
+    // 'estadistica'. Devuelve cuántos bloques usó.
+    int recorrerEnParalelo(const Marca& marca, PoolHilos& pool, int bloques,
+                           const std::function<void(int bloque, const Reservacion&)>& visitante,
+                           EstadisticaConsulta& estadistica) const;
+
+    // Exporta todo el histórico a CSV (mismo formato que Historico.csv).
+    // Devuelve la cantidad de registros escritos o -1 si hubo error.
+    long long exportarCSV(const std::string& archivoDestino);
+
+    unsigned long long getMayorNumeroCodigo() const;
+    long long getCantidadRegistros() const;
+    EstadisticaConsulta getUltimaConsulta() const;
+};
+
+#endif // ALMACENHISTORICO_H
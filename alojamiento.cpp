@@ -6,7 +6,7 @@
 
 #include "Alojamiento.h"
 #include <iostream> // Para std::cout (en mostrarDetalles y errores)
-#include <sstream>  // Para std::ostringstream (en toFileString)
+#include "bufercsv.h"
 #include <limits>   // Para validaciones de precio (opcional)
 #include <iomanip>
 // Usamos el namespace std para evitar escribir 'std::' repetidamente.
@@ -29,7 +29,8 @@ Alojamiento::Alojamiento() :
     tipoAlojamiento("No especificado"), // Podría ser "Casa" o "Apartamento"
     amenidades("Ninguna"),             // Ejemplo: "ascensor, piscina, etc."
     precioPorNoche(0.0),
-    anfitrionResponsableID("SIN_ANFITRION") {
+    anfitrionResponsableID("SIN_ANFITRION"),
+    retirado(false) {
     // El constructor por defecto es útil, pero se debe tener cuidado
     // de que los objetos creados así se inicialicen correctamente
     // antes de ser usados plenamente en la lógica del sistema.
@@ -60,7 +61,8 @@ Alojamiento::Alojamiento(const string& codID, const string& nom, const string& d
     tipoAlojamiento(tipo),
     amenidades(amen),
     precioPorNoche(precio),
-    anfitrionResponsableID(anfitrionID) {
+    anfitrionResponsableID(anfitrionID),
+    retirado(false) {
 
     // Validaciones básicas en el constructor
     if (codID.empty()) {
@@ -93,6 +95,7 @@ string Alojamiento::getTipoAlojamiento() const { return tipoAlojamiento; }
 string Alojamiento::getAmenidades() const { return amenidades; }
 double Alojamiento::getPrecioPorNoche() const { return precioPorNoche; }
 string Alojamiento::getAnfitrionResponsableID() const { return anfitrionResponsableID; }
+bool Alojamiento::estaRetirado() const { return retirado; }
 
 // --- Setters ---
 // Los setters permiten modificar los atributos después de la creación del objeto.
@@ -155,6 +158,10 @@ void Alojamiento::setPrecioPorNoche(double precio) {
     this->precioPorNoche = precio;
 }
 
+void Alojamiento::setRetirado(bool estado) {
+    this->retirado = estado;
+}
+
 // --- Métodos de Utilidad ---
 
 /**
@@ -180,17 +187,29 @@ void Alojamiento::mostrarDetalles() const {
  * @return string en formato CSV representando el alojamiento.
  */
 string Alojamiento::toFileString() const {
-    ostringstream oss;
+    BuferCSV salida(256);
+    escribirCSV(salida);
+    return salida.aString();
+}
+
+void Alojamiento::escribirCSV(BuferCSV& salida) const {
     // El orden debe coincidir con el formato esperado por la función de carga de archivos.
     // Ejemplo de formato: CodigoID,Nombre,Direccion,Departamento,Municipio,Tipo,Amenidades,Precio,AnfitrionID
-    oss << codigoID << ","
-        << "\"" << nombre << "\"," // Usar comillas si el nombre puede tener comas
-        << "\"" << direccion << "\","
-        << departamento << ","
-        << municipio << ","
-        << tipoAlojamiento << ","
-        << "\"" << amenidades << "\"," // Usar comillas si las amenidades usan comas internas, aunque usamos ';'
-        << fixed << setprecision(2) << precioPorNoche << ","
-        << anfitrionResponsableID;
-    return oss.str();
+    salida.agregar(codigoID);
+    salida.agregar(',');
+    salida.agregarEntreComillas(nombre);      // Usar comillas si el nombre puede tener comas
+    salida.agregar(',');
+    salida.agregarEntreComillas(direccion);
+    salida.agregar(',');
+    salida.agregar(departamento);
+    salida.agregar(',');
+    salida.agregar(municipio);
+    salida.agregar(',');
+    salida.agregar(tipoAlojamiento);
+    salida.agregar(',');
+    salida.agregarEntreComillas(amenidades);  // Usar comillas si las amenidades usan comas internas, aunque usamos ';'
+    salida.agregar(',');
+    salida.agregarDecimal(precioPorNoche);
+    salida.agregar(',');
+    salida.agregar(anfitrionResponsableID);
 }
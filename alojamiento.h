@@ -2,6 +2,8 @@
 #define ALOJAMIENTO_H
 
 #include <string>
+
+class BuferCSV;
 // No incluimos Fecha.h aquí directamente si no es estrictamente necesario
 // para la declaración de Alojamiento. La disponibilidad se gestiona a nivel SistemaUdeAStay.
 
@@ -16,6 +18,7 @@ private:
     std::string amenidades;     // "ascensor, piscina, etc." [cite: 20]
     double precioPorNoche;
     std::string anfitrionResponsableID; // ID del Anfitrion
+    bool retirado;                      // Quitado de Alojamientos.csv en una recarga (conserva su posición)
 
 public:
     // --- Constructores ---
@@ -34,6 +37,7 @@ public:
     std::string getAmenidades() const;
     double getPrecioPorNoche() const;
     std::string getAnfitrionResponsableID() const;
+    bool estaRetirado() const;
 
     // --- Setters ---
     // Generalmente, el codigoID y el anfitrionResponsableID no deberían cambiar una vez creados.
@@ -44,12 +48,15 @@ public:
     void setTipoAlojamiento(const std::string& tipo);
     void setAmenidades(const std::string& amen);
     void setPrecioPorNoche(double precio);
+    void setRetirado(bool estado);
 
     // --- Métodos de Utilidad ---
     // Para mostrar la información del alojamiento de forma legible
     void mostrarDetalles() const;
     // Podrías tener un método para convertir sus datos a un string para guardar en archivo
     std::string toFileString() const;
+    // Igual que toFileString, pero al final de un búfer reutilizable.
+    void escribirCSV(BuferCSV& salida) const;
 };
 
 #endif // ALOJAMIENTO_H
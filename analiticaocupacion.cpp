@@ -0,0 +1,386 @@
+// --- analiticaocupacion.cpp ---
+// Implementación de la analítica de ocupación e ingresos (agregados parciales por hilo).
+#include "analiticaocupacion.h"
+#include "bufercsv.h"
+#include "fecha.h"
+#include "lecturacampos.h"
+#include "poolhilos.h"
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+using namespace std;
+
+// Columnas de Historico.csv que se usan
+static const int CAMPO_ALOJAMIENTO = 1;
+static const int CAMPO_ENTRADA = 3;
+static const int CAMPO_NOCHES = 4;
+static const int CAMPO_MONTO = 7;
+static const int CAMPO_ACTIVA = 9;
+static const int CAMPOS_RESERVACION = 10;
+
+static int claveMes(const Fecha& fecha) {
+    return fecha.getAnio() * 12 + fecha.getMes() - 1;
+}
+
+AnaliticaOcupacion::AnaliticaOcupacion(long diaDesde, long diaHasta, PoolHilos& pool) :
+    codigos(nullptr), anfitriones(nullptr), municipios(nullptr), cantidadAlojamientos(0), cupoAlojamientos(0),
+    parciales(nullptr), cantidadParciales(0), pool(pool), foto(nullptr), cantidadFoto(0), cupoFoto(0) {
+    mesDesde = claveMes(Fecha::desdeNumeroDia(diaDesde));
+    const int mesHasta = claveMes(Fecha::desdeNumeroDia(diaHasta));
+    cantidadMeses = mesHasta >= mesDesde ? mesHasta - mesDesde + 1 : 0;
+    mesesPorPasada = mesesEnVentana = cantidadMeses;
+    cantidadPasadas = 1;
+    pasada = inicioVentana = 0;
+}
+
+AnaliticaOcupacion::~AnaliticaOcupacion() {
+    for (int h = 0; h < cantidadParciales; ++h) {
+        delete[] parciales[h].celdas;
+    }
+    delete[] parciales;
+    delete[] foto;
+    delete[] codigos;
+    delete[] anfitriones;
+    delete[] municipios;
+}
+
+void AnaliticaOcupacion::agregarAlojamiento(const string& codigo, const string& anfitrion, const string& municipio) {
+    if (indicePorCodigo.contiene(codigo)) return;
+    if (cantidadAlojamientos == cupoAlojamientos) {
+        cupoAlojamientos = cupoAlojamientos == 0 ? 64 : cupoAlojamientos * 2;
+        string* nuevosCodigos = new string[cupoAlojamientos];
+        string* nuevosAnfitriones = new string[cupoAlojamientos];
+        string* nuevosMunicipios = new string[cupoAlojamientos];
+        for (int i = 0; i < cantidadAlojamientos; ++i) {
+            nuevosCodigos[i] = std::move(codigos[i]);
+            nuevosAnfitriones[i] = std::move(anfitriones[i]);
+            nuevosMunicipios[i] = std::move(municipios[i]);
+        }
+        delete[] codigos;
+        delete[] anfitriones;
+        delete[] municipios;
+        codigos = nuevosCodigos;
+        anfitriones = nuevosAnfitriones;
+        municipios = nuevosMunicipios;
+    }
+    codigos[cantidadAlojamientos] = codigo;
+    anfitriones[cantidadAlojamientos] = anfitrion;
+    municipios[cantidadAlojamientos] = municipio;
+    indicePorCodigo.insertar(codigo, cantidadAlojamientos);
+    cantidadAlojamientos++;
+}
+
+/**
+ * @brief Decide los parciales y las ventanas de meses dentro de 'presupuestoBytes'.
+ * Al escribir cada CSV hace falta otro agregado del mismo tamaño (los totales por
+ * grupo; con un grupo por alojamiento, igual a un parcial), así que con todos los meses
+ * caben los parciales que dejen lugar para él. Si no caben dos, se usa un solo parcial
+ * y la ventana más grande que quepa: cada pasada relee el histórico, así que se
+ * prefieren menos pasadas a más hilos.
+ */
+int AnaliticaOcupacion::preparar(int cantidad, size_t presupuestoBytes) {
+    const size_t bytesPorMes = static_cast<size_t>(cantidadAlojamientos > 0 ? cantidadAlojamientos : 1) * sizeof(Celda);
+    const size_t meses = static_cast<size_t>(cantidadMeses > 0 ? cantidadMeses : 1);
+    const size_t caben = presupuestoBytes / bytesPorMes / meses;
+    if (caben >= 2) {
+        if (static_cast<size_t>(cantidad) > caben - 1) cantidad = static_cast<int>(caben - 1);
+        mesesPorPasada = static_cast<int>(meses);
+    } else {
+        cantidad = 1;
+        const size_t ventana = presupuestoBytes / bytesPorMes / 2;
+        mesesPorPasada = ventana > 0 ? static_cast<int>(ventana) : 1;
+    }
+    if (cantidad < 1) cantidad = 1;
+    cantidadPasadas = cantidadMeses > 0 ? (cantidadMeses + mesesPorPasada - 1) / mesesPorPasada : 1;
+    inicioVentana = 0;
+    mesesEnVentana = mesesPorPasada < cantidadMeses ? mesesPorPasada : cantidadMeses;
+
+    const size_t celdas = static_cast<size_t>(cantidadAlojamientos) * static_cast<size_t>(mesesPorPasada);
+    cantidadParciales = cantidad;
+    parciales = new Parcial[cantidad];
+    for (int p = 0; p < cantidad; ++p) {
+        parciales[p].celdas = new Celda[celdas > 0 ? celdas : 1]();
+        parciales[p].estadias = parciales[p].anuladas = parciales[p].sinAlojamiento = parciales[p].conError = 0;
+    }
+    return cantidad;
+}
+
+int AnaliticaOcupacion::getPasadas() const {
+    return cantidadPasadas;
+}
+
+void AnaliticaOcupacion::sumarFoto(const string& codigoAlojamiento, long diaEntrada, int noches, long long monto,
+                                   bool activa) {
+    if (cantidadPasadas == 1) {
+        sumar(0, codigoAlojamiento, diaEntrada, noches, monto, activa);
+        return;
+    }
+    // Las métricas se cuentan ahora; las celdas, en cada pasada
+    const int* alojamiento = activa ? indicePorCodigo.buscar(codigoAlojamiento) : nullptr;
+    if (alojamiento == nullptr) {
+        sumar(0, codigoAlojamiento, diaEntrada, noches, monto, activa);
+        return;
+    }
+    parciales[0].estadias++;
+    if (cantidadFoto == cupoFoto) {
+        cupoFoto = cupoFoto == 0 ? 256 : cupoFoto * 2;
+        Estadia* nuevas = new Estadia[cupoFoto];
+        for (int i = 0; i < cantidadFoto; ++i) nuevas[i] = foto[i];
+        delete[] foto;
+        foto = nuevas;
+    }
+    foto[cantidadFoto++] = Estadia{diaEntrada, monto, *alojamiento, noches};
+}
+
+void AnaliticaOcupacion::iniciarPasada(int numero) {
+    pasada = numero;
+    inicioVentana = numero * mesesPorPasada;
+    mesesEnVentana = cantidadMeses - inicioVentana < mesesPorPasada ? cantidadMeses - inicioVentana : mesesPorPasada;
+    if (numero > 0) {
+        // El parcial 0 tiene la ventana anterior combinada y ya escrita
+        const size_t celdas = static_cast<size_t>(cantidadAlojamientos) * static_cast<size_t>(mesesPorPasada);
+        for (int p = 0; p < cantidadParciales; ++p) {
+            for (size_t i = 0; i < celdas; ++i) parciales[p].celdas[i] = Celda{};
+        }
+    }
+    for (int i = 0; i < cantidadFoto; ++i) {
+        sumarEnVentana(parciales[0], foto[i].alojamiento, foto[i].diaEntrada, foto[i].noches, foto[i].monto);
+    }
+}
+
+void AnaliticaOcupacion::sumar(int numeroParcial, const string& codigoAlojamiento, long diaEntrada, int noches,
+                               long long monto, bool activa) {
+    Parcial& parcial = parciales[numeroParcial];
+    if (!activa) {
+        if (pasada == 0) parcial.anuladas++;
+        return;
+    }
+    const int* alojamiento = indicePorCodigo.buscar(codigoAlojamiento);
+    if (alojamiento == nullptr) {
+        if (pasada == 0) parcial.sinAlojamiento++;
+        return;
+    }
+    if (pasada == 0) parcial.estadias++;
+    sumarEnVentana(parcial, *alojamiento, diaEntrada, noches, monto);
+}
+
+void AnaliticaOcupacion::sumarEnVentana(Parcial& parcial, int alojamiento, long diaEntrada, int noches,
+                                        long long monto) {
+    Celda* fila = parcial.celdas + static_cast<size_t>(alojamiento) * static_cast<size_t>(mesesPorPasada);
+    const int finVentana = inicioVentana + mesesEnVentana;
+    const long diaSalida = diaEntrada + noches;
+    long long asignado = 0;
+    for (long dia = diaEntrada; dia < diaSalida;) {
+        const Fecha fecha = Fecha::desdeNumeroDia(dia);
+        const long finDeMes = dia + Fecha::diasDelMes(fecha.getMes(), fecha.getAnio()) - fecha.getDia() + 1;
+        const long hasta = finDeMes < diaSalida ? finDeMes : diaSalida;
+        const int mes = claveMes(fecha) - mesDesde;
+        if (mes >= finVentana) break;
+        // Monto de las noches hasta 'hasta' menos lo ya repartido: la suma da el monto exacto
+        const long long acumulado = monto * (hasta - diaEntrada) / noches;
+        if (mes >= inicioVentana) {
+            Celda& celda = fila[mes - inicioVentana];
+            if (dia == diaEntrada) {
+                celda.estadias++;
+                celda.nochesEstadias += noches;
+            }
+            celda.nochesOcupadas += hasta - dia;
+            celda.ingresos += acumulado - asignado;
+        }
+        asignado = acumulado;
+        dia = hasta;
+    }
+}
+
+long long AnaliticaOcupacion::leerCSVEnParalelo(const string& archivo, long long hastaByte) {
+    struct stat datos;
+    if (::stat(archivo.c_str(), &datos) != 0) {
+        return -1;
+    }
+    long long tamano = static_cast<long long>(datos.st_size);
+    if (hastaByte >= 0 && hastaByte < tamano) tamano = hastaByte; // Lo anexado después no se lee
+    long long* lineas = new long long[cantidadParciales]();
+
+    // El tramo h va de tamano * h / n a tamano * (h + 1) / n; cada bloque lee las líneas
+    // que empiezan dentro de su tramo (la que cruza el borde es del tramo donde empieza).
+    pool.ejecutarBloques(cantidadParciales, [&](int bloque) {
+        const long long inicio = tamano * bloque / cantidadParciales;
+        const long long fin = tamano * (bloque + 1) / cantidadParciales;
+        ifstream entrada(archivo, ios::binary);
+        if (!entrada.is_open() || inicio >= fin) return;
+        string linea;
+        long long posicion = inicio;
+        if (inicio > 0) {
+            // Si el byte anterior no es un fin de línea, se está a mitad de una línea ajena
+            entrada.seekg(inicio - 1);
+            if (entrada.get() != '\n') {
+                getline(entrada, linea);
+                posicion += static_cast<long long>(linea.size()) + 1;
+            }
+        }
+        string campos[CAMPOS_RESERVACION];
+        Fecha entradaFecha;
+        int noches, activa;
+        long long monto;
+        while (posicion < fin && getline(entrada, linea)) {
+            posicion += static_cast<long long>(linea.size()) + 1;
+            if (linea.empty()) continue;
+            lineas[bloque]++;
+            if (dividirLineaCSV(linea, campos, CAMPOS_RESERVACION) != CAMPOS_RESERVACION ||
+                leerFecha(campos[CAMPO_ENTRADA], entradaFecha) != LECTURA_CORRECTA ||
+                leerEntero(campos[CAMPO_NOCHES], noches) != LECTURA_CORRECTA || noches < 0 ||
+                leerEnteroLargo(campos[CAMPO_MONTO], monto) != LECTURA_CORRECTA ||
+                leerEntero(campos[CAMPO_ACTIVA], activa) != LECTURA_CORRECTA) {
+                if (pasada == 0) parciales[bloque].conError++;
+                continue;
+            }
+            sumar(bloque, campos[CAMPO_ALOJAMIENTO], entradaFecha.aNumeroDia(), noches, monto, activa != 0);
+        }
+    });
+
+    long long total = 0;
+    for (int h = 0; h < cantidadParciales; ++h) total += lineas[h];
+    delete[] lineas;
+    return total;
+}
+
+void AnaliticaOcupacion::combinar() {
+    const size_t celdas = static_cast<size_t>(cantidadAlojamientos) * static_cast<size_t>(mesesPorPasada);
+    pool.ejecutarBloques(cantidadParciales, [&](int bloque) {
+        const size_t desde = celdas * static_cast<size_t>(bloque) / static_cast<size_t>(cantidadParciales);
+        const size_t hasta = celdas * static_cast<size_t>(bloque + 1) / static_cast<size_t>(cantidadParciales);
+        Celda* destino = parciales[0].celdas;
+        for (int h = 1; h < cantidadParciales; ++h) {
+            Celda* origen = parciales[h].celdas;
+            for (size_t i = desde; i < hasta; ++i) {
+                destino[i].estadias += origen[i].estadias;
+                destino[i].nochesEstadias += origen[i].nochesEstadias;
+                destino[i].nochesOcupadas += origen[i].nochesOcupadas;
+                destino[i].ingresos += origen[i].ingresos;
+                origen[i] = Celda{};
+            }
+        }
+    });
+    for (int h = 1; h < cantidadParciales; ++h) {
+        parciales[0].estadias += parciales[h].estadias;
+        parciales[0].anuladas += parciales[h].anuladas;
+        parciales[0].sinAlojamiento += parciales[h].sinAlojamiento;
+        parciales[0].conError += parciales[h].conError;
+        parciales[h].estadias = parciales[h].anuladas = parciales[h].sinAlojamiento = parciales[h].conError = 0;
+    }
+}
+
+bool AnaliticaOcupacion::escribirAgrupado(const string& archivo, const char* columnaGrupo, const int* grupoDe,
+                                          const string* nombresGrupos, int cantidadGrupos) const {
+    ofstream salida(archivo, ios::binary | (pasada == 0 ? ios::trunc : ios::app));
+    if (!salida.is_open()) {
+        cerr << "Error [AnaliticaOcupacion]: No se pudo crear '" << archivo << "'." << endl;
+        return false;
+    }
+    Celda* totales = new Celda[static_cast<size_t>(cantidadGrupos > 0 ? cantidadGrupos : 1) * mesesEnVentana]();
+    int* alojamientosDelGrupo = new int[cantidadGrupos > 0 ? cantidadGrupos : 1]();
+    for (int a = 0; a < cantidadAlojamientos; ++a) {
+        alojamientosDelGrupo[grupoDe[a]]++;
+        const Celda* fila = parciales[0].celdas + static_cast<size_t>(a) * mesesPorPasada;
+        Celda* total = totales + static_cast<size_t>(grupoDe[a]) * mesesEnVentana;
+        for (int m = 0; m < mesesEnVentana; ++m) {
+            total[m].estadias += fila[m].estadias;
+            total[m].nochesEstadias += fila[m].nochesEstadias;
+            total[m].nochesOcupadas += fila[m].nochesOcupadas;
+            total[m].ingresos += fila[m].ingresos;
+        }
+    }
+
+    const size_t TAMANO_BLOQUE = 1 << 20;
+    BuferCSV bloque(TAMANO_BLOQUE + 4096);
+    if (pasada == 0) {
+        bloque.agregar(string(columnaGrupo) +
+                       ",Mes,Alojamientos,Estadias,NochesOcupadas,NochesDisponibles,OcupacionPct,Ingresos,EstadiaPromedio\n");
+    }
+    for (int g = 0; g < cantidadGrupos; ++g) {
+        for (int m = 0; m < mesesEnVentana; ++m) {
+            const Celda& celda = totales[static_cast<size_t>(g) * mesesEnVentana + m];
+            const int anio = (mesDesde + inicioVentana + m) / 12;
+            const int mes = (mesDesde + inicioVentana + m) % 12 + 1;
+            const long long disponibles = static_cast<long long>(alojamientosDelGrupo[g]) * Fecha::diasDelMes(mes, anio);
+            if (nombresGrupos[g].find_first_of(",\"") != string::npos) {
+                bloque.agregarEntreComillas(nombresGrupos[g]);
+            } else {
+                bloque.agregar(nombresGrupos[g]);
+            }
+            bloque.agregar(',');
+            bloque.agregarEntero(anio);
+            bloque.agregar(mes < 10 ? "-0" : "-", mes < 10 ? 2 : 1);
+            bloque.agregarEntero(mes);
+            bloque.agregar(',');
+            bloque.agregarEntero(alojamientosDelGrupo[g]);
+            bloque.agregar(',');
+            bloque.agregarEntero(celda.estadias);
+            bloque.agregar(',');
+            bloque.agregarEntero(celda.nochesOcupadas);
+            bloque.agregar(',');
+            bloque.agregarEntero(disponibles);
+            bloque.agregar(',');
+            bloque.agregarDecimal(disponibles > 0 ? 100.0 * celda.nochesOcupadas / disponibles : 0.0);
+            bloque.agregar(',');
+            bloque.agregarEntero(celda.ingresos);
+            bloque.agregar(',');
+            bloque.agregarDecimal(celda.estadias > 0 ? static_cast<double>(celda.nochesEstadias) / celda.estadias : 0.0);
+            bloque.agregar('\n');
+            if (bloque.getTamano() >= TAMANO_BLOQUE) {
+                salida.write(bloque.getDatos(), static_cast<streamsize>(bloque.getTamano()));
+                bloque.limpiar();
+            }
+        }
+    }
+    salida.write(bloque.getDatos(), static_cast<streamsize>(bloque.getTamano()));
+    delete[] totales;
+    delete[] alojamientosDelGrupo;
+    return static_cast<bool>(salida);
+}
+
+bool AnaliticaOcupacion::escribir(const string& prefijo) const {
+    int* grupoDe = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+    for (int a = 0; a < cantidadAlojamientos; ++a) grupoDe[a] = a;
+    bool exito = escribirAgrupado(prefijo + "_alojamientos.csv", "Alojamiento", grupoDe, codigos, cantidadAlojamientos);
+
+    // Anfitriones y municipios: grupos en el orden en que aparecen por primera vez
+    const string* claves[2] = {anfitriones, municipios};
+    const char* columnas[2] = {"Anfitrion", "Municipio"};
+    const char* sufijos[2] = {"_anfitriones.csv", "_municipios.csv"};
+    string* nombres = new string[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+    for (int k = 0; k < 2; ++k) {
+        TablaHash<int> grupos;
+        int cantidadGrupos = 0;
+        for (int a = 0; a < cantidadAlojamientos; ++a) {
+            const int* grupo = grupos.buscar(claves[k][a]);
+            if (grupo == nullptr) {
+                nombres[cantidadGrupos] = claves[k][a];
+                grupos.insertar(claves[k][a], cantidadGrupos);
+                grupoDe[a] = cantidadGrupos++;
+            } else {
+                grupoDe[a] = *grupo;
+            }
+        }
+        exito = escribirAgrupado(prefijo + sufijos[k], columnas[k], grupoDe, nombres, cantidadGrupos) && exito;
+    }
+    delete[] nombres;
+    delete[] grupoDe;
+    return exito;
+}
+
+AnaliticaOcupacion::Metricas AnaliticaOcupacion::getMetricas() const {
+    const int hilosPool = pool.getCantidadHilos() + 1;
+    Metricas m{0, 0, 0, 0, cantidadParciales, hilosPool < cantidadParciales ? hilosPool : cantidadParciales,
+               cantidadPasadas,
+               static_cast<size_t>(cantidadParciales) * static_cast<size_t>(cantidadAlojamientos) *
+                   static_cast<size_t>(mesesPorPasada) * sizeof(Celda),
+               static_cast<size_t>(cupoFoto) * sizeof(Estadia)};
+    for (int h = 0; h < cantidadParciales; ++h) {
+        m.estadias += parciales[h].estadias;
+        m.anuladas += parciales[h].anuladas;
+        m.sinAlojamiento += parciales[h].sinAlojamiento;
+        m.conError += parciales[h].conError;
+    }
+    return m;
+}
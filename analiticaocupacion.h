@@ -0,0 +1,134 @@
+#ifndef ANALITICAOCUPACION_H
+#define ANALITICAOCUPACION_H
+
+#include <string>
+#include "tablahash.h"
+
+class PoolHilos;
+
+// Ocupación, ingresos y duración de las estadías por alojamiento y por mes, con los
+// totales por anfitrión y por municipio.
+//
+// El trabajo se reparte en bloques de un PoolHilos, uno por agregado parcial (una celda
+// por alojamiento y mes): cada bloque suma solo en el suyo, sin candados ni variables
+// compartidas, y al final los parciales se suman en uno. Los parciales (y los totales
+// por grupo al escribir) se recortan para que quepan en el presupuesto; si ni uno solo
+// cabe con todos los meses, el cálculo se hace por ventanas de meses, una pasada por
+// ventana (cada una vuelve a leer el histórico y escribe sus filas al final de los
+// CSV). El mínimo es una ventana de un mes.
+//
+// Las estadías de la foto (las que quien llama suma con sus candados tomados) no se
+// pueden volver a leer: con varias pasadas se guardan, 24 bytes cada una, para sumarlas
+// en cada ventana. Es lo único que crece con las estadías, y solo cuando el
+// presupuesto no alcanza para todos los meses.
+//
+// Por cada estadía no anulada:
+//   - las noches ocupadas y el monto se reparten entre los meses que toca (el monto en
+//     proporción a las noches de cada mes, sin perder pesos por redondeo);
+//   - la estadía y sus noches cuentan en el mes de entrada (para la duración promedio).
+// Solo se cuentan los meses completos entre el de 'desde' y el de 'hasta'.
+class AnaliticaOcupacion {
+public:
+    struct Celda {
+        long long estadias;          // Estadías que entran ese mes
+        long long nochesEstadias;    // Noches de esas estadías
+        long long nochesOcupadas;    // Noches del mes ocupadas
+        long long ingresos;          // Monto de las noches del mes
+    };
+
+    struct Metricas {
+        long long estadias;          // Estadías sumadas (no anuladas)
+        long long anuladas;          // Registros de anulaciones (no ocupan noches)
+        long long sinAlojamiento;    // Alojamiento que no está en Alojamientos.csv
+        long long conError;          // Líneas que no se pudieron leer
+        int parciales;
+        int hilos;                   // Hilos del pool que pudieron sumar a la vez
+        int pasadas;                 // Ventanas de meses
+        size_t bytesParciales;       // Memoria de todos los agregados parciales
+        size_t bytesFoto;            // Estadías de la foto guardadas para las pasadas
+    };
+
+private:
+    // Cada bloque escribe solo el suyo; alineado para que los contadores de dos hilos no
+    // compartan línea de cache
+    struct alignas(64) Parcial {
+        Celda* celdas;               // [alojamiento * mesesPorPasada + mes - inicioVentana]
+        long long estadias, anuladas, sinAlojamiento, conError;
+    };
+
+    // Estadía de la foto guardada para repetirla en cada pasada
+    struct Estadia {
+        long diaEntrada;
+        long long monto;
+        int alojamiento;
+        int noches;
+    };
+
+    int mesDesde;                    // anio * 12 + (mes - 1)
+    int cantidadMeses;
+    int mesesPorPasada;
+    int cantidadPasadas;
+    int pasada;                      // Las métricas se cuentan solo en la primera
+    int inicioVentana;               // Primer mes de la pasada (desde mesDesde)
+    int mesesEnVentana;
+
+    Estadia* foto;
+    int cantidadFoto;
+    int cupoFoto;
+
+    std::string* codigos;
+    std::string* anfitriones;
+    std::string* municipios;
+    int cantidadAlojamientos;
+    int cupoAlojamientos;
+    TablaHash<int> indicePorCodigo;
+
+    Parcial* parciales;
+    int cantidadParciales;
+    PoolHilos& pool;
+
+    // Reparte una estadía entre los meses de la ventana actual.
+    void sumarEnVentana(Parcial& parcial, int alojamiento, long diaEntrada, int noches, long long monto);
+    // Escribe un CSV con una fila por grupo y mes de la ventana (desde la segunda pasada,
+    // al final del archivo); grupoDe[a] es el grupo del alojamiento a.
+    bool escribirAgrupado(const std::string& archivo, const char* columnaGrupo, const int* grupoDe,
+                          const std::string* nombresGrupos, int cantidadGrupos) const;
+
+public:
+    AnaliticaOcupacion(long diaDesde, long diaHasta, PoolHilos& pool);
+    ~AnaliticaOcupacion();
+
+    AnaliticaOcupacion(const AnaliticaOcupacion&) = delete;
+    AnaliticaOcupacion& operator=(const AnaliticaOcupacion&) = delete;
+
+    // Se llaman antes de preparar(). Ante códigos repetidos vale el primero.
+    void agregarAlojamiento(const std::string& codigo, const std::string& anfitrion, const std::string& municipio);
+    // Crea los parciales: 'parciales', o menos si no caben en 'presupuestoBytes' (al
+    // menos uno), y decide las ventanas de meses. Devuelve cuántos creó.
+    int preparar(int parciales, size_t presupuestoBytes);
+    int getPasadas() const;
+    // Suma una estadía de la foto; con varias pasadas la guarda para cada ventana. Va
+    // después de preparar() y antes de iniciarPasada(0).
+    void sumarFoto(const std::string& codigoAlojamiento, long diaEntrada, int noches, long long monto, bool activa);
+    // Deja los parciales en cero para la ventana 'numero' (0 .. getPasadas() - 1) y le
+    // suma la foto guardada. En cada pasada se lee el histórico, se combina y se escribe.
+    void iniciarPasada(int numero);
+
+    // Suma una estadía al parcial indicado (0 .. preparar() - 1). Sin candados: dos
+    // hilos no deben usar el mismo parcial a la vez.
+    void sumar(int parcial, const std::string& codigoAlojamiento, long diaEntrada, int noches, long long monto,
+               bool activa);
+    // Lee un CSV de reservaciones (formato de Historico.csv, sin cabecera) repartiendo el
+    // archivo en tramos de bytes, un bloque por parcial. Con hastaByte >= 0 lee solo ese
+    // prefijo (debe terminar en un fin de línea). Devuelve las líneas leídas o -1.
+    long long leerCSVEnParalelo(const std::string& archivo, long long hastaByte = -1);
+    // Suma todos los parciales en el primero (repartiendo las celdas en bloques).
+    void combinar();
+
+    // Escribe <prefijo>_alojamientos.csv, <prefijo>_anfitriones.csv y <prefijo>_municipios.csv
+    // (los meses de la pasada actual).
+    bool escribir(const std::string& prefijo) const;
+    Metricas getMetricas() const;
+};
+
+#endif // ANALITICAOCUPACION_H
@@ -67,6 +67,17 @@ float Anfitrion::getPuntuacion() const {
     return puntuacion;
 }
 
+int Anfitrion::getCantidadAlojamientos() const {
+    return cantidad;
+}
+
+string Anfitrion::getCodigoAlojamiento(int i) const {
+    if (i >= 0 && i < cantidad) {
+        return codigosAlojamiento[i];
+    }
+    return "";
+}
+
 void Anfitrion::agregarCodigoAlojamiento(const string &codigoAlo) {
     if (cantidad == capacidad) {
         capacidad *= 2;
@@ -80,6 +91,19 @@ void Anfitrion::agregarCodigoAlojamiento(const string &codigoAlo) {
     codigosAlojamiento[cantidad++] = codigoAlo;
 }
 
+bool Anfitrion::eliminarCodigoAlojamiento(const string &codigoAlo) {
+    for (int i = 0; i < cantidad; i++) {
+        if (codigosAlojamiento[i] == codigoAlo) {
+            for (int j = i + 1; j < cantidad; j++) {
+                codigosAlojamiento[j - 1] = codigosAlojamiento[j];
+            }
+            cantidad--;
+            return true;
+        }
+    }
+    return false;
+}
+
 void Anfitrion::mostrarDetalles() const {
     cout << "ID: " << id << endl;
     cout << "Nombre completo: " << nombre << endl;
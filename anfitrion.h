@@ -37,6 +37,10 @@ public:
 
     //agregar codigo de alojamiento
     void agregarCodigoAlojamiento(const string& codigoAlo);
+    // Quita el código (si está) conservando el orden de los demás
+    bool eliminarCodigoAlojamiento(const string& codigoAlo);
+    int getCantidadAlojamientos() const;
+    string getCodigoAlojamiento(int i) const;
 
     //informacion del anfitrion
     void mostrarDetalles() const;
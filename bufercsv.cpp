@@ -0,0 +1,95 @@
+// --- bufercsv.cpp ---
+// Implementación del búfer de salida para registros CSV.
+#include "bufercsv.h"
+#include "fecha.h"
+#include <charconv>
+#include <cstring>
+using namespace std;
+
+BuferCSV::BuferCSV() : datos(nullptr), tamano(0), cupo(0) {
+}
+
+BuferCSV::BuferCSV(size_t cupoInicial) : datos(nullptr), tamano(0), cupo(0) {
+    reservar(cupoInicial);
+}
+
+BuferCSV::~BuferCSV() {
+    delete[] datos;
+}
+
+void BuferCSV::reservar(size_t adicional) {
+    if (tamano + adicional <= cupo) return;
+    size_t nuevoCupo = cupo == 0 ? 256 : cupo * 2;
+    while (nuevoCupo < tamano + adicional) nuevoCupo *= 2;
+    char* nuevos = new char[nuevoCupo];
+    if (tamano > 0) memcpy(nuevos, datos, tamano);
+    delete[] datos;
+    datos = nuevos;
+    cupo = nuevoCupo;
+}
+
+void BuferCSV::agregar(char c) {
+    reservar(1);
+    datos[tamano++] = c;
+}
+
+void BuferCSV::agregar(const char* texto, size_t largo) {
+    reservar(largo);
+    memcpy(datos + tamano, texto, largo);
+    tamano += largo;
+}
+
+void BuferCSV::agregar(const string& texto) {
+    agregar(texto.data(), texto.size());
+}
+
+void BuferCSV::agregarEntero(long long valor) {
+    reservar(20);
+    tamano = static_cast<size_t>(to_chars(datos + tamano, datos + cupo, valor).ptr - datos);
+}
+
+void BuferCSV::agregarDecimal(double valor) {
+    reservar(32);
+    to_chars_result r = to_chars(datos + tamano, datos + cupo, valor, chars_format::fixed, 2);
+    if (r.ec != errc()) { // Solo con valores enormes: mejor 0 que una línea rota
+        agregar("0.00", 4);
+        return;
+    }
+    tamano = static_cast<size_t>(r.ptr - datos);
+}
+
+void BuferCSV::agregarFecha(const Fecha& fecha) {
+    reservar(Fecha::LARGO_MAXIMO_TEXTO);
+    tamano += static_cast<size_t>(fecha.escribirEn(datos + tamano));
+}
+
+void BuferCSV::agregarEntreComillas(const string& texto) {
+    reservar(texto.size() + 2);
+    datos[tamano++] = '"';
+    const char* inicio = texto.data();
+    const char* fin = inicio + texto.size();
+    const char* comilla;
+    while ((comilla = static_cast<const char*>(memchr(inicio, '"', static_cast<size_t>(fin - inicio)))) != nullptr) {
+        agregar(inicio, static_cast<size_t>(comilla - inicio) + 1);
+        agregar('"'); // La comilla se duplica
+        inicio = comilla + 1;
+    }
+    agregar(inicio, static_cast<size_t>(fin - inicio));
+    agregar('"');
+}
+
+const char* BuferCSV::getDatos() const {
+    return datos;
+}
+
+size_t BuferCSV::getTamano() const {
+    return tamano;
+}
+
+string BuferCSV::aString() const {
+    return string(datos == nullptr ? "" : datos, tamano);
+}
+
+void BuferCSV::limpiar() {
+    tamano = 0;
+}
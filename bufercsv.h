@@ -0,0 +1,46 @@
+#ifndef BUFERCSV_H
+#define BUFERCSV_H
+
+#include <cstddef>
+#include <string>
+
+class Fecha;
+
+// Búfer de salida reutilizable para escribir registros CSV sin crear un string por
+// campo ni por registro. Los números se formatean con std::to_chars (sin locale) y
+// las fechas con la tabla de dos dígitos de Fecha. El espacio crece al doble y no se
+// libera al limpiar: al serializar muchos registros se reserva solo al principio.
+class BuferCSV {
+private:
+    char* datos;
+    size_t tamano;
+    size_t cupo;
+
+    // Garantiza espacio para 'adicional' caracteres más.
+    void reservar(size_t adicional);
+
+public:
+    BuferCSV();
+    explicit BuferCSV(size_t cupoInicial);
+    ~BuferCSV();
+
+    BuferCSV(const BuferCSV&) = delete;
+    BuferCSV& operator=(const BuferCSV&) = delete;
+
+    void agregar(char c);
+    void agregar(const char* texto, size_t largo);
+    void agregar(const std::string& texto);
+    void agregarEntero(long long valor);
+    // Número con dos decimales fijos ("180000.00"), como los precios.
+    void agregarDecimal(double valor);
+    void agregarFecha(const Fecha& fecha);
+    // Campo entre comillas; una comilla interna se escribe doble ("" ) como pide CSV.
+    void agregarEntreComillas(const std::string& texto);
+
+    const char* getDatos() const;
+    size_t getTamano() const;
+    std::string aString() const;
+    void limpiar();          // Deja el búfer vacío, conservando el espacio reservado
+};
+
+#endif // BUFERCSV_H
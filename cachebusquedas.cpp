@@ -0,0 +1,262 @@
+// --- cachebusquedas.cpp ---
+// Implementación de la cache LRU de búsquedas de disponibilidad.
+#include "cachebusquedas.h"
+#include <cstring>
+using namespace std;
+
+CacheBusquedas::CacheBusquedas() :
+    entradas(nullptr), cupo(0), usadas(0), libres(nullptr), cantidadLibres(0),
+    masReciente(-1), menosReciente(-1), bytesOcupados(0), presupuestoBytes(0), cambios(0),
+    ultimoCambioOlvidado(0), aciertos(0), fallos(0), invalidadas(0), desalojadas(0) {
+}
+
+CacheBusquedas::~CacheBusquedas() {
+    for (int i = 0; i < usadas; ++i) {
+        delete[] entradas[i].resultado;
+    }
+    delete[] entradas;
+    delete[] libres;
+}
+
+string CacheBusquedas::construirClave(const string& municipio, long diaEntrada, long diaSalida,
+                                     long long precioNocheMaximo, long long costoMaximo) {
+    return municipio + "|" + to_string(diaEntrada) + "|" + to_string(diaSalida) + "|" +
+           to_string(precioNocheMaximo < 0 ? -1 : precioNocheMaximo) + "|" + to_string(costoMaximo < 0 ? -1 : costoMaximo);
+}
+
+void CacheBusquedas::desenlazar(int posicion) {
+    Entrada& e = entradas[posicion];
+    if (e.anterior >= 0) entradas[e.anterior].siguiente = e.siguiente;
+    else masReciente = e.siguiente;
+    if (e.siguiente >= 0) entradas[e.siguiente].anterior = e.anterior;
+    else menosReciente = e.anterior;
+    e.anterior = e.siguiente = -1;
+}
+
+void CacheBusquedas::enlazarAlFrente(int posicion) {
+    Entrada& e = entradas[posicion];
+    e.anterior = -1;
+    e.siguiente = masReciente;
+    if (masReciente >= 0) entradas[masReciente].anterior = posicion;
+    masReciente = posicion;
+    if (menosReciente < 0) menosReciente = posicion;
+}
+
+void CacheBusquedas::descartar(int posicion) {
+    Entrada& e = entradas[posicion];
+    desenlazar(posicion);
+    Grupo* grupo = gruposPorMunicipio.buscar(e.municipio);
+    if (e.anteriorEnGrupo >= 0) entradas[e.anteriorEnGrupo].siguienteEnGrupo = e.siguienteEnGrupo;
+    else grupo->primera = e.siguienteEnGrupo;
+    if (e.siguienteEnGrupo >= 0) entradas[e.siguienteEnGrupo].anteriorEnGrupo = e.anteriorEnGrupo;
+    if (grupo->primera < 0) {
+        // Sin grupo, sus invalidaciones se recuerdan solo en ultimoCambioOlvidado
+        if (grupo->ultimoCambio > ultimoCambioOlvidado) ultimoCambioOlvidado = grupo->ultimoCambio;
+        gruposPorMunicipio.eliminar(e.municipio);
+    }
+    indicePorClave.eliminar(e.clave);
+    bytesOcupados -= e.bytes;
+    delete[] e.resultado;
+    e = Entrada();
+    libres[cantidadLibres++] = posicion;
+}
+
+int CacheBusquedas::obtenerPosicionLibre() {
+    if (cantidadLibres > 0) {
+        return libres[--cantidadLibres];
+    }
+    if (usadas == cupo) {
+        int nuevoCupo = cupo == 0 ? 64 : cupo * 2;
+        Entrada* nuevas = new Entrada[nuevoCupo];
+        for (int i = 0; i < usadas; ++i) {
+            nuevas[i] = std::move(entradas[i]);
+        }
+        delete[] entradas;
+        delete[] libres;
+        entradas = nuevas;
+        libres = new int[nuevoCupo]; // Vacía: solo se llega aquí sin posiciones libres
+        cupo = nuevoCupo;
+    }
+    return usadas++;
+}
+
+size_t CacheBusquedas::memoriaOcupada() const {
+    return bytesOcupados + static_cast<size_t>(cupo) * (sizeof(Entrada) + sizeof(int)) +
+           indicePorClave.memoriaAproximada() + gruposPorMunicipio.memoriaAproximada();
+}
+
+size_t CacheBusquedas::crecimientoDeEntradas() const {
+    if (cantidadLibres > 0 || usadas < cupo) {
+        return 0;
+    }
+    const int nuevoCupo = cupo == 0 ? 64 : cupo * 2;
+    return static_cast<size_t>(nuevoCupo - cupo) * (sizeof(Entrada) + sizeof(int));
+}
+
+void CacheBusquedas::liberarEstructuras() {
+    delete[] entradas;
+    delete[] libres;
+    entradas = nullptr;
+    libres = nullptr;
+    cupo = usadas = cantidadLibres = 0;
+    indicePorClave.vaciar();
+    gruposPorMunicipio.vaciar(); // Ya vacío: cada grupo se borra con su última entrada
+}
+
+void CacheBusquedas::setPresupuesto(size_t bytes) {
+    lock_guard<mutex> bloqueo(mutexCache);
+    presupuestoBytes = bytes;
+    ultimoCambioOlvidado = ++cambios; // Mientras estuvo desactivada no se registraron invalidaciones
+    while (menosReciente >= 0 && memoriaOcupada() > presupuestoBytes) {
+        descartar(menosReciente);
+        desalojadas++;
+    }
+    if (menosReciente < 0) {
+        liberarEstructuras();
+    }
+}
+
+bool CacheBusquedas::estaActiva() const {
+    lock_guard<mutex> bloqueo(mutexCache);
+    return presupuestoBytes > 0;
+}
+
+int CacheBusquedas::buscar(const string& municipio, long diaEntrada, long diaSalida, long long precioNocheMaximo,
+                           long long costoMaximo, int* resultado, unsigned long long& marca) {
+    lock_guard<mutex> bloqueo(mutexCache);
+    marca = cambios;
+    if (presupuestoBytes == 0) {
+        return -1;
+    }
+    const int* posicion =
+        indicePorClave.buscar(construirClave(municipio, diaEntrada, diaSalida, precioNocheMaximo, costoMaximo));
+    if (posicion == nullptr) {
+        fallos++;
+        return -1;
+    }
+    aciertos++;
+    Entrada& e = entradas[*posicion];
+    if (e.cantidad > 0) {
+        memcpy(resultado, e.resultado, static_cast<size_t>(e.cantidad) * sizeof(int));
+    }
+    if (masReciente != *posicion) {
+        int p = *posicion;
+        desenlazar(p);
+        enlazarAlFrente(p);
+    }
+    return e.cantidad;
+}
+
+void CacheBusquedas::guardar(const string& municipio, long diaEntrada, long diaSalida, long long precioNocheMaximo,
+                             long long costoMaximo, const int* resultado, int cantidad, unsigned long long marca) {
+    lock_guard<mutex> bloqueo(mutexCache);
+    const Grupo* grupo = gruposPorMunicipio.buscar(municipio);
+    if ((grupo != nullptr ? grupo->ultimoCambio : ultimoCambioOlvidado) > marca) {
+        return; // Se calculó mientras cambiaban noches: ya no se sabe si sigue vigente
+    }
+    string clave = construirClave(municipio, diaEntrada, diaSalida, precioNocheMaximo, costoMaximo);
+    size_t bytes = clave.size() + municipio.size() + static_cast<size_t>(cantidad) * sizeof(int);
+    if (bytes > presupuestoBytes) {
+        return; // No cabe (o la cache está desactivada)
+    }
+    const int* anterior = indicePorClave.buscar(clave);
+    if (anterior != nullptr) {
+        descartar(*anterior); // Dos búsquedas iguales a la vez: queda la última
+    }
+    while (menosReciente >= 0 && memoriaOcupada() + crecimientoDeEntradas() + bytes > presupuestoBytes) {
+        descartar(menosReciente);
+        desalojadas++;
+    }
+    if (memoriaOcupada() + crecimientoDeEntradas() + bytes > presupuestoBytes) {
+        return; // Ni con la cache vacía cabe junto con su arreglo
+    }
+
+    int posicion = obtenerPosicionLibre();
+    Entrada& e = entradas[posicion];
+    e.clave = clave;
+    e.municipio = municipio;
+    e.diaEntrada = diaEntrada;
+    e.diaSalida = diaSalida;
+    e.cantidad = cantidad;
+    e.resultado = cantidad > 0 ? new int[cantidad] : nullptr;
+    if (cantidad > 0) {
+        memcpy(e.resultado, resultado, static_cast<size_t>(cantidad) * sizeof(int));
+    }
+    e.bytes = bytes;
+    bytesOcupados += bytes;
+    Grupo* suGrupo = gruposPorMunicipio.buscar(municipio);
+    if (suGrupo == nullptr) {
+        Grupo nuevo;
+        nuevo.ultimoCambio = ultimoCambioOlvidado; // Hereda lo que se invalidó sin grupo
+        gruposPorMunicipio.insertar(municipio, nuevo);
+        suGrupo = gruposPorMunicipio.buscar(municipio);
+    }
+    e.siguienteEnGrupo = suGrupo->primera;
+    if (suGrupo->primera >= 0) entradas[suGrupo->primera].anteriorEnGrupo = posicion;
+    suGrupo->primera = posicion;
+    indicePorClave.insertar(clave, posicion);
+    enlazarAlFrente(posicion);
+    // Los índices pudieron crecer al insertar
+    while (menosReciente >= 0 && memoriaOcupada() > presupuestoBytes) {
+        descartar(menosReciente);
+        desalojadas++;
+    }
+    if (menosReciente < 0) {
+        liberarEstructuras();
+    }
+}
+
+/**
+ * @brief Un cambio en las noches [diaEntrada, diaSalida) de un alojamiento de 'municipio'
+ * solo altera las consultas cuyas noches se cruzan con esas y que cubren ese municipio.
+ * Solo se recorren los grupos de ese municipio y de "cualquier municipio": el costo
+ * depende de las consultas guardadas de ese municipio, no del tamaño de la cache.
+ */
+void CacheBusquedas::invalidar(const string& municipio, long diaEntrada, long diaSalida) {
+    lock_guard<mutex> bloqueo(mutexCache);
+    cambios++;
+    invalidarGrupo(municipio, diaEntrada, diaSalida);
+    if (!municipio.empty()) {
+        invalidarGrupo("", diaEntrada, diaSalida);
+    }
+}
+
+void CacheBusquedas::invalidarGrupo(const string& municipio, long diaEntrada, long diaSalida) {
+    Grupo* grupo = gruposPorMunicipio.buscar(municipio);
+    if (grupo == nullptr) {
+        ultimoCambioOlvidado = cambios; // Una búsqueda de ese municipio pudo estar calculándose
+        return;
+    }
+    grupo->ultimoCambio = cambios;
+    int posicion = grupo->primera; // descartar puede borrar el grupo: no se vuelve a usar
+    while (posicion >= 0) {
+        int siguiente = entradas[posicion].siguienteEnGrupo;
+        const Entrada& e = entradas[posicion];
+        if (e.diaEntrada < diaSalida && diaEntrada < e.diaSalida) {
+            descartar(posicion);
+            invalidadas++;
+        }
+        posicion = siguiente;
+    }
+}
+
+void CacheBusquedas::vaciar() {
+    lock_guard<mutex> bloqueo(mutexCache);
+    while (menosReciente >= 0) {
+        descartar(menosReciente);
+    }
+    liberarEstructuras();
+}
+
+CacheBusquedas::Metricas CacheBusquedas::getMetricas() const {
+    lock_guard<mutex> bloqueo(mutexCache);
+    Metricas m;
+    m.aciertos = aciertos;
+    m.fallos = fallos;
+    m.invalidadas = invalidadas;
+    m.desalojadas = desalojadas;
+    m.entradas = usadas - cantidadLibres;
+    m.bytes = memoriaOcupada();
+    m.presupuesto = presupuestoBytes;
+    return m;
+}
@@ -0,0 +1,123 @@
+#ifndef CACHEBUSQUEDAS_H
+#define CACHEBUSQUEDAS_H
+
+#include <cstddef>
+#include <string>
+#include <mutex>
+#include "tablahash.h"
+
+// Resultados recientes de la búsqueda de disponibilidad (posiciones de alojamientos),
+// con la clave normalizada de la consulta: municipio en minúsculas y sin espacios
+// sobrantes, día de entrada, día de salida y los topes de precio (-1 = sin tope).
+//
+// Se descartan primero las menos usadas (LRU) cuando la memoria ocupada pasa del
+// presupuesto; la memoria cuenta también el arreglo de entradas y los índices. Una
+// reserva, anulación o archivado invalida solo las consultas que podrían cambiar: las
+// de noches que se cruzan con las del cambio y del municipio del alojamiento (o de
+// cualquier municipio). Para no recorrer toda la cache en cada cambio, las entradas
+// de cada municipio forman una lista propia (ver Grupo) y solo se revisan esas dos.
+//
+// Tiene su propio mutex: se consulta y se llena desde búsquedas concurrentes que solo
+// tienen el candado compartido del gestor. El gestor invalida después de cada cambio,
+// a veces con ese mismo candado compartido (una reserva que devuelve noches tomadas a
+// medias), así que una búsqueda pudo calcular su resultado con el cambio a medio hacer.
+// Por eso buscar entrega una marca de invalidaciones y guardar descarta el resultado si
+// hubo alguna invalidación desde esa marca.
+class CacheBusquedas {
+public:
+    struct Metricas {
+        unsigned long long aciertos;
+        unsigned long long fallos;
+        unsigned long long invalidadas;   // Entradas descartadas por un cambio en sus noches
+        unsigned long long desalojadas;   // Entradas descartadas por falta de presupuesto
+        int entradas;
+        size_t bytes;
+        size_t presupuesto;
+    };
+
+private:
+    struct Entrada {
+        std::string clave;
+        std::string municipio;        // "" = cualquier municipio
+        long diaEntrada;
+        long diaSalida;
+        int* resultado;
+        int cantidad;
+        size_t bytes;                 // Clave, municipio y resultado
+        int anterior;                 // Vecinos en la lista LRU (-1 = ninguno)
+        int siguiente;
+        int anteriorEnGrupo;          // Vecinos en la lista de su municipio
+        int siguienteEnGrupo;
+        Entrada() : diaEntrada(0), diaSalida(0), resultado(nullptr), cantidad(0), bytes(0),
+                    anterior(-1), siguiente(-1), anteriorEnGrupo(-1), siguienteEnGrupo(-1) {}
+    };
+
+    // Entradas de un municipio ("" = las de cualquier municipio). Existe mientras tenga
+    // alguna; ultimoCambio es el número de la última invalidación que lo tocó.
+    struct Grupo {
+        int primera;
+        unsigned long long ultimoCambio;
+        Grupo() : primera(-1), ultimoCambio(0) {}
+    };
+
+    mutable std::mutex mutexCache;
+    Entrada* entradas;
+    int cupo;
+    int usadas;                       // Posiciones de 'entradas' ya usadas alguna vez
+    int* libres;                      // Posiciones liberadas para reutilizar
+    int cantidadLibres;
+    int masReciente;                  // Cabeza de la lista LRU
+    int menosReciente;                // Cola de la lista LRU
+    TablaHash<int> indicePorClave;    // Clave -> posición en 'entradas'
+    TablaHash<Grupo> gruposPorMunicipio;
+    size_t bytesOcupados;             // Claves y resultados de las entradas guardadas
+    size_t presupuestoBytes;          // 0 = cache desactivada
+    unsigned long long cambios;       // Invalidaciones hechas (marca de buscar / guardar)
+    // Mayor ultimoCambio de los grupos que ya no existen (o invalidados sin existir):
+    // vale para los municipios sin grupo
+    unsigned long long ultimoCambioOlvidado;
+    unsigned long long aciertos, fallos, invalidadas, desalojadas;
+
+    static std::string construirClave(const std::string& municipio, long diaEntrada, long diaSalida,
+                                      long long precioNocheMaximo, long long costoMaximo);
+    void desenlazar(int posicion);
+    void enlazarAlFrente(int posicion);
+    void descartar(int posicion);     // Libera la entrada y la quita de las listas y del índice
+    int obtenerPosicionLibre();
+    // Entradas, arreglos e índices (lo que se compara con el presupuesto)
+    size_t memoriaOcupada() const;
+    // Lo que crecería el arreglo de entradas al guardar una más
+    size_t crecimientoDeEntradas() const;
+    // Descarta las entradas del grupo que se cruzan con [diaEntrada, diaSalida)
+    void invalidarGrupo(const std::string& municipio, long diaEntrada, long diaSalida);
+    // Libera el arreglo y los índices cuando la cache queda vacía
+    void liberarEstructuras();
+
+public:
+    CacheBusquedas();
+    ~CacheBusquedas();
+
+    CacheBusquedas(const CacheBusquedas&) = delete;
+    CacheBusquedas& operator=(const CacheBusquedas&) = delete;
+
+    // Cambia el presupuesto de memoria (desaloja lo que sobre); 0 la desactiva y la vacía.
+    void setPresupuesto(size_t bytes);
+    bool estaActiva() const;
+
+    // Si la consulta está guardada copia el resultado en 'resultado' (debe tener cupo)
+    // y devuelve la cantidad; si no, devuelve -1 y deja en 'marca' lo que se pasa a
+    // guardar con el resultado calculado.
+    int buscar(const std::string& municipio, long diaEntrada, long diaSalida, long long precioNocheMaximo,
+               long long costoMaximo, int* resultado, unsigned long long& marca);
+    // No guarda nada si desde 'marca' se invalidó algo (el resultado pudo quedar viejo).
+    void guardar(const std::string& municipio, long diaEntrada, long diaSalida, long long precioNocheMaximo,
+                 long long costoMaximo, const int* resultado, int cantidad, unsigned long long marca);
+    // Descarta las consultas que se cruzan con [diaEntrada, diaSalida) y cubren 'municipio'
+    // (solo revisa las de ese municipio y las de cualquiera).
+    void invalidar(const std::string& municipio, long diaEntrada, long diaSalida);
+    void vaciar();
+
+    Metricas getMetricas() const;
+};
+
+#endif // CACHEBUSQUEDAS_H
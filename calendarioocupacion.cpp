@@ -0,0 +1,175 @@
+// --- calendarioocupacion.cpp ---
+// Implementación del calendario de noches ocupadas con reclamos atómicos.
+#include "calendarioocupacion.h"
+using namespace std;
+
+// Máscara de las noches [dia, fin) dentro de la palabra de 64 bits de 'dia' (mismo bloque de 64).
+static uint64_t mascaraDeNoches(long dia, long fin) {
+    int primerBit = static_cast<int>(dia % 64);
+    int bits = static_cast<int>(fin - dia);
+    uint64_t unos = bits == 64 ? ~0ULL : ((1ULL << bits) - 1);
+    return unos << primerBit;
+}
+
+// Fin del tramo que empieza en 'dia' y no sale de su palabra ni de 'diaSalida'.
+static long finDeTramo(long dia, long diaSalida) {
+    long finPalabra = (dia / 64 + 1) * 64;
+    return finPalabra < diaSalida ? finPalabra : diaSalida;
+}
+
+CalendarioOcupacion::CalendarioOcupacion() :
+    paginas(nullptr), cantidadAlojamientos(0),
+    reclamos(0), conflictos(0), reversiones(0), reintentos(0), paginasCreadas(0) {
+}
+
+CalendarioOcupacion::~CalendarioOcupacion() {
+    vaciar();
+}
+
+void CalendarioOcupacion::vaciar() {
+    if (paginas == nullptr) return;
+    long total = static_cast<long>(cantidadAlojamientos) * PAGINAS_POR_ALOJAMIENTO;
+    for (long i = 0; i < total; ++i) {
+        delete paginas[i].load(memory_order_relaxed);
+    }
+    delete[] paginas;
+    paginas = nullptr;
+    cantidadAlojamientos = 0;
+}
+
+void CalendarioOcupacion::inicializar(int cantidad) {
+    vaciar();
+    if (cantidad <= 0) return;
+    long total = static_cast<long>(cantidad) * PAGINAS_POR_ALOJAMIENTO;
+    paginas = new atomic<Pagina*>[total];
+    for (long i = 0; i < total; ++i) {
+        paginas[i].store(nullptr, memory_order_relaxed);
+    }
+    cantidadAlojamientos = cantidad;
+    reclamos = conflictos = reversiones = reintentos = paginasCreadas = 0;
+}
+
+void CalendarioOcupacion::ampliar(int cantidad) {
+    if (cantidad <= cantidadAlojamientos) return;
+    const long actuales = static_cast<long>(cantidadAlojamientos) * PAGINAS_POR_ALOJAMIENTO;
+    const long total = static_cast<long>(cantidad) * PAGINAS_POR_ALOJAMIENTO;
+    atomic<Pagina*>* nuevas = new atomic<Pagina*>[total];
+    for (long i = 0; i < total; ++i) {
+        nuevas[i].store(i < actuales ? paginas[i].load(memory_order_relaxed) : nullptr, memory_order_relaxed);
+    }
+    delete[] paginas;
+    paginas = nuevas;
+    cantidadAlojamientos = cantidad;
+}
+
+bool CalendarioOcupacion::enRango(long diaEntrada, long diaSalida) {
+    return diaEntrada < diaSalida && diaEntrada >= DIA_BASE && diaSalida <= DIA_BASE + DIAS_CUBIERTOS;
+}
+
+CalendarioOcupacion::Pagina* CalendarioOcupacion::obtenerPagina(int alojamiento, long dia, bool crear) {
+    atomic<Pagina*>& ranura = paginas[static_cast<long>(alojamiento) * PAGINAS_POR_ALOJAMIENTO + dia / DIAS_POR_PAGINA];
+    Pagina* pagina = ranura.load(memory_order_acquire);
+    if (pagina != nullptr || !crear) {
+        return pagina;
+    }
+    // Dos hilos pueden crear la misma página a la vez: se queda la que se instale primero.
+    Pagina* nueva = new Pagina();
+    if (ranura.compare_exchange_strong(pagina, nueva, memory_order_acq_rel, memory_order_acquire)) {
+        paginasCreadas.fetch_add(1, memory_order_relaxed);
+        return nueva;
+    }
+    delete nueva;
+    return pagina; // compare_exchange dejó aquí la que ganó
+}
+
+const CalendarioOcupacion::Pagina* CalendarioOcupacion::consultarPagina(int alojamiento, long dia) const {
+    return paginas[static_cast<long>(alojamiento) * PAGINAS_POR_ALOJAMIENTO + dia / DIAS_POR_PAGINA]
+        .load(memory_order_acquire);
+}
+
+/**
+ * @brief Toma las noches palabra por palabra con compare-and-swap.
+ * Si una palabra ya tiene alguna de las noches pedidas, se devuelven las palabras
+ * tomadas antes (esos bits son de esta reserva, nadie más pudo tocarlos) y se falla
+ * sin esperar. Un CAS que falla solo porque otro hilo cambió otras noches de la misma
+ * palabra se reintenta con el valor nuevo.
+ */
+bool CalendarioOcupacion::reclamar(int alojamiento, long diaEntrada, long diaSalida, bool* revertido) {
+    if (revertido != nullptr) *revertido = false;
+    if (alojamiento < 0 || alojamiento >= cantidadAlojamientos || !enRango(diaEntrada, diaSalida)) {
+        return false;
+    }
+    const long desde = diaEntrada - DIA_BASE;
+    const long hasta = diaSalida - DIA_BASE;
+    for (long dia = desde; dia < hasta; ) {
+        long fin = finDeTramo(dia, hasta);
+        uint64_t mascara = mascaraDeNoches(dia, fin);
+        atomic<uint64_t>& palabra = obtenerPagina(alojamiento, dia, true)->palabras[(dia % DIAS_POR_PAGINA) / 64];
+        uint64_t actual = palabra.load(memory_order_acquire);
+        while (true) {
+            if ((actual & mascara) != 0) {
+                conflictos.fetch_add(1, memory_order_relaxed);
+                if (dia > desde) {
+                    reversiones.fetch_add(1, memory_order_relaxed);
+                    liberar(alojamiento, diaEntrada, dia + DIA_BASE);
+                    if (revertido != nullptr) *revertido = true;
+                }
+                return false;
+            }
+            if (palabra.compare_exchange_weak(actual, actual | mascara, memory_order_acq_rel, memory_order_acquire)) {
+                break;
+            }
+            reintentos.fetch_add(1, memory_order_relaxed);
+        }
+        dia = fin;
+    }
+    reclamos.fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+void CalendarioOcupacion::liberar(int alojamiento, long diaEntrada, long diaSalida) {
+    if (alojamiento < 0 || alojamiento >= cantidadAlojamientos || !enRango(diaEntrada, diaSalida)) {
+        return;
+    }
+    const long hasta = diaSalida - DIA_BASE;
+    for (long dia = diaEntrada - DIA_BASE; dia < hasta; ) {
+        long fin = finDeTramo(dia, hasta);
+        Pagina* pagina = obtenerPagina(alojamiento, dia, false);
+        if (pagina != nullptr) {
+            pagina->palabras[(dia % DIAS_POR_PAGINA) / 64].fetch_and(~mascaraDeNoches(dia, fin), memory_order_release);
+        }
+        dia = fin;
+    }
+}
+
+bool CalendarioOcupacion::estaLibre(int alojamiento, long diaEntrada, long diaSalida) const {
+    if (alojamiento < 0 || alojamiento >= cantidadAlojamientos || !enRango(diaEntrada, diaSalida)) {
+        return false; // Fuera del calendario tampoco se puede reservar (ver enRango)
+    }
+    const long hasta = diaSalida - DIA_BASE;
+    for (long dia = diaEntrada - DIA_BASE; dia < hasta; ) {
+        long fin = finDeTramo(dia, hasta);
+        const Pagina* pagina = consultarPagina(alojamiento, dia);
+        if (pagina != nullptr &&
+            (pagina->palabras[(dia % DIAS_POR_PAGINA) / 64].load(memory_order_acquire) & mascaraDeNoches(dia, fin)) != 0) {
+            return false;
+        }
+        dia = fin;
+    }
+    return true;
+}
+
+CalendarioOcupacion::Metricas CalendarioOcupacion::getMetricas() const {
+    Metricas m;
+    m.reclamos = reclamos.load(memory_order_relaxed);
+    m.conflictos = conflictos.load(memory_order_relaxed);
+    m.reversiones = reversiones.load(memory_order_relaxed);
+    m.reintentos = reintentos.load(memory_order_relaxed);
+    m.paginas = paginasCreadas.load(memory_order_relaxed);
+    return m;
+}
+
+size_t CalendarioOcupacion::memoriaAproximada() const {
+    return sizeof(*this) + static_cast<size_t>(cantidadAlojamientos) * PAGINAS_POR_ALOJAMIENTO * sizeof(atomic<Pagina*>) +
+           static_cast<size_t>(paginasCreadas.load(memory_order_relaxed)) * sizeof(Pagina);
+}
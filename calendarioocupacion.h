@@ -0,0 +1,121 @@
+#ifndef CALENDARIOOCUPACION_H
+#define CALENDARIOOCUPACION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include "fecha.h"
+
+// Noches ocupadas de cada alojamiento como un mapa de bits atómico (un bit por noche).
+// Reservar es "reclamar" las noches con compare-and-swap palabra por palabra: dos
+// reservas que no comparten noches nunca se esperan, y si una choca a mitad de camino
+// devuelve lo que ya había tomado y falla enseguida, sin bloquear a nadie.
+//
+// Cubre las noches desde el 01/01/2000 hasta (sin incluir) DIA_BASE + DIAS_CUBIERTOS.
+// Las páginas de cada alojamiento se crean al primer uso (también con CAS), así un
+// alojamiento sin reservas no ocupa más que su directorio de punteros.
+class CalendarioOcupacion {
+public:
+    static constexpr long DIA_BASE = Fecha(1, 1, 2000).aNumeroDia();
+    static constexpr int DIAS_POR_PAGINA = 512;
+    static constexpr int PAGINAS_POR_ALOJAMIENTO = 128;
+    static constexpr long DIAS_CUBIERTOS = static_cast<long>(DIAS_POR_PAGINA) * PAGINAS_POR_ALOJAMIENTO;
+
+    struct Metricas {
+        unsigned long long reclamos;      // Reservas que tomaron sus noches
+        unsigned long long conflictos;    // Reservas rechazadas por una noche ya ocupada
+        unsigned long long reversiones;   // Conflictos que tuvieron que devolver noches ya tomadas
+        unsigned long long reintentos;    // CAS que fallaron por una escritura concurrente en la misma palabra
+        unsigned long long paginas;       // Páginas de 512 noches creadas
+    };
+
+private:
+    static constexpr int PALABRAS_POR_PAGINA = DIAS_POR_PAGINA / 64;
+
+    struct Pagina {
+        std::atomic<uint64_t> palabras[PALABRAS_POR_PAGINA];
+        Pagina() {
+            for (int i = 0; i < PALABRAS_POR_PAGINA; ++i) palabras[i].store(0, std::memory_order_relaxed);
+        }
+    };
+
+    std::atomic<Pagina*>* paginas;   // cantidadAlojamientos * PAGINAS_POR_ALOJAMIENTO
+    int cantidadAlojamientos;
+
+    std::atomic<unsigned long long> reclamos, conflictos, reversiones, reintentos, paginasCreadas;
+
+    // Página del día (relativo a DIA_BASE) o nullptr; con 'crear' la instala si falta.
+    Pagina* obtenerPagina(int alojamiento, long dia, bool crear);
+    const Pagina* consultarPagina(int alojamiento, long dia) const;
+    void vaciar();
+
+public:
+    CalendarioOcupacion();
+    ~CalendarioOcupacion();
+
+    CalendarioOcupacion(const CalendarioOcupacion&) = delete;
+    CalendarioOcupacion& operator=(const CalendarioOcupacion&) = delete;
+
+    // Descarta todo y prepara calendarios vacíos para 'cantidad' alojamientos.
+    // No es seguro llamarlo mientras otros hilos usan el calendario.
+    void inicializar(int cantidad);
+    // Agrega calendarios vacíos hasta tener 'cantidad' alojamientos; conserva los actuales.
+    // Tampoco es seguro llamarlo mientras otros hilos usan el calendario.
+    void ampliar(int cantidad);
+
+    // true si [diaEntrada, diaSalida) no está vacío y cae dentro del calendario.
+    static bool enRango(long diaEntrada, long diaSalida);
+
+    // Toma las noches [diaEntrada, diaSalida) si todas están libres. Si alguna ya está
+    // ocupada devuelve las que alcanzó a tomar y retorna false; 'revertido' (si se da)
+    // dice si hubo que devolver alguna, porque otros hilos pudieron verlas ocupadas
+    // mientras tanto. Seguro entre hilos.
+    bool reclamar(int alojamiento, long diaEntrada, long diaSalida, bool* revertido = nullptr);
+    // Devuelve noches tomadas antes con reclamar (al anular o archivar).
+    void liberar(int alojamiento, long diaEntrada, long diaSalida);
+    // true si ninguna noche de [diaEntrada, diaSalida) está ocupada; false si el rango
+    // no cae dentro del calendario, como en reclamar.
+    bool estaLibre(int alojamiento, long diaEntrada, long diaSalida) const;
+
+    // Llama visitante(primeraNoche, finDelTramo) por cada tramo máximo de noches libres
+    // dentro de [diaDesde, diaHasta) (recortado al calendario), en orden. Las palabras
+    // enteramente libres u ocupadas se resuelven de un solo paso; solo las mixtas se
+    // recorren bit a bit.
+    template <typename Visitante>
+    void recorrerTramosLibres(int alojamiento, long diaDesde, long diaHasta, Visitante visitante) const {
+        if (alojamiento < 0 || alojamiento >= cantidadAlojamientos) return;
+        long desde = (diaDesde > DIA_BASE ? diaDesde : DIA_BASE) - DIA_BASE;
+        long hasta = (diaHasta < DIA_BASE + DIAS_CUBIERTOS ? diaHasta : DIA_BASE + DIAS_CUBIERTOS) - DIA_BASE;
+        long inicioLibre = -1;
+        for (long dia = desde; dia < hasta; ) {
+            long fin = (dia / 64 + 1) * 64 < hasta ? (dia / 64 + 1) * 64 : hasta;
+            const Pagina* pagina = consultarPagina(alojamiento, dia);
+            uint64_t bits = pagina == nullptr ? 0
+                : pagina->palabras[(dia % DIAS_POR_PAGINA) / 64].load(std::memory_order_acquire) >> (dia % 64);
+            uint64_t tramo = fin - dia == 64 ? ~0ULL : ((1ULL << (fin - dia)) - 1);
+            bits &= tramo;
+            if (bits == 0) {
+                if (inicioLibre < 0) inicioLibre = dia;
+            } else if (bits == tramo) {
+                if (inicioLibre >= 0) visitante(inicioLibre + DIA_BASE, dia + DIA_BASE);
+                inicioLibre = -1;
+            } else {
+                for (long d = dia; d < fin; ++d, bits >>= 1) {
+                    if ((bits & 1) == 0) {
+                        if (inicioLibre < 0) inicioLibre = d;
+                    } else if (inicioLibre >= 0) {
+                        visitante(inicioLibre + DIA_BASE, d + DIA_BASE);
+                        inicioLibre = -1;
+                    }
+                }
+            }
+            dia = fin;
+        }
+        if (inicioLibre >= 0) visitante(inicioLibre + DIA_BASE, hasta + DIA_BASE);
+    }
+
+    Metricas getMetricas() const;
+    size_t memoriaAproximada() const;
+};
+
+#endif // CALENDARIOOCUPACION_H
@@ -0,0 +1,139 @@
+// --- canalcambios.cpp ---
+// Implementación del canal de cambios de reservaciones (anillo con versiones).
+#include "canalcambios.h"
+#include "bufercsv.h"
+#include "fecha.h"
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+using namespace std;
+
+// Se copia al anillo y de vuelta como bytes
+static_assert(is_trivially_copyable<EventoReservacion>::value, "EventoReservacion debe copiarse con memcpy");
+
+const char* EventoReservacion::nombreTipo(int tipo) {
+    switch (tipo) {
+    case EVENTO_CREADA: return "CREADA";
+    case EVENTO_ANULADA: return "ANULADA";
+    case EVENTO_ARCHIVADA: return "ARCHIVADA";
+    default: return "DESCONOCIDO";
+    }
+}
+
+void EventoReservacion::escribirCSV(BuferCSV& salida) const {
+    salida.agregarEntero(static_cast<long long>(secuencia));
+    salida.agregar(',');
+    salida.agregar(string(nombreTipo(tipo)));
+    salida.agregar(',');
+    salida.agregarEntero(instanteMicros);
+    salida.agregar(',');
+    salida.agregar(codigo, strlen(codigo));
+    salida.agregar(',');
+    salida.agregar(alojamiento, strlen(alojamiento));
+    salida.agregar(',');
+    salida.agregar(documento, strlen(documento));
+    salida.agregar(',');
+    salida.agregarFecha(Fecha::desdeNumeroDia(diaEntrada));
+    salida.agregar(',');
+    salida.agregarEntero(noches);
+    salida.agregar(',');
+    salida.agregarEntero(monto);
+    salida.agregar('\n');
+}
+
+CanalCambios::Lector::Lector() : siguiente(1), leidos(0), perdidos(0) {
+}
+
+unsigned long long CanalCambios::Lector::getLeidos() const {
+    return leidos.load(memory_order_relaxed);
+}
+
+unsigned long long CanalCambios::Lector::getPerdidos() const {
+    return perdidos.load(memory_order_relaxed);
+}
+
+CanalCambios::CanalCambios(int cupo) : publicados(0) {
+    unsigned long long potencia = 16;
+    while (potencia < static_cast<unsigned long long>(cupo)) potencia *= 2;
+    casillas = new Casilla[potencia];
+    mascara = potencia - 1;
+    for (unsigned long long i = 0; i < potencia; ++i) {
+        casillas[i].version.store(0, memory_order_relaxed);
+        for (int p = 0; p < PALABRAS_EVENTO; ++p) {
+            casillas[i].palabras[p].store(0, memory_order_relaxed);
+        }
+    }
+}
+
+CanalCambios::~CanalCambios() {
+    delete[] casillas;
+}
+
+void CanalCambios::publicar(EventoReservacion evento) {
+    const unsigned long long secuencia = publicados.load(memory_order_relaxed) + 1;
+    evento.secuencia = secuencia;
+    evento.instanteMicros = chrono::duration_cast<chrono::microseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    uint64_t palabras[PALABRAS_EVENTO] = {};
+    memcpy(palabras, &evento, sizeof(EventoReservacion));
+
+    Casilla& casilla = casillas[secuencia & mascara];
+    // Versión impar: un lector que copie la casilla ahora la descarta
+    // (cada palabra se guarda con release para que no se adelante a la versión impar)
+    casilla.version.store(2 * secuencia - 1, memory_order_relaxed);
+    for (int p = 0; p < PALABRAS_EVENTO; ++p) {
+        casilla.palabras[p].store(palabras[p], memory_order_release);
+    }
+    casilla.version.store(2 * secuencia, memory_order_release);
+    publicados.store(secuencia, memory_order_release);
+}
+
+void CanalCambios::suscribir(Lector& lector) const {
+    lector.siguiente = publicados.load(memory_order_acquire) + 1;
+    lector.leidos.store(0, memory_order_relaxed);
+    lector.perdidos.store(0, memory_order_relaxed);
+}
+
+int CanalCambios::leer(Lector& lector, EventoReservacion destino[], int maximo) const {
+    const unsigned long long cupo = mascara + 1;
+    int copiados = 0;
+    while (copiados < maximo) {
+        const unsigned long long ultimo = publicados.load(memory_order_acquire);
+        if (lector.siguiente > ultimo) break;
+        if (ultimo - lector.siguiente >= cupo) {
+            // El lector se atrasó más que el anillo: salta a lo más viejo que sigue ahí
+            const unsigned long long primeroDisponible = ultimo - cupo + 1;
+            lector.perdidos.fetch_add(primeroDisponible - lector.siguiente, memory_order_relaxed);
+            lector.siguiente = primeroDisponible;
+        }
+        const Casilla& casilla = casillas[lector.siguiente & mascara];
+        const unsigned long long version = casilla.version.load(memory_order_acquire);
+        uint64_t palabras[PALABRAS_EVENTO];
+        bool valida = version == 2 * lector.siguiente;
+        if (valida) {
+            // Con acquire la segunda lectura de la versión no se adelanta a la copia
+            for (int p = 0; p < PALABRAS_EVENTO; ++p) {
+                palabras[p] = casilla.palabras[p].load(memory_order_acquire);
+            }
+            valida = casilla.version.load(memory_order_relaxed) == version;
+        }
+        if (!valida) {
+            // El productor ya la está reutilizando para un evento una vuelta más adelante
+            lector.perdidos.fetch_add(1, memory_order_relaxed);
+            lector.siguiente++;
+            continue;
+        }
+        memcpy(&destino[copiados++], palabras, sizeof(EventoReservacion));
+        lector.siguiente++;
+        lector.leidos.fetch_add(1, memory_order_relaxed);
+    }
+    return copiados;
+}
+
+unsigned long long CanalCambios::getPublicados() const {
+    return publicados.load(memory_order_acquire);
+}
+
+int CanalCambios::getCupo() const {
+    return static_cast<int>(mascara + 1);
+}
@@ -0,0 +1,98 @@
+#ifndef CANALCAMBIOS_H
+#define CANALCAMBIOS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class BuferCSV;
+
+enum TipoEventoReservacion {
+    EVENTO_CREADA = 1,
+    EVENTO_ANULADA,
+    EVENTO_ARCHIVADA
+};
+
+// Un cambio de una reservación, de tamaño fijo para copiarlo al anillo sin memoria
+// dinámica. Los códigos más largos que su campo se truncan (los de la aplicación son
+// de pocos caracteres: RES012, ALO004, un documento).
+struct EventoReservacion {
+    static const int LARGO_CODIGO = 16;
+    static const int LARGO_DOCUMENTO = 24;
+
+    unsigned long long secuencia;     // 1, 2, 3... en orden de publicación
+    long long instanteMicros;         // Reloj del sistema al publicarlo
+    int32_t tipo;                     // TipoEventoReservacion
+    int32_t diaEntrada;               // Número de día (ver Fecha::aNumeroDia)
+    int32_t noches;
+    int32_t monto;
+    char codigo[LARGO_CODIGO];        // Terminados en '\0'
+    char alojamiento[LARGO_CODIGO];
+    char documento[LARGO_DOCUMENTO];
+
+    // Línea CSV (con '\n'): secuencia,tipo,instante,codigo,alojamiento,documento,entrada,noches,monto
+    void escribirCSV(BuferCSV& salida) const;
+    static const char* nombreTipo(int tipo);
+};
+
+// Canal de cambios de las reservaciones: un anillo de tamaño fijo donde un productor
+// publica eventos y varios lectores los consumen, cada uno con su propio cursor.
+//
+// Publicar nunca espera a los lectores: si uno se atrasa más que el tamaño del anillo,
+// el productor sobrescribe los eventos más viejos y ese lector los cuenta como perdidos
+// al volver. Cada casilla lleva un número de versión (impar mientras se escribe, como
+// un seqlock); el lector copia la casilla y la descarta si la versión cambió durante la
+// copia. El contenido se guarda en palabras atómicas para que la copia concurrente con
+// una sobrescritura no sea una carrera de datos.
+//
+// Un solo productor a la vez: GestorUdeaStay publica con mutexDatos exclusivo.
+class CanalCambios {
+public:
+    // Cursor de un consumidor. Solo lo usa el hilo de ese consumidor.
+    class Lector {
+    private:
+        friend class CanalCambios;
+        unsigned long long siguiente;            // Secuencia del próximo evento a leer
+        std::atomic<unsigned long long> leidos;
+        std::atomic<unsigned long long> perdidos;
+
+    public:
+        Lector();
+        unsigned long long getLeidos() const;
+        unsigned long long getPerdidos() const;
+    };
+
+private:
+    static const int PALABRAS_EVENTO = (sizeof(EventoReservacion) + 7) / 8;
+
+    struct Casilla {
+        std::atomic<unsigned long long> version;  // 2 * secuencia al terminar de escribirla; impar a mitad
+        std::atomic<uint64_t> palabras[PALABRAS_EVENTO];
+    };
+
+    Casilla* casillas;
+    unsigned long long mascara;                   // cupo - 1 (cupo potencia de dos)
+    std::atomic<unsigned long long> publicados;   // Secuencia del último evento completo
+
+public:
+    // 'cupo' se redondea a la siguiente potencia de dos.
+    explicit CanalCambios(int cupo = 4096);
+    ~CanalCambios();
+
+    CanalCambios(const CanalCambios&) = delete;
+    CanalCambios& operator=(const CanalCambios&) = delete;
+
+    // Completa la secuencia y el instante del evento y lo publica. No bloquea.
+    void publicar(EventoReservacion evento);
+    // Nuevo lector que empieza en el próximo evento que se publique.
+    void suscribir(Lector& lector) const;
+    // Copia en 'destino' hasta 'maximo' eventos siguientes del lector y devuelve cuántos.
+    // Los que ya se sobrescribieron se suman a sus perdidos. No bloquea.
+    int leer(Lector& lector, EventoReservacion destino[], int maximo) const;
+
+    unsigned long long getPublicados() const;
+    int getCupo() const;
+};
+
+#endif // CANALCAMBIOS_H
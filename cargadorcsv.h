@@ -0,0 +1,148 @@
+#ifndef CARGADORCSV_H
+#define CARGADORCSV_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "fecha.h"
+#include "lecturacampos.h"
+
+// Carga de archivos CSV guiada por un esquema fijo al compilar.
+//
+// Un esquema es la lista de tipos de sus campos, en el orden del archivo:
+//     struct EsquemaX : EsquemaCSV<CampoTexto, CampoEntero, CampoFecha> {
+//         static constexpr const char* NOMBRES_CAMPOS[NUM_CAMPOS] = {"Codigo", "Cantidad", "Fecha"};
+//     };
+// y cargarArchivoCSV<EsquemaX>(archivo, informe, accion) lee cada línea, convierte
+// sus campos a una tupla de valores y llama a accion(valores, numeroLinea), que crea
+// el objeto y devuelve true si lo cargó. Las conversiones se resuelven al compilar
+// (una función por campo, sin tablas ni llamadas virtuales), los strings de los
+// campos y la tupla se reutilizan entre líneas, y los errores van al InformeCarga.
+// Agregar una entidad nueva es escribir su esquema y su acción.
+
+// --- Tipos de campo: cada uno sabe leer su valor desde el texto del campo ---
+
+struct CampoTexto {
+    using Tipo = std::string;
+    // Intercambia en vez de copiar: el campo y el valor se prestan su memoria
+    static EstadoLectura leer(std::string& texto, Tipo& valor) {
+        valor.swap(texto);
+        return LECTURA_CORRECTA;
+    }
+};
+
+struct CampoEntero {
+    using Tipo = int;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) { return leerEntero(texto, valor); }
+};
+
+struct CampoEnteroPositivo {
+    using Tipo = int;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) {
+        EstadoLectura estado = leerEntero(texto, valor);
+        return estado == LECTURA_CORRECTA && valor <= 0 ? LECTURA_FUERA_DE_RANGO : estado;
+    }
+};
+
+struct CampoDecimal {
+    using Tipo = double;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) { return leerDecimal(texto, valor); }
+};
+
+struct CampoFlotante {
+    using Tipo = float;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) { return leerDecimal(texto, valor); }
+};
+
+struct CampoFecha {
+    using Tipo = Fecha;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) { return leerFecha(texto, valor); }
+};
+
+// "1" o "true" es verdadero; cualquier otro texto es falso.
+struct CampoBandera {
+    using Tipo = bool;
+    static EstadoLectura leer(std::string& texto, Tipo& valor) {
+        valor = texto == "1" || texto == "true";
+        return LECTURA_CORRECTA;
+    }
+};
+
+// --- Esquema ---
+
+template <typename... Campos>
+struct EsquemaCSV {
+    static constexpr int NUM_CAMPOS = static_cast<int>(sizeof...(Campos));
+    using Valores = std::tuple<typename Campos::Tipo...>;
+
+    // Convierte los campos en orden y se detiene en el primero que falle.
+    static EstadoLectura convertir(std::string campos[], Valores& valores, int& campoConError) {
+        return convertirCampos(campos, valores, campoConError, std::index_sequence_for<Campos...>());
+    }
+
+private:
+    template <std::size_t I, typename Campo>
+    static bool convertirCampo(std::string campos[], Valores& valores, EstadoLectura& estado, int& campoConError) {
+        estado = Campo::leer(campos[I], std::get<I>(valores));
+        if (estado != LECTURA_CORRECTA) {
+            campoConError = static_cast<int>(I);
+            return false;
+        }
+        return true;
+    }
+
+    template <std::size_t... I>
+    static EstadoLectura convertirCampos(std::string campos[], Valores& valores, int& campoConError,
+                                         std::index_sequence<I...>) {
+        EstadoLectura estado = LECTURA_CORRECTA;
+        // El && corta en el primer campo con error
+        (void)(convertirCampo<I, Campos>(campos, valores, estado, campoConError) && ...);
+        return estado;
+    }
+};
+
+// --- Cargador ---
+
+/**
+ * @brief Lee un archivo CSV con cabecera según 'Esquema'.
+ * Las líneas vacías se saltan; una línea con otra cantidad de campos o con un campo
+ * que no se puede convertir se registra en 'informe' y no llega a la acción.
+ * @param accion bool(const Esquema::Valores&, long numeroLinea): true si cargó el registro.
+ *               Puede registrar en el informe sus propios errores (ej. un código inexistente).
+ * @return false si el archivo no se pudo abrir o no tiene cabecera.
+ */
+template <typename Esquema, typename Accion>
+bool cargarArchivoCSV(const std::string& nombreArchivo, InformeCarga& informe, Accion&& accion) {
+    std::ifstream archivo(nombreArchivo);
+    std::string linea;
+    if (!archivo.is_open() || !std::getline(archivo, linea)) { // Omitir cabecera
+        return false;
+    }
+
+    std::string campos[Esquema::NUM_CAMPOS];
+    typename Esquema::Valores valores;
+    long numeroLinea = 1;
+    while (std::getline(archivo, linea)) {
+        numeroLinea++;
+        if (linea.empty()) continue;
+        informe.contarLinea();
+        if (dividirLineaCSV(linea, campos, Esquema::NUM_CAMPOS) != Esquema::NUM_CAMPOS) {
+            informe.registrar(numeroLinea, -1, LECTURA_CAMPOS_INCOMPLETOS);
+            continue;
+        }
+        int campoConError = -1;
+        EstadoLectura estado = Esquema::convertir(campos, valores, campoConError);
+        if (estado != LECTURA_CORRECTA) {
+            informe.registrar(numeroLinea, campoConError, estado);
+            continue;
+        }
+        if (accion(static_cast<const typename Esquema::Valores&>(valores), numeroLinea)) {
+            informe.contarCargada();
+        }
+    }
+    return true;
+}
+
+#endif // CARGADORCSV_H
@@ -0,0 +1,308 @@
+// --- clienteudeastay.cpp ---
+// Implementación del cliente de consola del modo servidor.
+#include "clienteudeastay.h"
+#include "servidorudeastay.h"
+#include <iostream>
+#include <limits>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+using namespace std;
+
+// Lee una opción numérica del menú; -1 si la entrada no es un número y 0 (salir) al fin de la entrada.
+static int leerOpcion() {
+    int opcion;
+    cin >> opcion;
+    if (cin.eof()) {
+        return 0;
+    }
+    if (cin.fail()) {
+        cin.clear();
+        opcion = -1;
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    return opcion;
+}
+
+// Pide una fecha como "dd mm aaaa" y la devuelve en el formato del protocolo (dd/mm/aaaa).
+static string leerFecha(const string& mensaje) {
+    int dia = 0, mes = 0, anio = 0;
+    cout << mensaje;
+    cin >> dia >> mes >> anio;
+    if (cin.fail()) {
+        cin.clear();
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    char texto[16];
+    snprintf(texto, sizeof(texto), "%02d/%02d/%04d", dia, mes, anio);
+    return texto;
+}
+
+// Lee una línea de texto libre; los '|' se reemplazan porque separan campos del protocolo.
+static string leerTexto(const string& mensaje) {
+    string texto;
+    cout << mensaje;
+    getline(cin, texto);
+    for (char& c : texto) {
+        if (c == '|') c = '/';
+    }
+    return texto;
+}
+
+ClienteUdeaStay::ClienteUdeaStay() : fd(-1) {
+}
+
+ClienteUdeaStay::~ClienteUdeaStay() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool ClienteUdeaStay::conectar(const string& direccion) {
+    if (ServidorUdeaStay::esPuertoTCP(direccion)) {
+        sockaddr_in dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.sin_family = AF_INET;
+        dir.sin_port = htons(static_cast<uint16_t>(atoi(direccion.c_str())));
+        dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) == 0) {
+            return true;
+        }
+    } else {
+        sockaddr_un dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.sun_family = AF_UNIX;
+        strncpy(dir.sun_path, direccion.c_str(), sizeof(dir.sun_path) - 1);
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) == 0) {
+            return true;
+        }
+    }
+    cerr << "Error [ClienteUdeaStay]: No se pudo conectar a " << direccion << ": " << strerror(errno) << endl;
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    return false;
+}
+
+bool ClienteUdeaStay::leerLinea(string& linea) {
+    while (true) {
+        size_t finLinea = recibido.find('\n');
+        if (finLinea != string::npos) {
+            linea = recibido.substr(0, finLinea);
+            recibido.erase(0, finLinea + 1);
+            return true;
+        }
+        char bufer[4096];
+        ssize_t leidos = ::recv(fd, bufer, sizeof(bufer), 0);
+        if (leidos > 0) {
+            recibido.append(bufer, static_cast<size_t>(leidos));
+        } else if (leidos < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+}
+
+bool ClienteUdeaStay::enviar(const string& solicitud, string& respuesta) {
+    if (fd < 0) return false;
+    string mensaje = solicitud + "\n";
+    size_t enviados = 0;
+    while (enviados < mensaje.size()) {
+        ssize_t n = ::send(fd, mensaje.data() + enviados, mensaje.size() - enviados, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviados += static_cast<size_t>(n);
+    }
+
+    respuesta.clear();
+    string linea;
+    while (leerLinea(linea)) {
+        respuesta += linea + "\n";
+        if (linea.compare(0, 2, "OK") == 0 || linea.compare(0, 3, "ERR") == 0) {
+            return true;
+        }
+    }
+    cerr << "Error [ClienteUdeaStay]: Se perdió la conexión con el servidor." << endl;
+    return false;
+}
+
+// Imprime las líneas de datos con los campos separados por " | " y luego el estado final.
+void ClienteUdeaStay::mostrarRespuesta(const string& respuesta) const {
+    size_t inicio = 0;
+    while (inicio < respuesta.size()) {
+        size_t fin = respuesta.find('\n', inicio);
+        string linea = respuesta.substr(inicio, fin - inicio);
+        inicio = fin == string::npos ? respuesta.size() : fin + 1;
+        if (linea.compare(0, 2, "* ") == 0) {
+            string datos;
+            for (size_t i = 2; i < linea.size(); ++i) {
+                if (linea[i] == '|') datos += " | ";
+                else datos += linea[i];
+            }
+            cout << "  " << datos << endl;
+        } else if (linea.compare(0, 3, "OK ") == 0) {
+            cout << linea.substr(3) << endl;
+        } else if (linea.compare(0, 4, "ERR ") == 0) {
+            cout << "Error: " << linea.substr(4) << endl;
+        } else {
+            cout << linea << endl;
+        }
+    }
+}
+
+void ClienteUdeaStay::ejecutar() {
+    string respuesta;
+    int opcion = -1;
+    do {
+        cout << "\n--- UdeaStay (cliente) - Menú Principal ---" << endl;
+        cout << "1. Iniciar Sesión como Anfitrión" << endl;
+        cout << "2. Iniciar Sesión como Huésped" << endl;
+        cout << "3. Ver Estado del Servidor" << endl;
+        cout << "0. Salir" << endl;
+        cout << "Seleccione una opción: ";
+        opcion = leerOpcion();
+
+        switch (opcion) {
+        case 1:
+        case 2: {
+            string id = leerTexto(opcion == 1 ? "Ingrese ID de Anfitrión: " : "Ingrese ID de Huésped: ");
+            string clave = leerTexto("Ingrese Contraseña: ");
+            string rol = opcion == 1 ? "ANFITRION" : "HUESPED";
+            if (!enviar("LOGIN|" + rol + "|" + id + "|" + clave, respuesta)) return;
+            if (respuesta.compare(0, 3, "OK ") != 0) {
+                mostrarRespuesta(respuesta);
+                break;
+            }
+            string nombre = respuesta.substr(3, respuesta.size() - 4);
+            if (opcion == 1) {
+                manejarMenuAnfitrion(nombre);
+            } else {
+                manejarMenuHuesped(nombre);
+            }
+            if (!enviar("LOGOUT", respuesta)) return;
+            break;
+        }
+        case 3:
+            if (!enviar("ESTADO", respuesta)) return;
+            mostrarRespuesta(respuesta);
+            break;
+        case 0:
+            cout << "Saliendo del cliente UdeaStay." << endl;
+            break;
+        default:
+            cout << "Opción no válida. Intente de nuevo." << endl;
+            break;
+        }
+    } while (opcion != 0);
+}
+
+void ClienteUdeaStay::manejarMenuHuesped(const string& nombre) {
+    string respuesta;
+    int opcion = -1;
+    do {
+        cout << "\n--- Menú Huésped: " << nombre << " ---" << endl;
+        cout << "1. Buscar alojamiento disponible" << endl;
+        cout << "2. Crear nueva reservación por código" << endl;
+        cout << "3. Anular una de mis reservaciones" << endl;
+        cout << "4. Ver mis reservaciones activas" << endl;
+        cout << "5. Buscar con fechas flexibles" << endl;
+        cout << "0. Cerrar Sesión" << endl;
+        cout << "Seleccione una opción: ";
+        opcion = leerOpcion();
+
+        string solicitud;
+        switch (opcion) {
+        case 1: {
+            string fecha = leerFecha("Ingrese fecha de entrada (dd mm aaaa): ");
+            cout << "Ingrese cantidad de noches: ";
+            int noches = leerOpcion();
+            string municipio = leerTexto("Municipio (vacío = cualquiera): ");
+            string precioNoche = leerTexto("Precio promedio máximo por noche (vacío = sin límite): ");
+            string costoTotal = leerTexto("Costo total máximo de la estadía (vacío = sin límite): ");
+            solicitud = "BUSCAR|" + fecha + "|" + to_string(noches) + "|" + municipio + "|" + precioNoche + "|" + costoTotal;
+            break;
+        }
+        case 2: {
+            string codigo = leerTexto("Ingrese el código del alojamiento: ");
+            string fecha = leerFecha("Ingrese la fecha de entrada (dd mm aaaa): ");
+            cout << "Ingrese el número de noches: ";
+            int noches = leerOpcion();
+            string metodo = leerTexto("Ingrese el método de pago: ");
+            string anotaciones = leerTexto("Ingrese anotaciones (opcional): ");
+            solicitud = "RESERVAR|" + codigo + "|" + fecha + "|" + to_string(noches) + "|" + metodo + "|" + anotaciones;
+            break;
+        }
+        case 3: {
+            if (!enviar("RESERVAS", respuesta)) return;
+            mostrarRespuesta(respuesta);
+            solicitud = "ANULAR|" + leerTexto("Ingrese el código de la reservación que desea anular: ");
+            break;
+        }
+        case 4:
+            solicitud = "RESERVAS";
+            break;
+        case 5: {
+            string desde = leerFecha("Primera noche posible (dd mm aaaa): ");
+            string hasta = leerFecha("Última noche posible (dd mm aaaa): ");
+            cout << "Ingrese cantidad de noches: ";
+            int noches = leerOpcion();
+            string municipio = leerTexto("Municipio (vacío = cualquiera): ");
+            solicitud = "BUSCARFLEX|" + desde + "|" + hasta + "|" + to_string(noches);
+            if (!municipio.empty()) solicitud += "|" + municipio;
+            break;
+        }
+        case 0:
+            cout << "Sesión de Huésped cerrada." << endl;
+            break;
+        default:
+            cout << "Opción no válida. Intente de nuevo." << endl;
+            break;
+        }
+        if (!solicitud.empty()) {
+            if (!enviar(solicitud, respuesta)) return;
+            mostrarRespuesta(respuesta);
+        }
+    } while (opcion != 0);
+}
+
+void ClienteUdeaStay::manejarMenuAnfitrion(const string& nombre) {
+    string respuesta;
+    int opcion = -1;
+    do {
+        cout << "\n--- Menú Anfitrión: " << nombre << " ---" << endl;
+        cout << "1. Ver reservaciones activas de mis alojamientos" << endl;
+        cout << "2. Anular una reservación" << endl;
+        cout << "0. Cerrar Sesión" << endl;
+        cout << "Seleccione una opción: ";
+        opcion = leerOpcion();
+
+        string solicitud;
+        switch (opcion) {
+        case 1:
+            solicitud = "RESERVAS";
+            break;
+        case 2:
+            solicitud = "ANULAR|" + leerTexto("Ingrese el código de la reservación que desea anular: ");
+            break;
+        case 0:
+            cout << "Sesión de Anfitrión cerrada." << endl;
+            break;
+        default:
+            cout << "Opción no válida. Intente de nuevo." << endl;
+            break;
+        }
+        if (!solicitud.empty()) {
+            if (!enviar(solicitud, respuesta)) return;
+            mostrarRespuesta(respuesta);
+        }
+    } while (opcion != 0);
+}
@@ -0,0 +1,34 @@
+#ifndef CLIENTEUDEASTAY_H
+#define CLIENTEUDEASTAY_H
+
+#include <string>
+
+// Cliente de consola del modo servidor: el mismo flujo de menús del programa
+// local, pero cada operación es una solicitud al servidor (ver servidorudeastay.h).
+// No carga ningún archivo de datos; todo el estado vive en el servidor.
+class ClienteUdeaStay {
+private:
+    int fd;
+    std::string recibido;          // Bytes recibidos que aún no forman una línea
+
+    bool leerLinea(std::string& linea);
+    void mostrarRespuesta(const std::string& respuesta) const;
+    void manejarMenuHuesped(const std::string& nombre);
+    void manejarMenuAnfitrion(const std::string& nombre);
+
+public:
+    ClienteUdeaStay();
+    ~ClienteUdeaStay();
+
+    ClienteUdeaStay(const ClienteUdeaStay&) = delete;
+    ClienteUdeaStay& operator=(const ClienteUdeaStay&) = delete;
+
+    // 'direccion' es un puerto TCP en 127.0.0.1 o la ruta de un socket Unix.
+    bool conectar(const std::string& direccion);
+    // Envía una solicitud y recibe la respuesta completa (hasta la línea OK/ERR).
+    // Devuelve false si se perdió la conexión.
+    bool enviar(const std::string& solicitud, std::string& respuesta);
+    void ejecutar();
+};
+
+#endif // CLIENTEUDEASTAY_H
@@ -0,0 +1,55 @@
+#ifndef COLACIRCULAR_H
+#define COLACIRCULAR_H
+
+#include <utility>
+
+// Cola FIFO sobre un arreglo circular que duplica su cupo cuando se llena.
+// No es segura entre hilos: quien la comparte la protege con su propio mutex.
+// Es una plantilla, por eso toda la implementación vive en este encabezado.
+template <typename T>
+class ColaCircular {
+private:
+    T* elementos;
+    int inicio;      // Posición del primero
+    int cantidad;
+    int cupo;
+
+    void crecer() {
+        int nuevoCupo = cupo == 0 ? 16 : cupo * 2;
+        T* nuevo = new T[nuevoCupo];
+        for (int i = 0; i < cantidad; ++i) {
+            nuevo[i] = std::move(elementos[(inicio + i) % cupo]);
+        }
+        delete[] elementos;
+        elementos = nuevo;
+        inicio = 0;
+        cupo = nuevoCupo;
+    }
+
+public:
+    ColaCircular() : elementos(nullptr), inicio(0), cantidad(0), cupo(0) {}
+    ~ColaCircular() { delete[] elementos; }
+
+    ColaCircular(const ColaCircular&) = delete;
+    ColaCircular& operator=(const ColaCircular&) = delete;
+
+    void encolar(T elemento) {
+        if (cantidad == cupo) crecer();
+        elementos[(inicio + cantidad) % cupo] = std::move(elemento);
+        cantidad++;
+    }
+
+    // Saca el primero; false si la cola está vacía.
+    bool desencolar(T& destino) {
+        if (cantidad == 0) return false;
+        destino = std::move(elementos[inicio]);
+        inicio = (inicio + 1) % cupo;
+        cantidad--;
+        return true;
+    }
+
+    bool estaVacia() const { return cantidad == 0; }
+    int getCantidad() const { return cantidad; }
+};
+
+#endif // COLACIRCULAR_H
@@ -0,0 +1,92 @@
+// --- colavencimientos.cpp ---
+// Implementación del montículo mínimo de vencimientos (por día de salida).
+#include "colavencimientos.h"
+#include <utility>
+using namespace std;
+
+ColaVencimientos::ColaVencimientos() : entradas(nullptr), cantidad(0), cupo(0) {
+}
+
+ColaVencimientos::~ColaVencimientos() {
+    delete[] entradas;
+}
+
+/**
+ * @brief Duplica el cupo del arreglo del montículo cuando está lleno
+ * (mismo esquema que los arreglos del gestor).
+ */
+void ColaVencimientos::asegurarCapacidad() {
+    if (cupo == 0) {
+        cupo = 16;
+        entradas = new Entrada[cupo];
+    } else if (cantidad == cupo) {
+        int nuevoCupo = cupo * 2;
+        Entrada* nuevo = new Entrada[nuevoCupo];
+        for (int i = 0; i < cantidad; ++i) {
+            nuevo[i] = std::move(entradas[i]);
+        }
+        delete[] entradas;
+        entradas = nuevo;
+        cupo = nuevoCupo;
+    }
+}
+
+void ColaVencimientos::subir(int indice) {
+    while (indice > 0) {
+        int padre = (indice - 1) / 2;
+        if (entradas[padre].diaSalida <= entradas[indice].diaSalida) break;
+        swap(entradas[padre], entradas[indice]);
+        indice = padre;
+    }
+}
+
+void ColaVencimientos::bajar(int indice) {
+    while (true) {
+        int menor = indice;
+        int izq = 2 * indice + 1;
+        int der = izq + 1;
+        if (izq < cantidad && entradas[izq].diaSalida < entradas[menor].diaSalida) menor = izq;
+        if (der < cantidad && entradas[der].diaSalida < entradas[menor].diaSalida) menor = der;
+        if (menor == indice) break;
+        swap(entradas[menor], entradas[indice]);
+        indice = menor;
+    }
+}
+
+void ColaVencimientos::insertar(long diaSalida, const string& codigo) {
+    asegurarCapacidad();
+    entradas[cantidad].diaSalida = diaSalida;
+    entradas[cantidad].codigo = codigo;
+    subir(cantidad);
+    cantidad++;
+}
+
+bool ColaVencimientos::estaVacia() const {
+    return cantidad == 0;
+}
+
+int ColaVencimientos::getCantidad() const {
+    return cantidad;
+}
+
+long ColaVencimientos::verDiaMinimo() const {
+    return entradas[0].diaSalida;
+}
+
+/**
+ * @brief Extrae la raíz del montículo en O(log n).
+ * @return La entrada con el menor día de salida.
+ */
+ColaVencimientos::Entrada ColaVencimientos::extraerMinimo() {
+    Entrada minimo = std::move(entradas[0]);
+    cantidad--;
+    if (cantidad > 0) {
+        entradas[0] = std::move(entradas[cantidad]);
+        bajar(0);
+    }
+    return minimo;
+}
+
+void ColaVencimientos::vaciar() {
+    cantidad = 0;
+}
@@ -0,0 +1,44 @@
+#ifndef COLAVENCIMIENTOS_H
+#define COLAVENCIMIENTOS_H
+
+#include <string>
+
+// Montículo mínimo de reservaciones activas ordenado por día de salida.
+// Permite archivar hasta una fecha de corte extrayendo solo las k reservaciones
+// vencidas en O(k log n), sin recalcular la fecha de salida de todas las activas.
+// Las anulaciones no se retiran del montículo: la entrada se descarta al extraerla
+// si la reservación ya no está activa (eliminación perezosa).
+class ColaVencimientos {
+public:
+    struct Entrada {
+        long diaSalida;          // Ver Fecha::aNumeroDia
+        std::string codigo;      // Código de la reservación
+    };
+
+private:
+    Entrada* entradas;
+    int cantidad;
+    int cupo;
+
+    void asegurarCapacidad();
+    void subir(int indice);
+    void bajar(int indice);
+
+public:
+    ColaVencimientos();
+    ~ColaVencimientos();
+
+    ColaVencimientos(const ColaVencimientos&) = delete;
+    ColaVencimientos& operator=(const ColaVencimientos&) = delete;
+
+    void insertar(long diaSalida, const std::string& codigo);
+    bool estaVacia() const;
+    int getCantidad() const;
+    // Día de salida más temprano (solo válido si no está vacía).
+    long verDiaMinimo() const;
+    // Extrae la entrada con menor día de salida.
+    Entrada extraerMinimo();
+    void vaciar();
+};
+
+#endif // COLAVENCIMIENTOS_H
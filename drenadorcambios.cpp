@@ -0,0 +1,173 @@
+// --- drenadorcambios.cpp ---
+// Implementación de los sumideros y del consumidor del canal de cambios.
+#include "drenadorcambios.h"
+#include "bufercsv.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+SumideroArchivo::SumideroArchivo(const string& rutaArchivo) : ruta(rutaArchivo) {
+    descriptor = ::open(ruta.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (descriptor < 0) {
+        cerr << "Error [SumideroArchivo]: No se pudo abrir '" << ruta << "' para los eventos." << endl;
+    }
+}
+
+SumideroArchivo::~SumideroArchivo() {
+    if (descriptor >= 0) ::close(descriptor);
+}
+
+bool SumideroArchivo::escribir(const char* datos, size_t bytes) {
+    if (descriptor < 0) return false;
+    while (bytes > 0) {
+        ssize_t escritos = ::write(descriptor, datos, bytes);
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += escritos;
+        bytes -= static_cast<size_t>(escritos);
+    }
+    return true;
+}
+
+string SumideroArchivo::describir() const {
+    return "archivo " + ruta;
+}
+
+SumideroTuberia::SumideroTuberia(const string& rutaTuberia, int esperaMaximaMilisegundos) :
+    ruta(rutaTuberia), descriptor(-1), esperaMaximaMs(esperaMaximaMilisegundos) {
+    if (::mkfifo(ruta.c_str(), 0644) != 0 && errno != EEXIST) {
+        cerr << "Error [SumideroTuberia]: No se pudo crear la tubería '" << ruta << "'." << endl;
+    }
+}
+
+SumideroTuberia::~SumideroTuberia() {
+    cerrar();
+}
+
+void SumideroTuberia::cerrar() {
+    if (descriptor >= 0) ::close(descriptor);
+    descriptor = -1;
+}
+
+bool SumideroTuberia::escribir(const char* datos, size_t bytes) {
+    if (descriptor < 0) {
+        // Sin bloqueo: falla con ENXIO si nadie tiene la tubería abierta para leer
+        descriptor = ::open(ruta.c_str(), O_WRONLY | O_NONBLOCK);
+        if (descriptor < 0) return false;
+    }
+    const auto limite = chrono::steady_clock::now() + chrono::milliseconds(esperaMaximaMs);
+    while (bytes > 0) {
+        ssize_t escritos = ::write(descriptor, datos, bytes);
+        if (escritos >= 0) {
+            datos += escritos;
+            bytes -= static_cast<size_t>(escritos);
+            continue;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN) {
+            // Tubería llena: se espera un poco a que el lector avance, sin pasar del límite
+            long restante = static_cast<long>(chrono::duration_cast<chrono::milliseconds>(
+                limite - chrono::steady_clock::now()).count());
+            pollfd espera{descriptor, POLLOUT, 0};
+            if (restante > 0 && ::poll(&espera, 1, static_cast<int>(restante)) > 0) continue;
+        } else if (errno == EPIPE) {
+            // El lector cerró. El hilo del drenador tiene SIGPIPE bloqueada: se retira la pendiente
+            sigset_t senales;
+            sigemptyset(&senales);
+            sigaddset(&senales, SIGPIPE);
+            timespec cero{0, 0};
+            ::sigtimedwait(&senales, nullptr, &cero);
+        }
+        // Un lote a medias dejaría una línea cortada: se cierra y el lector verá el fin
+        cerrar();
+        return false;
+    }
+    return true;
+}
+
+string SumideroTuberia::describir() const {
+    return "tubería " + ruta;
+}
+
+DrenadorCambios::DrenadorCambios(CanalCambios& canalCambios, SumideroEventos* sumideroEventos,
+                                 int intervaloMilisegundos, int eventosPorLote) :
+    canal(canalCambios), sumidero(sumideroEventos),
+    intervaloMs(intervaloMilisegundos > 0 ? intervaloMilisegundos : 1),
+    maximoLote(eventosPorLote > 0 ? eventosPorLote : 1),
+    detener(false), lotes(0), escritos(0), descartados(0) {
+    canal.suscribir(lector);
+    hilo = thread(&DrenadorCambios::ciclo, this);
+}
+
+DrenadorCambios::~DrenadorCambios() {
+    {
+        lock_guard<mutex> bloqueo(mutexDrenador);
+        detener = true;
+    }
+    despertar.notify_one();
+    if (hilo.joinable()) hilo.join();
+    delete sumidero;
+}
+
+int DrenadorCambios::drenar(EventoReservacion* lote, BuferCSV& bufer) {
+    int leidos = canal.leer(lector, lote, maximoLote);
+    if (leidos == 0) return 0;
+    bufer.limpiar();
+    for (int i = 0; i < leidos; ++i) {
+        lote[i].escribirCSV(bufer);
+    }
+    if (sumidero->escribir(bufer.getDatos(), bufer.getTamano())) {
+        lotes.fetch_add(1, memory_order_relaxed);
+        escritos.fetch_add(static_cast<unsigned long long>(leidos), memory_order_relaxed);
+    } else {
+        descartados.fetch_add(static_cast<unsigned long long>(leidos), memory_order_relaxed);
+    }
+    return leidos;
+}
+
+void DrenadorCambios::ciclo() {
+    // Escribir en una tubería sin lector no debe terminar el proceso (ver SumideroTuberia)
+    sigset_t senales;
+    sigemptyset(&senales);
+    sigaddset(&senales, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &senales, nullptr);
+
+    EventoReservacion* lote = new EventoReservacion[maximoLote];
+    BuferCSV bufer(static_cast<size_t>(maximoLote) * 96);
+    unique_lock<mutex> bloqueo(mutexDrenador);
+    while (!detener) {
+        bloqueo.unlock();
+        // Con un lote lleno puede haber más esperando: se sigue sin dormir
+        int leidos = drenar(lote, bufer);
+        bloqueo.lock();
+        if (leidos < maximoLote && !detener) {
+            despertar.wait_for(bloqueo, chrono::milliseconds(intervaloMs));
+        }
+    }
+    bloqueo.unlock();
+    while (drenar(lote, bufer) == maximoLote) {
+    }
+    delete[] lote;
+}
+
+string DrenadorCambios::describir() const {
+    return sumidero->describir();
+}
+
+DrenadorCambios::Metricas DrenadorCambios::getMetricas() const {
+    Metricas m;
+    m.leidos = lector.getLeidos();
+    m.perdidos = lector.getPerdidos();
+    m.lotes = lotes.load(memory_order_relaxed);
+    m.escritos = escritos.load(memory_order_relaxed);
+    m.descartados = descartados.load(memory_order_relaxed);
+    return m;
+}
@@ -0,0 +1,96 @@
+#ifndef DRENADORCAMBIOS_H
+#define DRENADORCAMBIOS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "canalcambios.h"
+
+// Destino de los eventos del canal de cambios. Recibe lotes de líneas CSV completas.
+class SumideroEventos {
+public:
+    virtual ~SumideroEventos() {}
+    // Escribe el lote completo; false si no se pudo (el lote se cuenta como descartado).
+    virtual bool escribir(const char* datos, size_t bytes) = 0;
+    virtual std::string describir() const = 0;
+};
+
+// Anexa los lotes a un archivo (lo crea si no existe).
+class SumideroArchivo : public SumideroEventos {
+private:
+    std::string ruta;
+    int descriptor;
+
+public:
+    explicit SumideroArchivo(const std::string& rutaArchivo);
+    ~SumideroArchivo();
+    bool escribir(const char* datos, size_t bytes) override;
+    std::string describir() const override;
+};
+
+// Escribe los lotes en una tubería con nombre (la crea con mkfifo si no existe).
+// Sin un lector conectado, o si el lector no vacía la tubería a tiempo, el lote se
+// descarta en lugar de esperar: la tubería se vuelve a abrir en el lote siguiente.
+class SumideroTuberia : public SumideroEventos {
+private:
+    std::string ruta;
+    int descriptor;
+    int esperaMaximaMs;            // Cuánto se espera a que la tubería tenga espacio
+
+    void cerrar();
+
+public:
+    explicit SumideroTuberia(const std::string& rutaTuberia, int esperaMaximaMilisegundos = 200);
+    ~SumideroTuberia();
+    bool escribir(const char* datos, size_t bytes) override;
+    std::string describir() const override;
+};
+
+// Consumidor del canal de cambios con su propio hilo: cada 'intervalo' (o apenas hay
+// un lote lleno) lee lo nuevo con su cursor, lo pasa a CSV y lo entrega al sumidero.
+// Si se atrasa, el canal no lo espera: los eventos sobrescritos quedan en 'perdidos'.
+class DrenadorCambios {
+public:
+    struct Metricas {
+        unsigned long long leidos;       // Eventos tomados del canal
+        unsigned long long perdidos;     // Sobrescritos antes de que este consumidor los leyera
+        unsigned long long lotes;        // Lotes entregados al sumidero
+        unsigned long long escritos;     // Eventos en lotes entregados
+        unsigned long long descartados;  // Eventos en lotes que el sumidero no aceptó
+    };
+
+private:
+    CanalCambios& canal;
+    CanalCambios::Lector lector;
+    SumideroEventos* sumidero;
+    int intervaloMs;
+    int maximoLote;
+
+    std::mutex mutexDrenador;
+    std::condition_variable despertar;
+    bool detener;
+    std::thread hilo;
+
+    std::atomic<unsigned long long> lotes, escritos, descartados;
+
+    void ciclo();
+    // Lee y entrega lo disponible; devuelve los eventos leídos.
+    int drenar(EventoReservacion* lote, BuferCSV& bufer);
+
+public:
+    // Toma el sumidero (creado con new). Se suscribe al canal desde el próximo evento.
+    DrenadorCambios(CanalCambios& canalCambios, SumideroEventos* sumideroEventos, int intervaloMilisegundos = 50,
+                    int eventosPorLote = 512);
+    // Entrega lo que quede en el canal, detiene el hilo y libera el sumidero.
+    ~DrenadorCambios();
+
+    DrenadorCambios(const DrenadorCambios&) = delete;
+    DrenadorCambios& operator=(const DrenadorCambios&) = delete;
+
+    std::string describir() const;
+    Metricas getMetricas() const;
+};
+
+#endif // DRENADORCAMBIOS_H
@@ -0,0 +1,193 @@
+// --- escritorgrupal.cpp ---
+// Implementación del escritor con commit en grupo.
+#include "escritorgrupal.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+EscritorGrupal::EscritorGrupal() :
+    descriptor(-1), ventanaMicros(0), maximoLote(1), sincronizar(true),
+    ultimoEncolado(0), ultimoConfirmado(0), enError(false), detener(false),
+    lotes(0), registrosEscritos(0), bytesEscritos(0), loteMaximo(0), errores(0),
+    sumaLatenciasMicros(0), latenciaMaximaMicros(0), sumaSincronizacionMicros(0) {
+}
+
+EscritorGrupal::~EscritorGrupal() {
+    cerrar();
+}
+
+bool EscritorGrupal::abrir(const string& rutaArchivo, int ventanaMicrosegundos, int registrosPorLote,
+                           bool sincronizarEnDisco) {
+    cerrar();
+    descriptor = ::open(rutaArchivo.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (descriptor < 0) {
+        cerr << "Error [EscritorGrupal]: No se pudo abrir '" << rutaArchivo << "': " << strerror(errno) << endl;
+        return false;
+    }
+    ruta = rutaArchivo;
+    ventanaMicros = ventanaMicrosegundos > 0 ? ventanaMicrosegundos : 0;
+    maximoLote = registrosPorLote > 0 ? registrosPorLote : 1;
+    sincronizar = sincronizarEnDisco;
+    enError = false;
+    detener = false;
+    hiloEscritor = thread(&EscritorGrupal::cicloEscritor, this);
+    return true;
+}
+
+void EscritorGrupal::cerrar() {
+    {
+        lock_guard<mutex> bloqueo(mutexEscritor);
+        detener = true;
+    }
+    hayPendientes.notify_all();
+    if (hiloEscritor.joinable()) {
+        hiloEscritor.join();
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+}
+
+bool EscritorGrupal::estaAbierto() const {
+    return descriptor >= 0;
+}
+
+unsigned long long EscritorGrupal::encolar(const string& registro) {
+    unsigned long long turno;
+    {
+        lock_guard<mutex> bloqueo(mutexEscritor);
+        pendientes.encolar(Registro{registro + "\n", chrono::steady_clock::now()});
+        turno = ++ultimoEncolado;
+    }
+    hayPendientes.notify_one();
+    return turno;
+}
+
+bool EscritorGrupal::esperar(unsigned long long turno) {
+    unique_lock<mutex> bloqueo(mutexEscritor);
+    hayConfirmados.wait(bloqueo, [&]() { return ultimoConfirmado >= turno || enError; });
+    return ultimoConfirmado >= turno;
+}
+
+bool EscritorGrupal::estaEnError() const {
+    lock_guard<mutex> bloqueo(mutexEscritor);
+    return enError;
+}
+
+/**
+ * @brief Hilo escritor. Cuando llega el primer registro espera hasta que se cumpla
+ * la ventana (contada desde ese registro) o se junte un lote completo; luego escribe
+ * el lote con un solo write + fdatasync, sin tener el mutex, y despierta a los que esperan.
+ */
+void EscritorGrupal::cicloEscritor() {
+    unique_lock<mutex> bloqueo(mutexEscritor);
+    string lote;
+    chrono::steady_clock::time_point* encolados = new chrono::steady_clock::time_point[maximoLote];
+
+    while (true) {
+        hayPendientes.wait(bloqueo, [this]() { return detener || !pendientes.estaVacia(); });
+        if (pendientes.estaVacia()) {
+            break; // detener y no queda nada
+        }
+        if (ventanaMicros > 0 && !detener && pendientes.getCantidad() < maximoLote) {
+            hayPendientes.wait_for(bloqueo, chrono::microseconds(ventanaMicros),
+                                   [this]() { return detener || pendientes.getCantidad() >= maximoLote; });
+        }
+
+        lote.clear();
+        int enLote = 0;
+        Registro registro;
+        while (enLote < maximoLote && pendientes.desencolar(registro)) {
+            lote += registro.texto;
+            encolados[enLote++] = registro.encolado;
+        }
+        const unsigned long long ultimoDelLote = ultimoConfirmado + enLote;
+        if (enError) {
+            // Un lote anterior no llegó al disco: escribir este dejaría un hueco en el
+            // diario, así que se descarta y sus turnos fallan como los de aquel
+            hayConfirmados.notify_all();
+            continue;
+        }
+        bloqueo.unlock();
+
+        auto inicio = chrono::steady_clock::now();
+        bool exito = true;
+        size_t escritos = 0;
+        while (exito && escritos < lote.size()) {
+            ssize_t n = ::write(descriptor, lote.data() + escritos, lote.size() - escritos);
+            if (n > 0) {
+                escritos += static_cast<size_t>(n);
+            } else if (!(n < 0 && errno == EINTR)) {
+                exito = false;
+            }
+        }
+        if (exito && sincronizar && ::fdatasync(descriptor) != 0) {
+            exito = false;
+        }
+        auto fin = chrono::steady_clock::now();
+        if (!exito) {
+            cerr << "Error [EscritorGrupal]: No se pudo escribir el lote en '" << ruta << "': "
+                 << strerror(errno) << endl;
+        }
+
+        bloqueo.lock();
+        if (exito) {
+            ultimoConfirmado = ultimoDelLote;
+            lotes++;
+            registrosEscritos += enLote;
+            bytesEscritos += lote.size();
+            if (static_cast<unsigned long long>(enLote) > loteMaximo) loteMaximo = enLote;
+            sumaSincronizacionMicros += chrono::duration<double, micro>(fin - inicio).count();
+            for (int i = 0; i < enLote; ++i) {
+                double latencia = chrono::duration<double, micro>(fin - encolados[i]).count();
+                sumaLatenciasMicros += latencia;
+                if (latencia > latenciaMaximaMicros) latenciaMaximaMicros = latencia;
+            }
+        } else {
+            errores++;
+            enError = true; // El diario quedó incompleto: no se confirma nada más
+        }
+        hayConfirmados.notify_all();
+    }
+    delete[] encolados;
+}
+
+/**
+ * @brief Vacía el archivo después de un punto de control.
+ * Primero espera a que todo lo encolado esté confirmado, así ningún lote en curso
+ * se escribe sobre el archivo truncado.
+ */
+bool EscritorGrupal::truncar() {
+    unique_lock<mutex> bloqueo(mutexEscritor);
+    if (descriptor < 0) {
+        return false;
+    }
+    hayPendientes.notify_one();
+    hayConfirmados.wait(bloqueo, [this]() { return ultimoConfirmado == ultimoEncolado || enError; });
+    if (enError) {
+        return false;
+    }
+    if (::ftruncate(descriptor, 0) != 0 || (sincronizar && ::fsync(descriptor) != 0)) {
+        cerr << "Error [EscritorGrupal]: No se pudo vaciar '" << ruta << "': " << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+EscritorGrupal::Metricas EscritorGrupal::getMetricas() const {
+    lock_guard<mutex> bloqueo(mutexEscritor);
+    Metricas m;
+    m.lotes = lotes;
+    m.registros = registrosEscritos;
+    m.bytes = bytesEscritos;
+    m.loteMaximo = loteMaximo;
+    m.latenciaPromedioMicros = registrosEscritos > 0 ? sumaLatenciasMicros / registrosEscritos : 0;
+    m.latenciaMaximaMicros = latenciaMaximaMicros;
+    m.sincronizacionPromedioMicros = lotes > 0 ? sumaSincronizacionMicros / lotes : 0;
+    m.errores = errores;
+    return m;
+}
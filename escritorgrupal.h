@@ -0,0 +1,89 @@
+#ifndef ESCRITORGRUPAL_H
+#define ESCRITORGRUPAL_H
+
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "colacircular.h"
+
+// Escritor con "commit en grupo" para un archivo de solo anexar (el diario de reservaciones).
+// Los hilos encolan registros y esperan su confirmación; un hilo dedicado junta lo
+// que llegó durante una ventana corta (o hasta llenar un lote) y lo manda al disco
+// con una sola escritura y un solo fdatasync. Así N operaciones concurrentes pagan
+// una sincronización en lugar de N.
+//
+// Cada registro recibe un turno creciente; confirmar un lote confirma todos los
+// turnos hasta el último del lote (los lotes salen en orden de llegada).
+class EscritorGrupal {
+public:
+    struct Metricas {
+        unsigned long long lotes;
+        unsigned long long registros;
+        unsigned long long bytes;
+        unsigned long long loteMaximo;           // Registros en el lote más grande
+        double latenciaPromedioMicros;           // Desde encolar hasta quedar en disco
+        double latenciaMaximaMicros;
+        double sincronizacionPromedioMicros;     // write + fdatasync por lote
+        unsigned long long errores;
+    };
+
+private:
+    struct Registro {
+        std::string texto;
+        std::chrono::steady_clock::time_point encolado;
+    };
+
+    std::string ruta;
+    int descriptor;
+    int ventanaMicros;             // Cuánto se espera a que se sumen más registros
+    int maximoLote;                // Con este número de registros se escribe sin esperar
+    bool sincronizar;              // false: solo write (útil para comparar)
+
+    mutable std::mutex mutexEscritor;
+    std::condition_variable hayPendientes;
+    std::condition_variable hayConfirmados;
+    ColaCircular<Registro> pendientes;
+    unsigned long long ultimoEncolado;
+    unsigned long long ultimoConfirmado;
+    bool enError;                  // Falló una escritura: los turnos no confirmados fallan
+    bool detener;
+    std::thread hiloEscritor;
+
+    // Acumulados de las métricas (protegidos por mutexEscritor)
+    unsigned long long lotes, registrosEscritos, bytesEscritos, loteMaximo, errores;
+    double sumaLatenciasMicros, latenciaMaximaMicros, sumaSincronizacionMicros;
+
+    void cicloEscritor();
+
+public:
+    EscritorGrupal();
+    ~EscritorGrupal();
+
+    EscritorGrupal(const EscritorGrupal&) = delete;
+    EscritorGrupal& operator=(const EscritorGrupal&) = delete;
+
+    // Abre (o crea) el archivo en modo anexar y arranca el hilo escritor.
+    bool abrir(const std::string& rutaArchivo, int ventanaMicrosegundos, int registrosPorLote,
+               bool sincronizarEnDisco = true);
+    // Escribe lo pendiente, detiene el hilo y cierra el archivo.
+    void cerrar();
+    bool estaAbierto() const;
+
+    // Encola un registro (una línea, sin '\n') y devuelve su turno. No bloquea.
+    unsigned long long encolar(const std::string& registro);
+    // Bloquea hasta que el turno esté en disco. false si la escritura falló.
+    bool esperar(unsigned long long turno);
+    // true desde que falló una escritura (hasta el próximo abrir): de ahí en adelante
+    // ningún turno se confirma, así que no vale la pena encolar.
+    bool estaEnError() const;
+
+    // Espera a que todo lo encolado esté en disco y deja el archivo vacío.
+    // Se usa después de un punto de control (los registros ya están en el CSV).
+    bool truncar();
+
+    Metricas getMetricas() const;
+};
+
+#endif // ESCRITORGRUPAL_H
@@ -1,125 +1,37 @@
 // --- Fecha.cpp ---
 // Implementación de la clase Fecha para el sistema UdeAStay.
+// Lo que no escribe mensajes ni texto está en Fecha.h como constexpr.
 // Autor: [Nikolas Ortega]
 // Fecha de creación: 21 de Mayo del 2025
 #include "Fecha.h"
 #include <iostream>   // Para std::cerr (salida de errores)
-#include <sstream>    // Para std::ostringstream (construcción de strings)
-#include <iomanip>    // Para std::setw, std::setfill (formato de salida)
-#include <stdexcept>  // Para std::invalid_argument (manejo de excepciones)
+#include <ctime>      // Para std::time y localtime_r (Fecha::hoy)
+#include <charconv>   // Para std::to_chars (años y días en el texto)
+#include <cstring>    // Para memcpy y strlen (Fecha::escribirEn, escribirFormatoLargo)
 
 // Usamos el namespace std para evitar escribir 'std::' repetidamente.
 using namespace std;
 
-// --- Métodos Privados (Helpers) ---
+// Las tablas y la aritmética se evalúan al compilar.
+static_assert(Fecha::TABLAS.diasAcumulados[13] == 365, "El año no bisiesto debe sumar 365 días");
+static_assert(Fecha(1, 1, 1970).aNumeroDia() == 0, "El día 0 es el 01/01/1970");
+static_assert(Fecha(1, 1, 1970).diaDeLaSemana() == 4, "El 01/01/1970 fue jueves");
+static_assert(Fecha(29, 2, 2024).diaDelAnio() == 60, "Día del año en bisiesto");
+static_assert(Fecha(28, 2, 2025).calcularFechaMasDuracion(1).esIgual(Fecha(1, 3, 2025)), "Cambio de mes");
+static_assert(!Fecha::esValida(29, 2, 2100) && Fecha::esValida(29, 2, 2000), "Bisiestos de siglo");
 
-/**
- * @brief Verifica si los componentes de una fecha (día, mes, año) forman una fecha válida.
- * Incluye la validación de años bisiestos para Febrero.
- * @param d Día.
- * @param m Mes.
- * @param a Año.
- * @return true si la fecha es válida, false en caso contrario.
- */
-bool Fecha::esFechaValida(int d, int m, int a) const {
-    // Considero años válidos a partir del 0 o 1 d.C. Ajustar si es necesario.
-    if (a < 1) return false;
-    if (m < 1 || m > 12) return false; // Meses deben estar entre 1 y 12.
-    if (d < 1) return false;         // Días deben ser al menos 1.
+// --- Mensajes ---
 
-    // Días por mes (0 es un placeholder para el índice 0).
-    int diasEnMes[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
-    // Verificación de año bisiesto para Febrero.
-    if (m == 2 && ((a % 4 == 0 && a % 100 != 0) || (a % 400 == 0))) {
-        if (d > 29) return false; // Febrero en bisiesto tiene hasta 29 días.
-    } else {
-        if (d > diasEnMes[m]) return false; // Verificar contra días normales del mes.
-    }
-    return true; // Si pasó todas las validaciones, es válida.
+void Fecha::avisarFechaInvalida(int d, int m, int a) {
+    // La fecha proporcionada no es válida: el objeto queda en 01/01/1900.
+    cerr << "ADVERTENCIA [Fecha]: Fecha de construcción (" << d << "/" << m << "/" << a
+         << ") inválida. Estableciendo a 01/01/1900." << endl;
 }
 
-/**
- * @brief Calcula el nombre del día de la semana para una fecha dada.
- * Utiliza la Congruencia de Zeller.
- * @param d Día del mes (1-31).
- * @param m Mes (1-12). Enero y Febrero se tratan como meses 13 y 14 del año anterior.
- * @param a Año.
- * @return string con el nombre del día de la semana en español.
- */
-string Fecha::calcularNombreDiaSemana(int d, int m, int a) const {
-    // Nombres de los días, Domingo es 0 según Zeller para esta variante.
-    string nombresDia[] = {"Domingo", "Lunes", "Martes", "Miércoles", "Jueves", "Viernes", "Sábado"};
-
-    int anioZ = a;
-    int mesZ = m;
-
-    if (mesZ < 3) { // Enero (1) y Febrero (2) se consideran meses 13 y 14 del año anterior.
-        mesZ += 12;
-        anioZ--;
-    }
-
-    int K = anioZ % 100; // Año del siglo.
-    int J = anioZ / 100; // Siglo.
-
-    // Fórmula de Zeller (para el calendario Gregoriano):
-    // h = (q + floor(13*(m+1)/5) + K + floor(K/4) + floor(J/4) - 2*J) mod 7
-    // Donde q es el día, m es el mes (3=Marzo, ..., 12=Diciembre, 13=Enero, 14=Febrero),
-    // K el año del siglo, J el siglo.
-    // El resultado h: 0=Sábado, 1=Domingo, ..., 6=Viernes (si se usa la fórmula original directa)
-    // Adaptaremos para que 0=Domingo, 1=Lunes, etc.
-    // Mi variante: h = (d + floor((13*(mesZ+1))/5) + K + floor(K/4) + J + 5*J) mod 7
-    // Resultado: 0=Domingo, 1=Lunes, ..., 6=Sábado.
-
-    int h = (d + (13 * (mesZ + 1)) / 5 + K + K / 4 + J / 4 + 5 * J) % 7;
-    // Ajuste para que 0 sea Domingo, 1 Lunes, etc. según mi array `nombresDia`
-    // Zeller original da 0=Sábado, 1=Domingo...
-    // Si h=0 (Sábado), debe ser nombresDia[6]
-    // Si h=1 (Domingo), debe ser nombresDia[0]
-    // (h + 6) % 7 mapea 0->6, 1->0, 2->1 ...
-    return nombresDia[(h + 6) % 7]; // Ajuste para que 0=Domingo, 1=Lunes...
-}
-
-
-// --- Constructores ---
-
-/**
- * @brief Constructor por defecto. Inicializa a 01/01/1900.
- */
-Fecha::Fecha() : dia(1), mes(1), anio(1900) {
-    // Cuerpo del constructor por defecto. Ya inicializado en la lista.
-}
-
-/**
- * @brief Constructor con parámetros.
- * Valida la fecha; si es inválida, establece 01/01/1900 y muestra error.
- * @param d Día.
- * @param m Mes.
- * @param a Año.
- */
-Fecha::Fecha(int d, int m, int a) {
-    if (esFechaValida(d, m, a)) {
-        this->dia = d;
-        this->mes = m;
-        this->anio = a;
-    } else {
-        // La fecha proporcionada no es válida.
-        // Informamos y establecemos una fecha segura por defecto.
-        cerr << "ADVERTENCIA [Fecha]: Fecha de construcción (" << d << "/" << m << "/" << a
-             << ") inválida. Estableciendo a 01/01/1900." << endl;
-        this->dia = 1;
-        this->mes = 1;
-        this->anio = 1900;
-        // Podríamos lanzar std::invalid_argument aquí si quisiéramos ser más estrictos.
-        // throw invalid_argument("Fecha de construcción inválida.");
-    }
+void Fecha::avisarNochesNegativas() {
+    cerr << "ERROR [Fecha]: No se pueden sumar noches negativas en calcularFechaMasDuracion." << endl;
 }
 
-// --- Getters ---
-int Fecha::getDia() const { return dia; }
-int Fecha::getMes() const { return mes; }
-int Fecha::getAnio() const { return anio; }
-
 // --- Setters ---
 /**
  * @brief Establece el día. Valida que la nueva fecha sea coherente.
@@ -127,7 +39,7 @@ int Fecha::getAnio() const { return anio; }
  * @return true si se pudo establecer, false si la fecha resultante sería inválida.
  */
 bool Fecha::setDia(int d) {
-    if (esFechaValida(d, this->mes, this->anio)) {
+    if (esValida(d, this->mes, this->anio)) {
         this->dia = d;
         return true;
     }
@@ -137,7 +49,7 @@ bool Fecha::setDia(int d) {
 }
 
 bool Fecha::setMes(int m) {
-    if (esFechaValida(this->dia, m, this->anio)) {
+    if (esValida(this->dia, m, this->anio)) {
         this->mes = m;
         return true;
     }
@@ -147,7 +59,7 @@ bool Fecha::setMes(int m) {
 }
 
 bool Fecha::setAnio(int a) {
-    if (esFechaValida(this->dia, this->mes, a)) {
+    if (esValida(this->dia, this->mes, a)) {
         this->anio = a;
         return true;
     }
@@ -164,7 +76,7 @@ bool Fecha::setAnio(int a) {
  * @return true si se pudo establecer, false si la fecha resultante sería inválida.
  */
 bool Fecha::setFecha(int d, int m, int a) {
-    if (esFechaValida(d, m, a)) {
+    if (esValida(d, m, a)) {
         this->dia = d;
         this->mes = m;
         this->anio = a;
@@ -182,116 +94,76 @@ bool Fecha::setFecha(int d, int m, int a) {
  * @return string con la fecha formateada.
  */
 string Fecha::toString() const {
-    ostringstream oss;
-    oss << setw(2) << setfill('0') << dia << "/"
-        << setw(2) << setfill('0') << mes << "/"
-        << anio;
-    return oss.str();
+    char texto[LARGO_MAXIMO_TEXTO];
+    return string(texto, static_cast<size_t>(escribirEn(texto)));
 }
 
-/**
- * @brief Convierte la fecha a un string en formato largo: "NombreDia, DD de NombreMes del AAAA".
- * Cumple con el formato especificado en el desafío.
- * @return string con la fecha en formato largo.
- */
-string Fecha::toStringFormatoLargo() const {
-    string nombresMes[] = {
-        "", "Enero", "Febrero", "Marzo", "Abril", "Mayo", "Junio",
-        "Julio", "Agosto", "Septiembre", "Octubre", "Noviembre", "Diciembre"
-    };
-
-    // Obtenemos el nombre del día de la semana.
-    string nombreDia = calcularNombreDiaSemana(this->dia, this->mes, this->anio);
-
-    ostringstream oss;
-    oss << nombreDia << ", " << dia << " de " << nombresMes[mes] << " del " << anio;
-    return oss.str();
-}
+// "00" ... "99": el día y el mes se copian de a dos caracteres, sin dividir
+static const char DOS_DIGITOS[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
 
 /**
- * @brief Compara si esta fecha es anterior a otraFecha.
- * @param otraFecha La fecha con la que se compara.
- * @return true si esta fecha es estrictamente menor.
+ * @brief Escribe la fecha como "dd/mm/aaaa" sin reservar memoria.
+ * @param destino Espacio para al menos LARGO_MAXIMO_TEXTO caracteres.
+ * @return Cantidad de caracteres escritos.
  */
-bool Fecha::esMenor(const Fecha& otraFecha) const {
-    if (this->anio < otraFecha.anio) return true;
-    if (this->anio > otraFecha.anio) return false;
-    // Años iguales, se compara el mes.
-    if (this->mes < otraFecha.mes) return true;
-    if (this->mes > otraFecha.mes) return false;
-    // Meses iguales, se compara el día.
-    return this->dia < otraFecha.dia;
-}
-
-/**
- * @brief Compara si esta fecha es igual a otraFecha.
- * @param otraFecha La fecha con la que se compara.
- * @return true si ambas fechas son idénticas.
- */
-bool Fecha::esIgual(const Fecha& otraFecha) const {
-    return this->anio == otraFecha.anio &&
-           this->mes == otraFecha.mes &&
-           this->dia == otraFecha.dia;
+int Fecha::escribirEn(char* destino) const {
+    memcpy(destino, DOS_DIGITOS + 2 * (dia % 100), 2);
+    destino[2] = '/';
+    memcpy(destino + 3, DOS_DIGITOS + 2 * (mes % 100), 2);
+    destino[5] = '/';
+    if (anio >= 1000 && anio <= 9999) {
+        memcpy(destino + 6, DOS_DIGITOS + 2 * (anio / 100), 2);
+        memcpy(destino + 8, DOS_DIGITOS + 2 * (anio % 100), 2);
+        return 10;
+    }
+    return static_cast<int>(to_chars(destino + 6, destino + LARGO_MAXIMO_TEXTO, anio).ptr - destino);
 }
 
 /**
- * @brief Calcula la fecha resultante después de sumar un número de noches a la fecha actual.
- * Maneja correctamente el cambio de meses y años, incluyendo años bisiestos.
- * @param noches Número de noches a sumar (debe ser no negativo).
- * @return Un nuevo objeto Fecha con la fecha resultante.
+ * @brief Escribe la fecha en formato largo: "NombreDia, D de NombreMes del AAAA".
+ * Cumple con el formato especificado en el desafío. Los nombres salen de las
+ * tablas estáticas y los números se escriben con to_chars: no reserva memoria.
+ * @param destino Espacio para al menos LARGO_MAXIMO_FORMATO_LARGO caracteres.
+ * @return Cantidad de caracteres escritos.
  */
-Fecha Fecha::calcularFechaMasDuracion(int noches) const {
-    if (noches < 0) {
-        cerr << "ERROR [Fecha]: No se pueden sumar noches negativas en calcularFechaMasDuracion." << endl;
-        return *this; // Devolver la fecha actual o manejar el error de otra forma.
-    }
-
-    Fecha nuevaFecha = *this; // Se trabaja sobre una copia.
-
-    int diasEnMes[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
-    for (int i = 0; i < noches; ++i) {
-        // Actualizar días en Febrero si es necesario para el año actual de nuevaFecha
-        if ((nuevaFecha.anio % 4 == 0 && nuevaFecha.anio % 100 != 0) || (nuevaFecha.anio % 400 == 0)) {
-            diasEnMes[2] = 29;
-        } else {
-            diasEnMes[2] = 28;
-        }
-
-        nuevaFecha.dia++;
-        if (nuevaFecha.dia > diasEnMes[nuevaFecha.mes]) {
-            nuevaFecha.dia = 1; // Reiniciar día a 1.
-            nuevaFecha.mes++;
-            if (nuevaFecha.mes > 12) {
-                nuevaFecha.mes = 1; // Reiniciar mes a Enero.
-                nuevaFecha.anio++;  // Incrementar año.
-            }
-        }
-    }
-    // Es importante asegurar que la nuevaFecha final sea válida, aunque el bucle debería garantizarlo.
-    // Sin embargo, si 'noches' es muy grande, podrían surgir problemas no previstos.
-    // Por ahora, confiamos en que la lógica incremental es correcta.
-    return nuevaFecha;
+int Fecha::escribirFormatoLargo(char* destino) const {
+    char* fin = destino + LARGO_MAXIMO_FORMATO_LARGO;
+    char* p = destino;
+    const char* nombreDia = nombreDiaSemana();
+    size_t largo = strlen(nombreDia);
+    memcpy(p, nombreDia, largo);
+    p += largo;
+    memcpy(p, ", ", 2);
+    p = to_chars(p + 2, fin, dia).ptr;
+    memcpy(p, " de ", 4);
+    p += 4;
+    const char* nombre = nombreMes();
+    largo = strlen(nombre);
+    memcpy(p, nombre, largo);
+    p += largo;
+    memcpy(p, " del ", 5);
+    p = to_chars(p + 5, fin, anio).ptr;
+    return static_cast<int>(p - destino);
 }
 
-
 /**
- * @brief Verifica si la fecha actual (this) se encuentra dentro de un rango [inicio, fin], inclusivo.
- * @param inicio Fecha de inicio del rango.
- * @param fin Fecha de fin del rango.
- * @return true si this está en el rango [inicio, fin].
+ * @brief Convierte la fecha a un string en formato largo: "NombreDia, DD de NombreMes del AAAA".
+ * @return string con la fecha en formato largo.
  */
-bool Fecha::fechaEnRango(const Fecha& inicio, const Fecha& fin) const {
-    // this >= inicio Y this <= fin
-    // Lo que es equivalente a: !(this < inicio) Y !(fin < this)
-    return !this->esMenor(inicio) && !fin.esMenor(*this);
+string Fecha::toStringFormatoLargo() const {
+    char texto[LARGO_MAXIMO_FORMATO_LARGO];
+    return string(texto, static_cast<size_t>(escribirFormatoLargo(texto)));
 }
 
 /**
- * @brief Compara si esta fecha es mayor o igual a otraFecha.
- * @param otraFecha La fecha con la que se compara.
- * @return true si esta fecha es mayor o igual.
+ * @brief Devuelve la fecha actual del sistema.
  */
-bool Fecha::esMayorOIgual(const Fecha& otraFecha) const {
-    return this->esIgual(otraFecha) || !this->esMenor(otraFecha);
+Fecha Fecha::hoy() {
+    time_t ahora = time(nullptr);
+    tm partes{};
+    localtime_r(&ahora, &partes);
+    return Fecha(partes.tm_mday, partes.tm_mon + 1, partes.tm_year + 1900);
 }
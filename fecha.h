@@ -7,30 +7,66 @@
 // para no contaminar el espacio de nombres global de quien incluya este archivo.
 // Es una buena práctica mantenerlo así en los .h.
 
+// Tablas del calendario (índice = mes, 1..12), generadas al compilar.
+struct TablasCalendario {
+    int diasPorMes[13];            // Año no bisiesto
+    int diasAcumulados[14];        // Días del año antes del primer día del mes (no bisiesto)
+    int desplazamientoSemana[13];  // Aporte del mes al día de la semana (ver Fecha::diaDeLaSemana)
+};
+
+constexpr TablasCalendario generarTablasCalendario() {
+    TablasCalendario t{};
+    for (int m = 1; m <= 12; ++m) {
+        // Meses de 31 días: enero a julio los impares, agosto a diciembre los pares
+        t.diasPorMes[m] = m == 2 ? 28 : 30 + ((m + m / 8) & 1);
+        t.diasAcumulados[m + 1] = t.diasAcumulados[m] + t.diasPorMes[m];
+    }
+    for (int m = 1; m <= 12; ++m) {
+        // Enero y febrero se cuentan como meses del año anterior: desde marzo se
+        // descuenta el día que el 29 de febrero agregaría a la cuenta de bisiestos.
+        t.desplazamientoSemana[m] = (t.diasAcumulados[m] - (m >= 3 ? 1 : 0)) % 7;
+    }
+    return t;
+}
+
 class Fecha {
+public:
+    static constexpr TablasCalendario TABLAS = generarTablasCalendario();
+    static constexpr const char* NOMBRES_DIA[7] = {
+        "Domingo", "Lunes", "Martes", "Miércoles", "Jueves", "Viernes", "Sábado"};
+    static constexpr const char* NOMBRES_MES[13] = {
+        "", "Enero", "Febrero", "Marzo", "Abril", "Mayo", "Junio",
+        "Julio", "Agosto", "Septiembre", "Octubre", "Noviembre", "Diciembre"};
+
 private:
     int dia;
     int mes;
     int anio;
 
     // --- Helpers Privados ---
-    // Valida si los componentes d, m, a forman una fecha calendárica correcta.
-    bool esFechaValida(int d, int m, int a) const;
-
-    // Calcula el nombre del día de la semana (e.g., "Lunes", "Martes").
-    // Este método es usado internamente por toStringFormatoLargo().
-    std::string calcularNombreDiaSemana(int d, int m, int a) const;
+    // Mensajes de error (fuera de línea: nunca se evalúan al compilar).
+    static void avisarFechaInvalida(int d, int m, int a);
+    static void avisarNochesNegativas();
 
 public:
     // --- Constructores ---
-    Fecha(); // Constructor por defecto (ej: 01/01/1900).
-    Fecha(int d, int m, int a); // Constructor con parámetros.
+    constexpr Fecha() : dia(1), mes(1), anio(1900) {} // Constructor por defecto (01/01/1900).
+    // Constructor con parámetros: si la fecha no es válida avisa y queda en 01/01/1900.
+    constexpr Fecha(int d, int m, int a) : dia(1), mes(1), anio(1900) {
+        if (esValida(d, m, a)) {
+            dia = d;
+            mes = m;
+            anio = a;
+        } else {
+            avisarFechaInvalida(d, m, a);
+        }
+    }
 
     // --- Getters ---
     // Devuelven los componentes individuales de la fecha.
-    int getDia() const;
-    int getMes() const;
-    int getAnio() const;
+    constexpr int getDia() const { return dia; }
+    constexpr int getMes() const { return mes; }
+    constexpr int getAnio() const { return anio; }
 
     // --- Setters ---
     // Permiten modificar los componentes de la fecha.
@@ -40,29 +76,107 @@ public:
     bool setAnio(int a);
     bool setFecha(int d, int m, int a); // Establece la fecha completa.
 
+    // --- Calendario ---
+    static constexpr bool esBisiesto(int a) {
+        return (a % 4 == 0 && a % 100 != 0) || a % 400 == 0;
+    }
+    static constexpr int diasDelMes(int m, int a) {
+        return m == 2 && esBisiesto(a) ? 29 : TABLAS.diasPorMes[m];
+    }
+    // Indica si d/m/a es una fecha del calendario, sin mensajes (para validar entradas).
+    static constexpr bool esValida(int d, int m, int a) {
+        // Considero años válidos a partir del 1 d.C.
+        return a >= 1 && m >= 1 && m <= 12 && d >= 1 && d <= diasDelMes(m, a);
+    }
+    // Día del año, 1..366.
+    constexpr int diaDelAnio() const {
+        return TABLAS.diasAcumulados[mes] + dia + (mes > 2 && esBisiesto(anio) ? 1 : 0);
+    }
+    // 0 = domingo ... 6 = sábado (método de Sakamoto con la tabla de desplazamientos).
+    constexpr int diaDeLaSemana() const {
+        int a = anio - (mes < 3 ? 1 : 0);
+        return (a + a / 4 - a / 100 + a / 400 + TABLAS.desplazamientoSemana[mes] + dia) % 7;
+    }
+    constexpr const char* nombreDiaSemana() const { return NOMBRES_DIA[diaDeLaSemana()]; }
+    constexpr const char* nombreMes() const { return NOMBRES_MES[mes]; }
+
     // --- Métodos de Utilidad y Conversión ---
     // Convierte la fecha a un string simple (ej: "dd/mm/aaaa").
     std::string toString() const;
+    // Escribe "dd/mm/aaaa" en 'destino' (con cupo para LARGO_MAXIMO_TEXTO caracteres,
+    // sin '\0' al final) y devuelve cuántos caracteres escribió.
+    static constexpr int LARGO_MAXIMO_TEXTO = 18;
+    int escribirEn(char* destino) const;
 
     // Convierte la fecha al formato largo especificado en el desafío
     // (ej: "Lunes, 12 de Mayo del 2025").
     std::string toStringFormatoLargo() const;
+    // Igual, sin reservar memoria: escribe en 'destino' (LARGO_MAXIMO_FORMATO_LARGO
+    // caracteres de cupo, sin '\0') y devuelve cuántos escribió.
+    static constexpr int LARGO_MAXIMO_FORMATO_LARGO = 48;
+    int escribirFormatoLargo(char* destino) const;
 
     // --- Métodos de Comparación ---
     // Compara si esta fecha es estrictamente anterior a 'otraFecha'.
-    bool esMenor(const Fecha& otraFecha) const;
+    constexpr bool esMenor(const Fecha& otraFecha) const {
+        if (anio != otraFecha.anio) return anio < otraFecha.anio;
+        if (mes != otraFecha.mes) return mes < otraFecha.mes;
+        return dia < otraFecha.dia;
+    }
     // Compara si esta fecha es idéntica a 'otraFecha'.
-    bool esIgual(const Fecha& otraFecha) const;
+    constexpr bool esIgual(const Fecha& otraFecha) const {
+        return anio == otraFecha.anio && mes == otraFecha.mes && dia == otraFecha.dia;
+    }
     // Compara si esta fecha es posterior o igual a 'otraFecha'.
     // Útil, por ejemplo, para validar la "fecha de corte" del histórico.
-    bool esMayorOIgual(const Fecha& otraFecha) const;
+    constexpr bool esMayorOIgual(const Fecha& otraFecha) const { return !esMenor(otraFecha); }
 
     // --- Métodos de Cálculo ---
     // Calcula y devuelve una nueva fecha resultante de sumar 'noches' a la fecha actual.
-    Fecha calcularFechaMasDuracion(int noches) const;
+    // Con noches negativas avisa y devuelve la misma fecha.
+    constexpr Fecha calcularFechaMasDuracion(int noches) const {
+        if (noches < 0) {
+            avisarNochesNegativas();
+            return *this;
+        }
+        return desdeNumeroDia(aNumeroDia() + noches);
+    }
 
     // Verifica si la fecha actual (this) está dentro del rango [inicio, fin], inclusivo.
-    bool fechaEnRango(const Fecha& inicio, const Fecha& fin) const;
+    constexpr bool fechaEnRango(const Fecha& inicio, const Fecha& fin) const {
+        return !esMenor(inicio) && !fin.esMenor(*this);
+    }
+
+    // --- Aritmética por número de día ---
+    // Número de días transcurridos desde el 01/01/1970 (negativo antes de esa fecha).
+    // Permite comparar y restar fechas con una sola operación entera. Usa el algoritmo
+    // de eras de 400 años del calendario gregoriano: no recorre meses ni días.
+    constexpr long aNumeroDia() const {
+        long a = anio - (mes <= 2 ? 1 : 0);
+        long era = (a >= 0 ? a : a - 399) / 400;
+        long anioDeEra = a - era * 400;                                        // [0, 399]
+        long mesDesdeMarzo = mes > 2 ? mes - 3 : mes + 9;                      // [0, 11]
+        long diaDelAnioDesdeMarzo = (153 * mesDesdeMarzo + 2) / 5 + dia - 1;   // [0, 365]
+        long diaDeEra = anioDeEra * 365 + anioDeEra / 4 - anioDeEra / 100 + diaDelAnioDesdeMarzo;
+        return era * 146097 + diaDeEra - 719468;
+    }
+    // Construye la fecha correspondiente a un número de día (inversa de aNumeroDia).
+    static constexpr Fecha desdeNumeroDia(long numeroDia) {
+        numeroDia += 719468;
+        long era = (numeroDia >= 0 ? numeroDia : numeroDia - 146096) / 146097;
+        long diaDeEra = numeroDia - era * 146097;                                          // [0, 146096]
+        long anioDeEra = (diaDeEra - diaDeEra / 1460 + diaDeEra / 36524 - diaDeEra / 146096) / 365;
+        long diaDelAnioDesdeMarzo = diaDeEra - (365 * anioDeEra + anioDeEra / 4 - anioDeEra / 100);  // [0, 365]
+        long mesDesdeMarzo = (5 * diaDelAnioDesdeMarzo + 2) / 153;                         // [0, 11]
+
+        Fecha resultado;
+        resultado.dia = static_cast<int>(diaDelAnioDesdeMarzo - (153 * mesDesdeMarzo + 2) / 5 + 1);
+        resultado.mes = static_cast<int>(mesDesdeMarzo < 10 ? mesDesdeMarzo + 3 : mesDesdeMarzo - 9);
+        resultado.anio = static_cast<int>(anioDeEra + era * 400 + (resultado.mes <= 2 ? 1 : 0));
+        return resultado;
+    }
+    // Fecha actual según el reloj del sistema (hora local).
+    static Fecha hoy();
 };
 
 #endif // FECHA_H
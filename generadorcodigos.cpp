@@ -0,0 +1,119 @@
+// --- generadorcodigos.cpp ---
+// Implementación del asignador monotónico de códigos de reservación.
+#include "generadorcodigos.h"
+#include <fstream>
+#include <limits>
+using namespace std;
+
+GeneradorCodigos::GeneradorCodigos(const string& prefijoCodigo) :
+    prefijo(prefijoCodigo), ultimoEmitido(0) {
+}
+
+/**
+ * @brief Extrae el número de un código con formato <prefijo><dígitos>.
+ * @param codigo Código completo (ej: "RES017").
+ * @param prefijo Prefijo esperado (ej: "RES").
+ * @param numero Salida con el valor numérico.
+ * @return true si el código tiene el formato esperado y el número cabe en 64 bits.
+ */
+bool GeneradorCodigos::extraerNumero(const string& codigo, const string& prefijo,
+                                     unsigned long long& numero) {
+    if (codigo.length() <= prefijo.length() || codigo.compare(0, prefijo.length(), prefijo) != 0) {
+        return false;
+    }
+    const unsigned long long maximo = numeric_limits<unsigned long long>::max();
+    unsigned long long valor = 0;
+    for (size_t i = prefijo.length(); i < codigo.length(); ++i) {
+        char c = codigo[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        const unsigned long long digito = static_cast<unsigned long long>(c - '0');
+        if (valor > (maximo - digito) / 10) {
+            return false; // valor * 10 + digito no cabe
+        }
+        valor = valor * 10 + digito;
+    }
+    numero = valor;
+    return true;
+}
+
+/**
+ * @brief Eleva el contador hasta 'numero' si este es mayor que el actual.
+ * Usa compare_exchange para que la siembra también sea segura entre hilos.
+ */
+void GeneradorCodigos::observarNumero(unsigned long long numero) {
+    unsigned long long actual = ultimoEmitido.load(memory_order_relaxed);
+    while (numero > actual &&
+           !ultimoEmitido.compare_exchange_weak(actual, numero, memory_order_relaxed)) {
+        // 'actual' se recarga en cada intento fallido.
+    }
+}
+
+void GeneradorCodigos::observarCodigo(const string& codigo) {
+    unsigned long long numero;
+    if (extraerNumero(codigo, prefijo, numero)) {
+        observarNumero(numero);
+    }
+}
+
+/**
+ * @brief Carga el último número emitido desde el archivo de secuencia.
+ * Si el archivo no existe no es un error: la semilla sale de los datos.
+ */
+bool GeneradorCodigos::cargarSecuencia(const string& nombreArchivo) {
+    ifstream archivo(nombreArchivo);
+    if (!archivo.is_open()) {
+        return false;
+    }
+    unsigned long long numero = 0;
+    if (!(archivo >> numero)) {
+        return false;
+    }
+    observarNumero(numero);
+    return true;
+}
+
+bool GeneradorCodigos::guardarSecuencia(const string& nombreArchivo) const {
+    ofstream archivo(nombreArchivo);
+    if (!archivo.is_open()) {
+        return false;
+    }
+    archivo << ultimoEmitido.load() << "\n";
+    return true;
+}
+
+/**
+ * @brief Forma un código con el prefijo y el número rellenado a ANCHO_MINIMO dígitos.
+ * El ancho crece solo cuando el número supera 3 dígitos (RES001, ..., RES999, RES1000).
+ */
+string GeneradorCodigos::formatear(const string& prefijo, unsigned long long numero) {
+    char digitos[24];
+    int largo = 0;
+    do {
+        digitos[largo++] = static_cast<char>('0' + numero % 10);
+        numero /= 10;
+    } while (numero > 0);
+    while (largo < ANCHO_MINIMO) {
+        digitos[largo++] = '0';
+    }
+
+    string codigo = prefijo;
+    codigo.reserve(prefijo.length() + largo);
+    while (largo > 0) {
+        codigo += digitos[--largo];
+    }
+    return codigo;
+}
+
+/**
+ * @brief Emite un código nuevo. fetch_add garantiza que dos hilos nunca
+ * reciban el mismo número.
+ */
+string GeneradorCodigos::siguiente() {
+    return formatear(prefijo, ultimoEmitido.fetch_add(1) + 1);
+}
+
+unsigned long long GeneradorCodigos::getUltimoEmitido() const {
+    return ultimoEmitido.load();
+}
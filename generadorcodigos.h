@@ -0,0 +1,44 @@
+#ifndef GENERADORCODIGOS_H
+#define GENERADORCODIGOS_H
+
+#include <atomic>
+#include <string>
+
+// Asignador monotónico de códigos de reservación (ej: "RES001", "RES1234").
+// El contador es atómico, así que varios hilos pueden pedir códigos a la vez
+// sin repetirlos. Se siembra con el mayor código visto en los datos activos,
+// en el histórico y en el archivo de secuencia, por lo que nunca reemite
+// un código que ya exista aunque se archiven o anulen reservaciones.
+class GeneradorCodigos {
+private:
+    std::string prefijo;
+    std::atomic<unsigned long long> ultimoEmitido; // 64 bits: miles de millones de códigos
+
+    // Ancho mínimo del número (compatibilidad con los códigos RES001 existentes).
+    static const int ANCHO_MINIMO = 3;
+
+public:
+    explicit GeneradorCodigos(const std::string& prefijoCodigo);
+
+    // --- Siembra ---
+    // Eleva el contador si 'codigo' (con el prefijo) tiene un número mayor.
+    void observarCodigo(const std::string& codigo);
+    void observarNumero(unsigned long long numero);
+    // Lee/escribe el último número emitido en un archivo de secuencia.
+    bool cargarSecuencia(const std::string& nombreArchivo);
+    bool guardarSecuencia(const std::string& nombreArchivo) const;
+
+    // --- Emisión ---
+    // Devuelve un código nuevo y único. Es seguro llamarlo desde varios hilos.
+    std::string siguiente();
+    unsigned long long getUltimoEmitido() const;
+
+    // Forma el código <prefijo><número con al menos 3 dígitos>.
+    static std::string formatear(const std::string& prefijo, unsigned long long numero);
+    // Extrae la parte numérica de un código con el prefijo dado.
+    // Devuelve false si el código no tiene ese formato.
+    static bool extraerNumero(const std::string& codigo, const std::string& prefijo,
+                              unsigned long long& numero);
+};
+
+#endif // GENERADORCODIGOS_H
@@ -10,40 +10,26 @@ Huesped::Huesped() :
     documento(""),
     credencialLogin(""),
     antiguedadMeses(0),
-    puntuacion(0.0f), // Usar 0.0f para float
-    cantidad(0),
-    capacidad(2) // O un valor inicial que consideres apropiado para la capacidad
+    puntuacion(0.0f) // Usar 0.0f para float
 {
-    // Es crucial inicializar el arreglo dinámico aquí también
-    codigosDeSusReservaciones = new string[capacidad];
-    // No necesitas un bucle para inicializar los strings, new string[] ya los crea vacíos.
+    // La lista de reservaciones empieza vacía y crece al agregar.
     // cout << "Constructor por defecto de Huesped llamado." << endl; // Para depuración
 }
 Huesped::Huesped(const string& id_, const string& nom_, const string& doc, const string& clave, int antig, float punt)
     : id(id_), nombre(nom_), documento(doc), credencialLogin(clave), antiguedadMeses(antig), puntuacion(punt){
-    capacidad = 2;
-    cantidad = 0;
-    codigosDeSusReservaciones = new string[capacidad];
 }
 
 // Constructor por copia
 Huesped::Huesped(const Huesped& otro)
     : id(otro.id), nombre(otro.nombre), credencialLogin(otro.credencialLogin),
     documento(otro.documento), antiguedadMeses(otro.antiguedadMeses),
-    puntuacion(otro.puntuacion), cantidad(otro.cantidad), capacidad(otro.capacidad)
+    puntuacion(otro.puntuacion), reservaciones(otro.reservaciones)
 {
-    codigosDeSusReservaciones = new string[capacidad];
-    for (int i = 0; i < cantidad; ++i) {
-        codigosDeSusReservaciones[i] = otro.codigosDeSusReservaciones[i];
-    }
 }
 
 // Operador de asignación
 Huesped& Huesped::operator=(const Huesped& otro) {
     if (this != &otro) {
-        // Liberar memoria actual
-        delete[] codigosDeSusReservaciones;
-
         // Copiar datos
         id = otro.id;
         nombre = otro.nombre;
@@ -51,20 +37,13 @@ Huesped& Huesped::operator=(const Huesped& otro) {
         documento = otro.documento;
         antiguedadMeses = otro.antiguedadMeses;
         puntuacion = otro.puntuacion;
-        cantidad = otro.cantidad;
-        capacidad = otro.capacidad;
-
-        codigosDeSusReservaciones = new string[capacidad];
-        for (int i = 0; i < cantidad; ++i) {
-            codigosDeSusReservaciones[i] = otro.codigosDeSusReservaciones[i];
-        }
+        reservaciones = otro.reservaciones; // ListaEstadias copia su propio arreglo
     }
     return *this;
 }
 
 
 Huesped::~Huesped() {
-    delete[] codigosDeSusReservaciones;
 }
 std::string Huesped::getId() const {
     return id; // Devuelve el atributo 'id'
@@ -84,12 +63,12 @@ string Huesped::getContrasena() const {
 }
 
 int Huesped::getCantidadReservaciones() const {
-    return cantidad;
+    return reservaciones.getCantidad();
 }
 
 string Huesped::getCodigoReservacion(int i) const {
-    if (i >= 0 && i < cantidad) {
-        return codigosDeSusReservaciones[i];
+    if (i >= 0 && i < reservaciones.getCantidad()) {
+        return reservaciones.getEstadia(i).codigoReservacion;
     } else {
         return "";
     }
@@ -101,29 +80,18 @@ void Huesped::setPuntuacion(float nueva) {
     }
 }
 
-void Huesped::agregarCodigoReservacion(const string &codigoRes) {
-    if (cantidad == capacidad) {
-        capacidad *= 2;
-        string* nueva = new string[capacidad];
-        for (int i = 0; i < cantidad; ++i) {
-            nueva[i] = codigosDeSusReservaciones[i];
-        }
-        delete[] codigosDeSusReservaciones;
-        codigosDeSusReservaciones = nueva;
-    }
-    codigosDeSusReservaciones[cantidad++] = codigoRes;
+void Huesped::agregarReservacion(const string &codigoRes, long diaEntrada, long diaSalida) {
+    reservaciones.insertar(diaEntrada, diaSalida, codigoRes);
 }
 
-void Huesped::eliminarCodigoReservacion(const string &codigoRes) {
-    for (int i = 0; i < cantidad; ++i) {
-        if (codigosDeSusReservaciones[i] == codigoRes) {
-            for (int j = i; j < cantidad - 1; ++j) {
-                codigosDeSusReservaciones[j] = codigosDeSusReservaciones[j + 1];
-            }
-            cantidad--;
-            break;
-        }
-    }
+// Búsqueda binaria por día de entrada; no recorre las demás reservaciones.
+bool Huesped::eliminarReservacion(const string &codigoRes, long diaEntrada) {
+    return reservaciones.eliminar(diaEntrada, codigoRes);
+}
+
+// Intervalos semiabiertos: salir un día y entrar a otro alojamiento ese mismo día no es cruce.
+bool Huesped::tieneEstadiaQueSeCruza(long diaEntrada, long diaSalida) const {
+    return reservaciones.hayCruce(diaEntrada, diaSalida - 1);
 }
 
 void Huesped::mostrarDetalles() const {
@@ -132,8 +100,8 @@ void Huesped::mostrarDetalles() const {
     cout << "documento: " << documento << endl;
     cout << "Antiguedad (meses): " << antiguedadMeses << endl;
     cout << "Puntuacion: " << puntuacion << endl;
-    cout << "Reservaciones (" << cantidad << "): " << endl;
-    for (int i = 0; i < cantidad; ++i) {
-        cout << " - " << codigosDeSusReservaciones[i] << endl;
+    cout << "Reservaciones (" << reservaciones.getCantidad() << "): " << endl;
+    for (int i = 0; i < reservaciones.getCantidad(); ++i) {
+        cout << " - " << reservaciones.getEstadia(i).codigoReservacion << endl;
     }
 }
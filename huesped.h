@@ -1,6 +1,7 @@
 #ifndef HUESPED_H
 #define HUESPED_H
 #include <string>
+#include "listaestadias.h"
 using namespace std;
 
 class Huesped
@@ -13,9 +14,8 @@ private:
 
     int antiguedadMeses;
     float puntuacion;
-    string* codigosDeSusReservaciones;
-    int cantidad;
-    int capacidad;
+    // Reservaciones activas del huésped ordenadas por día de entrada
+    ListaEstadias reservaciones;
 public:
     Huesped();
     Huesped(const Huesped& otro);                     // Constructor por copia
@@ -32,14 +32,16 @@ public:
     float getPuntuacion() const;
     string getContrasena() const; //se agrego para poder crear el login
     int getCantidadReservaciones() const;
-    string getCodigoReservacion(int i) const;
+    string getCodigoReservacion(int i) const;   // En orden de entrada
 
     //Setters
     void setPuntuacion(float nueva);
 
     //Metodos de utilidad
-    void agregarCodigoReservacion(const string& codigoRes);
-    void eliminarCodigoReservacion(const string& codigoRes);
+    void agregarReservacion(const string& codigoRes, long diaEntrada, long diaSalida);
+    bool eliminarReservacion(const string& codigoRes, long diaEntrada);
+    // true si ya tiene una estadía que comparte alguna noche con [diaEntrada, diaSalida)
+    bool tieneEstadiaQueSeCruza(long diaEntrada, long diaSalida) const;
     void mostrarDetalles() const;
 
 };
@@ -0,0 +1,136 @@
+// --- indiceclaves.cpp ---
+// Implementación del índice compacto clave -> posición.
+#include "indiceclaves.h"
+#include <cstring>
+using namespace std;
+
+IndiceClaves::IndiceClaves() :
+    ranuras(nullptr), cupo(0), cantidad(0), claves(nullptr), bytesClaves(0), cupoClaves(0) {
+}
+
+IndiceClaves::~IndiceClaves() {
+    delete[] ranuras;
+    delete[] claves;
+}
+
+// FNV-1a de 64 bits, como TablaHash.
+unsigned long long IndiceClaves::calcularHash(const char* clave, size_t largo) {
+    unsigned long long h = 1469598103934665603ULL;
+    for (size_t i = 0; i < largo; ++i) {
+        h ^= static_cast<unsigned char>(clave[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool IndiceClaves::coincide(const Ranura& ranura, unsigned int huella, const string& clave) const {
+    if (ranura.huella != huella) return false;
+    const unsigned char* largo = reinterpret_cast<const unsigned char*>(claves + ranura.inicioClave - 2);
+    return (static_cast<size_t>(largo[0]) | static_cast<size_t>(largo[1]) << 8) == clave.size() &&
+           memcmp(claves + ranura.inicioClave, clave.data(), clave.size()) == 0;
+}
+
+void IndiceClaves::redimensionar(int nuevoCupo) {
+    Ranura* anteriores = ranuras;
+    int cupoAnterior = cupo;
+    ranuras = new Ranura[nuevoCupo];
+    cupo = nuevoCupo;
+    for (int i = 0; i < cupo; ++i) {
+        ranuras[i].posicion = -1;
+    }
+    // Las claves no se mueven: cada ranura se recoloca con el hash recalculado desde su clave.
+    const int mascara = cupo - 1;
+    for (int i = 0; i < cupoAnterior; ++i) {
+        const Ranura& r = anteriores[i];
+        if (r.posicion < 0) continue;
+        const unsigned char* largo = reinterpret_cast<const unsigned char*>(claves + r.inicioClave - 2);
+        size_t bytes = static_cast<size_t>(largo[0]) | static_cast<size_t>(largo[1]) << 8;
+        int j = static_cast<int>(calcularHash(claves + r.inicioClave, bytes) & static_cast<unsigned long long>(mascara));
+        while (ranuras[j].posicion >= 0) {
+            j = (j + 1) & mascara;
+        }
+        ranuras[j] = r;
+    }
+    delete[] anteriores;
+}
+
+void IndiceClaves::reservar(int elementos) {
+    int necesario = 16;
+    while (necesario * 7 < elementos * 10) necesario *= 2;
+    if (necesario > cupo) redimensionar(necesario);
+}
+
+unsigned int IndiceClaves::guardarClave(const string& clave) {
+    const size_t necesario = bytesClaves + 2 + clave.size();
+    if (necesario > cupoClaves) {
+        size_t nuevoCupo = cupoClaves == 0 ? 4096 : cupoClaves * 2;
+        while (nuevoCupo < necesario) nuevoCupo *= 2;
+        char* nuevas = new char[nuevoCupo];
+        if (bytesClaves > 0) memcpy(nuevas, claves, bytesClaves);
+        delete[] claves;
+        claves = nuevas;
+        cupoClaves = nuevoCupo;
+    }
+    claves[bytesClaves] = static_cast<char>(clave.size() & 0xFF);
+    claves[bytesClaves + 1] = static_cast<char>(clave.size() >> 8);
+    memcpy(claves + bytesClaves + 2, clave.data(), clave.size());
+    unsigned int inicio = static_cast<unsigned int>(bytesClaves + 2);
+    bytesClaves = necesario;
+    return inicio;
+}
+
+bool IndiceClaves::insertar(const string& clave, int posicion) {
+    if (posicion < 0 || clave.size() > LARGO_MAXIMO_CLAVE) {
+        return false;
+    }
+    if ((cantidad + 1) * 10 > cupo * 7) {
+        redimensionar(cupo == 0 ? 16 : cupo * 2);
+    }
+    const unsigned long long hash = calcularHash(clave.data(), clave.size());
+    const unsigned int huella = static_cast<unsigned int>(hash >> 32);
+    const int mascara = cupo - 1;
+    int i = static_cast<int>(hash & static_cast<unsigned long long>(mascara));
+    while (ranuras[i].posicion >= 0) {
+        if (coincide(ranuras[i], huella, clave)) {
+            return false;
+        }
+        i = (i + 1) & mascara;
+    }
+    ranuras[i].huella = huella;
+    ranuras[i].inicioClave = guardarClave(clave);
+    ranuras[i].posicion = posicion;
+    cantidad++;
+    return true;
+}
+
+int IndiceClaves::buscar(const string& clave) const {
+    if (cupo == 0) return -1;
+    const unsigned long long hash = calcularHash(clave.data(), clave.size());
+    const unsigned int huella = static_cast<unsigned int>(hash >> 32);
+    const int mascara = cupo - 1;
+    int i = static_cast<int>(hash & static_cast<unsigned long long>(mascara));
+    while (ranuras[i].posicion >= 0) {
+        if (coincide(ranuras[i], huella, clave)) {
+            return ranuras[i].posicion;
+        }
+        i = (i + 1) & mascara;
+    }
+    return -1;
+}
+
+void IndiceClaves::vaciar() {
+    delete[] ranuras;
+    delete[] claves;
+    ranuras = nullptr;
+    claves = nullptr;
+    cupo = cantidad = 0;
+    bytesClaves = cupoClaves = 0;
+}
+
+int IndiceClaves::getCantidad() const {
+    return cantidad;
+}
+
+size_t IndiceClaves::memoriaAproximada() const {
+    return static_cast<size_t>(cupo) * sizeof(Ranura) + cupoClaves;
+}
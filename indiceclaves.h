@@ -0,0 +1,56 @@
+#ifndef INDICECLAVES_H
+#define INDICECLAVES_H
+
+#include <cstddef>
+#include <string>
+
+// Índice compacto clave -> posición para conjuntos grandes de claves que solo crecen
+// (ID y documento de anfitriones y huéspedes).
+//
+// A diferencia de TablaHash no guarda un std::string por ranura: las claves se copian
+// seguidas en un solo bloque de caracteres y cada ranura tiene 12 bytes (32 bits del
+// hash, dónde empieza su clave y la posición). Con un millón de claves ocupa unos
+// 35 MB en lugar de ~85 MB. Ante claves repetidas se conserva la primera.
+class IndiceClaves {
+private:
+    struct Ranura {
+        unsigned int huella;       // 32 bits altos del hash (descarta casi todas las comparaciones)
+        unsigned int inicioClave;  // Desplazamiento en 'claves' (largo en los 2 bytes previos)
+        int posicion;              // -1 = ranura vacía
+    };
+
+    Ranura* ranuras;
+    int cupo;                      // Siempre potencia de dos
+    int cantidad;
+    char* claves;
+    size_t bytesClaves;
+    size_t cupoClaves;
+
+    static unsigned long long calcularHash(const char* clave, size_t largo);
+    bool coincide(const Ranura& ranura, unsigned int huella, const std::string& clave) const;
+    void redimensionar(int nuevoCupo);
+    unsigned int guardarClave(const std::string& clave);
+
+public:
+    static const size_t LARGO_MAXIMO_CLAVE = 65535;
+
+    IndiceClaves();
+    ~IndiceClaves();
+
+    IndiceClaves(const IndiceClaves&) = delete;
+    IndiceClaves& operator=(const IndiceClaves&) = delete;
+
+    // Prepara espacio para 'elementos' claves sin redimensionar durante la carga.
+    void reservar(int elementos);
+    // false si la clave ya estaba (se conserva la posición anterior) o es demasiado larga.
+    // La posición debe ser >= 0.
+    bool insertar(const std::string& clave, int posicion);
+    // Posición de la clave, o -1 si no está.
+    int buscar(const std::string& clave) const;
+    void vaciar();
+
+    int getCantidad() const;
+    size_t memoriaAproximada() const;
+};
+
+#endif // INDICECLAVES_H
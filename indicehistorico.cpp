@@ -0,0 +1,469 @@
+// --- indicehistorico.cpp ---
+// Implementación del índice por bloques (zone maps + posting lists) sobre el histórico.
+#include "indicehistorico.h"
+#include "fecha.h"
+#include "lecturacampos.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+using namespace std;
+
+// Cabecera del archivo lateral del índice (versión del formato).
+static const char* const FIRMA_INDICE = "IndiceHistorico";
+static const int VERSION_INDICE = 2;
+
+// FNV-1a de 64 bits, como TablaHash; se puede continuar por tramos.
+static const unsigned long long SUMA_INICIAL = 1469598103934665603ULL;
+static unsigned long long acumularSuma(unsigned long long suma, const char* datos, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; ++i) {
+        suma ^= static_cast<unsigned char>(datos[i]);
+        suma *= 1099511628211ULL;
+    }
+    return suma;
+}
+
+// Tamaño y fecha de modificación del histórico (0 si no existe)
+static void estadoDatos(const string& archivo, long long& tamano, long long& segundos, long long& nanosegundos) {
+    struct stat estado;
+    if (::stat(archivo.c_str(), &estado) != 0) {
+        tamano = segundos = nanosegundos = 0;
+        return;
+    }
+    tamano = static_cast<long long>(estado.st_size);
+    segundos = static_cast<long long>(estado.st_mtim.tv_sec);
+    nanosegundos = static_cast<long long>(estado.st_mtim.tv_nsec);
+}
+
+IndiceHistorico::IndiceHistorico(const string& nombreArchivoDatos, const string& nombreArchivoIndice,
+                                 int registrosBloque) :
+    archivoDatos(nombreArchivoDatos), archivoIndice(nombreArchivoIndice),
+    registrosPorBloque(registrosBloque > 0 ? registrosBloque : 512),
+    bloques(nullptr), cantidadBloques(0), cupoBloques(0),
+    publicaciones(nullptr), cantidadPublicaciones(0), cupoPublicaciones(0),
+    publicacionesOrdenadas(true), bytesIndexados(0), sumaIndexada(SUMA_INICIAL), ultimaConsulta{0, 0, 0, 0} {
+}
+
+IndiceHistorico::~IndiceHistorico() {
+    delete[] bloques;
+    delete[] publicaciones;
+}
+
+// --- Arreglos dinámicos ---
+
+void IndiceHistorico::asegurarCapacidadBloques() {
+    if (cupoBloques == 0) {
+        cupoBloques = 16;
+        bloques = new Bloque[cupoBloques];
+    } else if (cantidadBloques == cupoBloques) {
+        int nuevoCupo = cupoBloques * 2;
+        Bloque* nuevo = new Bloque[nuevoCupo];
+        for (int i = 0; i < cantidadBloques; ++i) nuevo[i] = bloques[i];
+        delete[] bloques;
+        bloques = nuevo;
+        cupoBloques = nuevoCupo;
+    }
+}
+
+void IndiceHistorico::asegurarCapacidadPublicaciones() {
+    if (cupoPublicaciones == 0) {
+        cupoPublicaciones = 64;
+        publicaciones = new Publicacion[cupoPublicaciones];
+    } else if (cantidadPublicaciones == cupoPublicaciones) {
+        int nuevoCupo = cupoPublicaciones * 2;
+        Publicacion* nuevo = new Publicacion[nuevoCupo];
+        for (int i = 0; i < cantidadPublicaciones; ++i) nuevo[i] = std::move(publicaciones[i]);
+        delete[] publicaciones;
+        publicaciones = nuevo;
+        cupoPublicaciones = nuevoCupo;
+    }
+}
+
+void IndiceHistorico::agregarPublicacion(const string& codigoAlojamiento, int bloque) {
+    asegurarCapacidadPublicaciones();
+    publicaciones[cantidadPublicaciones].codigoAlojamiento = codigoAlojamiento;
+    publicaciones[cantidadPublicaciones].bloque = bloque;
+    cantidadPublicaciones++;
+    publicacionesOrdenadas = false;
+}
+
+/**
+ * @brief Ordena las publicaciones por (alojamiento, bloque) y elimina duplicados.
+ * Se hace de forma perezosa, justo antes de una consulta o de guardar.
+ */
+void IndiceHistorico::ordenarPublicaciones() {
+    if (publicacionesOrdenadas) return;
+    sort(publicaciones, publicaciones + cantidadPublicaciones,
+         [](const Publicacion& a, const Publicacion& b) {
+             int cmp = a.codigoAlojamiento.compare(b.codigoAlojamiento);
+             return cmp < 0 || (cmp == 0 && a.bloque < b.bloque);
+         });
+    int destino = 0;
+    for (int i = 0; i < cantidadPublicaciones; ++i) {
+        if (destino > 0 && publicaciones[destino - 1].bloque == publicaciones[i].bloque &&
+            publicaciones[destino - 1].codigoAlojamiento == publicaciones[i].codigoAlojamiento) {
+            continue;
+        }
+        if (destino != i) publicaciones[destino] = std::move(publicaciones[i]);
+        destino++;
+    }
+    cantidadPublicaciones = destino;
+    publicacionesOrdenadas = true;
+}
+
+void IndiceHistorico::limpiar() {
+    cantidadBloques = 0;
+    cantidadPublicaciones = 0;
+    publicacionesOrdenadas = true;
+    bytesIndexados = 0;
+    sumaIndexada = SUMA_INICIAL;
+}
+
+// --- Extracción de campos ---
+
+/**
+ * @brief Extrae los cinco primeros campos de una línea del histórico
+ * (código, alojamiento, documento, fecha de entrada, noches).
+ * Los campos posteriores (pago, anotaciones entre comillas, ...) no se tocan.
+ */
+bool IndiceHistorico::extraerRegistro(const string& linea, RegistroHistorico& registro) {
+    const int CAMPOS_CLAVE = 5;
+    string campos[CAMPOS_CLAVE];
+    int indiceCampo = 0;
+    bool dentroDeComillas = false;
+
+    for (size_t i = 0; i < linea.length() && indiceCampo < CAMPOS_CLAVE; ++i) {
+        char c = linea[i];
+        if (c == '"') {
+            dentroDeComillas = !dentroDeComillas;
+        } else if (c == ',' && !dentroDeComillas) {
+            indiceCampo++;
+        } else if (c != ' ' || !campos[indiceCampo].empty()) {
+            campos[indiceCampo] += c;
+        }
+    }
+    if (indiceCampo < CAMPOS_CLAVE - 1) return false;
+
+    Fecha entrada;
+    int noches = 0;
+    if (leerFecha(campos[3], entrada) != LECTURA_CORRECTA || leerEntero(campos[4], noches) != LECTURA_CORRECTA ||
+        noches < 0) {
+        return false;
+    }
+    long diaEntrada = entrada.aNumeroDia();
+
+    registro.linea = linea;
+    registro.codigoReservacion = campos[0];
+    registro.codigoAlojamiento = campos[1];
+    registro.documentoHuesped = campos[2];
+    registro.diaEntrada = diaEntrada;
+    registro.diaSalida = diaEntrada + noches;
+    return true;
+}
+
+// --- Construcción y persistencia ---
+
+/**
+ * @brief Recorre el histórico desde bytesIndexados y añade sus líneas a los bloques.
+ * El último bloque se completa antes de abrir uno nuevo. Una línea final sin '\n'
+ * (escritura en curso) no se indexa todavía.
+ */
+void IndiceHistorico::indexarCola() {
+    ifstream archivo(archivoDatos, ios::binary);
+    if (!archivo.is_open()) {
+        return;
+    }
+    archivo.seekg(bytesIndexados);
+    if (!archivo) {
+        return;
+    }
+
+    string linea;
+    RegistroHistorico registro;
+    while (getline(archivo, linea)) {
+        if (archivo.eof()) {
+            break; // Línea incompleta: se indexará cuando termine de escribirse.
+        }
+        long long inicioLinea = bytesIndexados;
+        bytesIndexados += static_cast<long long>(linea.length()) + 1;
+        sumaIndexada = acumularSuma(acumularSuma(sumaIndexada, linea.data(), linea.length()), "\n", 1);
+
+        if (cantidadBloques == 0 || bloques[cantidadBloques - 1].registros >= registrosPorBloque) {
+            asegurarCapacidadBloques();
+            Bloque& nuevo = bloques[cantidadBloques++];
+            nuevo.desplazamiento = inicioLinea;
+            nuevo.longitud = 0;
+            nuevo.registros = 0;
+            nuevo.diaMinimo = 0;
+            nuevo.diaMaximo = 0;
+        }
+        Bloque& actual = bloques[cantidadBloques - 1];
+        actual.longitud = bytesIndexados - actual.desplazamiento;
+
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (linea.empty() || !extraerRegistro(linea, registro)) {
+            continue;
+        }
+        if (actual.registros == 0 || registro.diaEntrada < actual.diaMinimo) actual.diaMinimo = registro.diaEntrada;
+        if (actual.registros == 0 || registro.diaSalida > actual.diaMaximo) actual.diaMaximo = registro.diaSalida;
+        actual.registros++;
+        agregarPublicacion(registro.codigoAlojamiento, cantidadBloques - 1);
+    }
+}
+
+bool IndiceHistorico::sumarPrefijoDatos(long long bytes, unsigned long long& suma) const {
+    suma = SUMA_INICIAL;
+    ifstream datos(archivoDatos, ios::binary);
+    if (!datos.is_open()) return bytes == 0;
+    const size_t TAMANO_TRAMO = 1 << 20;
+    char* tramo = new char[TAMANO_TRAMO];
+    long long restantes = bytes;
+    while (restantes > 0) {
+        const size_t pedir = restantes < static_cast<long long>(TAMANO_TRAMO) ? static_cast<size_t>(restantes)
+                                                                               : TAMANO_TRAMO;
+        datos.read(tramo, static_cast<streamsize>(pedir));
+        const streamsize leidos = datos.gcount();
+        if (leidos <= 0) break;
+        suma = acumularSuma(suma, tramo, static_cast<size_t>(leidos));
+        restantes -= leidos;
+    }
+    delete[] tramo;
+    return restantes == 0;
+}
+
+/**
+ * @brief Carga el índice lateral. Si no existe, está corrupto o no coincide con el
+ * histórico (tamaño de bloque distinto, archivo más corto o con otro contenido en la
+ * parte indexada), se descarta.
+ * @return true si el índice lateral se pudo usar.
+ */
+bool IndiceHistorico::cargarArchivoIndice() {
+    ifstream archivo(archivoIndice);
+    if (!archivo.is_open()) return false;
+
+    string linea;
+    if (!getline(archivo, linea)) return false;
+    const int CAMPOS_CABECERA = 7; // firma, versión, registros por bloque, bytes, suma, segundos, nanosegundos
+    string campos[CAMPOS_CABECERA];
+    long long valores[CAMPOS_CABECERA - 1];
+    if (dividirLineaCSV(linea, campos, CAMPOS_CABECERA) != CAMPOS_CABECERA || campos[0] != FIRMA_INDICE) {
+        return false;
+    }
+    for (int i = 1; i < CAMPOS_CABECERA; ++i) {
+        if (i != 4 && leerEnteroLargo(campos[i], valores[i - 1]) != LECTURA_CORRECTA) return false;
+    }
+    char* finSuma = nullptr;
+    const unsigned long long suma = strtoull(campos[4].c_str(), &finSuma, 10);
+    if (campos[4].empty() || *finSuma != '\0' || valores[0] != VERSION_INDICE || valores[1] != registrosPorBloque) {
+        return false;
+    }
+    const long long bytes = valores[2];
+
+    long long tamanoDatos, segundos, nanosegundos;
+    estadoDatos(archivoDatos, tamanoDatos, segundos, nanosegundos);
+    if (bytes < 0 || bytes > tamanoDatos) {
+        return false; // El histórico fue truncado o reemplazado.
+    }
+    if (tamanoDatos != bytes || segundos != valores[4] || nanosegundos != valores[5]) {
+        // Cambió desde que se guardó el índice: sirve solo si lo indexado sigue igual
+        unsigned long long sumaActual;
+        if (!sumarPrefijoDatos(bytes, sumaActual) || sumaActual != suma) {
+            return false;
+        }
+    }
+
+    while (getline(archivo, linea)) {
+        if (linea.size() < 2) continue;
+        if (linea[0] == 'B') {
+            Bloque b;
+            if (sscanf(linea.c_str(), "B,%lld,%lld,%d,%ld,%ld", &b.desplazamiento, &b.longitud,
+                       &b.registros, &b.diaMinimo, &b.diaMaximo) != 5) {
+                limpiar();
+                return false;
+            }
+            asegurarCapacidadBloques();
+            bloques[cantidadBloques++] = b;
+        } else if (linea[0] == 'P') {
+            size_t coma = linea.rfind(',');
+            if (coma == string::npos || coma < 2) {
+                limpiar();
+                return false;
+            }
+            agregarPublicacion(linea.substr(2, coma - 2), atoi(linea.c_str() + coma + 1));
+        }
+    }
+    bytesIndexados = bytes;
+    sumaIndexada = suma;
+    publicacionesOrdenadas = false;
+    return true;
+}
+
+void IndiceHistorico::abrir() {
+    limpiar();
+    if (!cargarArchivoIndice()) {
+        limpiar();
+    }
+    indexarCola();
+}
+
+void IndiceHistorico::sincronizar() {
+    indexarCola();
+}
+
+bool IndiceHistorico::guardar() {
+    ofstream archivo(archivoIndice);
+    if (!archivo.is_open()) {
+        cerr << "Error [IndiceHistorico]: No se pudo escribir el índice '" << archivoIndice << "'." << endl;
+        return false;
+    }
+    ordenarPublicaciones();
+    long long tamanoDatos, segundos, nanosegundos;
+    estadoDatos(archivoDatos, tamanoDatos, segundos, nanosegundos);
+    archivo << FIRMA_INDICE << "," << VERSION_INDICE << "," << registrosPorBloque << "," << bytesIndexados << ","
+            << sumaIndexada << "," << segundos << "," << nanosegundos << "\n";
+    for (int i = 0; i < cantidadBloques; ++i) {
+        const Bloque& b = bloques[i];
+        archivo << "B," << b.desplazamiento << "," << b.longitud << "," << b.registros << ","
+                << b.diaMinimo << "," << b.diaMaximo << "\n";
+    }
+    for (int i = 0; i < cantidadPublicaciones; ++i) {
+        archivo << "P," << publicaciones[i].codigoAlojamiento << "," << publicaciones[i].bloque << "\n";
+    }
+    return true;
+}
+
+/**
+ * @brief Reescribe el histórico ordenado por fecha de entrada (orden estable) y
+ * reconstruye el índice. Las líneas mal formadas se conservan al final.
+ */
+bool IndiceHistorico::reordenarPorFecha() {
+    ifstream entrada(archivoDatos, ios::binary);
+    if (!entrada.is_open()) return false;
+
+    struct LineaOrdenable { long dia; string linea; };
+    LineaOrdenable* lineas = nullptr;
+    int cantidad = 0, cupo = 0;
+    string linea;
+    RegistroHistorico registro;
+    while (getline(entrada, linea)) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (linea.empty()) continue;
+        if (cantidad == cupo) {
+            int nuevoCupo = cupo == 0 ? 256 : cupo * 2;
+            LineaOrdenable* nuevo = new LineaOrdenable[nuevoCupo];
+            for (int i = 0; i < cantidad; ++i) nuevo[i] = std::move(lineas[i]);
+            delete[] lineas;
+            lineas = nuevo;
+            cupo = nuevoCupo;
+        }
+        long dia = extraerRegistro(linea, registro) ? registro.diaEntrada : 2147483647L;
+        lineas[cantidad].dia = dia;
+        lineas[cantidad].linea = std::move(linea);
+        cantidad++;
+    }
+    entrada.close();
+
+    stable_sort(lineas, lineas + cantidad,
+                [](const LineaOrdenable& a, const LineaOrdenable& b) { return a.dia < b.dia; });
+
+    string temporal = archivoDatos + ".tmp";
+    {
+        ofstream salida(temporal, ios::binary | ios::trunc);
+        if (!salida.is_open()) {
+            delete[] lineas;
+            return false;
+        }
+        for (int i = 0; i < cantidad; ++i) salida << lineas[i].linea << '\n';
+    }
+    delete[] lineas;
+    if (rename(temporal.c_str(), archivoDatos.c_str()) != 0) {
+        return false;
+    }
+
+    limpiar();
+    indexarCola();
+    return guardar();
+}
+
+// --- Consultas ---
+
+/**
+ * @brief Lee del disco un bloque completo y visita los registros que cumplen
+ * el filtro de alojamiento (opcional) y de cruce con [diaDesde, diaHasta].
+ */
+void IndiceHistorico::recorrerBloque(istream& archivo, int bloque, const string* codigoAlojamiento,
+                                     long diaDesde, long diaHasta, const Visitante& visitante) {
+    const Bloque& b = bloques[bloque];
+    string contenido(static_cast<size_t>(b.longitud), '\0');
+    archivo.clear();
+    archivo.seekg(b.desplazamiento);
+    archivo.read(&contenido[0], b.longitud);
+    contenido.resize(static_cast<size_t>(archivo.gcount()));
+    ultimaConsulta.bloquesLeidos++;
+
+    RegistroHistorico registro;
+    size_t inicio = 0;
+    while (inicio < contenido.size()) {
+        size_t fin = contenido.find('\n', inicio);
+        if (fin == string::npos) fin = contenido.size();
+        size_t largo = fin - inicio;
+        if (largo > 0 && contenido[fin - 1] == '\r') largo--;
+        if (largo > 0 && extraerRegistro(contenido.substr(inicio, largo), registro)) {
+            ultimaConsulta.registrosExaminados++;
+            bool coincideAlojamiento = codigoAlojamiento == nullptr || registro.codigoAlojamiento == *codigoAlojamiento;
+            bool cruzaFechas = registro.diaEntrada <= diaHasta && registro.diaSalida > diaDesde;
+            if (coincideAlojamiento && cruzaFechas) {
+                ultimaConsulta.registrosEncontrados++;
+                visitante(registro);
+            }
+        }
+        inicio = fin + 1;
+    }
+}
+
+void IndiceHistorico::consultarPorAlojamiento(const string& codigoAlojamiento, long diaDesde, long diaHasta,
+                                              const Visitante& visitante) {
+    ultimaConsulta = EstadisticaConsulta{cantidadBloques, 0, 0, 0};
+    ordenarPublicaciones();
+    ifstream archivo(archivoDatos, ios::binary);
+    if (!archivo.is_open()) return;
+
+    Publicacion clave;
+    clave.codigoAlojamiento = codigoAlojamiento;
+    clave.bloque = -1;
+    Publicacion* inicio = lower_bound(publicaciones, publicaciones + cantidadPublicaciones, clave,
+                                      [](const Publicacion& a, const Publicacion& b) {
+                                          int cmp = a.codigoAlojamiento.compare(b.codigoAlojamiento);
+                                          return cmp < 0 || (cmp == 0 && a.bloque < b.bloque);
+                                      });
+    for (Publicacion* p = inicio; p != publicaciones + cantidadPublicaciones &&
+                                  p->codigoAlojamiento == codigoAlojamiento; ++p) {
+        const Bloque& b = bloques[p->bloque];
+        if (b.registros > 0 && b.diaMinimo <= diaHasta && b.diaMaximo > diaDesde) {
+            recorrerBloque(archivo, p->bloque, &codigoAlojamiento, diaDesde, diaHasta, visitante);
+        }
+    }
+}
+
+void IndiceHistorico::consultarPorRango(long diaDesde, long diaHasta, const Visitante& visitante) {
+    ultimaConsulta = EstadisticaConsulta{cantidadBloques, 0, 0, 0};
+    ifstream archivo(archivoDatos, ios::binary);
+    if (!archivo.is_open()) return;
+    for (int i = 0; i < cantidadBloques; ++i) {
+        const Bloque& b = bloques[i];
+        if (b.registros > 0 && b.diaMinimo <= diaHasta && b.diaMaximo > diaDesde) {
+            recorrerBloque(archivo, i, nullptr, diaDesde, diaHasta, visitante);
+        }
+    }
+}
+
+int IndiceHistorico::getCantidadBloques() const {
+    return cantidadBloques;
+}
+
+IndiceHistorico::EstadisticaConsulta IndiceHistorico::getUltimaConsulta() const {
+    return ultimaConsulta;
+}
@@ -0,0 +1,120 @@
+#ifndef INDICEHISTORICO_H
+#define INDICEHISTORICO_H
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+// Registro del histórico visto por una consulta: la línea CSV completa y
+// los campos clave ya extraídos para filtrar.
+struct RegistroHistorico {
+    std::string linea;
+    std::string codigoReservacion;
+    std::string codigoAlojamiento;
+    std::string documentoHuesped;
+    long diaEntrada;   // Ver Fecha::aNumeroDia
+    long diaSalida;
+};
+
+// Índice por bloques sobre el histórico (archivo CSV de solo anexado).
+// El archivo se divide en bloques contiguos de a lo sumo 'registrosPorBloque' líneas.
+// Por cada bloque se guarda su desplazamiento en bytes y el rango de fechas que cubre
+// (zone map: mínima fecha de entrada y máxima fecha de salida), y por cada alojamiento
+// la lista de bloques donde aparece (posting list). Una consulta solo lee del disco
+// los bloques cuyo rango de fechas se cruza con el pedido y que contienen el alojamiento.
+// El índice se persiste en un archivo lateral (ej: "Historico.idx") y al abrirse solo
+// indexa la cola del histórico añadida desde la última vez. El lateral guarda el tamaño
+// indexado, la fecha de modificación del histórico y una suma de los bytes indexados:
+// si el histórico no se tocó basta comparar tamaño y fecha; si creció, el prefijo se
+// vuelve a sumar para confirmar que es el mismo archivo con líneas anexadas.
+class IndiceHistorico {
+public:
+    struct Bloque {
+        long long desplazamiento;  // Byte donde empieza el bloque
+        long long longitud;        // Bytes del bloque
+        int registros;
+        long diaMinimo;            // Menor día de entrada del bloque
+        long diaMaximo;            // Mayor día de salida del bloque
+    };
+
+    // Estadística de la última consulta (para medir cuánto se evitó leer).
+    struct EstadisticaConsulta {
+        int bloquesTotales;
+        int bloquesLeidos;
+        int registrosExaminados;
+        int registrosEncontrados;
+    };
+
+    typedef std::function<void(const RegistroHistorico&)> Visitante;
+
+private:
+    struct Publicacion {           // (alojamiento, bloque)
+        std::string codigoAlojamiento;
+        int bloque;
+    };
+
+    std::string archivoDatos;
+    std::string archivoIndice;
+    int registrosPorBloque;
+
+    Bloque* bloques;
+    int cantidadBloques;
+    int cupoBloques;
+
+    Publicacion* publicaciones;
+    int cantidadPublicaciones;
+    int cupoPublicaciones;
+    bool publicacionesOrdenadas;
+
+    long long bytesIndexados;      // Tamaño del histórico ya cubierto por el índice
+    unsigned long long sumaIndexada; // FNV-1a de esos bytes (detecta un histórico reemplazado)
+    EstadisticaConsulta ultimaConsulta;
+
+    void asegurarCapacidadBloques();
+    void asegurarCapacidadPublicaciones();
+    void agregarPublicacion(const std::string& codigoAlojamiento, int bloque);
+    void ordenarPublicaciones();
+    void limpiar();
+    bool cargarArchivoIndice();
+    // Suma (FNV-1a) los primeros 'bytes' bytes del histórico; false si es más corto.
+    bool sumarPrefijoDatos(long long bytes, unsigned long long& suma) const;
+    // Indexa el histórico desde bytesIndexados hasta el final.
+    void indexarCola();
+    // Lee un bloque y llama al visitante con los registros que cumplen el filtro.
+    void recorrerBloque(std::istream& archivo, int bloque, const std::string* codigoAlojamiento,
+                        long diaDesde, long diaHasta, const Visitante& visitante);
+
+public:
+    IndiceHistorico(const std::string& nombreArchivoDatos, const std::string& nombreArchivoIndice,
+                    int registrosPorBloque = 512);
+    ~IndiceHistorico();
+
+    IndiceHistorico(const IndiceHistorico&) = delete;
+    IndiceHistorico& operator=(const IndiceHistorico&) = delete;
+
+    // Carga el índice lateral (si existe y es coherente) e indexa lo que falte.
+    void abrir();
+    // Indexa los registros anexados al histórico después de la última llamada.
+    void sincronizar();
+    // Escribe el índice lateral.
+    bool guardar();
+    // Reescribe el histórico ordenado por fecha de entrada y reconstruye el índice,
+    // para que los bloques queden con rangos de fechas disjuntos. Nadie debe anexar
+    // al histórico mientras corre.
+    bool reordenarPorFecha();
+
+    // --- Consultas ---
+    // Estadías del alojamiento que se cruzan con [diaDesde, diaHasta].
+    void consultarPorAlojamiento(const std::string& codigoAlojamiento, long diaDesde, long diaHasta,
+                                 const Visitante& visitante);
+    // Estadías de cualquier alojamiento que se cruzan con [diaDesde, diaHasta].
+    void consultarPorRango(long diaDesde, long diaHasta, const Visitante& visitante);
+
+    int getCantidadBloques() const;
+    EstadisticaConsulta getUltimaConsulta() const;
+
+    // Extrae los campos clave de una línea del histórico. Devuelve false si está mal formada.
+    static bool extraerRegistro(const std::string& linea, RegistroHistorico& registro);
+};
+
+#endif // INDICEHISTORICO_H
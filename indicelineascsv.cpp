@@ -0,0 +1,200 @@
+// --- indicelineascsv.cpp ---
+// Implementación del índice de posiciones de un archivo CSV.
+#include "indicelineascsv.h"
+#include "bufercsv.h"
+#include "lecturacampos.h"
+#include <cstdio>
+#include <iostream>
+#include <sys/stat.h>   // Para el tamaño y la fecha de modificación del CSV
+using namespace std;
+
+static const char* const FIRMA_LATERAL = "IndiceLineasCSV";
+static const int VERSION_LATERAL = 1;
+static const int CAMPOS_CABECERA_LATERAL = 6;  // Firma, versión, columnas clave, tamaño, segundos, nanosegundos
+static const int MAX_CAMPOS_LINEA = 16;
+
+IndiceLineasCSV::IndiceLineasCSV() :
+    cantidadColumnas(0), camposLeidos(0), desplazamientos(nullptr), cantidad(0), cupo(0), abiertoDesdeLateral(false) {
+}
+
+IndiceLineasCSV::~IndiceLineasCSV() {
+    delete[] desplazamientos;
+}
+
+// Las columnas clave en un número (una cifra hexadecimal por columna), para que un
+// lateral escrito con otras columnas no se use.
+long long IndiceLineasCSV::firmaColumnas() const {
+    long long firma = cantidadColumnas;
+    for (int c = 0; c < cantidadColumnas; ++c) {
+        firma = firma * 16 + columnasClave[c];
+    }
+    return firma;
+}
+
+void IndiceLineasCSV::agregar(long long desplazamiento) {
+    if (cantidad == cupo) {
+        int nuevoCupo = cupo == 0 ? 256 : cupo * 2;
+        long long* nuevos = new long long[nuevoCupo];
+        for (int i = 0; i < cantidad; ++i) {
+            nuevos[i] = desplazamientos[i];
+        }
+        delete[] desplazamientos;
+        desplazamientos = nuevos;
+        cupo = nuevoCupo;
+    }
+    desplazamientos[cantidad++] = desplazamiento;
+}
+
+bool IndiceLineasCSV::abrir(const string& nombreArchivoDatos, const string& nombreArchivoLateral, const int columnas[],
+                            int columnasPedidas, InformeCarga& informe, const Visitante& visitante) {
+    archivoDatos = nombreArchivoDatos;
+    archivoLateral = nombreArchivoLateral;
+    cantidadColumnas = 0;
+    camposLeidos = 0;
+    for (int c = 0; c < columnasPedidas && cantidadColumnas < MAX_COLUMNAS_CLAVE; ++c) {
+        if (columnas[c] < 0 || columnas[c] >= MAX_CAMPOS_LINEA) continue;
+        columnasClave[cantidadColumnas++] = columnas[c];
+        if (columnas[c] + 1 > camposLeidos) camposLeidos = columnas[c] + 1;
+    }
+    cantidad = 0;
+    abiertoDesdeLateral = false;
+    lector.close();
+
+    struct stat estado;
+    if (::stat(archivoDatos.c_str(), &estado) != 0) {
+        return false;
+    }
+    const long long tamano = static_cast<long long>(estado.st_size);
+    const long long segundos = static_cast<long long>(estado.st_mtim.tv_sec);
+    const long long nanosegundos = static_cast<long long>(estado.st_mtim.tv_nsec);
+
+    if (leerLateral(tamano, segundos, nanosegundos, visitante)) {
+        abiertoDesdeLateral = true;
+        return true;
+    }
+    // Lateral ausente, viejo o dañado. Si se dañó a mitad, el recorrido entrega otra vez
+    // las mismas posiciones con las mismas claves (el orden es el del CSV).
+    cantidad = 0;
+    BuferCSV lateral;
+    lateral.agregar(FIRMA_LATERAL);
+    const long long cabecera[] = {VERSION_LATERAL, firmaColumnas(), tamano, segundos, nanosegundos};
+    for (long long valor : cabecera) {
+        lateral.agregar(',');
+        lateral.agregarEntero(valor);
+    }
+    lateral.agregar('\n');
+    if (!recorrerDatos(informe, visitante, lateral)) {
+        return false;
+    }
+    escribirLateral(lateral);
+    return true;
+}
+
+bool IndiceLineasCSV::leerLateral(long long tamanoDatos, long long segundos, long long nanosegundos,
+                                  const Visitante& visitante) {
+    ifstream archivo(archivoLateral, ios::binary);
+    string linea;
+    if (!archivo.is_open() || !getline(archivo, linea)) {
+        return false;
+    }
+    string campos[MAX_CAMPOS_LINEA];  // Cabecera (6 campos) o desplazamiento y claves
+    long long cabecera[CAMPOS_CABECERA_LATERAL - 1];
+    if (dividirLineaCSV(linea, campos, CAMPOS_CABECERA_LATERAL) != CAMPOS_CABECERA_LATERAL || campos[0] != FIRMA_LATERAL) {
+        return false;
+    }
+    for (int i = 1; i < CAMPOS_CABECERA_LATERAL; ++i) {
+        if (leerEnteroLargo(campos[i], cabecera[i - 1]) != LECTURA_CORRECTA) return false;
+    }
+    if (cabecera[0] != VERSION_LATERAL || cabecera[1] != firmaColumnas() || cabecera[2] != tamanoDatos ||
+        cabecera[3] != segundos || cabecera[4] != nanosegundos) {
+        return false; // El CSV cambió desde que se escribió el lateral
+    }
+
+    long long desplazamiento = 0;
+    while (getline(archivo, linea)) {
+        if (dividirLineaCSV(linea, campos, cantidadColumnas + 1) != cantidadColumnas + 1 ||
+            leerEnteroLargo(campos[0], desplazamiento) != LECTURA_CORRECTA ||
+            desplazamiento < 0 || desplazamiento >= tamanoDatos) {
+            return false;
+        }
+        agregar(desplazamiento);
+        visitante(cantidad - 1, campos + 1);
+    }
+    return true;
+}
+
+bool IndiceLineasCSV::recorrerDatos(InformeCarga& informe, const Visitante& visitante, BuferCSV& lateral) {
+    ifstream archivo(archivoDatos, ios::binary);
+    string linea;
+    if (!archivo.is_open() || !getline(archivo, linea)) { // Omitir cabecera
+        return false;
+    }
+    string campos[MAX_CAMPOS_LINEA];
+    string claves[MAX_COLUMNAS_CLAVE];
+    long long desplazamiento = static_cast<long long>(linea.size()) + 1;
+    long numeroLinea = 1;
+    while (getline(archivo, linea)) {
+        const long long inicio = desplazamiento;
+        desplazamiento += static_cast<long long>(linea.size()) + 1;
+        numeroLinea++;
+        if (linea.empty()) continue;
+        informe.contarLinea();
+        // Solo se separan los campos clave: el resto de la línea no se convierte
+        if (dividirLineaCSV(linea, campos, camposLeidos) != camposLeidos) {
+            informe.registrar(numeroLinea, -1, LECTURA_CAMPOS_INCOMPLETOS);
+            continue;
+        }
+        for (int c = 0; c < cantidadColumnas; ++c) {
+            claves[c].swap(campos[columnasClave[c]]);
+        }
+        agregar(inicio);
+        visitante(cantidad - 1, claves);
+        informe.contarCargada();
+        lateral.agregarEntero(inicio);
+        for (int c = 0; c < cantidadColumnas; ++c) {
+            lateral.agregar(',');
+            lateral.agregarEntreComillas(claves[c]);
+        }
+        lateral.agregar('\n');
+    }
+    return true;
+}
+
+void IndiceLineasCSV::escribirLateral(const BuferCSV& contenido) {
+    const string temporal = archivoLateral + ".tmp";
+    ofstream salida(temporal, ios::binary | ios::trunc);
+    if (!salida.is_open() || !salida.write(contenido.getDatos(), static_cast<streamsize>(contenido.getTamano()))) {
+        cerr << "Advertencia [IndiceLineasCSV]: No se pudo escribir el índice '" << archivoLateral << "'." << endl;
+        return;
+    }
+    salida.close();
+    if (!salida || ::rename(temporal.c_str(), archivoLateral.c_str()) != 0) {
+        cerr << "Advertencia [IndiceLineasCSV]: No se pudo reemplazar el índice '" << archivoLateral << "'." << endl;
+        ::remove(temporal.c_str());
+    }
+}
+
+bool IndiceLineasCSV::leerLinea(int posicion, string& linea) {
+    if (posicion < 0 || posicion >= cantidad) {
+        return false;
+    }
+    if (!lector.is_open()) {
+        lector.open(archivoDatos, ios::binary);
+        if (!lector.is_open()) return false;
+    }
+    lector.clear();
+    lector.seekg(desplazamientos[posicion]);
+    return static_cast<bool>(getline(lector, linea));
+}
+
+int IndiceLineasCSV::getCantidad() const {
+    return cantidad;
+}
+
+bool IndiceLineasCSV::getAbiertoDesdeLateral() const {
+    return abiertoDesdeLateral;
+}
+
+size_t IndiceLineasCSV::memoriaAproximada() const {
+    return sizeof(IndiceLineasCSV) + static_cast<size_t>(cupo) * sizeof(long long);
+}
@@ -0,0 +1,70 @@
+#ifndef INDICELINEASCSV_H
+#define INDICELINEASCSV_H
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+
+class BuferCSV;
+class InformeCarga;
+
+// Índice de posiciones de un archivo CSV con cabecera: por cada registro guarda el
+// byte donde empieza su línea, y al abrirlo entrega solo algunas columnas clave
+// (ej. ID y documento) para que quien lo usa arme sus tablas de búsqueda.
+// El registro completo se lee después, con una lectura directa, cuando se necesita.
+//
+// El índice se persiste en un archivo lateral (ej: "Huespedes.idx") con el tamaño y la
+// fecha de modificación del CSV: si siguen iguales, abrir() lee el lateral (más chico
+// que el CSV) en lugar de recorrer el archivo; si no, recorre el CSV y lo reescribe.
+//
+// No es seguro entre hilos: RegistroBajoDemanda serializa las lecturas.
+class IndiceLineasCSV {
+public:
+    static const int MAX_COLUMNAS_CLAVE = 4;
+    // Recibe la posición del registro (orden del archivo) y sus campos clave.
+    typedef std::function<void(int posicion, const std::string claves[])> Visitante;
+
+private:
+    std::string archivoDatos;
+    std::string archivoLateral;
+    int columnasClave[MAX_COLUMNAS_CLAVE];
+    int cantidadColumnas;
+    int camposLeidos;             // Campos a separar de cada línea (hasta la última columna clave)
+    long long* desplazamientos;   // Byte donde empieza la línea de cada registro
+    int cantidad;
+    int cupo;
+    bool abiertoDesdeLateral;
+    std::ifstream lector;         // Abierto con la primera lectura de un registro
+
+    void agregar(long long desplazamiento);
+    long long firmaColumnas() const;
+    bool leerLateral(long long tamanoDatos, long long segundos, long long nanosegundos,
+                     const Visitante& visitante);
+    void escribirLateral(const BuferCSV& contenido);
+    // Recorre el CSV y arma en 'lateral' las líneas del índice lateral; devuelve false
+    // si no se pudo abrir o no tiene cabecera.
+    bool recorrerDatos(InformeCarga& informe, const Visitante& visitante, BuferCSV& lateral);
+
+public:
+    IndiceLineasCSV();
+    ~IndiceLineasCSV();
+
+    IndiceLineasCSV(const IndiceLineasCSV&) = delete;
+    IndiceLineasCSV& operator=(const IndiceLineasCSV&) = delete;
+
+    // Indexa 'archivoDatos' (desde el lateral si está al día) y llama al visitante por
+    // cada registro con los campos de 'columnas' (en ese orden). Las líneas que no
+    // llegan a la última columna se registran en el informe y no reciben posición.
+    // Devuelve false si el CSV no se pudo abrir.
+    bool abrir(const std::string& archivoDatos, const std::string& archivoLateral, const int columnas[],
+               int cantidadColumnas, InformeCarga& informe, const Visitante& visitante);
+    // Lee la línea completa del registro en 'posicion'.
+    bool leerLinea(int posicion, std::string& linea);
+
+    int getCantidad() const;
+    bool getAbiertoDesdeLateral() const;
+    size_t memoriaAproximada() const;
+};
+
+#endif // INDICELINEASCSV_H
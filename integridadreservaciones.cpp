@@ -0,0 +1,152 @@
+// --- integridadreservaciones.cpp ---
+// Implementación de la revisión de integridad de las reservaciones activas.
+#include "integridadreservaciones.h"
+#include "poolhilos.h"
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+const char* describirProblemaIntegridad(ProblemaIntegridad problema) {
+    switch (problema) {
+    case INTEGRIDAD_CORRECTA: return "correcta";
+    case INTEGRIDAD_ALOJAMIENTO_DESCONOCIDO: return "alojamiento inexistente";
+    case INTEGRIDAD_HUESPED_DESCONOCIDO: return "huésped inexistente";
+    case INTEGRIDAD_CODIGO_REPETIDO: return "código de reservación repetido";
+    case INTEGRIDAD_CRUCE_DE_FECHAS: return "se cruza con otra del mismo alojamiento";
+    default: return "problema desconocido";
+    }
+}
+
+// Ordena y recorre los grupos de los alojamientos [desde, hasta).
+static void barrerAlojamientos(int desde, int hasta, const int inicio[], int orden[], const long diaEntrada[],
+                               const long diaSalida[], int cruceCon[]) {
+    for (int a = desde; a < hasta; ++a) {
+        int* primero = orden + inicio[a];
+        int* ultimo = orden + inicio[a + 1];
+        sort(primero, ultimo, [diaEntrada](int x, int y) {
+            return diaEntrada[x] != diaEntrada[y] ? diaEntrada[x] < diaEntrada[y] : x < y;
+        });
+        // Las conservadas no se cruzan entre sí y están por entrada: la última es la de salida mayor
+        int conservada = -1;
+        for (int* r = primero; r != ultimo; ++r) {
+            if (conservada >= 0 && diaEntrada[*r] < diaSalida[conservada]) {
+                cruceCon[*r] = conservada;
+            } else {
+                cruceCon[*r] = -1;
+                conservada = *r;
+            }
+        }
+    }
+}
+
+int detectarCrucesPorAlojamiento(const int alojamiento[], const long diaEntrada[], const long diaSalida[],
+                                 int cantidad, int cantidadAlojamientos, PoolHilos& pool, int cruceCon[]) {
+    // Agrupar por alojamiento: grupo a = orden[inicio[a] .. inicio[a + 1])
+    int* inicio = new int[cantidadAlojamientos + 1]();
+    for (int i = 0; i < cantidad; ++i) {
+        cruceCon[i] = -1;
+        if (alojamiento[i] >= 0) inicio[alojamiento[i] + 1]++;
+    }
+    for (int a = 0; a < cantidadAlojamientos; ++a) {
+        inicio[a + 1] += inicio[a];
+    }
+    const int agrupadas = inicio[cantidadAlojamientos];
+    int* orden = new int[agrupadas > 0 ? agrupadas : 1];
+    int* siguiente = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+    for (int a = 0; a < cantidadAlojamientos; ++a) {
+        siguiente[a] = inicio[a];
+    }
+    for (int i = 0; i < cantidad; ++i) {
+        if (alojamiento[i] >= 0) orden[siguiente[alojamiento[i]]++] = i;
+    }
+    delete[] siguiente;
+
+    // Los hilos ya existen: repartir solo cuesta encolar los bloques, así que se reparte
+    // aun con pocas reservaciones. Varios bloques por hilo dejan que el robo de trabajo
+    // compense alojamientos con grupos más grandes.
+    const int BLOQUES_POR_HILO = 4;
+    const int hilosPool = pool.getCantidadHilos() + 1; // Quien llama también ejecuta bloques
+    int bloques = agrupadas > 0 ? hilosPool * BLOQUES_POR_HILO : 1;
+    if (bloques > cantidadAlojamientos) bloques = cantidadAlojamientos;
+    if (bloques < 1) bloques = 1;
+
+    // Cortes entre alojamientos con una parte parecida de las reservaciones en cada bloque
+    int* cortes = new int[bloques + 1];
+    cortes[0] = 0;
+    cortes[bloques] = cantidadAlojamientos;
+    for (int b = 1; b < bloques; ++b) {
+        const long long objetivo = static_cast<long long>(agrupadas) * b / bloques;
+        int corte = static_cast<int>(lower_bound(inicio, inicio + cantidadAlojamientos, objetivo) - inicio);
+        cortes[b] = corte > cortes[b - 1] ? corte : cortes[b - 1];
+    }
+    pool.ejecutarBloques(bloques, [&](int bloque) {
+        barrerAlojamientos(cortes[bloque], cortes[bloque + 1], inicio, orden, diaEntrada, diaSalida, cruceCon);
+    });
+    const int hilos = hilosPool < bloques ? hilosPool : bloques;
+    delete[] cortes;
+    delete[] orden;
+    delete[] inicio;
+    return hilos;
+}
+
+InformeIntegridad::InformeIntegridad(const string& nombreArchivo) :
+    archivo(nombreArchivo), revisadas(0), rechazadas(0), advertencias(0), cantidadEjemplos(0), hilos(1) {
+    for (int i = 0; i < CANTIDAD_PROBLEMAS_INTEGRIDAD; ++i) {
+        conteoPorProblema[i] = 0;
+    }
+}
+
+void InformeIntegridad::setRevisadas(long cantidad) {
+    revisadas = cantidad;
+}
+
+void InformeIntegridad::setHilos(int cantidad) {
+    hilos = cantidad;
+}
+
+void InformeIntegridad::registrar(const string& codigo, ProblemaIntegridad problema, const string& relacionado,
+                                  bool rechazada) {
+    if (rechazada) rechazadas++;
+    else advertencias++;
+    conteoPorProblema[problema]++;
+    if (cantidadEjemplos < MAX_EJEMPLOS) {
+        ejemplos[cantidadEjemplos++] = Ejemplo{codigo, problema, relacionado, rechazada};
+    }
+}
+
+long InformeIntegridad::getRevisadas() const {
+    return revisadas;
+}
+
+long InformeIntegridad::getRechazadas() const {
+    return rechazadas;
+}
+
+long InformeIntegridad::getAdvertencias() const {
+    return advertencias;
+}
+
+long InformeIntegridad::getConteo(ProblemaIntegridad problema) const {
+    return conteoPorProblema[problema];
+}
+
+void InformeIntegridad::mostrar() const {
+    cout << "Integridad de " << archivo << ": " << revisadas << " reservaciones activas revisadas, " << rechazadas
+         << " rechazadas, " << advertencias << " con advertencias (" << hilos << (hilos == 1 ? " hilo" : " hilos")
+         << ")" << endl;
+    const long conProblemas = rechazadas + advertencias;
+    if (conProblemas == 0) return;
+    for (int p = 1; p < CANTIDAD_PROBLEMAS_INTEGRIDAD; ++p) {
+        if (conteoPorProblema[p] > 0) {
+            cerr << "  " << describirProblemaIntegridad(static_cast<ProblemaIntegridad>(p)) << ": "
+                 << conteoPorProblema[p] << endl;
+        }
+    }
+    for (int i = 0; i < cantidadEjemplos; ++i) {
+        cerr << "  " << ejemplos[i].codigo << ": " << describirProblemaIntegridad(ejemplos[i].problema) << " ("
+             << ejemplos[i].relacionado << ")" << (ejemplos[i].rechazada ? "" : ", se conserva") << endl;
+    }
+    if (conProblemas > cantidadEjemplos) {
+        cerr << "  (" << conProblemas - cantidadEjemplos << " reservaciones con problemas más)" << endl;
+    }
+}
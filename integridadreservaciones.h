@@ -0,0 +1,78 @@
+#ifndef INTEGRIDADRESERVACIONES_H
+#define INTEGRIDADRESERVACIONES_H
+
+#include <string>
+
+class PoolHilos;
+
+// Revisión de integridad de las reservaciones activas al cargarlas: referencias a
+// alojamientos y huéspedes que no existen, códigos repetidos y reservaciones del
+// mismo alojamiento que se cruzan en fechas.
+//
+// Un huésped desconocido es solo una advertencia: la reservación sigue ocupando su
+// alojamiento (los datos de ejemplo tienen documentos que no están en Huespedes.csv).
+// Los demás problemas la rechazan.
+
+enum ProblemaIntegridad {
+    INTEGRIDAD_CORRECTA = 0,
+    INTEGRIDAD_ALOJAMIENTO_DESCONOCIDO,
+    INTEGRIDAD_HUESPED_DESCONOCIDO,
+    INTEGRIDAD_CODIGO_REPETIDO,
+    INTEGRIDAD_CRUCE_DE_FECHAS,     // Se cruza con otra (conservada) del mismo alojamiento
+    CANTIDAD_PROBLEMAS_INTEGRIDAD
+};
+
+const char* describirProblemaIntegridad(ProblemaIntegridad problema);
+
+// Detecta los cruces de fechas entre reservaciones del mismo alojamiento.
+// Agrupa las reservaciones por alojamiento (conteo, O(n + A)), ordena cada grupo por
+// día de entrada y lo recorre una vez: una reservación que entra antes de la salida
+// de la última conservada se cruza con ella. Ante un cruce se conserva la que entra
+// primero (y, con la misma entrada, la que aparece primero en el arreglo).
+// Los alojamientos se reparten en bloques de trabajo parecido que corren en 'pool';
+// cada reservación pertenece a un solo alojamiento, así que no comparten escrituras.
+// Deja en cruceCon[i] la reservación con la que se cruza i, o -1 (también para las
+// que tienen alojamiento[i] < 0, que no se revisan). Devuelve los hilos usados.
+int detectarCrucesPorAlojamiento(const int alojamiento[], const long diaEntrada[], const long diaSalida[],
+                                 int cantidad, int cantidadAlojamientos, PoolHilos& pool, int cruceCon[]);
+
+// Resultado de la revisión: conteo por problema y los primeros ejemplos, mostrados
+// en un resumen como el de InformeCarga.
+class InformeIntegridad {
+public:
+    static const int MAX_EJEMPLOS = 8;
+
+private:
+    struct Ejemplo {
+        std::string codigo;
+        ProblemaIntegridad problema;
+        std::string relacionado;  // Alojamiento, documento o reservación con la que choca
+        bool rechazada;
+    };
+
+    std::string archivo;
+    long revisadas;
+    long rechazadas;
+    long advertencias;
+    long conteoPorProblema[CANTIDAD_PROBLEMAS_INTEGRIDAD];
+    Ejemplo ejemplos[MAX_EJEMPLOS];
+    int cantidadEjemplos;
+    int hilos;
+
+public:
+    explicit InformeIntegridad(const std::string& nombreArchivo);
+
+    void setRevisadas(long cantidad);
+    void setHilos(int cantidad);
+    // Registra el problema de una reservación (el que la descarta si 'rechazada').
+    void registrar(const std::string& codigo, ProblemaIntegridad problema, const std::string& relacionado,
+                   bool rechazada = true);
+
+    long getRevisadas() const;
+    long getRechazadas() const;
+    long getAdvertencias() const;
+    long getConteo(ProblemaIntegridad problema) const;
+    void mostrar() const;
+};
+
+#endif // INTEGRIDADRESERVACIONES_H
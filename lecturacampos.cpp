@@ -0,0 +1,177 @@
+// --- lecturacampos.cpp ---
+// Implementación de la conversión de campos y del informe de carga.
+#include "lecturacampos.h"
+#include <charconv>
+#include <iostream>
+using namespace std;
+
+static bool esEspacio(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// Recorta espacios de ambos lados sin crear otro string.
+static void recortarEspacios(string& texto) {
+    size_t fin = texto.size();
+    while (fin > 0 && esEspacio(texto[fin - 1])) fin--;
+    size_t inicio = 0;
+    while (inicio < fin && esEspacio(texto[inicio])) inicio++;
+    texto.erase(fin);
+    texto.erase(0, inicio);
+}
+
+int dividirLineaCSV(const string& linea, string campos[], int maximo) {
+    if (linea.empty() || maximo <= 0) {
+        return 0;
+    }
+    int indice = 0;
+    string* campo = &campos[0];
+    campo->clear();
+    bool dentroDeComillas = false;
+    for (size_t i = 0; i < linea.size(); ++i) {
+        char c = linea[i];
+        if (c == '"') {
+            if (dentroDeComillas && i + 1 < linea.size() && linea[i + 1] == '"') {
+                campo->push_back('"');
+                i++;
+            } else {
+                dentroDeComillas = !dentroDeComillas;
+            }
+        } else if (c == ',' && !dentroDeComillas) {
+            recortarEspacios(*campo);
+            if (++indice == maximo) {
+                return maximo; // El resto de la línea sobra
+            }
+            campo = &campos[indice];
+            campo->clear();
+        } else {
+            campo->push_back(c);
+        }
+    }
+    recortarEspacios(*campo);
+    return indice + 1;
+}
+
+// Convierte todo el texto con from_chars; cualquier sobrante es un error.
+template <typename T>
+static EstadoLectura leerNumero(const string& texto, T& valor) {
+    if (texto.empty()) return LECTURA_VACIO;
+    const char* fin = texto.data() + texto.size();
+    from_chars_result r = from_chars(texto.data(), fin, valor);
+    if (r.ec == errc::result_out_of_range) return LECTURA_FUERA_DE_RANGO;
+    if (r.ec != errc() || r.ptr != fin) return LECTURA_NO_NUMERICO;
+    return LECTURA_CORRECTA;
+}
+
+EstadoLectura leerEntero(const string& texto, int& valor) {
+    return leerNumero(texto, valor);
+}
+
+EstadoLectura leerEnteroLargo(const string& texto, long long& valor) {
+    return leerNumero(texto, valor);
+}
+
+EstadoLectura leerDecimal(const string& texto, double& valor) {
+    return leerNumero(texto, valor);
+}
+
+EstadoLectura leerDecimal(const string& texto, float& valor) {
+    return leerNumero(texto, valor);
+}
+
+/**
+ * @brief Lee "dd/mm/aaaa" dígito por dígito en posiciones fijas.
+ * Solo cambia 'fecha' si el texto es una fecha válida.
+ */
+EstadoLectura leerFecha(const string& texto, Fecha& fecha) {
+    if (texto.empty()) return LECTURA_VACIO;
+    if (texto.size() != 10 || texto[2] != '/' || texto[5] != '/') return LECTURA_FORMATO_FECHA;
+    static const int POSICIONES[8] = {0, 1, 3, 4, 6, 7, 8, 9};
+    int digitos[8];
+    for (int k = 0; k < 8; ++k) {
+        unsigned d = static_cast<unsigned char>(texto[POSICIONES[k]]) - '0';
+        if (d > 9) return LECTURA_FORMATO_FECHA;
+        digitos[k] = static_cast<int>(d);
+    }
+    int dia = digitos[0] * 10 + digitos[1];
+    int mes = digitos[2] * 10 + digitos[3];
+    int anio = digitos[4] * 1000 + digitos[5] * 100 + digitos[6] * 10 + digitos[7];
+    if (!Fecha::esValida(dia, mes, anio)) return LECTURA_FECHA_INVALIDA;
+    fecha = Fecha(dia, mes, anio);
+    return LECTURA_CORRECTA;
+}
+
+const char* describirEstadoLectura(EstadoLectura estado) {
+    switch (estado) {
+    case LECTURA_CORRECTA: return "correcta";
+    case LECTURA_CAMPOS_INCOMPLETOS: return "cantidad de campos incorrecta";
+    case LECTURA_VACIO: return "campo vacío";
+    case LECTURA_NO_NUMERICO: return "no es un número";
+    case LECTURA_FUERA_DE_RANGO: return "número fuera de rango";
+    case LECTURA_FORMATO_FECHA: return "fecha sin formato dd/mm/aaaa";
+    case LECTURA_FECHA_INVALIDA: return "fecha inexistente";
+    case LECTURA_VALOR_INVALIDO: return "valor no permitido";
+    default: return "desconocido";
+    }
+}
+
+InformeCarga::InformeCarga(const string& nombreArchivo) :
+    archivo(nombreArchivo), lineasLeidas(0), lineasCargadas(0), lineasConError(0), cantidadEjemplos(0) {
+    for (int i = 0; i < CANTIDAD_ESTADOS_LECTURA; ++i) {
+        conteoPorEstado[i] = 0;
+    }
+}
+
+void InformeCarga::contarLinea() {
+    lineasLeidas++;
+}
+
+void InformeCarga::contarCargada() {
+    lineasCargadas++;
+}
+
+void InformeCarga::registrar(long linea, int campo, EstadoLectura estado) {
+    lineasConError++;
+    conteoPorEstado[estado]++;
+    if (cantidadEjemplos < MAX_EJEMPLOS) {
+        ejemplos[cantidadEjemplos++] = Ejemplo{linea, campo, estado};
+    }
+}
+
+long InformeCarga::getLineasLeidas() const {
+    return lineasLeidas;
+}
+
+long InformeCarga::getLineasCargadas() const {
+    return lineasCargadas;
+}
+
+long InformeCarga::getLineasConError() const {
+    return lineasConError;
+}
+
+long InformeCarga::getConteo(EstadoLectura estado) const {
+    return conteoPorEstado[estado];
+}
+
+void InformeCarga::mostrar(const char* const nombresCampos[]) const {
+    cout << "Informe de carga de " << archivo << ": " << lineasLeidas << " líneas, " << lineasCargadas
+         << " cargadas, " << lineasConError << " con errores" << endl;
+    if (lineasConError == 0) return;
+    for (int e = 1; e < CANTIDAD_ESTADOS_LECTURA; ++e) {
+        if (conteoPorEstado[e] > 0) {
+            cerr << "  " << describirEstadoLectura(static_cast<EstadoLectura>(e)) << ": " << conteoPorEstado[e] << endl;
+        }
+    }
+    for (int i = 0; i < cantidadEjemplos; ++i) {
+        cerr << "  línea " << ejemplos[i].linea;
+        if (ejemplos[i].campo >= 0) {
+            cerr << ", campo ";
+            if (nombresCampos != nullptr) cerr << nombresCampos[ejemplos[i].campo];
+            else cerr << ejemplos[i].campo + 1;
+        }
+        cerr << ": " << describirEstadoLectura(ejemplos[i].estado) << endl;
+    }
+    if (lineasConError > cantidadEjemplos) {
+        cerr << "  (" << lineasConError - cantidadEjemplos << " líneas con errores más)" << endl;
+    }
+}
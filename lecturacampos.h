@@ -0,0 +1,74 @@
+#ifndef LECTURACAMPOS_H
+#define LECTURACAMPOS_H
+
+#include <string>
+#include "fecha.h"
+
+// Conversión de campos CSV sin excepciones ni memoria temporal: los números con
+// std::from_chars y las fechas dd/mm/aaaa leyendo cada dígito en su posición fija.
+// Cada lectura devuelve un estado; el campo completo debe ser válido ("12abc" no es 12).
+
+enum EstadoLectura {
+    LECTURA_CORRECTA = 0,
+    LECTURA_CAMPOS_INCOMPLETOS,   // La línea no tiene la cantidad de campos esperada
+    LECTURA_VACIO,
+    LECTURA_NO_NUMERICO,
+    LECTURA_FUERA_DE_RANGO,
+    LECTURA_FORMATO_FECHA,        // No tiene la forma dd/mm/aaaa
+    LECTURA_FECHA_INVALIDA,       // Tiene la forma pero no existe (31/02/2025)
+    LECTURA_VALOR_INVALIDO,       // Bien formado pero no permitido (ej. un código inexistente)
+    CANTIDAD_ESTADOS_LECTURA
+};
+
+// Divide una línea CSV en a lo más 'maximo' campos (los sobrantes se ignoran) y devuelve
+// cuántos leyó. Respeta las comillas ("" dentro de comillas es una comilla) y recorta
+// los espacios de cada campo. Reutiliza la memoria que ya tengan los strings de 'campos'.
+int dividirLineaCSV(const std::string& linea, std::string campos[], int maximo);
+
+EstadoLectura leerEntero(const std::string& texto, int& valor);
+EstadoLectura leerEnteroLargo(const std::string& texto, long long& valor);
+EstadoLectura leerDecimal(const std::string& texto, double& valor);
+EstadoLectura leerDecimal(const std::string& texto, float& valor);
+EstadoLectura leerFecha(const std::string& texto, Fecha& fecha);
+const char* describirEstadoLectura(EstadoLectura estado);
+
+// Informe de errores de la carga de un archivo. Se cuentan los errores por tipo y se
+// guardan los primeros ejemplos (línea y campo); al final se muestra un solo resumen
+// en lugar de un mensaje por línea.
+class InformeCarga {
+public:
+    static const int MAX_EJEMPLOS = 8;
+
+private:
+    struct Ejemplo {
+        long linea;
+        int campo;                // -1 = la línea completa
+        EstadoLectura estado;
+    };
+
+    std::string archivo;
+    long lineasLeidas;
+    long lineasCargadas;
+    long lineasConError;
+    long conteoPorEstado[CANTIDAD_ESTADOS_LECTURA];
+    Ejemplo ejemplos[MAX_EJEMPLOS];
+    int cantidadEjemplos;
+
+public:
+    explicit InformeCarga(const std::string& nombreArchivo);
+
+    void contarLinea();           // Una línea de datos leída (sin contar la cabecera)
+    void contarCargada();
+    // Registra el error que descarta una línea (se registra uno por línea).
+    void registrar(long linea, int campo, EstadoLectura estado);
+
+    long getLineasLeidas() const;
+    long getLineasCargadas() const;
+    long getLineasConError() const;
+    long getConteo(EstadoLectura estado) const;
+    // Resumen en una línea y, si hubo errores, los ejemplos en las siguientes.
+    // 'nombresCampos' (opcional) da el nombre de cada campo para los ejemplos.
+    void mostrar(const char* const nombresCampos[] = nullptr) const;
+};
+
+#endif // LECTURACAMPOS_H
@@ -0,0 +1,119 @@
+// --- listaestadias.cpp ---
+// Implementación de la lista de estadías ordenada por día de entrada.
+#include "listaestadias.h"
+#include <utility>
+using namespace std;
+
+ListaEstadias::ListaEstadias() : estadias(nullptr), cantidad(0), cupo(0), maxNoches(0) {
+}
+
+ListaEstadias::ListaEstadias(const ListaEstadias& otra) :
+    estadias(otra.cupo > 0 ? new Estadia[otra.cupo] : nullptr),
+    cantidad(otra.cantidad), cupo(otra.cupo), maxNoches(otra.maxNoches) {
+    for (int i = 0; i < cantidad; ++i) {
+        estadias[i] = otra.estadias[i];
+    }
+}
+
+ListaEstadias& ListaEstadias::operator=(const ListaEstadias& otra) {
+    if (this != &otra) {
+        Estadia* nuevo = otra.cupo > 0 ? new Estadia[otra.cupo] : nullptr;
+        for (int i = 0; i < otra.cantidad; ++i) {
+            nuevo[i] = otra.estadias[i];
+        }
+        delete[] estadias;
+        estadias = nuevo;
+        cantidad = otra.cantidad;
+        cupo = otra.cupo;
+        maxNoches = otra.maxNoches;
+    }
+    return *this;
+}
+
+ListaEstadias::~ListaEstadias() {
+    delete[] estadias;
+}
+
+int ListaEstadias::limiteInferior(long dia) const {
+    int bajo = 0, alto = cantidad;
+    while (bajo < alto) {
+        int medio = bajo + (alto - bajo) / 2;
+        if (estadias[medio].diaEntrada < dia) {
+            bajo = medio + 1;
+        } else {
+            alto = medio;
+        }
+    }
+    return bajo;
+}
+
+/**
+ * @brief Inserta la estadía en su posición ordenada por día de entrada.
+ * Las reservaciones nuevas suelen ser posteriores a las existentes, así que
+ * en la práctica el desplazamiento es corto.
+ */
+void ListaEstadias::insertar(long diaEntrada, long diaSalida, const string& codigoReservacion) {
+    if (cantidad == cupo) {
+        int nuevoCupo = cupo == 0 ? 4 : cupo * 2;
+        Estadia* nuevo = new Estadia[nuevoCupo];
+        for (int i = 0; i < cantidad; ++i) {
+            nuevo[i] = std::move(estadias[i]);
+        }
+        delete[] estadias;
+        estadias = nuevo;
+        cupo = nuevoCupo;
+    }
+
+    // Después de las que tienen la misma entrada, para conservar el orden de llegada.
+    int posicion = limiteInferior(diaEntrada + 1);
+    for (int i = cantidad; i > posicion; --i) {
+        estadias[i] = std::move(estadias[i - 1]);
+    }
+    estadias[posicion] = Estadia{diaEntrada, diaSalida, codigoReservacion};
+    cantidad++;
+
+    if (diaSalida - diaEntrada > maxNoches) {
+        maxNoches = diaSalida - diaEntrada;
+    }
+}
+
+bool ListaEstadias::eliminar(long diaEntrada, const string& codigoReservacion) {
+    for (int i = limiteInferior(diaEntrada); i < cantidad && estadias[i].diaEntrada == diaEntrada; ++i) {
+        if (estadias[i].codigoReservacion == codigoReservacion) {
+            for (int j = i; j + 1 < cantidad; ++j) {
+                estadias[j] = std::move(estadias[j + 1]);
+            }
+            cantidad--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ListaEstadias::vaciar() {
+    cantidad = 0;
+    maxNoches = 0;
+}
+
+/**
+ * @brief Recorre el mismo rango que recorrerCruces, pero se detiene en la primera coincidencia.
+ */
+bool ListaEstadias::hayCruce(long diaDesde, long diaHasta) const {
+    for (int i = limiteInferior(diaDesde - maxNoches + 1);
+         i < cantidad && estadias[i].diaEntrada <= diaHasta; ++i) {
+        if (estadias[i].diaSalida > diaDesde) return true;
+    }
+    return false;
+}
+
+int ListaEstadias::getCantidad() const {
+    return cantidad;
+}
+
+const ListaEstadias::Estadia& ListaEstadias::getEstadia(int i) const {
+    return estadias[i];
+}
+
+size_t ListaEstadias::memoriaAproximada() const {
+    return sizeof(*this) + static_cast<size_t>(cupo) * sizeof(Estadia);
+}
@@ -0,0 +1,63 @@
+#ifndef LISTAESTADIAS_H
+#define LISTAESTADIAS_H
+
+#include <cstddef>
+#include <string>
+
+// Lista de estadías (intervalos de días) ordenada por día de entrada.
+// Es la base de la agenda de cada alojamiento y de las reservaciones de cada huésped.
+// Como ninguna estadía de la lista dura más de 'maxNoches', las que pueden cruzarse
+// con [desde, hasta] tienen entrada en (desde - maxNoches, hasta]: una búsqueda
+// binaria ubica el inicio y el resto es un recorrido contiguo.
+class ListaEstadias {
+public:
+    struct Estadia {
+        long diaEntrada;              // Ver Fecha::aNumeroDia
+        long diaSalida;
+        std::string codigoReservacion;
+    };
+
+private:
+    Estadia* estadias;
+    int cantidad;
+    int cupo;
+    long maxNoches;                   // Estadía más larga registrada (no disminuye)
+
+public:
+    ListaEstadias();
+    ListaEstadias(const ListaEstadias& otra);
+    ListaEstadias& operator=(const ListaEstadias& otra);
+    ~ListaEstadias();
+
+    void insertar(long diaEntrada, long diaSalida, const std::string& codigoReservacion);
+    // Devuelve false si la estadía no estaba en la lista.
+    bool eliminar(long diaEntrada, const std::string& codigoReservacion);
+    void vaciar();
+
+    // Primera posición con diaEntrada >= dia.
+    int limiteInferior(long dia) const;
+
+    // true si alguna estadía cumple entrada <= diaHasta y salida > diaDesde.
+    bool hayCruce(long diaDesde, long diaHasta) const;
+
+    // Llama visitante(const Estadia&) para cada estadía con entrada <= diaHasta y
+    // salida > diaDesde, en orden de entrada. Devuelve la cantidad examinada.
+    template <typename Visitante>
+    int recorrerCruces(long diaDesde, long diaHasta, Visitante visitante) const {
+        int examinadas = 0;
+        for (int i = limiteInferior(diaDesde - maxNoches + 1);
+             i < cantidad && estadias[i].diaEntrada <= diaHasta; ++i) {
+            examinadas++;
+            if (estadias[i].diaSalida > diaDesde) {
+                visitante(estadias[i]);
+            }
+        }
+        return examinadas;
+    }
+
+    int getCantidad() const;
+    const Estadia& getEstadia(int i) const;   // En orden de entrada
+    size_t memoriaAproximada() const;
+};
+
+#endif // LISTAESTADIAS_H
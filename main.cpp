@@ -1,9 +1,170 @@
 #include "GestorUdeaStay.h" // Incluir la clase principal del sistema
+#include "servidorudeastay.h"
+#include "clienteudeastay.h"
+#include "lecturacampos.h"
 #include <iostream>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+#include <thread>
 
-int main() {
+static ServidorUdeaStay* servidorActivo = nullptr;
 
-    GestorUdeaStay sistema;
+// SIGINT/SIGTERM detienen el servidor con orden: el gestor guarda los datos al destruirse.
+static void detenerServidor(int) {
+    if (servidorActivo != nullptr) {
+        servidorActivo->detener();
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    // Opciones de línea de comandos:
+    //   --archivado-automatico <segundos>  archiva periódicamente lo vencido hasta hoy
+    //   --historico-particionado           usa historico/AAAA-MM.part en vez de Historico.csv
+    //   --comprimir-historico              comprime los segmentos nuevos (requiere zlib)
+    //   --importar-historico               copia Historico.csv al histórico particionado
+    //   --exportar-historico <archivo>     exporta el histórico particionado a CSV y termina
+    //   --reordenar-historico              reescribe Historico.csv ordenado por fecha de entrada
+    //   --prueba-estres <hilos> <ops>      prueba de concurrencia sin escribir archivos y termina
+    //   --diario-reservaciones <us> <lote> reservas durables con commit en grupo (ventana y lote máximo)
+    //   --hilos-busqueda <n>               hilos que evalúan cada búsqueda de disponibilidad (1 = secuencial)
+    //   --cache-busquedas <KB>             memoria de la cache de búsquedas repetidas (0 = sin cache)
+    //   --servidor <puerto|ruta>           atiende clientes por socket (TCP local o Unix) hasta SIGINT
+    //   --trabajadores <n>                 hilos que atienden solicitudes en modo servidor
+    //   --cliente <puerto|ruta>            menú de consola conectado a un servidor (no carga datos)
+    //   --usuarios-bajo-demanda            indexa anfitriones y huéspedes y los lee del archivo al usarlos
+    //   --cambios-archivo <ruta>           anexa cada reserva, anulación y archivado a un archivo (CSV)
+    //   --cambios-tuberia <ruta>           envía esos eventos a una tubería con nombre (mkfifo)
+    //   --recargar-alojamientos            recarga Alojamientos.csv cada vez que cambia (inotify)
+    //   --analitica <desde> <hasta> <pref> ocupación e ingresos por mes (dd/mm/aaaa) a <pref>_*.csv y termina
+    bool particionado = false, comprimir = false, importar = false, reordenar = false;
+    bool usuariosBajoDemanda = false, recargarAlojamientos = false;
+    std::string destinoExportacion;
+    Fecha analiticaDesde, analiticaHasta;
+    std::string prefijoAnalitica;
+    int hilosEstres = 0, operacionesEstres = 0;
+    int segundosArchivado = 0;
+    int ventanaDiario = -1, loteDiario = 0;
+    std::string direccionServidor, direccionCliente;
+    std::string archivoCambios, tuberiaCambios;
+    int trabajadores = static_cast<int>(std::thread::hardware_concurrency());
+    int hilosBusqueda = trabajadores;
+    long kilobytesCache = 4096;
+    for (int i = 1; i < argc; ++i) {
+        std::string opcion = argv[i];
+        if (opcion == "--archivado-automatico" && i + 1 < argc) {
+            segundosArchivado = std::atoi(argv[++i]);
+        } else if (opcion == "--historico-particionado") {
+            particionado = true;
+        } else if (opcion == "--comprimir-historico") {
+            particionado = comprimir = true;
+        } else if (opcion == "--importar-historico") {
+            particionado = importar = true;
+        } else if (opcion == "--reordenar-historico") {
+            reordenar = true;
+        } else if (opcion == "--exportar-historico" && i + 1 < argc) {
+            particionado = true;
+            destinoExportacion = argv[++i];
+        } else if (opcion == "--prueba-estres" && i + 2 < argc) {
+            hilosEstres = std::atoi(argv[++i]);
+            operacionesEstres = std::atoi(argv[++i]);
+        } else if (opcion == "--diario-reservaciones" && i + 2 < argc) {
+            ventanaDiario = std::atoi(argv[++i]);
+            loteDiario = std::atoi(argv[++i]);
+        } else if (opcion == "--hilos-busqueda" && i + 1 < argc) {
+            hilosBusqueda = std::atoi(argv[++i]);
+        } else if (opcion == "--cache-busquedas" && i + 1 < argc) {
+            kilobytesCache = std::atol(argv[++i]);
+        } else if (opcion == "--servidor" && i + 1 < argc) {
+            direccionServidor = argv[++i];
+        } else if (opcion == "--trabajadores" && i + 1 < argc) {
+            trabajadores = std::atoi(argv[++i]);
+        } else if (opcion == "--cliente" && i + 1 < argc) {
+            direccionCliente = argv[++i];
+        } else if (opcion == "--usuarios-bajo-demanda") {
+            usuariosBajoDemanda = true;
+        } else if (opcion == "--cambios-archivo" && i + 1 < argc) {
+            archivoCambios = argv[++i];
+        } else if (opcion == "--cambios-tuberia" && i + 1 < argc) {
+            tuberiaCambios = argv[++i];
+        } else if (opcion == "--recargar-alojamientos") {
+            recargarAlojamientos = true;
+        } else if (opcion == "--analitica" && i + 3 < argc) {
+            if (leerFecha(argv[i + 1], analiticaDesde) != LECTURA_CORRECTA ||
+                leerFecha(argv[i + 2], analiticaHasta) != LECTURA_CORRECTA) {
+                std::cerr << "Fechas inválidas para --analitica (dd/mm/aaaa)." << std::endl;
+                return 1;
+            }
+            prefijoAnalitica = argv[i + 3];
+            i += 3;
+        } else {
+            std::cerr << "Opción desconocida: " << opcion << std::endl;
+        }
+    }
+
+    if (!direccionCliente.empty()) {
+        ClienteUdeaStay cliente;
+        if (!cliente.conectar(direccionCliente)) {
+            return 1;
+        }
+        cliente.ejecutar();
+        return 0;
+    }
+
+    GestorUdeaStay sistema(usuariosBajoDemanda);
+    sistema.setHilosDeBusqueda(hilosBusqueda);
+    sistema.setPresupuestoCacheBusquedas(kilobytesCache > 0 ? static_cast<size_t>(kilobytesCache) * 1024 : 0);
+    if (!archivoCambios.empty()) {
+        sistema.agregarSumideroCambios(new SumideroArchivo(archivoCambios));
+    }
+    if (!tuberiaCambios.empty()) {
+        sistema.agregarSumideroCambios(new SumideroTuberia(tuberiaCambios));
+    }
+
+    if (hilosEstres > 0) {
+        return sistema.ejecutarPruebaDeEstres(hilosEstres, operacionesEstres) ? 0 : 1;
+    }
+    if (ventanaDiario >= 0 && !sistema.activarDiarioDeReservaciones(ventanaDiario, loteDiario)) {
+        return 1;
+    }
+    if (recargarAlojamientos && !sistema.activarRecargaAlojamientos()) {
+        return 1;
+    }
+    if (segundosArchivado > 0) {
+        sistema.iniciarArchivadoAutomatico(segundosArchivado);
+    }
+    if (reordenar && !sistema.reordenarHistorico()) {
+        return 1;
+    }
+    if (particionado && !sistema.usarHistoricoParticionado(comprimir)) {
+        return 1;
+    }
+    if (importar) {
+        std::cout << "Registros importados al histórico particionado: "
+                  << sistema.importarHistoricoDesdeCSV() << std::endl;
+    }
+    if (!destinoExportacion.empty()) {
+        long long exportados = sistema.exportarHistoricoCSV(destinoExportacion);
+        std::cout << "Registros exportados a " << destinoExportacion << ": " << exportados << std::endl;
+        return exportados < 0 ? 1 : 0;
+    }
+    if (!prefijoAnalitica.empty()) {
+        return sistema.generarAnalitica(analiticaDesde, analiticaHasta, prefijoAnalitica, trabajadores) ? 0 : 1;
+    }
+
+    if (!direccionServidor.empty()) {
+        ServidorUdeaStay servidor(sistema, trabajadores);
+        if (!servidor.escuchar(direccionServidor)) {
+            return 1;
+        }
+        servidorActivo = &servidor;
+        std::signal(SIGINT, detenerServidor);
+        std::signal(SIGTERM, detenerServidor);
+        servidor.ejecutar();
+        servidorActivo = nullptr;
+        return 0;
+    }
 
     sistema.ejecutar();
 
@@ -0,0 +1,175 @@
+// --- poolhilos.cpp ---
+// Implementación del grupo de hilos con robo de trabajo.
+#include "poolhilos.h"
+using namespace std;
+
+PoolHilos::PoolHilos() :
+    colas(nullptr), hilos(nullptr), cantidadHilos(0), trabajosEnColas(0), siguienteCola(0), detener(false),
+    peticiones(0), bloquesEjecutados(0), bloquesRobados(0) {
+}
+
+PoolHilos::~PoolHilos() {
+    detenerHilos();
+}
+
+void PoolHilos::iniciar(int cantidad) {
+    detenerHilos();
+    if (cantidad <= 0) return;
+    colas = new ColaDoble[cantidad];
+    hilos = new thread[cantidad];
+    cantidadHilos = cantidad;
+    detener = false;
+    for (int i = 0; i < cantidad; ++i) {
+        hilos[i] = thread(&PoolHilos::cicloHilo, this, i);
+    }
+}
+
+void PoolHilos::detenerHilos() {
+    if (hilos == nullptr) return;
+    {
+        lock_guard<mutex> bloqueo(mutexEspera);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (int i = 0; i < cantidadHilos; ++i) {
+        hilos[i].join();
+    }
+    delete[] hilos;
+    delete[] colas;
+    hilos = nullptr;
+    colas = nullptr;
+    cantidadHilos = 0;
+}
+
+int PoolHilos::getCantidadHilos() const {
+    return cantidadHilos;
+}
+
+void PoolHilos::agregar(int cola, const Trabajo& trabajo) {
+    ColaDoble& c = colas[cola];
+    {
+        lock_guard<mutex> bloqueo(c.mutexCola);
+        if (c.cantidad == c.cupo) {
+            int nuevoCupo = c.cupo == 0 ? 16 : c.cupo * 2;
+            Trabajo* nuevos = new Trabajo[nuevoCupo];
+            for (int i = 0; i < c.cantidad; ++i) {
+                nuevos[i] = c.trabajos[(c.inicio + i) % c.cupo];
+            }
+            delete[] c.trabajos;
+            c.trabajos = nuevos;
+            c.inicio = 0;
+            c.cupo = nuevoCupo;
+        }
+        c.trabajos[(c.inicio + c.cantidad) % c.cupo] = trabajo;
+        c.cantidad++;
+    }
+    trabajosEnColas.fetch_add(1, memory_order_release); // Después de quedar en la cola
+}
+
+bool PoolHilos::tomarPropio(int cola, Trabajo& trabajo) {
+    ColaDoble& c = colas[cola];
+    {
+        lock_guard<mutex> bloqueo(c.mutexCola);
+        if (c.cantidad == 0) return false;
+        trabajo = c.trabajos[(c.inicio + c.cantidad - 1) % c.cupo];
+        c.cantidad--;
+    }
+    trabajosEnColas.fetch_sub(1, memory_order_relaxed);
+    return true;
+}
+
+bool PoolHilos::robar(int desde, Trabajo& trabajo) {
+    for (int k = 0; k < cantidadHilos; ++k) {
+        ColaDoble& c = colas[(desde + k) % cantidadHilos];
+        lock_guard<mutex> bloqueo(c.mutexCola);
+        if (c.cantidad == 0) continue;
+        trabajo = c.trabajos[c.inicio];
+        c.inicio = (c.inicio + 1) % c.cupo;
+        c.cantidad--;
+        trabajosEnColas.fetch_sub(1, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void PoolHilos::ejecutar(const Trabajo& trabajo) {
+    (*trabajo.lote->tarea)(trabajo.bloque);
+    bloquesEjecutados.fetch_add(1, memory_order_relaxed);
+    // El descuento va con el mutex del lote: quien espera no puede ver cero (y destruir
+    // el lote, que vive en su pila) mientras este hilo todavía lo está usando.
+    lock_guard<mutex> bloqueo(trabajo.lote->mutexLote);
+    if (trabajo.lote->pendientes.fetch_sub(1, memory_order_acq_rel) == 1) {
+        trabajo.lote->terminado.notify_all();
+    }
+}
+
+void PoolHilos::cicloHilo(int indice) {
+    Trabajo trabajo;
+    while (true) {
+        if (tomarPropio(indice, trabajo)) {
+            ejecutar(trabajo);
+            continue;
+        }
+        if (robar(indice + 1, trabajo)) {
+            bloquesRobados.fetch_add(1, memory_order_relaxed);
+            ejecutar(trabajo);
+            continue;
+        }
+        unique_lock<mutex> bloqueo(mutexEspera);
+        hayTrabajo.wait(bloqueo, [this]() { return detener || trabajosEnColas.load(memory_order_acquire) > 0; });
+        if (detener && trabajosEnColas.load(memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Reparte los bloques en tramos contiguos, uno por hilo (cada hilo empieza con
+ * bloques vecinos), despierta a los hilos y roba bloques mientras queden en las colas.
+ * Con un solo bloque o sin hilos no vale la pena repartir: corre todo aquí.
+ */
+void PoolHilos::ejecutarBloques(int bloques, const Tarea& tarea) {
+    if (bloques <= 0) return;
+    if (cantidadHilos == 0 || bloques == 1) {
+        for (int b = 0; b < bloques; ++b) {
+            tarea(b);
+        }
+        return;
+    }
+    peticiones.fetch_add(1, memory_order_relaxed);
+
+    Lote lote;
+    lote.tarea = &tarea;
+    lote.pendientes.store(bloques, memory_order_relaxed);
+    for (int h = 0; h < cantidadHilos; ++h) {
+        int desde = static_cast<int>(static_cast<long long>(bloques) * h / cantidadHilos);
+        int hasta = static_cast<int>(static_cast<long long>(bloques) * (h + 1) / cantidadHilos);
+        // Al final de la cola va el primero: el dueño toma sus bloques en orden
+        for (int b = hasta - 1; b >= desde; --b) {
+            agregar(h, Trabajo{&lote, b});
+        }
+    }
+    {
+        lock_guard<mutex> bloqueo(mutexEspera);
+    }
+    hayTrabajo.notify_all();
+
+    // Mientras espera, quien pidió el trabajo también ejecuta bloques (de este o de otro lote)
+    Trabajo trabajo;
+    while (lote.pendientes.load(memory_order_acquire) > 0 &&
+           robar(static_cast<int>(siguienteCola.fetch_add(1, memory_order_relaxed) % cantidadHilos), trabajo)) {
+        bloquesRobados.fetch_add(1, memory_order_relaxed);
+        ejecutar(trabajo);
+    }
+    unique_lock<mutex> bloqueo(lote.mutexLote);
+    lote.terminado.wait(bloqueo, [&lote]() { return lote.pendientes.load(memory_order_acquire) == 0; });
+}
+
+PoolHilos::Metricas PoolHilos::getMetricas() const {
+    Metricas m;
+    m.hilos = cantidadHilos;
+    m.peticiones = peticiones.load(memory_order_relaxed);
+    m.bloques = bloquesEjecutados.load(memory_order_relaxed);
+    m.robados = bloquesRobados.load(memory_order_relaxed);
+    return m;
+}
@@ -0,0 +1,92 @@
+#ifndef POOLHILOS_H
+#define POOLHILOS_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Grupo de hilos con robo de trabajo para repartir un trabajo en bloques numerados
+// (por ejemplo, tramos del arreglo de alojamientos en una búsqueda).
+//
+// Cada hilo tiene su propia cola doble: toma sus bloques por el final y, cuando se
+// queda sin trabajo, roba por el inicio de la cola de otro. Así un bloque que tarda
+// más (muchos alojamientos del municipio buscado, páginas del calendario frías) no
+// deja a los demás hilos ociosos. El hilo que pide el trabajo también roba bloques
+// mientras espera, y varias peticiones pueden estar en curso a la vez (una por
+// cada búsqueda concurrente).
+class PoolHilos {
+public:
+    typedef std::function<void(int)> Tarea;   // Recibe el número de bloque
+
+    struct Metricas {
+        int hilos;                        // Hilos del grupo (sin contar a quien pide el trabajo)
+        unsigned long long peticiones;    // Llamadas a ejecutarBloques repartidas entre hilos
+        unsigned long long bloques;
+        unsigned long long robados;       // Bloques que no ejecutó el hilo al que se asignaron
+    };
+
+private:
+    // Un llamado a ejecutarBloques: sus bloques pueden estar en varias colas a la vez
+    struct Lote {
+        const Tarea* tarea;
+        std::atomic<int> pendientes;
+        std::mutex mutexLote;
+        std::condition_variable terminado;
+    };
+
+    struct Trabajo {
+        Lote* lote;
+        int bloque;
+    };
+
+    // Cola doble de un hilo (arreglo circular protegido por su propio mutex)
+    struct ColaDoble {
+        std::mutex mutexCola;
+        Trabajo* trabajos;
+        int inicio;
+        int cantidad;
+        int cupo;
+        ColaDoble() : trabajos(nullptr), inicio(0), cantidad(0), cupo(0) {}
+        ~ColaDoble() { delete[] trabajos; }
+    };
+
+    ColaDoble* colas;
+    std::thread* hilos;
+    int cantidadHilos;
+    std::atomic<int> trabajosEnColas;    // Para que los hilos ociosos sepan si vale la pena buscar
+    std::atomic<unsigned int> siguienteCola;
+    std::mutex mutexEspera;
+    std::condition_variable hayTrabajo;
+    bool detener;
+
+    std::atomic<unsigned long long> peticiones, bloquesEjecutados, bloquesRobados;
+
+    void agregar(int cola, const Trabajo& trabajo);
+    bool tomarPropio(int cola, Trabajo& trabajo);        // Por el final
+    bool robar(int desde, Trabajo& trabajo);             // Por el inicio de las otras colas
+    void ejecutar(const Trabajo& trabajo);
+    void cicloHilo(int indice);
+
+public:
+    PoolHilos();
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    // Arranca 'cantidad' hilos (detiene los anteriores). Con 0 todo corre en quien llama.
+    void iniciar(int cantidad);
+    void detenerHilos();
+    int getCantidadHilos() const;
+
+    // Ejecuta tarea(0) ... tarea(bloques - 1) repartidos entre los hilos y quien llama,
+    // y regresa cuando todos terminaron. El orden de ejecución no está definido: cada
+    // bloque debe escribir en su propia parte del resultado.
+    void ejecutarBloques(int bloques, const Tarea& tarea);
+
+    Metricas getMetricas() const;
+};
+
+#endif // POOLHILOS_H
@@ -0,0 +1,116 @@
+#ifndef REGISTROBAJODEMANDA_H
+#define REGISTROBAJODEMANDA_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include "indicelineascsv.h"
+
+// Colección de objetos por posición (orden del archivo) que pueden estar ya en memoria
+// o leerse del CSV la primera vez que se piden.
+//
+// - Carga inmediata: agregar() recibe cada objeto ya construido.
+// - Carga bajo demanda: abrirBajoDemanda() solo indexa el archivo (posición -> byte de
+//   su línea); obtener() lee, convierte y guarda el objeto la primera vez que se pide.
+//
+// Los objetos se reservan uno por uno, así un puntero entregado sigue válido aunque se
+// carguen otros. obtener() se puede llamar desde varios hilos: el camino rápido es una
+// lectura atómica y la lectura del archivo se hace con un mutex.
+template <typename T>
+class RegistroBajoDemanda {
+private:
+    std::atomic<T*>* objetos;           // nullptr = todavía no se leyó del archivo
+    int cantidad;
+    int cupo;
+    mutable std::atomic<int> enMemoria;  // Objetos ya construidos
+    bool bajoDemanda;
+    mutable std::mutex mutexLectura;    // Serializa las lecturas del archivo
+    mutable IndiceLineasCSV lineas;
+
+    void asegurarCupo(int necesario) {
+        if (necesario <= cupo) return;
+        int nuevoCupo = cupo == 0 ? 16 : cupo;
+        while (nuevoCupo < necesario) nuevoCupo *= 2;
+        std::atomic<T*>* nuevos = new std::atomic<T*>[nuevoCupo];
+        for (int i = 0; i < nuevoCupo; ++i) {
+            nuevos[i].store(i < cantidad ? objetos[i].load(std::memory_order_relaxed) : nullptr,
+                            std::memory_order_relaxed);
+        }
+        delete[] objetos;
+        objetos = nuevos;
+        cupo = nuevoCupo;
+    }
+
+public:
+    RegistroBajoDemanda() : objetos(nullptr), cantidad(0), cupo(0), enMemoria(0), bajoDemanda(false) {}
+    ~RegistroBajoDemanda() {
+        for (int i = 0; i < cantidad; ++i) {
+            delete objetos[i].load(std::memory_order_relaxed);
+        }
+        delete[] objetos;
+    }
+
+    RegistroBajoDemanda(const RegistroBajoDemanda&) = delete;
+    RegistroBajoDemanda& operator=(const RegistroBajoDemanda&) = delete;
+
+    // Toma el objeto (creado con new) y devuelve su posición. Solo durante la carga.
+    int agregar(T* objeto) {
+        asegurarCupo(cantidad + 1);
+        objetos[cantidad].store(objeto, std::memory_order_relaxed);
+        enMemoria.fetch_add(1, std::memory_order_relaxed);
+        return cantidad++;
+    }
+
+    // Indexa el archivo sin construir objetos; el visitante recibe la posición y las
+    // columnas clave de cada registro (ver IndiceLineasCSV::abrir).
+    bool abrirBajoDemanda(const std::string& archivoDatos, const std::string& archivoLateral, const int columnas[],
+                          int cantidadColumnas, InformeCarga& informe, const IndiceLineasCSV::Visitante& visitante) {
+        bajoDemanda = true;
+        if (!lineas.abrir(archivoDatos, archivoLateral, columnas, cantidadColumnas, informe, visitante)) {
+            return false;
+        }
+        asegurarCupo(lineas.getCantidad());
+        cantidad = lineas.getCantidad();
+        return true;
+    }
+
+    // Objeto en 'posicion', leyéndolo del archivo si hace falta con
+    // construir(const std::string& linea) -> T* (creado con new; nullptr si la línea ya
+    // no es válida, y se vuelve a intentar en el próximo pedido).
+    template <typename Construir>
+    T* obtener(int posicion, Construir&& construir) const {
+        if (posicion < 0 || posicion >= cantidad) return nullptr;
+        T* objeto = objetos[posicion].load(std::memory_order_acquire);
+        if (objeto != nullptr || !bajoDemanda) return objeto;
+
+        std::lock_guard<std::mutex> bloqueo(mutexLectura);
+        objeto = objetos[posicion].load(std::memory_order_acquire);
+        if (objeto == nullptr) {
+            std::string linea;
+            if (lineas.leerLinea(posicion, linea) && (objeto = construir(linea)) != nullptr) {
+                objetos[posicion].store(objeto, std::memory_order_release);
+                enMemoria.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return objeto;
+    }
+
+    // Objeto en 'posicion' solo si ya está en memoria (no lee el archivo).
+    T* obtenerSiEnMemoria(int posicion) const {
+        if (posicion < 0 || posicion >= cantidad) return nullptr;
+        return objetos[posicion].load(std::memory_order_acquire);
+    }
+
+    int getCantidad() const { return cantidad; }
+    int getEnMemoria() const { return enMemoria.load(std::memory_order_relaxed); }
+    bool esBajoDemanda() const { return bajoDemanda; }
+    bool indiceDesdeLateral() const { return lineas.getAbiertoDesdeLateral(); }
+
+    size_t memoriaAproximada() const {
+        return static_cast<size_t>(cupo) * sizeof(std::atomic<T*>) +
+               static_cast<size_t>(getEnMemoria()) * sizeof(T) + (bajoDemanda ? lineas.memoriaAproximada() : 0);
+    }
+};
+
+#endif // REGISTROBAJODEMANDA_H
@@ -1,4 +1,5 @@
 #include "reservacion.h"
+#include "bufercsv.h"
 #include <iostream>
 using namespace std;
 
@@ -34,6 +35,14 @@ Fecha Reservacion::getFechaSalida() const {
     return fechaEntrada.calcularFechaMasDuracion(duracionNoche);
 }
 
+long Reservacion::getDiaEntrada() const {
+    return fechaEntrada.aNumeroDia();
+}
+
+long Reservacion::getDiaSalida() const {
+    return fechaEntrada.aNumeroDia() + duracionNoche;
+}
+
 bool Reservacion::EstaActiva() const {
     return activa;
 }
@@ -50,6 +59,26 @@ string Reservacion::getDocumentoHuesped() const {
     return documentoHuesped;
 }
 
+string Reservacion::getMetodoPago() const {
+    return metodoPago;
+}
+
+int Reservacion::getDuracionNoches() const {
+    return duracionNoche;
+}
+
+Fecha Reservacion::getFechaPago() const {
+    return fechaPago;
+}
+
+int Reservacion::getValorTotal() const {
+    return valorTotal;
+}
+
+void Reservacion::setActiva(bool estado) {
+    activa = estado;
+}
+
 void Reservacion::setAnotaciones(const string& notas) {
     if (notas.length() > 1000) {
         anotaciones = notas.substr(0,1000);
@@ -64,8 +93,12 @@ void Reservacion::mostrarComprobante() const {
     cout << "Codigo de Alojamiento: " << codigoAlojamiento << endl;
     cout << "Documento del huesped: " << documentoHuesped << endl;
     cout << "Metodo de pago: " << metodoPago << endl;
-    cout << "Fecha de entrada: " << fechaEntrada.toStringFormatoLargo() << endl;
-    cout << "Fecha de salida: " << getFechaSalida().toStringFormatoLargo() << endl;
+    // Las fechas se escriben en un arreglo local: el comprobante no reserva memoria
+    char fecha[Fecha::LARGO_MAXIMO_FORMATO_LARGO];
+    cout << "Fecha de entrada: ";
+    cout.write(fecha, fechaEntrada.escribirFormatoLargo(fecha)) << endl;
+    cout << "Fecha de salida: ";
+    cout.write(fecha, getFechaSalida().escribirFormatoLargo(fecha)) << endl;
     cout << "Valor total pagado: " << valorTotal << endl;
     cout << "Estado: " << (activa ? "Activa" : "Cancelada") << endl;
     cout << "Anotaciones: " << anotaciones << endl;
@@ -75,17 +108,34 @@ void Reservacion::anular() {
     activa = false;
 }
 
+/**
+ * @brief Escribe la reservación como línea CSV (sin salto de línea) al final de 'salida'.
+ * Las anotaciones van entre comillas, con las comillas internas duplicadas.
+ */
+void Reservacion::escribirCSV(BuferCSV& salida) const {
+    salida.agregar(codigo);
+    salida.agregar(',');
+    salida.agregar(codigoAlojamiento);
+    salida.agregar(',');
+    salida.agregar(documentoHuesped);
+    salida.agregar(',');
+    salida.agregarFecha(fechaEntrada);
+    salida.agregar(',');
+    salida.agregarEntero(duracionNoche);
+    salida.agregar(',');
+    salida.agregar(metodoPago);
+    salida.agregar(',');
+    salida.agregarFecha(fechaPago);
+    salida.agregar(',');
+    salida.agregarEntero(valorTotal);
+    salida.agregar(',');
+    salida.agregarEntreComillas(anotaciones);
+    salida.agregar(',');
+    salida.agregar(activa ? '1' : '0');                //1 si es verdadero, 0 si es falso
+}
+
 string Reservacion::toFileString() const {
-    ostringstream oss;
-    oss << codigo << ","
-        << codigoAlojamiento << ","
-        << documentoHuesped << ","
-        << fechaEntrada.toString() << ","
-        << duracionNoche << ","
-        << metodoPago << ","
-        << fechaPago.toString() << ","
-        << valorTotal << ","
-        << "\"" << anotaciones << "\","
-        << (activa ? "1" : "0");                //1 si es verdadero, 0 si es falso
-    return oss.str();
+    BuferCSV salida(128);
+    escribirCSV(salida);
+    return salida.aString();
 }
@@ -3,6 +3,7 @@
 #include <string>
 #include <sstream>
 #include "fecha.h"
+class BuferCSV;
 using namespace std;
 
 class Reservacion
@@ -28,10 +29,16 @@ public:
     string getCodigo() const;
     Fecha getFechaEntrada() const;
     Fecha getFechaSalida() const;
+    long getDiaEntrada() const;   // Número de día de la entrada (ver Fecha::aNumeroDia)
+    long getDiaSalida() const;    // Número de día de la salida, sin recorrer noche por noche
     bool EstaActiva() const;
     string getAnotaciones() const;
     string getCodigoAlojamiento() const;
     string getDocumentoHuesped() const;
+    string getMetodoPago() const;
+    int getDuracionNoches() const;
+    Fecha getFechaPago() const;
+    int getValorTotal() const;
 
     //Setters
     void setActiva(bool estado);
@@ -42,6 +49,7 @@ public:
     void anular();
 
     string toFileString() const;
+    void escribirCSV(BuferCSV& salida) const;   // Sin crear strings intermedios
 
 };
 
@@ -0,0 +1,400 @@
+// --- servidorudeastay.cpp ---
+// Implementación del modo servidor (bucle epoll + grupo de trabajadores).
+#include "servidorudeastay.h"
+#include "GestorUdeaStay.h"
+#include <iostream>
+#include <exception>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+using namespace std;
+
+static const size_t LARGO_MAXIMO_SOLICITUD = 4096;   // Una línea más larga cierra la conexión
+static const size_t ENTRADA_MAXIMA_EN_ESPERA = 64 * 1024; // Por encima se deja de leer (contrapresión)
+static const int EVENTOS_POR_ESPERA = 64;
+static const unsigned int FUERA_DE_EPOLL = ~0u;
+
+ServidorUdeaStay::ServidorUdeaStay(GestorUdeaStay& gestor, int trabajadores) :
+    gestor(gestor),
+    cantidadTrabajadores(trabajadores > 0 ? trabajadores : 1),
+    trabajadores(nullptr),
+    fdEscucha(-1), fdEpoll(-1), fdAviso(-1),
+    conexiones(nullptr), cupoConexiones(0), conexionesAbiertas(0),
+    terminando(false),
+    detenerPedido(false) {
+}
+
+ServidorUdeaStay::~ServidorUdeaStay() {
+    for (int fd = 0; fd < cupoConexiones; ++fd) {
+        if (conexiones[fd] != nullptr) {
+            ::close(fd);
+            delete conexiones[fd];
+        }
+    }
+    delete[] conexiones;
+    if (fdEscucha >= 0) ::close(fdEscucha);
+    if (fdEpoll >= 0) ::close(fdEpoll);
+    if (fdAviso >= 0) ::close(fdAviso);
+    if (!rutaSocketUnix.empty()) ::unlink(rutaSocketUnix.c_str());
+}
+
+bool ServidorUdeaStay::esPuertoTCP(const string& direccion) {
+    if (direccion.empty() || direccion.size() > 5) return false;
+    for (char c : direccion) {
+        if (c < '0' || c > '9') return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Abre el socket de escucha (no bloqueante) y prepara epoll y el eventfd de avisos.
+ * Una ruta de socket Unix que ya existe se reemplaza (queda de una ejecución anterior).
+ */
+bool ServidorUdeaStay::escuchar(const string& direccion) {
+    fdEpoll = epoll_create1(EPOLL_CLOEXEC);
+    fdAviso = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fdEpoll < 0 || fdAviso < 0) {
+        cerr << "Error [ServidorUdeaStay]: No se pudo crear epoll/eventfd: " << strerror(errno) << endl;
+        return false;
+    }
+
+    if (esPuertoTCP(direccion)) {
+        fdEscucha = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int uno = 1;
+        if (fdEscucha >= 0) ::setsockopt(fdEscucha, SOL_SOCKET, SO_REUSEADDR, &uno, sizeof(uno));
+        sockaddr_in dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.sin_family = AF_INET;
+        dir.sin_port = htons(static_cast<uint16_t>(atoi(direccion.c_str())));
+        dir.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Solo local
+        if (fdEscucha < 0 || ::bind(fdEscucha, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) < 0) {
+            cerr << "Error [ServidorUdeaStay]: No se pudo usar el puerto " << direccion << ": " << strerror(errno) << endl;
+            return false;
+        }
+    } else {
+        sockaddr_un dir;
+        memset(&dir, 0, sizeof(dir));
+        dir.sun_family = AF_UNIX;
+        if (direccion.size() >= sizeof(dir.sun_path)) {
+            cerr << "Error [ServidorUdeaStay]: La ruta del socket es demasiado larga: " << direccion << endl;
+            return false;
+        }
+        strncpy(dir.sun_path, direccion.c_str(), sizeof(dir.sun_path) - 1);
+        ::unlink(direccion.c_str());
+        fdEscucha = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fdEscucha < 0 || ::bind(fdEscucha, reinterpret_cast<sockaddr*>(&dir), sizeof(dir)) < 0) {
+            cerr << "Error [ServidorUdeaStay]: No se pudo crear el socket " << direccion << ": " << strerror(errno) << endl;
+            return false;
+        }
+        rutaSocketUnix = direccion;
+    }
+
+    if (::listen(fdEscucha, SOMAXCONN) < 0) {
+        cerr << "Error [ServidorUdeaStay]: listen falló: " << strerror(errno) << endl;
+        return false;
+    }
+
+    epoll_event evento;
+    memset(&evento, 0, sizeof(evento));
+    evento.events = EPOLLIN;
+    evento.data.fd = fdEscucha;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdEscucha, &evento);
+    evento.data.fd = fdAviso;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdAviso, &evento);
+    return true;
+}
+
+void ServidorUdeaStay::detener() {
+    detenerPedido = true;
+    uint64_t uno = 1;
+    ssize_t escritos = ::write(fdAviso, &uno, sizeof(uno));
+    (void)escritos;
+}
+
+/**
+ * @brief Bucle de eventos. Solo este hilo toca las conexiones; los trabajadores
+ * reciben la línea y la Sesion de la conexión, y devuelven el texto de la respuesta.
+ */
+void ServidorUdeaStay::ejecutar() {
+    if (fdEpoll < 0 || fdEscucha < 0) {
+        return;
+    }
+    trabajadores = new thread[cantidadTrabajadores];
+    for (int i = 0; i < cantidadTrabajadores; ++i) {
+        trabajadores[i] = thread(&ServidorUdeaStay::cicloTrabajador, this);
+    }
+    string direccion = rutaSocketUnix;
+    if (direccion.empty()) {
+        sockaddr_in dir;
+        socklen_t largo = sizeof(dir);
+        getsockname(fdEscucha, reinterpret_cast<sockaddr*>(&dir), &largo);
+        direccion = "127.0.0.1:" + to_string(ntohs(dir.sin_port));
+    }
+    cout << "Servidor UdeaStay escuchando en " << direccion << " con " << cantidadTrabajadores
+         << " trabajadores." << endl;
+
+    epoll_event eventos[EVENTOS_POR_ESPERA];
+    while (!detenerPedido) {
+        int listos = epoll_wait(fdEpoll, eventos, EVENTOS_POR_ESPERA, -1);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error [ServidorUdeaStay]: epoll_wait falló: " << strerror(errno) << endl;
+            break;
+        }
+        for (int i = 0; i < listos; ++i) {
+            int fd = eventos[i].data.fd;
+            if (fd == fdEscucha) {
+                aceptarConexiones();
+            } else if (fd == fdAviso) {
+                uint64_t contador;
+                while (::read(fdAviso, &contador, sizeof(contador)) > 0) {
+                }
+                recogerRespuestas();
+            } else if (fd < cupoConexiones && conexiones[fd] != nullptr) {
+                Conexion* conexion = conexiones[fd];
+                if (eventos[i].events & (EPOLLHUP | EPOLLERR)) {
+                    conexion->rota = true;
+                } else if (eventos[i].events & EPOLLIN) {
+                    leerDeConexion(conexion);
+                }
+                avanzar(conexion);
+            }
+        }
+    }
+
+    {
+        lock_guard<mutex> bloqueo(mutexTrabajos);
+        terminando = true;
+    }
+    hayTrabajo.notify_all();
+    for (int i = 0; i < cantidadTrabajadores; ++i) {
+        trabajadores[i].join();
+    }
+    delete[] trabajadores;
+    trabajadores = nullptr;
+    cout << "Servidor UdeaStay detenido (" << conexionesAbiertas << " conexiones abiertas al cerrar)." << endl;
+}
+
+void ServidorUdeaStay::cicloTrabajador() {
+    Trabajo trabajo;
+    while (true) {
+        {
+            unique_lock<mutex> bloqueo(mutexTrabajos);
+            hayTrabajo.wait(bloqueo, [this]() { return terminando || !trabajos.estaVacia(); });
+            if (!trabajos.desencolar(trabajo)) {
+                return; // terminando y sin trabajos pendientes
+            }
+        }
+
+        string texto;
+        try {
+            texto = gestor.atenderSolicitud(trabajo.conexion->sesion, trabajo.solicitud);
+        } catch (const exception& e) {
+            texto = string("ERR Error interno: ") + e.what() + "\n";
+        }
+
+        {
+            lock_guard<mutex> bloqueo(mutexRespuestas);
+            respuestas.encolar(Respuesta{trabajo.conexion, std::move(texto)});
+        }
+        uint64_t uno = 1;
+        ssize_t escritos = ::write(fdAviso, &uno, sizeof(uno));
+        (void)escritos;
+    }
+}
+
+void ServidorUdeaStay::aceptarConexiones() {
+    while (true) {
+        int fd = ::accept4(fdEscucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                cerr << "Error [ServidorUdeaStay]: accept falló: " << strerror(errno) << endl;
+            }
+            return;
+        }
+        registrarConexion(fd);
+    }
+}
+
+void ServidorUdeaStay::registrarConexion(int fd) {
+    if (fd >= cupoConexiones) {
+        int nuevoCupo = cupoConexiones == 0 ? 64 : cupoConexiones;
+        while (nuevoCupo <= fd) nuevoCupo *= 2;
+        Conexion** nuevo = new Conexion*[nuevoCupo];
+        for (int i = 0; i < nuevoCupo; ++i) {
+            nuevo[i] = i < cupoConexiones ? conexiones[i] : nullptr;
+        }
+        delete[] conexiones;
+        conexiones = nuevo;
+        cupoConexiones = nuevoCupo;
+    }
+
+    Conexion* conexion = new Conexion();
+    conexion->fd = fd;
+    conexion->enProceso = false;
+    conexion->entradaCerrada = false;
+    conexion->cerrarAlVaciar = false;
+    conexion->rota = false;
+    conexion->interes = EPOLLIN;
+    conexiones[fd] = conexion;
+    conexionesAbiertas++;
+
+    epoll_event evento;
+    memset(&evento, 0, sizeof(evento));
+    evento.events = conexion->interes;
+    evento.data.fd = fd;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fd, &evento);
+}
+
+void ServidorUdeaStay::leerDeConexion(Conexion* conexion) {
+    char bufer[4096];
+    while (conexion->entrada.size() < ENTRADA_MAXIMA_EN_ESPERA) {
+        ssize_t leidos = ::recv(conexion->fd, bufer, sizeof(bufer), 0);
+        if (leidos > 0) {
+            conexion->entrada.append(bufer, static_cast<size_t>(leidos));
+        } else if (leidos == 0) {
+            conexion->entradaCerrada = true; // Se atiende lo que ya llegó y luego se cierra
+            conexion->cerrarAlVaciar = true;
+            return;
+        } else {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                conexion->rota = true;
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Si la conexión no tiene una solicitud en proceso, entrega la siguiente línea
+ * completa a los trabajadores. Una línea demasiado larga se responde con ERR y se cierra.
+ */
+void ServidorUdeaStay::despacharSiguiente(Conexion* conexion) {
+    while (!conexion->enProceso) {
+        size_t finLinea = conexion->entrada.find('\n');
+        if (finLinea == string::npos) {
+            if (conexion->entrada.size() > LARGO_MAXIMO_SOLICITUD) {
+                conexion->salida += "ERR Solicitud demasiado larga\n";
+                conexion->entrada.clear();
+                conexion->entradaCerrada = true;
+                conexion->cerrarAlVaciar = true;
+            }
+            return;
+        }
+        size_t largo = finLinea;
+        if (largo > 0 && conexion->entrada[largo - 1] == '\r') largo--;
+        string solicitud = conexion->entrada.substr(0, largo);
+        conexion->entrada.erase(0, finLinea + 1);
+        if (solicitud.empty()) continue;
+
+        conexion->enProceso = true;
+        {
+            lock_guard<mutex> bloqueo(mutexTrabajos);
+            trabajos.encolar(Trabajo{conexion, std::move(solicitud)});
+        }
+        hayTrabajo.notify_one();
+    }
+}
+
+void ServidorUdeaStay::escribirPendiente(Conexion* conexion) {
+    size_t enviados = 0;
+    while (enviados < conexion->salida.size()) {
+        ssize_t n = ::send(conexion->fd, conexion->salida.data() + enviados,
+                           conexion->salida.size() - enviados, MSG_NOSIGNAL);
+        if (n > 0) {
+            enviados += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                conexion->rota = true;
+            }
+            break;
+        }
+    }
+    conexion->salida.erase(0, enviados);
+}
+
+/**
+ * @brief Avanza una conexión después de cualquier evento: despacha la siguiente
+ * solicitud, envía lo pendiente y la cierra cuando ya no queda nada por hacer.
+ * Una conexión con un trabajador en curso nunca se libera (se cierra al volver).
+ */
+void ServidorUdeaStay::avanzar(Conexion* conexion) {
+    if (!conexion->rota) {
+        despacharSiguiente(conexion);
+        if (!conexion->salida.empty()) {
+            escribirPendiente(conexion);
+        }
+    }
+    if (!conexion->enProceso &&
+        (conexion->rota || (conexion->cerrarAlVaciar && conexion->salida.empty()))) {
+        cerrarConexion(conexion);
+        return;
+    }
+    actualizarInteres(conexion);
+}
+
+// Lee solo si el cliente sigue enviando y no hay demasiado en espera; escribe si hay pendiente.
+// Una conexión rota sale de epoll (EPOLLHUP se reportaría sin parar) hasta que vuelva su trabajador.
+void ServidorUdeaStay::actualizarInteres(Conexion* conexion) {
+    if (conexion->rota) {
+        if (conexion->interes != FUERA_DE_EPOLL) {
+            epoll_ctl(fdEpoll, EPOLL_CTL_DEL, conexion->fd, nullptr);
+            conexion->interes = FUERA_DE_EPOLL;
+        }
+        return;
+    }
+    unsigned int interes = 0;
+    if (!conexion->entradaCerrada && conexion->entrada.size() < ENTRADA_MAXIMA_EN_ESPERA) {
+        interes |= EPOLLIN;
+    }
+    if (!conexion->salida.empty()) {
+        interes |= EPOLLOUT;
+    }
+    if (interes != conexion->interes) {
+        epoll_event evento;
+        memset(&evento, 0, sizeof(evento));
+        evento.events = interes;
+        evento.data.fd = conexion->fd;
+        epoll_ctl(fdEpoll, EPOLL_CTL_MOD, conexion->fd, &evento);
+        conexion->interes = interes;
+    }
+}
+
+void ServidorUdeaStay::recogerRespuestas() {
+    while (true) {
+        Respuesta respuesta;
+        {
+            lock_guard<mutex> bloqueo(mutexRespuestas);
+            if (!respuestas.desencolar(respuesta)) return;
+        }
+        Conexion* conexion = respuesta.conexion;
+        conexion->enProceso = false;
+        if (!conexion->rota) {
+            conexion->salida += respuesta.texto;
+        }
+        avanzar(conexion);
+    }
+}
+
+void ServidorUdeaStay::cerrarConexion(Conexion* conexion) {
+    if (conexion->interes != FUERA_DE_EPOLL) {
+        epoll_ctl(fdEpoll, EPOLL_CTL_DEL, conexion->fd, nullptr);
+    }
+    ::close(conexion->fd);
+    conexiones[conexion->fd] = nullptr;
+    conexionesAbiertas--;
+    delete conexion;
+}
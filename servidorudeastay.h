@@ -0,0 +1,100 @@
+#ifndef SERVIDORUDEASTAY_H
+#define SERVIDORUDEASTAY_H
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "sesion.h"
+#include "colacircular.h"
+
+class GestorUdeaStay;
+
+// Modo servidor: un solo proceso carga los datos una vez y atiende a muchos
+// clientes por un socket local (ruta de socket Unix, o un puerto TCP en 127.0.0.1).
+//
+// Protocolo de líneas: cada solicitud es una línea con campos separados por '|'
+// (ver GestorUdeaStay::atenderSolicitud). La respuesta son cero o más líneas de
+// datos que empiezan con "* " y una línea final que empieza con "OK" o "ERR".
+//
+// Un hilo lleva el bucle epoll (aceptar, leer y escribir sin bloquear) y entrega
+// cada línea completa a un grupo de trabajadores. Cada conexión tiene su propia
+// Sesion y a lo sumo una solicitud en proceso, así que sus respuestas salen en
+// el orden de las solicitudes aunque el cliente envíe varias seguidas.
+class ServidorUdeaStay {
+public:
+    ServidorUdeaStay(GestorUdeaStay& gestor, int trabajadores);
+    ~ServidorUdeaStay();
+
+    ServidorUdeaStay(const ServidorUdeaStay&) = delete;
+    ServidorUdeaStay& operator=(const ServidorUdeaStay&) = delete;
+
+    // 'direccion' es un número de puerto (TCP en 127.0.0.1) o la ruta de un socket Unix.
+    bool escuchar(const std::string& direccion);
+    // Atiende conexiones hasta que se llame detener().
+    void ejecutar();
+    // Pide terminar el bucle. Solo escribe en un eventfd: sirve desde un manejador de señales.
+    void detener();
+
+    // true si la dirección es un puerto TCP (solo dígitos) y no una ruta de socket Unix.
+    static bool esPuertoTCP(const std::string& direccion);
+
+private:
+    struct Conexion {
+        int fd;
+        std::string entrada;       // Bytes recibidos que aún no se han atendido
+        std::string salida;        // Respuestas pendientes de enviar
+        Sesion sesion;
+        bool enProceso;            // Un trabajador está atendiendo una solicitud suya
+        bool entradaCerrada;       // El cliente ya no enviará más (EOF)
+        bool cerrarAlVaciar;       // Cerrar en cuanto se envíe lo pendiente
+        bool rota;                 // Error de red: se descarta lo pendiente
+        unsigned int interes;      // Eventos registrados en epoll
+    };
+    struct Trabajo {
+        Conexion* conexion;
+        std::string solicitud;
+    };
+    struct Respuesta {
+        Conexion* conexion;
+        std::string texto;
+    };
+
+    GestorUdeaStay& gestor;
+    int cantidadTrabajadores;
+    std::thread* trabajadores;
+
+    int fdEscucha;
+    int fdEpoll;
+    int fdAviso;                   // eventfd: respuestas listas o pedido de detener
+    std::string rutaSocketUnix;    // Para borrarla al terminar
+
+    // Tabla de conexiones indexada por descriptor
+    Conexion** conexiones;
+    int cupoConexiones;
+    int conexionesAbiertas;
+
+    std::mutex mutexTrabajos;
+    std::condition_variable hayTrabajo;
+    ColaCircular<Trabajo> trabajos;
+    bool terminando;
+
+    std::mutex mutexRespuestas;
+    ColaCircular<Respuesta> respuestas;
+
+    std::atomic<bool> detenerPedido;
+
+    void cicloTrabajador();
+    void aceptarConexiones();
+    void registrarConexion(int fd);
+    void leerDeConexion(Conexion* conexion);
+    void escribirPendiente(Conexion* conexion);
+    void despacharSiguiente(Conexion* conexion);
+    void avanzar(Conexion* conexion);
+    void actualizarInteres(Conexion* conexion);
+    void recogerRespuestas();
+    void cerrarConexion(Conexion* conexion);
+};
+
+#endif // SERVIDORUDEASTAY_H
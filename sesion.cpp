@@ -0,0 +1,36 @@
+#include "sesion.h"
+
+Sesion::Sesion() : anfitrion(nullptr), huesped(nullptr) {
+}
+
+// Una sesión tiene un solo rol: iniciar como uno cierra el otro.
+void Sesion::iniciarComoAnfitrion(Anfitrion* anf) {
+    anfitrion = anf;
+    huesped = nullptr;
+}
+
+void Sesion::iniciarComoHuesped(Huesped* hue) {
+    huesped = hue;
+    anfitrion = nullptr;
+}
+
+void Sesion::cerrar() {
+    anfitrion = nullptr;
+    huesped = nullptr;
+}
+
+bool Sesion::esAnfitrion() const {
+    return anfitrion != nullptr;
+}
+
+bool Sesion::esHuesped() const {
+    return huesped != nullptr;
+}
+
+Anfitrion* Sesion::getAnfitrion() const {
+    return anfitrion;
+}
+
+Huesped* Sesion::getHuesped() const {
+    return huesped;
+}
@@ -0,0 +1,30 @@
+#ifndef SESION_H
+#define SESION_H
+
+#include "anfitrion.h"
+#include "huesped.h"
+
+// Estado de la sesión de un usuario (quién inició sesión y con qué rol).
+// Vive fuera de GestorUdeaStay para que un mismo gestor atienda a varios
+// usuarios a la vez: cada hilo o conexión tiene su propia Sesion y la pasa
+// a las operaciones que dependen de quién las pide.
+// Los punteros no son dueños: apuntan a objetos del gestor.
+class Sesion {
+private:
+    Anfitrion* anfitrion;
+    Huesped* huesped;
+
+public:
+    Sesion();
+
+    void iniciarComoAnfitrion(Anfitrion* anf);
+    void iniciarComoHuesped(Huesped* hue);
+    void cerrar();
+
+    bool esAnfitrion() const;
+    bool esHuesped() const;
+    Anfitrion* getAnfitrion() const;
+    Huesped* getHuesped() const;
+};
+
+#endif // SESION_H
@@ -0,0 +1,159 @@
+#ifndef TABLAHASH_H
+#define TABLAHASH_H
+
+#include <string>
+#include <utility>
+
+// Tabla hash de direccionamiento abierto (sondeo lineal) con claves std::string.
+// Se usa para los índices del gestor (código -> posición, documento -> huésped, ...),
+// que antes se resolvían con recorridos lineales sobre los arreglos.
+// Es una plantilla, por eso toda la implementación vive en este encabezado.
+template <typename Valor>
+class TablaHash {
+private:
+    enum EstadoRanura : unsigned char { VACIA = 0, OCUPADA = 1, BORRADA = 2 };
+
+    struct Ranura {
+        std::string clave;
+        Valor valor;
+        EstadoRanura estado;
+        Ranura() : clave(), valor(), estado(VACIA) {}
+    };
+
+    Ranura* ranuras;
+    int cupo;        // Siempre potencia de dos
+    int cantidad;    // Ranuras OCUPADAS
+    int borradas;    // Ranuras BORRADAS (lápidas)
+
+    // FNV-1a de 64 bits: rápido y suficiente para códigos cortos.
+    static unsigned long long calcularHash(const std::string& clave) {
+        unsigned long long h = 1469598103934665603ULL;
+        for (unsigned char c : clave) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    // Devuelve la ranura con la clave, o -1 si no está.
+    int ubicar(const std::string& clave) const {
+        if (cupo == 0) return -1;
+        int mascara = cupo - 1;
+        int i = static_cast<int>(calcularHash(clave) & static_cast<unsigned long long>(mascara));
+        while (ranuras[i].estado != VACIA) {
+            if (ranuras[i].estado == OCUPADA && ranuras[i].clave == clave) {
+                return i;
+            }
+            i = (i + 1) & mascara;
+        }
+        return -1;
+    }
+
+    void redimensionar(int nuevoCupo) {
+        Ranura* anteriores = ranuras;
+        int cupoAnterior = cupo;
+
+        ranuras = new Ranura[nuevoCupo];
+        cupo = nuevoCupo;
+        cantidad = 0;
+        borradas = 0;
+
+        for (int i = 0; i < cupoAnterior; ++i) {
+            if (anteriores[i].estado == OCUPADA) {
+                insertar(std::move(anteriores[i].clave), std::move(anteriores[i].valor));
+            }
+        }
+        delete[] anteriores;
+    }
+
+    // Mantiene el factor de carga (incluyendo lápidas) por debajo del 70%.
+    void asegurarCapacidad() {
+        if (cupo == 0) {
+            redimensionar(16);
+        } else if ((cantidad + borradas + 1) * 10 > cupo * 7) {
+            // Si la mayoría son lápidas basta con reconstruir al mismo tamaño.
+            redimensionar(cantidad * 2 >= cupo / 2 ? cupo * 2 : cupo);
+        }
+    }
+
+public:
+    TablaHash() : ranuras(nullptr), cupo(0), cantidad(0), borradas(0) {}
+    ~TablaHash() { delete[] ranuras; }
+
+    TablaHash(const TablaHash&) = delete;
+    TablaHash& operator=(const TablaHash&) = delete;
+
+    // Prepara espacio para 'elementos' claves sin redimensionar durante la carga.
+    void reservar(int elementos) {
+        int necesario = 16;
+        while (necesario * 7 < elementos * 10) necesario *= 2;
+        if (necesario > cupo) redimensionar(necesario);
+    }
+
+    // Inserta o sobrescribe. Devuelve true si la clave era nueva.
+    bool insertar(std::string clave, Valor valor) {
+        int existente = ubicar(clave);
+        if (existente >= 0) {
+            ranuras[existente].valor = std::move(valor);
+            return false;
+        }
+        asegurarCapacidad();
+        int mascara = cupo - 1;
+        int i = static_cast<int>(calcularHash(clave) & static_cast<unsigned long long>(mascara));
+        while (ranuras[i].estado == OCUPADA) {
+            i = (i + 1) & mascara;
+        }
+        if (ranuras[i].estado == BORRADA) borradas--;
+        ranuras[i].clave = std::move(clave);
+        ranuras[i].valor = std::move(valor);
+        ranuras[i].estado = OCUPADA;
+        cantidad++;
+        return true;
+    }
+
+    Valor* buscar(const std::string& clave) {
+        int i = ubicar(clave);
+        return i >= 0 ? &ranuras[i].valor : nullptr;
+    }
+
+    const Valor* buscar(const std::string& clave) const {
+        int i = ubicar(clave);
+        return i >= 0 ? &ranuras[i].valor : nullptr;
+    }
+
+    bool contiene(const std::string& clave) const { return ubicar(clave) >= 0; }
+
+    bool eliminar(const std::string& clave) {
+        int i = ubicar(clave);
+        if (i < 0) return false;
+        ranuras[i].estado = BORRADA;
+        ranuras[i].clave.clear();
+        ranuras[i].valor = Valor();
+        cantidad--;
+        borradas++;
+        return true;
+    }
+
+    void vaciar() {
+        delete[] ranuras;
+        ranuras = nullptr;
+        cupo = 0;
+        cantidad = 0;
+        borradas = 0;
+    }
+
+    int getCantidad() const { return cantidad; }
+
+    // Aplica f(clave, valor) a cada entrada (orden no especificado).
+    template <typename Funcion>
+    void paraCada(Funcion f) const {
+        for (int i = 0; i < cupo; ++i) {
+            if (ranuras[i].estado == OCUPADA) f(ranuras[i].clave, ranuras[i].valor);
+        }
+    }
+
+    // Memoria aproximada ocupada por las ranuras (sin contar el contenido dinámico de las claves).
+    size_t memoriaAproximada() const { return static_cast<size_t>(cupo) * sizeof(Ranura); }
+};
+
+#endif // TABLAHASH_H
@@ -0,0 +1,192 @@
+// --- tarifastemporada.cpp ---
+// Implementación de las tarifas por fecha con sumas prefijas.
+#include "tarifastemporada.h"
+using namespace std;
+
+// 0 = domingo ... 6 = sábado. El día 0 (01/01/1970) fue jueves.
+static int diaDeLaSemana(long numeroDia) {
+    long d = (numeroDia + 4) % 7;
+    return static_cast<int>(d < 0 ? d + 7 : d);
+}
+
+TarifasTemporada::TarifasTemporada() :
+    reglas(nullptr), cantidadReglas(0), cupoReglas(0),
+    perfiles(nullptr), cantidadPerfiles(0), perfilDeAlojamiento(nullptr), cantidadAlojamientos(0) {
+}
+
+TarifasTemporada::~TarifasTemporada() {
+    liberarPerfiles();
+    delete[] reglas;
+}
+
+void TarifasTemporada::liberarPerfiles() {
+    for (int i = 0; i < cantidadPerfiles; ++i) {
+        delete[] perfiles[i].acumulado;
+    }
+    delete[] perfiles;
+    delete[] perfilDeAlojamiento;
+    perfiles = nullptr;
+    perfilDeAlojamiento = nullptr;
+    cantidadPerfiles = 0;
+}
+
+void TarifasTemporada::inicializar(int cantidad) {
+    liberarPerfiles();
+    delete[] reglas;
+    reglas = nullptr;
+    cantidadReglas = cupoReglas = 0;
+    cantidadAlojamientos = cantidad > 0 ? cantidad : 0;
+    perfilDeAlojamiento = new int[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1];
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        perfilDeAlojamiento[i] = -1;
+    }
+}
+
+bool TarifasTemporada::agregarRegla(int alojamiento, long diaDesde, long diaHasta, DiasAplica dias,
+                                    long ajustePuntosBasicos) {
+    if (alojamiento >= cantidadAlojamientos || diaHasta < diaDesde || ajustePuntosBasicos <= -FACTOR_BASE) {
+        return false;
+    }
+    if (cantidadReglas == cupoReglas) {
+        int nuevoCupo = cupoReglas == 0 ? 16 : cupoReglas * 2;
+        Regla* nuevas = new Regla[nuevoCupo];
+        for (int i = 0; i < cantidadReglas; ++i) {
+            nuevas[i] = reglas[i];
+        }
+        delete[] reglas;
+        reglas = nuevas;
+        cupoReglas = nuevoCupo;
+    }
+    reglas[cantidadReglas++] = Regla{alojamiento < 0 ? -1 : alojamiento, diaDesde, diaHasta, dias, ajustePuntosBasicos};
+    return true;
+}
+
+TarifasTemporada::Perfil TarifasTemporada::construirPerfil(int alojamiento) const {
+    Perfil perfil{0, 0, nullptr};
+    long desde = 0, hasta = -1;
+    for (int r = 0; r < cantidadReglas; ++r) {
+        const Regla& regla = reglas[r];
+        if (regla.alojamiento != -1 && regla.alojamiento != alojamiento) continue;
+        if (hasta < desde) {
+            desde = regla.diaDesde;
+            hasta = regla.diaHasta;
+        } else {
+            if (regla.diaDesde < desde) desde = regla.diaDesde;
+            if (regla.diaHasta > hasta) hasta = regla.diaHasta;
+        }
+    }
+    if (hasta < desde) {
+        return perfil;
+    }
+
+    perfil.diaInicio = desde;
+    perfil.dias = hasta - desde + 1;
+    long long* factores = new long long[perfil.dias];
+    for (long k = 0; k < perfil.dias; ++k) {
+        factores[k] = FACTOR_BASE;
+    }
+    for (int r = 0; r < cantidadReglas; ++r) {
+        const Regla& regla = reglas[r];
+        if (regla.alojamiento != -1 && regla.alojamiento != alojamiento) continue;
+        for (long dia = regla.diaDesde; dia <= regla.diaHasta; ++dia) {
+            if (regla.dias == FIN_DE_SEMANA) {
+                int semana = diaDeLaSemana(dia);
+                if (semana != 5 && semana != 6) continue;
+            }
+            long long& f = factores[dia - desde];
+            // Siempre >= 0 porque el ajuste es mayor que -10000: la división redondea al más cercano
+            f = (f * (FACTOR_BASE + regla.ajustePuntosBasicos) + FACTOR_BASE / 2) / FACTOR_BASE;
+        }
+    }
+    perfil.acumulado = new long long[perfil.dias + 1];
+    perfil.acumulado[0] = 0;
+    for (long k = 0; k < perfil.dias; ++k) {
+        perfil.acumulado[k + 1] = perfil.acumulado[k] + factores[k];
+    }
+    delete[] factores;
+    return perfil;
+}
+
+/**
+ * @brief Arma el perfil general (si hay reglas para todos) y uno por cada alojamiento
+ * con reglas propias; los demás alojamientos comparten el general.
+ */
+void TarifasTemporada::construir() {
+    for (int i = 0; i < cantidadPerfiles; ++i) {
+        delete[] perfiles[i].acumulado;
+    }
+    delete[] perfiles;
+    perfiles = nullptr;
+    cantidadPerfiles = 0;
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        perfilDeAlojamiento[i] = -1;
+    }
+
+    bool hayGenerales = false;
+    bool* conPropias = new bool[cantidadAlojamientos > 0 ? cantidadAlojamientos : 1]();
+    int propias = 0;
+    for (int r = 0; r < cantidadReglas; ++r) {
+        if (reglas[r].alojamiento < 0) {
+            hayGenerales = true;
+        } else if (!conPropias[reglas[r].alojamiento]) {
+            conPropias[reglas[r].alojamiento] = true;
+            propias++;
+        }
+    }
+
+    perfiles = new Perfil[(hayGenerales ? 1 : 0) + propias + 1];
+    int general = -1;
+    if (hayGenerales) {
+        general = cantidadPerfiles;
+        perfiles[cantidadPerfiles++] = construirPerfil(-1);
+    }
+    for (int i = 0; i < cantidadAlojamientos; ++i) {
+        if (conPropias[i]) {
+            perfilDeAlojamiento[i] = cantidadPerfiles;
+            perfiles[cantidadPerfiles++] = construirPerfil(i);
+        } else {
+            perfilDeAlojamiento[i] = general;
+        }
+    }
+    delete[] conPropias;
+}
+
+long long TarifasTemporada::sumarFactores(int alojamiento, long diaEntrada, long diaSalida) const {
+    if (diaSalida <= diaEntrada) {
+        return 0;
+    }
+    long long noches = diaSalida - diaEntrada;
+    int p = alojamiento >= 0 && alojamiento < cantidadAlojamientos ? perfilDeAlojamiento[alojamiento] : -1;
+    if (p < 0) {
+        return noches * FACTOR_BASE;
+    }
+    const Perfil& perfil = perfiles[p];
+    long desde = diaEntrada > perfil.diaInicio ? diaEntrada : perfil.diaInicio;
+    long hasta = diaSalida < perfil.diaInicio + perfil.dias ? diaSalida : perfil.diaInicio + perfil.dias;
+    if (hasta <= desde) {
+        return noches * FACTOR_BASE;
+    }
+    long long dentro = perfil.acumulado[hasta - perfil.diaInicio] - perfil.acumulado[desde - perfil.diaInicio];
+    return dentro + (noches - (hasta - desde)) * FACTOR_BASE;
+}
+
+long long TarifasTemporada::costoEstadia(int alojamiento, long long precioBase, long diaEntrada, long diaSalida) const {
+    return (precioBase * sumarFactores(alojamiento, diaEntrada, diaSalida) + FACTOR_BASE / 2) / FACTOR_BASE;
+}
+
+int TarifasTemporada::getCantidadReglas() const {
+    return cantidadReglas;
+}
+
+int TarifasTemporada::getCantidadPerfiles() const {
+    return cantidadPerfiles;
+}
+
+size_t TarifasTemporada::memoriaAproximada() const {
+    size_t total = sizeof(*this) + static_cast<size_t>(cupoReglas) * sizeof(Regla) +
+                   static_cast<size_t>(cantidadAlojamientos) * sizeof(int);
+    for (int i = 0; i < cantidadPerfiles; ++i) {
+        total += sizeof(Perfil) + static_cast<size_t>(perfiles[i].dias + 1) * sizeof(long long);
+    }
+    return total;
+}
@@ -0,0 +1,81 @@
+#ifndef TARIFASTEMPORADA_H
+#define TARIFASTEMPORADA_H
+
+#include <cstddef>
+
+// Precios por noche según la fecha (temporadas, fines de semana, festivos).
+//
+// Cada regla ajusta el precio base del alojamiento en un porcentaje para un rango de
+// noches, a un alojamiento o a todos. Las reglas se aplican en el orden en que se
+// agregan y se componen: temporada alta +20 % y luego fin de semana +10 % dan
+// +32 % el sábado de temporada. El factor de cada noche se guarda en puntos básicos
+// (10000 = precio base) con aritmética entera.
+//
+// Para cada perfil (las reglas generales, y las generales más las propias de un
+// alojamiento que tenga reglas propias) se guardan las sumas prefijas de los factores
+// en el rango que cubren sus reglas. El costo de cualquier estadía sale en O(1):
+//     costo = redondeo(precioBase * suma de factores de sus noches / 10000)
+// en pesos enteros, redondeando una sola vez al final. Fuera del rango del perfil
+// cada noche vale el precio base.
+class TarifasTemporada {
+public:
+    static constexpr long FACTOR_BASE = 10000;
+
+    enum DiasAplica {
+        TODOS_LOS_DIAS,
+        FIN_DE_SEMANA          // Noches de viernes y sábado
+    };
+
+private:
+    struct Regla {
+        int alojamiento;       // -1 = todos
+        long diaDesde;         // Primera noche (ver Fecha::aNumeroDia)
+        long diaHasta;         // Última noche, incluida
+        DiasAplica dias;
+        long ajustePuntosBasicos;  // +2500 = +25 %, -1000 = -10 %
+    };
+
+    struct Perfil {
+        long diaInicio;
+        long dias;
+        long long* acumulado;  // acumulado[k] = suma de factores de las noches [diaInicio, diaInicio + k)
+    };
+
+    Regla* reglas;
+    int cantidadReglas;
+    int cupoReglas;
+
+    Perfil* perfiles;
+    int cantidadPerfiles;
+    int* perfilDeAlojamiento;  // -1 = sin reglas: todas sus noches al precio base
+    int cantidadAlojamientos;
+
+    void liberarPerfiles();
+    // Arma un perfil con las reglas generales y, si alojamiento >= 0, las de ese alojamiento.
+    Perfil construirPerfil(int alojamiento) const;
+
+public:
+    TarifasTemporada();
+    ~TarifasTemporada();
+
+    TarifasTemporada(const TarifasTemporada&) = delete;
+    TarifasTemporada& operator=(const TarifasTemporada&) = delete;
+
+    // Descarta todas las reglas y perfiles y prepara 'cantidad' alojamientos sin tarifas.
+    void inicializar(int cantidad);
+    // El ajuste debe ser mayor que -10000 (un descuento del 100 % o más no tiene sentido).
+    bool agregarRegla(int alojamiento, long diaDesde, long diaHasta, DiasAplica dias, long ajustePuntosBasicos);
+    // Aplica las reglas agregadas y arma las sumas prefijas de cada perfil.
+    void construir();
+
+    // Suma de los factores de las noches [diaEntrada, diaSalida) en puntos básicos.
+    long long sumarFactores(int alojamiento, long diaEntrada, long diaSalida) const;
+    // Costo total de la estadía en pesos enteros (redondeo al peso más cercano).
+    long long costoEstadia(int alojamiento, long long precioBase, long diaEntrada, long diaSalida) const;
+
+    int getCantidadReglas() const;
+    int getCantidadPerfiles() const;
+    size_t memoriaAproximada() const;
+};
+
+#endif // TARIFASTEMPORADA_H
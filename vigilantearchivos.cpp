@@ -0,0 +1,120 @@
+// --- vigilantearchivos.cpp ---
+// Implementación del vigilante de archivos (inotify).
+#include "vigilantearchivos.h"
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+using namespace std;
+
+VigilanteArchivos::VigilanteArchivos() : cantidad(0), descriptor(-1), esperaMs(300) {
+    tuberiaDetener[0] = tuberiaDetener[1] = -1;
+}
+
+VigilanteArchivos::~VigilanteArchivos() {
+    detener();
+}
+
+bool VigilanteArchivos::iniciar(const string rutas[], int cantidadRutas, const Aviso& alCambiar,
+                                int esperaMilisegundos) {
+    detener();
+    descriptor = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descriptor < 0 || ::pipe2(tuberiaDetener, O_CLOEXEC) != 0) {
+        cerr << "Error [VigilanteArchivos]: inotify no está disponible." << endl;
+        detener();
+        return false;
+    }
+    cantidad = 0;
+    for (int i = 0; i < cantidadRutas && cantidad < MAX_ARCHIVOS; ++i) {
+        Vigilado& v = vigilados[cantidad];
+        const size_t barra = rutas[i].rfind('/');
+        const string directorio = barra == string::npos ? "." : (barra == 0 ? "/" : rutas[i].substr(0, barra));
+        v.ruta = rutas[i];
+        v.nombre = barra == string::npos ? rutas[i] : rutas[i].substr(barra + 1);
+        // Dos archivos del mismo directorio comparten la vigilancia (inotify devuelve el mismo número)
+        v.vigilancia = ::inotify_add_watch(descriptor, directorio.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        v.pendiente = false;
+        if (v.vigilancia < 0) {
+            cerr << "Error [VigilanteArchivos]: No se puede vigilar el directorio '" << directorio << "'." << endl;
+            continue;
+        }
+        cantidad++;
+    }
+    if (cantidad == 0) {
+        detener();
+        return false;
+    }
+    esperaMs = esperaMilisegundos > 0 ? esperaMilisegundos : 1;
+    aviso = alCambiar;
+    hilo = thread(&VigilanteArchivos::ciclo, this);
+    return true;
+}
+
+void VigilanteArchivos::detener() {
+    if (hilo.joinable()) {
+        const char fin = 0;
+        while (::write(tuberiaDetener[1], &fin, 1) < 0 && errno == EINTR) {
+        }
+        hilo.join();
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (tuberiaDetener[i] >= 0) ::close(tuberiaDetener[i]);
+        tuberiaDetener[i] = -1;
+    }
+    if (descriptor >= 0) ::close(descriptor); // También retira las vigilancias
+    descriptor = -1;
+    cantidad = 0;
+}
+
+bool VigilanteArchivos::estaActivo() const {
+    return descriptor >= 0;
+}
+
+void VigilanteArchivos::leerEventos() {
+    alignas(inotify_event) char bufer[4096];
+    const auto avisarEn = chrono::steady_clock::now() + chrono::milliseconds(esperaMs);
+    while (true) {
+        ssize_t leidos = ::read(descriptor, bufer, sizeof(bufer));
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos <= 0) return; // EAGAIN: no hay más por ahora
+        for (char* p = bufer; p < bufer + leidos;) {
+            const inotify_event* evento = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + evento->len;
+            for (int i = 0; i < cantidad; ++i) {
+                // Si se perdieron eventos (cola llena) se revisan todos los archivos
+                if ((evento->mask & IN_Q_OVERFLOW) ||
+                    (evento->wd == vigilados[i].vigilancia && evento->len > 0 && vigilados[i].nombre == evento->name)) {
+                    vigilados[i].pendiente = true;
+                    vigilados[i].avisarEn = avisarEn;
+                }
+            }
+        }
+    }
+}
+
+void VigilanteArchivos::ciclo() {
+    pollfd esperas[2] = {{descriptor, POLLIN, 0}, {tuberiaDetener[0], POLLIN, 0}};
+    while (true) {
+        int espera = -1;
+        const auto ahora = chrono::steady_clock::now();
+        for (int i = 0; i < cantidad; ++i) {
+            if (!vigilados[i].pendiente) continue;
+            long restante = static_cast<long>(
+                chrono::duration_cast<chrono::milliseconds>(vigilados[i].avisarEn - ahora).count());
+            if (restante < 0) restante = 0;
+            if (espera < 0 || restante < espera) espera = static_cast<int>(restante);
+        }
+        if (::poll(esperas, 2, espera) < 0 && errno != EINTR) return;
+        if (esperas[1].revents != 0) return;
+        if (esperas[0].revents & POLLIN) leerEventos();
+
+        for (int i = 0; i < cantidad; ++i) {
+            if (vigilados[i].pendiente && chrono::steady_clock::now() >= vigilados[i].avisarEn) {
+                vigilados[i].pendiente = false;
+                aviso(vigilados[i].ruta);
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef VIGILANTEARCHIVOS_H
+#define VIGILANTEARCHIVOS_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Avisa cuando cambia alguno de unos archivos, con inotify y un hilo propio.
+//
+// Se vigila el directorio de cada archivo (no el archivo): así también se ve el
+// reemplazo atómico "escribir un temporal y renombrarlo", que cambia el inodo.
+// Cuenta como cambio cerrar el archivo después de escribirlo (IN_CLOSE_WRITE) o que
+// otro archivo se renombre con su nombre (IN_MOVED_TO). Un editor suele producir
+// varios eventos seguidos: el aviso se da cuando pasa 'esperaMs' sin eventos nuevos
+// de ese archivo, una sola vez por ráfaga.
+class VigilanteArchivos {
+public:
+    static const int MAX_ARCHIVOS = 4;
+    // Recibe la ruta tal como se pasó a iniciar(). Corre en el hilo del vigilante.
+    typedef std::function<void(const std::string& ruta)> Aviso;
+
+private:
+    struct Vigilado {
+        std::string ruta;
+        std::string nombre;          // Sin el directorio (así lo reporta inotify)
+        int vigilancia;              // Descriptor de inotify_add_watch del directorio
+        bool pendiente;
+        std::chrono::steady_clock::time_point avisarEn;
+    };
+
+    Vigilado vigilados[MAX_ARCHIVOS];
+    int cantidad;
+    int descriptor;                  // inotify
+    int tuberiaDetener[2];           // Escribir en [1] despierta al hilo para que termine
+    int esperaMs;
+    Aviso aviso;
+    std::thread hilo;
+
+    void ciclo();
+    void leerEventos();
+
+public:
+    VigilanteArchivos();
+    ~VigilanteArchivos();
+
+    VigilanteArchivos(const VigilanteArchivos&) = delete;
+    VigilanteArchivos& operator=(const VigilanteArchivos&) = delete;
+
+    // Empieza a vigilar 'rutas' (hasta MAX_ARCHIVOS). false si inotify no está disponible.
+    bool iniciar(const std::string rutas[], int cantidadRutas, const Aviso& alCambiar, int esperaMilisegundos = 300);
+    void detener();
+    bool estaActivo() const;
+};
+
+#endif // VIGILANTEARCHIVOS_H